@@ -16,7 +16,8 @@ let telemetry_data = {
 	download_ota: {
 		status: 'none',
 		progress: 0,
-		error: ''
+		error: '',
+		mbps: 0
 	}
 };
 
@@ -47,7 +48,12 @@ function createTelemetry() {
 		setDownloadOTA: (data: DownloadOTA) => {
 			update((telemetry_data) => ({
 				...telemetry_data,
-				download_ota: { status: data.status, progress: data.progress, error: data.error }
+				download_ota: {
+					status: data.status,
+					progress: data.progress,
+					error: data.error,
+					mbps: data.mbps
+				}
 			}));
 		}
 	};
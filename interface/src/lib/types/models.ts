@@ -10,6 +10,12 @@ export type WifiStatus = {
 	gateway_ip: string;
 	dns_ip_1: string;
 	dns_ip_2?: string;
+	boot_to_connected: number;
+	last_connect: number;
+	fast_connect: boolean;
+	fast_connects: number;
+	scan_connects: number;
+	fast_failures: number;
 };
 
 export type WifiSettings = {
@@ -96,6 +102,20 @@ export type Analytics = {
 	uptime: number;
 	cpuPerc: number;
 	loopsPerSecond: number;
+	sockets_open: number;
+	sockets_ws: number;
+	sockets_clients: number;
+	sockets_max: number;
+	sockets_peak: number;
+	sockets_accepted: number;
+	sockets_evicted: number;
+	tls_key?: string;
+	tls_full?: number;
+	tls_resumed?: number;
+	tls_failed?: number;
+	tls_full_ms?: number;
+	tls_resumed_ms?: number;
+	tls_max_ms?: number;
 };
 
 export type RSSI = {
@@ -112,6 +132,7 @@ export type DownloadOTA = {
 	status: string;
 	progress: number;
 	error: string;
+	mbps?: number;
 };
 
 export type StaticSystemInformation = {
@@ -122,6 +143,7 @@ export type StaticSystemInformation = {
 	cpu_rev: number;
 	cpu_cores: number;
 	sketch_size: number;
+	firmware_sha256: string;
 	free_sketch_space: number;
 	sdk_version: string;
 	arduino_version: string;
@@ -137,6 +159,8 @@ export type MQTTStatus = {
 	connected: boolean;
 	client_id: string;
 	last_error: string;
+	published: number;
+	suppressed: number;
 };
 
 export type MQTTSettings = {
@@ -177,12 +201,52 @@ export type FixtureState = {
 	depth: number;
 	driverOn:boolean;
 	monitorOn:boolean;
-	pin:number
+	pin:number;
+	slice: FixtureSlice
+};
+
+export type FixtureSlice = {
+	x: number;
+	y: number;
+	z: number;
+	width: number;
+	height: number;
+	depth: number;
+};
+
+export type LayerState = {
+	effect: number;
+	projection: number;
+	opacity: number;
+	blend: number; // 0: alpha, 1: add, 2: multiply, 3: screen
+	start: number;
+	end: number;
+	on: boolean;
+};
+
+export type NodeState = {
+	name: string;
+	id: number; // referred to by inputs, 0: no node
+	type: number; // 0: effect, 1: modifier, 2: projection, 3: blend, 4: output
+	index: number; // effect, modifier or projection
+	inputs: number[];
+	opacity: number;
+	blend: number;
+	on: boolean;
+};
+
+export type NodeTiming = {
+	total_us: number;
+	buffers: number;
+	nodes: { id: number; us: number; cached: boolean }[];
 };
 
 export type EffectsState = {
 	name: string;
 	effect: number;
 	projection: number;
-	nodes: EffectsState[];
+	layers: LayerState[];
+	transition: number;
+	transitionDuration: number;
+	nodes: NodeState[];
 };
\ No newline at end of file
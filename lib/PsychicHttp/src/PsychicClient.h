@@ -22,6 +22,12 @@ class PsychicClient {
 
     bool isNew = false;
 
+    //connection management
+    IPAddress remoteAddress;        //set on open
+    unsigned long lastActivity = 0; //millis of the last request start / end
+    bool webSocket = false;         //upgraded: never closed for idleness or pressure
+    bool closing = false;           //close triggered, not counted anymore
+
     bool operator==(PsychicClient& rhs) const { return _socket == rhs.socket(); }
 
     httpd_handle_t server();
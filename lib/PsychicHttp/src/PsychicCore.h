@@ -28,6 +28,32 @@
   #define MAX_REQUEST_BODY_SIZE (16*1024) //16K
 #endif
 
+//connection management, see PsychicHttpServer::manageConnections
+#ifndef MAX_OPEN_SOCKETS
+  #define MAX_OPEN_SOCKETS 10 //capped to CONFIG_LWIP_MAX_SOCKETS - 3, keep some for udp / mqtt
+#endif
+
+#ifndef MAX_SOCKETS_PER_CLIENT
+  #define MAX_SOCKETS_PER_CLIENT 5 //http sockets per remote ip (websockets not counted), a browser opens up to 6
+#endif
+
+#ifndef SOCKET_IDLE_TIMEOUT
+  #define SOCKET_IDLE_TIMEOUT 10000 //ms, keep-alive http sockets without requests are closed, websockets are kept
+#endif
+
+//tls session resumption, see PsychicHttpsServer
+#ifndef SSL_SESSION_CACHE_SIZE
+  #define SSL_SESSION_CACHE_SIZE 8 //session id cache entries, 0: no cache
+#endif
+
+#ifndef SSL_SESSION_LIFETIME
+  #define SSL_SESSION_LIFETIME 86400 //seconds, of cached sessions and tickets
+#endif
+
+#ifndef SSL_SESSION_TICKETS
+  #define SSL_SESSION_TICKETS 1
+#endif
+
 #ifdef ARDUINO
   #include <Arduino.h>
   #include <ArduinoTrace.h>
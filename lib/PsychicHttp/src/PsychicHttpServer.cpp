@@ -13,6 +13,8 @@ PsychicHttpServer::PsychicHttpServer() :
 {
   maxRequestBodySize = MAX_REQUEST_BODY_SIZE;
   maxUploadSize = MAX_UPLOAD_SIZE;
+  maxSocketsPerClient = MAX_SOCKETS_PER_CLIENT;
+  idleTimeout = SOCKET_IDLE_TIMEOUT;
 
   defaultEndpoint = new PsychicEndpoint(this, HTTP_GET, "");
   onNotFound(PsychicHttpServer::defaultNotFoundHandler);
@@ -27,6 +29,14 @@ PsychicHttpServer::PsychicHttpServer() :
   config.global_user_ctx_free_fn = destroy;
   config.max_uri_handlers = 20;
 
+  //httpd default is 7, lru purge is the last resort: openCallback evicts http sockets before websockets
+  config.max_open_sockets = MAX_OPEN_SOCKETS;
+  #ifdef CONFIG_LWIP_MAX_SOCKETS
+    if (config.max_open_sockets > CONFIG_LWIP_MAX_SOCKETS - 3)
+      config.max_open_sockets = CONFIG_LWIP_MAX_SOCKETS - 3;
+  #endif
+  config.lru_purge_enable = true;
+
   #ifdef ENABLE_ASYNC
     // It is advisable that httpd_config_t->max_open_sockets > MAX_ASYNC_REQUESTS
     // Why? This leaves at least one socket still available to handle
@@ -245,6 +255,22 @@ esp_err_t PsychicHttpServer::openCallback(httpd_handle_t hd, int sockfd)
     client = new PsychicClient(hd, sockfd);
     server->addClient(client);
   }
+  client->remoteAddress = client->remoteIP();
+  client->lastActivity = millis();
+
+  PsychicConnectionStats &stats = server->connectionStats;
+  stats.accepted++;
+  if (server->count() > stats.peak)
+    stats.peak = server->count();
+
+  //a client over its quota of http sockets (its websockets do not count): make room by closing its oldest http socket
+  if (server->maxSocketsPerClient && server->countClients(client->remoteAddress, false) > server->maxSocketsPerClient &&
+      server->evict(client, client->remoteAddress, false))
+    stats.evictedQuota++;
+
+  //keep one socket free so httpd does not purge (possibly a websocket) itself
+  if (server->countClients(IPAddress()) >= server->config.max_open_sockets - 1 && server->evict(client, IPAddress(), true))
+    stats.evictedPressure++;
 
   //user callback
   if (server->_onOpen != NULL)
@@ -296,6 +322,88 @@ PsychicStaticFileHandler* PsychicHttpServer::serveStatic(const char* uri, fs::FS
   return handler;
 }
 
+//sockets not being closed, of one remote ip or all if ip is not set, with or without websockets
+uint16_t PsychicHttpServer::countClients(IPAddress ip, bool webSockets)
+{
+  uint16_t count = 0;
+  for (PsychicClient *client : _clients)
+    if (!client->closing && (webSockets || !client->webSocket) && (ip == IPAddress() || client->remoteAddress == ip))
+      count++;
+  return count;
+}
+
+//closes the least recently used http socket (not a websocket) of ip, or of any client
+bool PsychicHttpServer::evict(PsychicClient *except, IPAddress ip, bool anyClient)
+{
+  PsychicClient *oldest = NULL;
+  for (PsychicClient *client : _clients)
+  {
+    if (client == except || client->webSocket || client->closing)
+      continue;
+    if (!anyClient && client->remoteAddress != ip)
+      continue;
+    if (oldest == NULL || (long)(client->lastActivity - oldest->lastActivity) < 0)
+      oldest = client;
+  }
+  if (oldest == NULL)
+    return false;
+
+  ESP_LOGD(PH_TAG, "Evicting socket %d of %s", oldest->socket(), oldest->remoteAddress.toString().c_str());
+  oldest->closing = true;
+  httpd_sess_trigger_close(server, oldest->socket());
+  return true;
+}
+
+void PsychicHttpServer::manageConnections()
+{
+  if (server != NULL)
+    httpd_queue_work(server, PsychicHttpServer::manageConnectionsWork, this);
+}
+
+//runs in the httpd task, as all the other client list changes
+void PsychicHttpServer::manageConnectionsWork(void *arg)
+{
+  PsychicHttpServer *server = (PsychicHttpServer *)arg;
+  PsychicConnectionStats &stats = server->connectionStats;
+  unsigned long now = millis();
+
+  uint16_t open = 0, webSockets = 0, clients = 0;
+  for (PsychicClient *client : server->_clients)
+  {
+    if (client->closing)
+      continue;
+
+    if (!client->webSocket && server->idleTimeout && now - client->lastActivity > server->idleTimeout)
+    {
+      ESP_LOGD(PH_TAG, "Closing idle socket %d of %s", client->socket(), client->remoteAddress.toString().c_str());
+      client->closing = true;
+      httpd_sess_trigger_close(server->server, client->socket());
+      stats.evictedIdle++;
+      continue;
+    }
+
+    open++;
+    if (client->webSocket)
+      webSockets++;
+
+    //first socket of this ip
+    bool first = true;
+    for (PsychicClient *other : server->_clients)
+    {
+      if (other == client)
+        break;
+      if (!other->closing && other->remoteAddress == client->remoteAddress)
+        first = false;
+    }
+    if (first)
+      clients++;
+  }
+
+  stats.open = open;
+  stats.webSockets = webSockets;
+  stats.clients = clients;
+}
+
 void PsychicHttpServer::addClient(PsychicClient *client) {
   _clients.push_back(client);
 }
@@ -9,6 +9,30 @@ class PsychicEndpoint;
 class PsychicHandler;
 class PsychicStaticFileHandler;
 
+struct PsychicConnectionStats
+{
+  uint16_t open = 0;       //sockets, updated by manageConnections
+  uint16_t webSockets = 0;
+  uint16_t clients = 0;    //distinct remote ips
+  uint16_t peak = 0;
+  uint32_t accepted = 0;
+  uint32_t evictedIdle = 0;     //keep-alive sockets without requests for idleTimeout
+  uint32_t evictedQuota = 0;    //oldest http socket of a client over maxSocketsPerClient http sockets
+  uint32_t evictedPressure = 0; //oldest http socket when the server is (almost) full
+};
+
+struct PsychicTlsStats
+{
+  uint32_t full = 0;          //handshakes
+  uint32_t resumed = 0;       //abbreviated handshakes: session id cache or ticket
+  uint32_t failed = 0;
+  uint64_t fullMicros = 0;    //total of the full handshakes
+  uint64_t resumedMicros = 0; //total of the resumed handshakes
+  uint32_t lastMicros = 0;
+  uint32_t maxMicros = 0;
+  const char *keyType = "";   //of the server certificate: RSA, EC
+};
+
 class PsychicHttpServer
 {
   protected:
@@ -20,6 +44,10 @@ class PsychicHttpServer
     PsychicClientCallback _onOpen;
     PsychicClientCallback _onClose;
 
+    uint16_t countClients(IPAddress ip, bool webSockets = true);
+    bool evict(PsychicClient *except, IPAddress ip, bool anyClient);
+    static void manageConnectionsWork(void *arg);
+
     esp_err_t _start();
     virtual esp_err_t _startServer();
 
@@ -35,6 +63,14 @@ class PsychicHttpServer
     unsigned long maxUploadSize;
     unsigned long maxRequestBodySize;
 
+    //connection management: per client quota, idle timeout, websockets first
+    uint8_t maxSocketsPerClient; //0: no quota
+    unsigned long idleTimeout;   //ms, 0: no timeout
+    PsychicConnectionStats connectionStats;
+    PsychicTlsStats tlsStats; //only used by PsychicHttpsServer
+    bool secure() { return _use_ssl; }
+    void manageConnections(); //call every second or so from any task, the work is done in the httpd task
+
     PsychicEndpoint *defaultEndpoint;
 
     static void destroy(void *ctx);
@@ -1,24 +1,124 @@
 #include "PsychicHttpsServer.h"
+#include <lwip/sockets.h>
+#include <mbedtls/net_sockets.h>
+
+#ifndef MBEDTLS_PRIVATE
+  #define MBEDTLS_PRIVATE(member) member //mbedtls 2.x
+#endif
+
+//one tls session per socket, the httpd transport context
+struct PsychicTlsSession
+{
+  mbedtls_ssl_context ssl;
+  int fd;
+};
+
+//set by the cache / ticket callbacks during a handshake, all handshakes run in the httpd task
+static bool s_resumed = false;
+
+static int bioSend(void *ctx, const unsigned char *buf, size_t len)
+{
+  int ret = send(*(int *)ctx, buf, len, 0);
+  if (ret < 0)
+    return (errno == EAGAIN || errno == EWOULDBLOCK) ? MBEDTLS_ERR_SSL_WANT_WRITE : MBEDTLS_ERR_NET_SEND_FAILED;
+  return ret;
+}
+
+static int bioRecv(void *ctx, unsigned char *buf, size_t len)
+{
+  int ret = recv(*(int *)ctx, buf, len, 0);
+  if (ret < 0)
+    return (errno == EAGAIN || errno == EWOULDBLOCK) ? MBEDTLS_ERR_SSL_WANT_READ : MBEDTLS_ERR_NET_RECV_FAILED;
+  return ret;
+}
+
+static int sslSend(httpd_handle_t hd, int sockfd, const char *buf, size_t buf_len, int flags)
+{
+  PsychicTlsSession *session = (PsychicTlsSession *)httpd_sess_get_transport_ctx(hd, sockfd);
+  int ret = mbedtls_ssl_write(&session->ssl, (const unsigned char *)buf, buf_len);
+  if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE)
+    return HTTPD_SOCK_ERR_TIMEOUT;
+  return ret < 0 ? HTTPD_SOCK_ERR_FAIL : ret;
+}
+
+static int sslRecv(httpd_handle_t hd, int sockfd, char *buf, size_t buf_len, int flags)
+{
+  PsychicTlsSession *session = (PsychicTlsSession *)httpd_sess_get_transport_ctx(hd, sockfd);
+  int ret = mbedtls_ssl_read(&session->ssl, (unsigned char *)buf, buf_len);
+  if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE)
+    return HTTPD_SOCK_ERR_TIMEOUT;
+  if (ret == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY)
+    return 0;
+  return ret < 0 ? HTTPD_SOCK_ERR_FAIL : ret;
+}
+
+static int sslPending(httpd_handle_t hd, int sockfd)
+{
+  PsychicTlsSession *session = (PsychicTlsSession *)httpd_sess_get_transport_ctx(hd, sockfd);
+  return mbedtls_ssl_get_bytes_avail(&session->ssl);
+}
+
+static void freeSession(void *ctx)
+{
+  PsychicTlsSession *session = (PsychicTlsSession *)ctx;
+  mbedtls_ssl_free(&session->ssl);
+  free(session);
+}
+
+//wrappers of the mbedtls session cache and ticket parse to count resumed handshakes
+#if defined(MBEDTLS_SSL_CACHE_C)
+  #if MBEDTLS_VERSION_NUMBER >= 0x03000000
+    static int cacheGet(void *data, unsigned char const *session_id, size_t session_id_len, mbedtls_ssl_session *session)
+    {
+      int ret = mbedtls_ssl_cache_get(data, session_id, session_id_len, session);
+      if (ret == 0)
+        s_resumed = true;
+      return ret;
+    }
+  #else
+    static int cacheGet(void *data, mbedtls_ssl_session *session)
+    {
+      int ret = mbedtls_ssl_cache_get(data, session);
+      if (ret == 0)
+        s_resumed = true;
+      return ret;
+    }
+  #endif
+#endif
+
+#if defined(MBEDTLS_SSL_TICKET_C)
+  static int ticketParse(void *p_ticket, mbedtls_ssl_session *session, unsigned char *buf, size_t len)
+  {
+    int ret = mbedtls_ssl_ticket_parse(p_ticket, session, buf, len);
+    if (ret == 0)
+      s_resumed = true;
+    return ret;
+  }
+#endif
 
 PsychicHttpsServer::PsychicHttpsServer() : PsychicHttpServer()
 {
   //for a SSL server
   ssl_config = HTTPD_SSL_CONFIG_DEFAULT();
-  ssl_config.httpd.open_fn = PsychicHttpServer::openCallback;
+  ssl_config.httpd.open_fn = PsychicHttpsServer::openCallbackSSL;
   ssl_config.httpd.close_fn = PsychicHttpServer::closeCallback;
   ssl_config.httpd.uri_match_fn = httpd_uri_match_wildcard;
   ssl_config.httpd.global_user_ctx = this;
   ssl_config.httpd.global_user_ctx_free_fn = destroy;
   ssl_config.httpd.max_uri_handlers = 20;
+  ssl_config.httpd.lru_purge_enable = true;
 
-  // each SSL connection takes about 45kb of heap
+  // each SSL connection takes about 35kb of heap (the in and out record buffers, the certificate and key are shared)
   // a barebones sketch with PsychicHttp has ~150kb of heap available
   // if we set it higher than 2 and use all the connections, we get lots of memory errors.
   // not to mention there is no heap left over for the program itself.
   ssl_config.httpd.max_open_sockets = 2;
 }
 
-PsychicHttpsServer::~PsychicHttpsServer() {}
+PsychicHttpsServer::~PsychicHttpsServer()
+{
+  _freeTls();
+}
 
 esp_err_t PsychicHttpsServer::listen(uint16_t port, const char *cert, const char *private_key)
 {
@@ -33,18 +133,164 @@ esp_err_t PsychicHttpsServer::listen(uint16_t port, const char *cert, const char
   return this->_start();
 }
 
+esp_err_t PsychicHttpsServer::_setupTls()
+{
+  _freeTls();
+
+  mbedtls_ssl_config_init(&_conf);
+  mbedtls_x509_crt_init(&_cert);
+  mbedtls_pk_init(&_key);
+  mbedtls_entropy_init(&_entropy);
+  mbedtls_ctr_drbg_init(&_drbg);
+  #if defined(MBEDTLS_SSL_CACHE_C)
+    mbedtls_ssl_cache_init(&_cache);
+  #endif
+  #if defined(MBEDTLS_SSL_TICKET_C)
+    mbedtls_ssl_ticket_init(&_ticket);
+  #endif
+  _tlsReady = true; //from here _freeTls cleans up, all contexts are initialized
+
+  int ret = mbedtls_ctr_drbg_seed(&_drbg, mbedtls_entropy_func, &_entropy, (const unsigned char *)PH_TAG, strlen(PH_TAG));
+  if (ret == 0)
+    ret = mbedtls_x509_crt_parse(&_cert, ssl_config.cacert_pem, ssl_config.cacert_len);
+  if (ret == 0)
+  #if MBEDTLS_VERSION_NUMBER >= 0x03000000
+    ret = mbedtls_pk_parse_key(&_key, ssl_config.prvtkey_pem, ssl_config.prvtkey_len, NULL, 0, mbedtls_ctr_drbg_random, &_drbg);
+  #else
+    ret = mbedtls_pk_parse_key(&_key, ssl_config.prvtkey_pem, ssl_config.prvtkey_len, NULL, 0);
+  #endif
+  if (ret == 0)
+    ret = mbedtls_ssl_config_defaults(&_conf, MBEDTLS_SSL_IS_SERVER, MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT);
+  if (ret == 0)
+  {
+    mbedtls_ssl_conf_rng(&_conf, mbedtls_ctr_drbg_random, &_drbg);
+    //the ciphersuites follow the key: ECDHE-ECDSA for an EC key (much cheaper handshake), ECDHE-RSA for RSA
+    ret = mbedtls_ssl_conf_own_cert(&_conf, &_cert, &_key);
+  }
+  if (ret != 0)
+  {
+    ESP_LOGE(PH_TAG, "TLS setup failed (-0x%x)", -ret);
+    _freeTls();
+    return ESP_FAIL;
+  }
+  tlsStats.keyType = mbedtls_pk_get_name(&_key);
+
+  #if defined(MBEDTLS_SSL_CACHE_C)
+    if (sessionCacheSize)
+    {
+      mbedtls_ssl_cache_set_max_entries(&_cache, sessionCacheSize);
+      mbedtls_ssl_cache_set_timeout(&_cache, sessionLifetime);
+      mbedtls_ssl_conf_session_cache(&_conf, &_cache, cacheGet, mbedtls_ssl_cache_set);
+    }
+  #endif
+  #if defined(MBEDTLS_SSL_TICKET_C)
+    if (sessionTickets && mbedtls_ssl_ticket_setup(&_ticket, mbedtls_ctr_drbg_random, &_drbg, MBEDTLS_CIPHER_AES_256_GCM, sessionLifetime) == 0)
+      mbedtls_ssl_conf_session_tickets_cb(&_conf, mbedtls_ssl_ticket_write, ticketParse, &_ticket);
+  #endif
+
+  ESP_LOGI(PH_TAG, "TLS ready, %s key, session cache %d, tickets %d, lifetime %d s", tlsStats.keyType, sessionCacheSize, sessionTickets, sessionLifetime);
+  return ESP_OK;
+}
+
+void PsychicHttpsServer::_freeTls()
+{
+  if (!_tlsReady)
+    return;
+  _tlsReady = false;
+
+  #if defined(MBEDTLS_SSL_CACHE_C)
+    mbedtls_ssl_cache_free(&_cache);
+  #endif
+  #if defined(MBEDTLS_SSL_TICKET_C)
+    mbedtls_ssl_ticket_free(&_ticket);
+  #endif
+  mbedtls_ssl_config_free(&_conf);
+  mbedtls_x509_crt_free(&_cert);
+  mbedtls_pk_free(&_key);
+  mbedtls_ctr_drbg_free(&_drbg);
+  mbedtls_entropy_free(&_entropy);
+}
+
+esp_err_t PsychicHttpsServer::openCallbackSSL(httpd_handle_t hd, int sockfd)
+{
+  PsychicHttpsServer *server = (PsychicHttpsServer *)httpd_get_global_user_ctx(hd);
+  if (!server->_use_ssl)
+    return PsychicHttpServer::openCallback(hd, sockfd);
+
+  PsychicTlsStats &stats = server->tlsStats;
+
+  PsychicTlsSession *session = (PsychicTlsSession *)calloc(1, sizeof(PsychicTlsSession));
+  if (session == NULL)
+  {
+    stats.failed++;
+    return ESP_ERR_NO_MEM;
+  }
+  session->fd = sockfd;
+  mbedtls_ssl_init(&session->ssl);
+
+  //blocking handshake, the socket has the httpd receive timeout
+  int64_t start = esp_timer_get_time();
+  int64_t deadline = start + (int64_t)server->ssl_config.httpd.recv_wait_timeout * 1000000;
+  s_resumed = false;
+  int ret = mbedtls_ssl_setup(&session->ssl, &server->_conf);
+  if (ret == 0)
+  {
+    mbedtls_ssl_set_bio(&session->ssl, &session->fd, bioSend, bioRecv, NULL);
+    while ((ret = mbedtls_ssl_handshake(&session->ssl)) != 0)
+    {
+      if ((ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) || esp_timer_get_time() > deadline)
+        break;
+    }
+  }
+  uint32_t micros = esp_timer_get_time() - start;
+
+  if (ret != 0)
+  {
+    ESP_LOGD(PH_TAG, "TLS handshake failed (-0x%x) after %d us", -ret, micros);
+    stats.failed++;
+    freeSession(session);
+    return ESP_FAIL;
+  }
+
+  stats.lastMicros = micros;
+  if (micros > stats.maxMicros)
+    stats.maxMicros = micros;
+  if (s_resumed)
+  {
+    stats.resumed++;
+    stats.resumedMicros += micros;
+  }
+  else
+  {
+    stats.full++;
+    stats.fullMicros += micros;
+  }
+  ESP_LOGD(PH_TAG, "TLS handshake %s in %d us", s_resumed ? "resumed" : "full", micros);
+
+  httpd_sess_set_transport_ctx(hd, sockfd, session, freeSession);
+  httpd_sess_set_send_override(hd, sockfd, sslSend);
+  httpd_sess_set_recv_override(hd, sockfd, sslRecv);
+  httpd_sess_set_pending_override(hd, sockfd, sslPending);
+
+  return PsychicHttpServer::openCallback(hd, sockfd);
+}
+
 esp_err_t PsychicHttpsServer::_startServer()
 {
   if (this->_use_ssl)
-    return httpd_ssl_start(&this->server, &this->ssl_config);
+  {
+    //httpd_ssl_start would create a tls config per session, run httpd with our own shared one
+    if (_setupTls() != ESP_OK)
+      return ESP_FAIL;
+    this->ssl_config.httpd.server_port = this->ssl_config.port_secure;
+    return httpd_start(&this->server, &this->ssl_config.httpd);
+  }
   else
     return httpd_start(&this->server, &this->config);
 }
 
 void PsychicHttpsServer::stop()
 {
-  if (this->_use_ssl)
-    httpd_ssl_stop(this->server);
-  else
-    httpd_stop(this->server);
-}
\ No newline at end of file
+  httpd_stop(this->server);
+  _freeTls();
+}
@@ -4,6 +4,17 @@
 #include "PsychicCore.h"
 #include "PsychicHttpServer.h"
 #include <esp_https_server.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/x509_crt.h>
+#include <mbedtls/pk.h>
+#if defined(MBEDTLS_SSL_CACHE_C)
+  #include <mbedtls/ssl_cache.h>
+#endif
+#if defined(MBEDTLS_SSL_TICKET_C)
+  #include <mbedtls/ssl_ticket.h>
+#endif
 
 #if !CONFIG_HTTPD_WS_SUPPORT
   #error PsychicHttpsServer cannot be used unless HTTPD_WS_SUPPORT is enabled in esp-http-server component configuration
@@ -11,10 +22,34 @@
 
 #define PSY_ENABLE_SSL //you can use this define in your code to enable/disable these features
 
+/*
+* PsychicHttpsServer :: TLS on top of httpd with one mbedtls config shared by all sessions:
+* the certificate and key (RSA or ECDSA) are parsed once, and returning clients resume their session
+* (session id cache and/or session tickets) instead of doing a full handshake.
+* The handshake runs in the open callback and blocks the httpd task (up to recv_wait_timeout): no other
+* request or websocket of the server is served meanwhile.
+*/
+
 class PsychicHttpsServer : public PsychicHttpServer
 {
   protected:
-    bool _use_ssl = false;
+    mbedtls_ssl_config _conf;
+    mbedtls_x509_crt _cert;
+    mbedtls_pk_context _key;
+    mbedtls_entropy_context _entropy;
+    mbedtls_ctr_drbg_context _drbg;
+    #if defined(MBEDTLS_SSL_CACHE_C)
+      mbedtls_ssl_cache_context _cache;
+    #endif
+    #if defined(MBEDTLS_SSL_TICKET_C)
+      mbedtls_ssl_ticket_context _ticket;
+    #endif
+    bool _tlsReady = false;
+
+    esp_err_t _setupTls();
+    void _freeTls();
+
+    static esp_err_t openCallbackSSL(httpd_handle_t hd, int sockfd);
 
   public:
     PsychicHttpsServer();
@@ -22,6 +57,11 @@ class PsychicHttpsServer : public PsychicHttpServer
 
     httpd_ssl_config_t ssl_config;
 
+    //session resumption, set before listen
+    uint16_t sessionCacheSize = SSL_SESSION_CACHE_SIZE; //0: no session id cache
+    uint32_t sessionLifetime = SSL_SESSION_LIFETIME;    //seconds
+    bool sessionTickets = SSL_SESSION_TICKETS;
+
     using PsychicHttpServer::listen; //keep the regular version
     esp_err_t listen(uint16_t port, const char *cert, const char *private_key);
 
@@ -29,4 +69,4 @@ class PsychicHttpsServer : public PsychicHttpServer
     virtual void stop() override final;
 };
 
-#endif // PsychicHttpsServer_h
\ No newline at end of file
+#endif // PsychicHttpsServer_h
@@ -11,6 +11,8 @@ PsychicRequest::PsychicRequest(PsychicHttpServer *server, httpd_req_t *req) : _s
 {
   // load up our client.
   this->_client = server->getClient(req);
+  if (this->_client != NULL)
+    this->_client->lastActivity = millis();
 
   // handle our session data
   if (req->sess_ctx != NULL)
@@ -30,6 +32,10 @@ PsychicRequest::PsychicRequest(PsychicHttpServer *server, httpd_req_t *req) : _s
 
 PsychicRequest::~PsychicRequest()
 {
+  // a long request (upload) is not idle
+  if (_client != NULL)
+    _client->lastActivity = millis();
+
   // temorary user object
   if (_tempObject != NULL)
     free(_tempObject);
@@ -155,6 +155,8 @@ esp_err_t PsychicWebSocketHandler::handleRequest(PsychicRequest *request)
   // beginning of the ws URI handler and our onConnect hook
   if (request->method() == HTTP_GET)
   {
+    request->client()->webSocket = true;
+
     if (client->isNew)
       openCallback(client);
 
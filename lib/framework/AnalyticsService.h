@@ -22,6 +22,8 @@
 #define EVENT_ANALYTICS "analytics"
 #define ANALYTICS_INTERVAL 1000 //every second is more intuitive
 
+typedef std::function<void(JsonObject &root)> AnalyticsCallback;
+
 class AnalyticsService
 {
 public:
@@ -35,6 +37,12 @@ public:
         _socket->registerEvent(EVENT_ANALYTICS);
     }
 
+    // add values of other services to the analytics event
+    void addAnalytics(AnalyticsCallback callback)
+    {
+        _callbacks.push_back(callback);
+    }
+
     void loop()
     {
         if (millis() - lastMillis > ANALYTICS_INTERVAL)
@@ -59,6 +67,8 @@ public:
             }
 
             JsonObject jsonObject = doc.as<JsonObject>();
+            for (AnalyticsCallback &callback : _callbacks)
+                callback(jsonObject);
             _socket->emitEvent(EVENT_ANALYTICS, jsonObject);
         }
     };
@@ -67,4 +77,5 @@ protected:
     EventSocket *_socket;
 
     unsigned long lastMillis = 0;
+    std::vector<AnalyticsCallback> _callbacks;
 };
@@ -0,0 +1,77 @@
+/**
+ *   ESP32 SvelteKit
+ *
+ *   A simple, secure and extensible framework for IoT projects for ESP32 platforms
+ *   with responsive Sveltekit front-end built with TailwindCSS and DaisyUI.
+ *   https://github.com/theelims/ESP32-sveltekit
+ *
+ *   Copyright (C) 2018 - 2023 rjwats
+ *   Copyright (C) 2023 - 2024 theelims
+ *
+ *   All Rights Reserved. This software may be modified and distributed under
+ *   the terms of the LGPL v3 license. See the LICENSE file for details.
+ **/
+
+#include <BootProfile.h>
+
+BootProfile bootProfile; // see .h
+
+void BootProfile::begin(PsychicHttpServer *server, SecurityManager *securityManager)
+{
+    server->on(BOOT_PROFILE_SERVICE_PATH,
+               HTTP_GET,
+               securityManager->wrapRequest(std::bind(&BootProfile::bootProfile, this, std::placeholders::_1),
+                                            AuthenticationPredicates::IS_AUTHENTICATED));
+
+    ESP_LOGV("BootProfile", "Registered GET endpoint: %s", BOOT_PROFILE_SERVICE_PATH);
+}
+
+void BootProfile::mark(const char *name)
+{
+    uint32_t micros = esp_timer_get_time();
+    uint32_t freeHeap = ESP.getFreeHeap();
+
+    portENTER_CRITICAL(&_mux);
+    bool added = _count < BOOT_PROFILE_MAX_STAGES;
+    uint32_t took = 0;
+    if (added)
+    {
+        took = micros - (_count ? _stages[_count - 1].micros : 0);
+        _stages[_count++] = {name, micros, freeHeap};
+    }
+    portEXIT_CRITICAL(&_mux);
+
+    if (added)
+    {
+        ESP_LOGD("BootProfile", "%s at %d ms took %d us", name, micros / 1000, took);
+    }
+}
+
+void BootProfile::read(JsonObject &root)
+{
+    boot_stage_t stages[BOOT_PROFILE_MAX_STAGES];
+    portENTER_CRITICAL(&_mux);
+    uint8_t count = _count;
+    memcpy(stages, _stages, count * sizeof(boot_stage_t));
+    portEXIT_CRITICAL(&_mux);
+
+    JsonArray array = root["stages"].to<JsonArray>();
+    uint32_t previous = 0;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        JsonObject stage = array.add<JsonObject>();
+        stage["name"] = stages[i].name;
+        stage["at"] = stages[i].micros;
+        stage["took"] = stages[i].micros - previous;
+        stage["heap"] = stages[i].freeHeap;
+        previous = stages[i].micros;
+    }
+}
+
+esp_err_t BootProfile::bootProfile(PsychicRequest *request)
+{
+    PsychicJsonResponse response = PsychicJsonResponse(request, false);
+    JsonObject root = response.getRoot();
+    read(root);
+    return response.send();
+}
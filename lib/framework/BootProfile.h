@@ -0,0 +1,60 @@
+#ifndef BootProfile_h
+#define BootProfile_h
+
+/**
+ *   ESP32 SvelteKit
+ *
+ *   A simple, secure and extensible framework for IoT projects for ESP32 platforms
+ *   with responsive Sveltekit front-end built with TailwindCSS and DaisyUI.
+ *   https://github.com/theelims/ESP32-sveltekit
+ *
+ *   Copyright (C) 2018 - 2023 rjwats
+ *   Copyright (C) 2023 - 2024 theelims
+ *
+ *   All Rights Reserved. This software may be modified and distributed under
+ *   the terms of the LGPL v3 license. See the LICENSE file for details.
+ **/
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <PsychicHttp.h>
+#include <SecurityManager.h>
+
+#define BOOT_PROFILE_SERVICE_PATH "/rest/bootProfile"
+
+#ifndef BOOT_PROFILE_MAX_STAGES
+#define BOOT_PROFILE_MAX_STAGES 40
+#endif
+
+typedef struct
+{
+    const char *name; // string literal, not copied
+    uint32_t micros;  // since boot
+    uint32_t freeHeap;
+} boot_stage_t;
+
+/**
+ * Timeline of the boot: mark() timestamps the end of a stage, /rest/bootProfile returns the stages with
+ * the time since boot, the duration (since the previous mark) and the free heap. Marks can be set from any task,
+ * also after setup (lazy started services, first frame, WiFi connected). Marks beyond BOOT_PROFILE_MAX_STAGES are dropped.
+ */
+class BootProfile
+{
+public:
+    void begin(PsychicHttpServer *server, SecurityManager *securityManager);
+
+    void mark(const char *name);
+
+    void read(JsonObject &root);
+
+private:
+    boot_stage_t _stages[BOOT_PROFILE_MAX_STAGES];
+    uint8_t _count = 0;
+    portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+
+    esp_err_t bootProfile(PsychicRequest *request);
+};
+
+extern BootProfile bootProfile;
+
+#endif // end BootProfile_h
@@ -0,0 +1,267 @@
+/**
+ *   ESP32 SvelteKit
+ *
+ *   A simple, secure and extensible framework for IoT projects for ESP32 platforms
+ *   with responsive Sveltekit front-end built with TailwindCSS and DaisyUI.
+ *   https://github.com/theelims/ESP32-sveltekit
+ *
+ *   Copyright (C) 2018 - 2023 rjwats
+ *   Copyright (C) 2023 - 2024 theelims
+ *
+ *   All Rights Reserved. This software may be modified and distributed under
+ *   the terms of the LGPL v3 license. See the LICENSE file for details.
+ **/
+
+#include <DeltaUpdate.h>
+#include <esp_ota_ops.h>
+
+static uint8_t runningSha[32];
+static bool runningShaValid = false;
+
+DeltaUpdate::~DeltaUpdate()
+{
+    freeBuffers();
+}
+
+bool DeltaUpdate::isDelta(const uint8_t *data, size_t len)
+{
+    return len >= sizeof(uint32_t) && *(const uint32_t *)data == DELTA_MAGIC;
+}
+
+bool DeltaUpdate::runningSha256(uint8_t sha[32])
+{
+    if (!runningShaValid)
+    {
+        const esp_partition_t *running = esp_ota_get_running_partition();
+        uint32_t size = ESP.getSketchSize();
+        uint8_t *buffer = (uint8_t *)malloc(DELTA_BASE_BUFFER);
+        if (!running || !size || !buffer)
+        {
+            free(buffer);
+            return false;
+        }
+
+        mbedtls_sha256_context context;
+        mbedtls_sha256_init(&context);
+        mbedtls_sha256_starts_ret(&context, 0);
+        bool ok = true;
+        for (uint32_t offset = 0; ok && offset < size; offset += DELTA_BASE_BUFFER)
+        {
+            size_t len = MIN(DELTA_BASE_BUFFER, size - offset);
+            ok = esp_partition_read(running, offset, buffer, len) == ESP_OK;
+            mbedtls_sha256_update_ret(&context, buffer, len);
+        }
+        mbedtls_sha256_finish_ret(&context, runningSha);
+        mbedtls_sha256_free(&context);
+        free(buffer);
+
+        if (!ok)
+            return false;
+        runningShaValid = true;
+    }
+    memcpy(sha, runningSha, sizeof(runningSha));
+    return true;
+}
+
+String DeltaUpdate::runningSha256()
+{
+    uint8_t sha[32];
+    if (!runningSha256(sha))
+        return "";
+    char hex[65];
+    for (int i = 0; i < 32; i++)
+        sprintf(hex + i * 2, "%02x", sha[i]);
+    return hex;
+}
+
+bool DeltaUpdate::begin()
+{
+    freeBuffers();
+    _state = ds_header;
+    _headerPos = _controlPos = _remaining = _basePos = _written = _dictPos = 0;
+    _inflated = _baseMismatch = false;
+    _error = nullptr;
+    memset(&_header, 0, sizeof(_header));
+
+    // the inflator state is ~11 KB, the window 32 KB: PSRAM if available, they are only used during the update
+    _inflator = (tinfl_decompressor *)(psramFound() ? ps_malloc(sizeof(tinfl_decompressor)) : malloc(sizeof(tinfl_decompressor)));
+    _dict = (uint8_t *)(psramFound() ? ps_malloc(TINFL_LZ_DICT_SIZE) : malloc(TINFL_LZ_DICT_SIZE));
+    _base = (uint8_t *)malloc(DELTA_BASE_BUFFER);
+    _running = esp_ota_get_running_partition();
+    if (!_inflator || !_dict || !_base || !_running)
+    {
+        freeBuffers();
+        return fail("no memory for delta update");
+    }
+    tinfl_init(_inflator);
+    return true;
+}
+
+bool DeltaUpdate::write(const uint8_t *data, size_t len)
+{
+    if (_error || !_inflator)
+        return false;
+
+    if (_state == ds_header)
+    {
+        size_t n = MIN(len, sizeof(_header) - _headerPos);
+        memcpy((uint8_t *)&_header + _headerPos, data, n);
+        _headerPos += n;
+        data += n;
+        len -= n;
+        if (_headerPos < sizeof(_header))
+            return true;
+        if (!readHeader())
+            return false;
+    }
+
+    // a window can fill up before the input is used up (HAS_MORE_OUTPUT): call again with the rest
+    tinfl_status status = TINFL_STATUS_NEEDS_MORE_INPUT;
+    while (!_inflated && (len || status == TINFL_STATUS_HAS_MORE_OUTPUT))
+    {
+        size_t in = len;
+        size_t out = TINFL_LZ_DICT_SIZE - _dictPos;
+        status = tinfl_decompress(_inflator, data, &in, _dict, _dict + _dictPos, &out,
+                                  TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_HAS_MORE_INPUT);
+        data += in;
+        len -= in;
+        if (out && !apply(_dict + _dictPos, out))
+            return false;
+        _dictPos = (_dictPos + out) & (TINFL_LZ_DICT_SIZE - 1);
+
+        if (status < TINFL_STATUS_DONE)
+            return fail("corrupt delta");
+        _inflated = status == TINFL_STATUS_DONE;
+    }
+    return true;
+}
+
+bool DeltaUpdate::end()
+{
+    if (_error)
+        return false;
+    if (!_inflated || _state != ds_control || _written != _header.size)
+        return fail("delta incomplete");
+
+    if (!_writer.end(false, _header.sha256))
+        return fail(_writer.error());
+
+    ESP_LOGI("DeltaUpdate", "Rebuilt %d bytes image", _written);
+    freeBuffers();
+    return true;
+}
+
+void DeltaUpdate::abort()
+{
+    _writer.abort();
+    freeBuffers();
+}
+
+bool DeltaUpdate::readHeader()
+{
+    if (_header.magic != DELTA_MAGIC)
+        return fail("not a delta file");
+
+    uint8_t sha[32];
+    if (_header.baseSize != ESP.getSketchSize() || !runningSha256(sha) || memcmp(sha, _header.baseSha256, sizeof(sha)))
+    {
+        _baseMismatch = true;
+        return fail("delta is made for another firmware");
+    }
+
+    if (!_writer.begin(_header.size))
+        return fail(_writer.error());
+
+    _state = ds_control;
+    ESP_LOGI("DeltaUpdate", "Applying delta to %d bytes image", _header.size);
+    return true;
+}
+
+// data is inflated output: records, parsed across calls
+bool DeltaUpdate::apply(const uint8_t *data, size_t len)
+{
+    while (len)
+    {
+        if (_state == ds_control)
+        {
+            size_t n = MIN(len, sizeof(_control) - _controlPos);
+            memcpy((uint8_t *)_control + _controlPos, data, n);
+            _controlPos += n;
+            data += n;
+            len -= n;
+            if (_controlPos < sizeof(_control))
+                return true;
+            _controlPos = 0;
+
+            if (_control[0] < 0 || _control[1] < 0 || _basePos + _control[0] > _header.baseSize ||
+                _written + _control[0] + _control[1] > _header.size)
+                return fail("corrupt delta");
+            _remaining = _control[0];
+            _state = ds_diff;
+        }
+        else if (_state == ds_diff)
+        {
+            size_t n = MIN(MIN(len, _remaining), DELTA_BASE_BUFFER);
+            if (esp_partition_read(_running, _basePos, _base, n) != ESP_OK)
+                return fail("reading the running firmware failed");
+            for (size_t i = 0; i < n; i++)
+                _base[i] += data[i];
+            if (!output(_base, n))
+                return false;
+            _basePos += n;
+            _remaining -= n;
+            data += n;
+            len -= n;
+        }
+        else
+        {
+            size_t n = MIN(len, _remaining);
+            if (!output(data, n))
+                return false;
+            _remaining -= n;
+            data += n;
+            len -= n;
+        }
+
+        // also for empty blocks
+        if (_state == ds_diff && !_remaining)
+        {
+            _remaining = _control[1];
+            _state = ds_extra;
+        }
+        if (_state == ds_extra && !_remaining)
+        {
+            _basePos += _control[2];
+            _state = ds_control;
+        }
+    }
+    return true;
+}
+
+bool DeltaUpdate::output(const uint8_t *data, size_t len)
+{
+    if (!_writer.write(data, len))
+        return fail(_writer.error());
+    _written += len;
+    return true;
+}
+
+bool DeltaUpdate::fail(const char *error)
+{
+    if (!_error)
+    {
+        _error = error;
+        ESP_LOGE("DeltaUpdate", "Delta update failed: %s", error);
+    }
+    return false;
+}
+
+void DeltaUpdate::freeBuffers()
+{
+    free(_inflator);
+    free(_dict);
+    free(_base);
+    _inflator = nullptr;
+    _dict = nullptr;
+    _base = nullptr;
+}
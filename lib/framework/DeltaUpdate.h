@@ -0,0 +1,105 @@
+#ifndef DeltaUpdate_h
+#define DeltaUpdate_h
+
+/**
+ *   ESP32 SvelteKit
+ *
+ *   A simple, secure and extensible framework for IoT projects for ESP32 platforms
+ *   with responsive Sveltekit front-end built with TailwindCSS and DaisyUI.
+ *   https://github.com/theelims/ESP32-sveltekit
+ *
+ *   Copyright (C) 2018 - 2023 rjwats
+ *   Copyright (C) 2023 - 2024 theelims
+ *
+ *   All Rights Reserved. This software may be modified and distributed under
+ *   the terms of the LGPL v3 license. See the LICENSE file for details.
+ **/
+
+#include <Arduino.h>
+#include <OtaWriter.h>
+#include <esp_partition.h>
+#include <mbedtls/sha256.h>
+#include "rom/miniz.h"
+
+#define DELTA_MAGIC 0x31444C4D // "MLD1"
+#define DELTA_EXTENSION "mld"
+#define DELTA_BASE_BUFFER 1024
+
+// Delta file format (.mld), little endian, made by scripts/delta.py:
+//   delta_header_t
+//   zlib stream of records: int32_t diffLen, extraLen, seek, diffLen bytes, extraLen bytes
+// A record adds diffLen bytes to the base image at the current base position (byte wise, mod 256), then copies
+// extraLen bytes as is and moves the base position by diffLen + seek. The base image is the firmware running now.
+typedef struct __attribute__((packed))
+{
+    uint32_t magic;
+    uint32_t baseSize;      // of the running firmware image
+    uint8_t baseSha256[32]; // of the running firmware image
+    uint32_t size;          // of the new image
+    uint8_t sha256[32];     // of the new image
+    uint32_t flags;         // 0
+} delta_header_t;
+
+/**
+ * Applies a delta file while it streams in: the new image is rebuilt from the running app partition and written
+ * with an OtaWriter into the inactive OTA partition, nothing is buffered beyond the 32 KB inflate window.
+ * The patch is only applied if it was made against the running image (size and SHA-256) and the rebuilt image is
+ * only activated if its SHA-256 matches, so a failed delta leaves the running firmware untouched: send the full image.
+ */
+class DeltaUpdate
+{
+public:
+    ~DeltaUpdate();
+
+    static bool isDelta(const uint8_t *data, size_t len);
+
+    // SHA-256 of the running image, as scripts/delta.py hash prints it for the .bin (computed once)
+    static bool runningSha256(uint8_t sha[32]);
+    static String runningSha256();
+
+    bool begin();
+    bool write(const uint8_t *data, size_t len); // false: see error(), call abort()
+    bool end();                                  // verify the new image and activate it
+    void abort();
+
+    bool baseMismatch() { return _baseMismatch; } // patch made for another firmware, fall back to the full image
+    const char *error() { return _error; }
+    size_t size() { return _header.size; } // of the new image, 0 until the header is in
+    size_t written() { return _written; }
+    OtaWriter &writer() { return _writer; }
+
+private:
+    enum
+    {
+        ds_header,
+        ds_control,
+        ds_diff,
+        ds_extra
+    } _state = ds_header;
+
+    delta_header_t _header = {};
+    size_t _headerPos = 0;
+    tinfl_decompressor *_inflator = nullptr;
+    uint8_t *_dict = nullptr; // TINFL_LZ_DICT_SIZE, circular output window of the inflator
+    size_t _dictPos = 0;
+    bool _inflated = false;
+    uint8_t *_base = nullptr; // DELTA_BASE_BUFFER bytes read from the running partition
+    const esp_partition_t *_running = nullptr;
+    OtaWriter _writer; // hashes the new image
+
+    int32_t _control[3]; // diffLen, extraLen, seek
+    size_t _controlPos = 0;
+    size_t _remaining = 0; // of the current diff or extra block
+    size_t _basePos = 0;
+    size_t _written = 0;
+    bool _baseMismatch = false;
+    const char *_error = nullptr;
+
+    bool readHeader();
+    bool apply(const uint8_t *data, size_t len);
+    bool output(const uint8_t *data, size_t len);
+    bool fail(const char *error);
+    void freeBuffers();
+};
+
+#endif // end DeltaUpdate_h
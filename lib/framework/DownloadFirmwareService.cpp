@@ -17,11 +17,21 @@ extern const uint8_t rootca_crt_bundle_start[] asm("_binary_src_certs_x509_crt_b
 
 static EventSocket *_socket = nullptr;
 static int previousProgress = 0;
+static uint32_t updateStart = 0; // micros
+static size_t updateBytes = 0;   // of the image written
 JsonDocument doc;
 
+typedef struct
+{
+    String url;      // full firmware image
+    String deltaUrl; // optional .mld against the running firmware, the full image is the fallback
+} ota_request_t;
+
 void update_started()
 {
     String output;
+    updateStart = micros();
+    updateBytes = 0;
     doc["status"] = "preparing";
     JsonObject jsonObject = doc.as<JsonObject>();
     _socket->emitEvent(EVENT_DOWNLOAD_OTA, jsonObject);
@@ -30,6 +40,7 @@ void update_started()
 void update_progress(int currentBytes, int totalBytes)
 {
     doc["status"] = "progress";
+    updateBytes = currentBytes;
     int progress = ((currentBytes * 100) / totalBytes);
     if (progress > previousProgress)
     {
@@ -43,7 +54,11 @@ void update_progress(int currentBytes, int totalBytes)
 
 void update_finished()
 {
+    uint32_t elapsed = micros() - updateStart;
+    float mbps = elapsed ? (float)updateBytes / elapsed : 0; // bytes per us is MB/s
+    ESP_LOGI("Download OTA", "Updated %d bytes in %d ms: %.2f MB/s", updateBytes, elapsed / 1000, mbps);
     doc["status"] = "finished";
+    doc["mbps"] = serialized(String(mbps, 2));
     JsonObject jsonObject = doc.as<JsonObject>();
     _socket->emitEvent(EVENT_DOWNLOAD_OTA, jsonObject);
 
@@ -51,6 +66,57 @@ void update_finished()
     vTaskDelay(100 / portTICK_PERIOD_MS);
 }
 
+// streams the delta into DeltaUpdate, false if it could not be applied (Update is aborted then)
+bool deltaUpdate(WiFiClientSecure &client, const String &url)
+{
+    HTTPClient http;
+    http.setFollowRedirects(HTTPC_FORCE_FOLLOW_REDIRECTS);
+    if (!http.begin(client, url))
+    {
+        return false;
+    }
+    int code = http.GET();
+    if (code != HTTP_CODE_OK)
+    {
+        ESP_LOGW("Download OTA", "Delta download failed with HTTP code %d", code);
+        http.end();
+        return false;
+    }
+
+    int total = http.getSize(); // -1 if not sent, DeltaUpdate::end checks the image is complete
+    WiFiClient *stream = http.getStreamPtr();
+    uint8_t buffer[OTA_DELTA_BUFFER];
+    int received = 0;
+    previousProgress = 0;
+    update_started();
+
+    DeltaUpdate delta;
+    bool ok = delta.begin();
+    while (ok && (total < 0 || received < total))
+    {
+        size_t len = stream->readBytes(buffer, total < 0 ? sizeof(buffer) : MIN(sizeof(buffer), (size_t)(total - received)));
+        if (!len)
+        {
+            break; // closed or timed out
+        }
+        ok = delta.write(buffer, len);
+        received += len;
+        if (total > 0)
+        {
+            update_progress(received, total);
+        }
+    }
+    ok = ok && delta.end();
+    updateBytes = delta.written(); // MB/s of the image, not of the delta
+    if (!ok)
+    {
+        ESP_LOGW("Download OTA", "Delta update failed: %s", delta.error() ? delta.error() : "download incomplete");
+        delta.abort();
+    }
+    http.end();
+    return ok;
+}
+
 void updateTask(void *param)
 {
     WiFiClientSecure client;
@@ -60,11 +126,33 @@ void updateTask(void *param)
     httpUpdate.setFollowRedirects(HTTPC_FORCE_FOLLOW_REDIRECTS);
     httpUpdate.rebootOnUpdate(true);
 
-    String url = *((String *)param);
+    ota_request_t *request = (ota_request_t *)param;
+    String url = request->url;
+    String deltaUrl = request->deltaUrl;
+    delete request;
     String output;
-    // httpUpdate.onStart(update_started);
-    // httpUpdate.onProgress(update_progress);
-    // httpUpdate.onEnd(update_finished);
+
+    if (deltaUrl.length())
+    {
+        if (deltaUpdate(client, deltaUrl))
+        {
+            ESP_LOGI("Download OTA", "Delta update successful - Restarting");
+            update_finished();
+            RestartService::restartNow();
+            vTaskDelete(NULL);
+        }
+        // the progress starts again for the full image
+        doc["status"] = "preparing";
+        doc["progress"] = 0;
+        JsonObject jsonObject = doc.as<JsonObject>();
+        _socket->emitEvent(EVENT_DOWNLOAD_OTA, jsonObject);
+        ESP_LOGI("Download OTA", "Falling back to the full firmware from: %s", url.c_str());
+    }
+
+    previousProgress = 0;
+    httpUpdate.onStart(update_started);
+    httpUpdate.onProgress(update_progress);
+    httpUpdate.onEnd(update_finished);
 
     t_httpUpdate_return ret = httpUpdate.update(client, url.c_str());
     JsonObject jsonObject;
@@ -115,6 +203,8 @@ DownloadFirmwareService::DownloadFirmwareService(PsychicHttpServer *server,
 
 void DownloadFirmwareService::begin()
 {
+    ::_socket = _socket; // for the update task
+
     _socket->registerEvent(EVENT_DOWNLOAD_OTA);
 
     _server->on(GITHUB_FIRMWARE_PATH,
@@ -134,7 +224,8 @@ esp_err_t DownloadFirmwareService::downloadUpdate(PsychicRequest *request, JsonV
     }
 
     String downloadURL = json["download_url"];
-    ESP_LOGI("Download OTA", "Starting OTA from: %s", downloadURL.c_str());
+    String deltaURL = json["delta_url"] | "";
+    ESP_LOGI("Download OTA", "Starting OTA from: %s%s%s", downloadURL.c_str(), deltaURL.length() ? ", delta: " : "", deltaURL.c_str());
 #ifdef SERIAL_INFO
     Serial.println("Starting OTA from: " + downloadURL);
 #endif
@@ -146,16 +237,19 @@ esp_err_t DownloadFirmwareService::downloadUpdate(PsychicRequest *request, JsonV
     JsonObject jsonObject = doc.as<JsonObject>();
     _socket->emitEvent(EVENT_DOWNLOAD_OTA, jsonObject);
 
+    // the task owns the request, the strings of this handler are gone when it runs
+    ota_request_t *otaRequest = new ota_request_t{downloadURL, deltaURL};
     if (xTaskCreatePinnedToCore(
             &updateTask,                // Function that should be called
             "Update",                   // Name of the task (for debugging)
             OTA_TASK_STACK_SIZE,        // Stack size (bytes)
-            &downloadURL,               // Pass reference to this class instance
+            otaRequest,                 // The urls to update from
             (configMAX_PRIORITIES - 1), // Pretty high task priority
             NULL,                       // Task handle
             1                           // Have it on application core
             ) != pdPASS)
     {
+        delete otaRequest;
         ESP_LOGE("Download OTA", "Couldn't create download OTA task");
         return request->reply(500);
     }
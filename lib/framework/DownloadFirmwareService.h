@@ -21,6 +21,8 @@
 #include <EventSocket.h>
 #include <PsychicHttp.h>
 #include <SecurityManager.h>
+#include <RestartService.h>
+#include <DeltaUpdate.h>
 
 #include <HTTPClient.h>
 #include <HTTPUpdate.h>
@@ -28,7 +30,8 @@
 
 #define GITHUB_FIRMWARE_PATH "/rest/downloadUpdate"
 #define EVENT_DOWNLOAD_OTA "otastatus"
-#define OTA_TASK_STACK_SIZE 9216
+#define OTA_TASK_STACK_SIZE 10240 // + OTA_DELTA_BUFFER for delta updates
+#define OTA_DELTA_BUFFER 1024
 
 class DownloadFirmwareService
 {
@@ -13,8 +13,9 @@
  **/
 
 #include <ESP32SvelteKit.h>
+#include <MqttEndpoint.h>
 
-std::vector<std::function<void()>> runInLoopTask; //see .h
+LoopTaskQueue runInLoopTask; //see .h
 
 ESP32SvelteKit::ESP32SvelteKit(PsychicHttpServer *server, unsigned int numberEndpoints) : _server(server),
                                                                                           _numberEndpoints(numberEndpoints),
@@ -61,15 +62,20 @@ ESP32SvelteKit::ESP32SvelteKit(PsychicHttpServer *server, unsigned int numberEnd
 
 void ESP32SvelteKit::begin()
 {
+    bootProfile.mark("esp32sveltekit");
+
     ESP_LOGV("ESP32SvelteKit", "Loading settings from files system");
     ESPFS.begin(true);
+    bootProfile.mark("filesystem");
 
     _wifiSettingsService.initWiFi();
+    bootProfile.mark("wifi init");
 
     // SvelteKit uses a lot of handlers, so we need to increase the max_uri_handlers
     // WWWData has 77 Endpoints, Framework has 27, and Lighstate Demo has 4
     _server->config.max_uri_handlers = _numberEndpoints;
     _server->listen(80);
+    bootProfile.mark("http listen");
 
 #ifdef EMBED_WWW
     // Serve static resources from PROGMEM
@@ -126,12 +132,22 @@ void ESP32SvelteKit::begin()
     DefaultHeaders::Instance().addHeader("Access-Control-Allow-Credentials", "true");
 #endif
 
+    bootProfile.begin(_server, &_securitySettingsService);
+#if FT_ENABLED(FT_ANALYTICS)
+    metricsHistory.begin(_server, &_securitySettingsService); // early: restores the history of before a soft reset
+#endif
+#if FT_ENABLED(FT_HEAP_TRACE)
+    heapTrace.begin(_server, &_securitySettingsService); // allocations from here on are traced
+#endif
+    bootProfile.mark("static routes");
+
     ESP_LOGV("ESP32SvelteKit", "Starting MDNS");
     MDNS.begin(_wifiSettingsService.getHostname().c_str());
     MDNS.setInstanceName(_appName);
     MDNS.addService("http", "tcp", 80);
     MDNS.addService("ws", "tcp", 80);
     MDNS.addServiceTxt("http", "tcp", "Firmware Version", APP_VERSION);
+    bootProfile.mark("mdns");
 
 #ifdef SERIAL_INFO
     Serial.printf("Running Firmware Version: %s\n", APP_VERSION);
@@ -147,23 +163,11 @@ void ESP32SvelteKit::begin()
     _restartService.begin();
     _systemStatus.begin();
     _wifiSettingsService.begin();
-    _wifiScanner.begin();
     _wifiStatus.begin();
 
 #if FT_ENABLED(FT_UPLOAD_FIRMWARE)
     _uploadFirmwareService.begin();
 #endif
-#if FT_ENABLED(FT_DOWNLOAD_FIRMWARE)
-    _downloadFirmwareService.begin();
-#endif
-#if FT_ENABLED(FT_NTP)
-    _ntpSettingsService.begin();
-    _ntpStatus.begin();
-#endif
-#if FT_ENABLED(FT_MQTT)
-    _mqttSettingsService.begin();
-    _mqttStatus.begin();
-#endif
 #if FT_ENABLED(FT_SECURITY)
     _authenticationService.begin();
     _securitySettingsService.begin();
@@ -173,10 +177,36 @@ void ESP32SvelteKit::begin()
 #endif
 #if FT_ENABLED(FT_BATTERY)
     _batteryService.begin();
+#endif
+    bootProfile.mark("core services");
+
+    // not needed to render or to reach the device
+    startService("wifi scanner", [this]()
+                 { _wifiScanner.begin(); });
+#if FT_ENABLED(FT_DOWNLOAD_FIRMWARE)
+    startService("firmware download", [this]()
+                 { _downloadFirmwareService.begin(); });
+#endif
+#if FT_ENABLED(FT_NTP)
+    startService("ntp", [this]()
+                 { _ntpSettingsService.begin();
+                   _ntpStatus.begin(); });
+#endif
+#if FT_ENABLED(FT_MQTT)
+    startService("mqtt", [this]()
+                 { _mqttSettingsService.begin();
+                   _mqttStatus.begin(); });
+#endif
+#if FT_ENABLED(FT_ANALYTICS)
+    startService("analytics", [this]()
+                 { _analyticsService.begin(); });
 #endif
 #if FT_ENABLED(FT_ANALYTICS)
-    _analyticsService.begin();
+    _analyticsService.addAnalytics([this](JsonObject &root)
+                                   { SystemStatus::sockets(_server, root); });
 #endif
+    _lazyStarted = _lazyServices.empty();
+    _lazyStartMillis = millis() + ESP32SVELTEKIT_LAZY_START_DELAY;
 
     // Start the loop task
     ESP_LOGV("ESP32SvelteKit", "Starting loop task");
@@ -207,12 +237,20 @@ void ESP32SvelteKit::_loop()
 
         _wifiSettingsService.loop(); // 30 seconds
         _apSettingsService.loop();   // 10 seconds
+        if (_lazyStarted)
+        {
 #if FT_ENABLED(FT_MQTT)
-        _mqttSettingsService.loop(); // 5 seconds
+            _mqttSettingsService.loop(); // 5 seconds
+            MqttPublisher::flushDue();   // publishes deferred by the publish interval
 #endif
 #if FT_ENABLED(FT_ANALYTICS)
-        _analyticsService.loop();
+            _analyticsService.loop();
 #endif
+        }
+        else
+        {
+            loopLazyServices();
+        }
 
         // Query the connectivity status
         wifi = _wifiStatus.isConnected();
@@ -252,8 +290,12 @@ void ESP32SvelteKit::_loop()
         if (millis() - lastTime > 1000)
         {
             lastTime = millis();
+            _server->manageConnections(); // idle sockets and socket stats
             _analyticsService.cpuPerc = cyclesPerSecond / (ESP.getCpuFreqMHz() * 10000); //(converted to ms) 1 sec
             _analyticsService.loopsPerSecond = loopsPerSecond;
+#if FT_ENABLED(FT_ANALYTICS)
+            metricsHistory.sample(_analyticsService.cpuPerc, loopsPerSecond, _server->connectionStats.open);
+#endif
             // _systemStatus.cpuPerc = _analyticsService.cpuPerc;
             // _systemStatus.loopsPerSecond = _analyticsService.loopsPerSecond;
             // Serial.printf("Cycles: %d - %d / %d -> %d lps:%d\n", cycles/1000000, cyclesPerSecond/1000000, ESP.getCpuFreqMHz(), _analyticsService.cpuPerc, _analyticsService.loopsPerSecond);
@@ -268,3 +310,37 @@ void ESP32SvelteKit::_loop()
         vTaskDelayUntil(&xLastWakeTime, ESP32SVELTEKIT_LOOP_INTERVAL / portTICK_PERIOD_MS);
     }
 }
+
+void ESP32SvelteKit::startService(const char *name, std::function<void()> begin)
+{
+#if ESP32SVELTEKIT_LAZY_START
+    _lazyServices.push_back({name, begin});
+#else
+    begin();
+    bootProfile.mark(name);
+#endif
+}
+
+void ESP32SvelteKit::loopLazyServices()
+{
+    if (_lazyQueued || (long)(millis() - _lazyStartMillis) < 0)
+    {
+        return;
+    }
+
+    // one service per main loop pass, begin() registers routes and reads files: run it in the main loop task
+    _lazyQueued = true;
+    runInLoopTask.push_back([this]()
+                            {
+        lazy_service_t service = _lazyServices.front();
+        _lazyServices.erase(_lazyServices.begin());
+        service.begin();
+        bootProfile.mark(service.name);
+        ESP_LOGV("ESP32SvelteKit", "Lazy started %s", service.name);
+        if (_lazyServices.empty())
+        {
+            _lazyServices.shrink_to_fit();
+            _lazyStarted = true;
+        }
+        _lazyQueued = false; });
+}
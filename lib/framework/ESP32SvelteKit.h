@@ -21,13 +21,16 @@
 #include <ESPmDNS.h>
 #include <AnalyticsService.h>
 #include <FeaturesService.h>
+#include <HeapTrace.h>
 #include <APSettingsService.h>
 #include <APStatus.h>
 #include <AuthenticationService.h>
 #include <BatteryService.h>
+#include <BootProfile.h>
 #include <FactoryResetService.h>
 #include <DownloadFirmwareService.h>
 #include <EventSocket.h>
+#include <MetricsHistory.h>
 #include <MqttSettingsService.h>
 #include <MqttStatus.h>
 #include <NotificationService.h>
@@ -69,6 +72,17 @@
 #define ESP32SVELTEKIT_LOOP_INTERVAL 10
 #endif
 
+// 1: non critical services (NTP, MQTT, analytics, firmware download, WiFi scanner) are started after the app
+// is up, one per loop, see startLazyServices()
+#ifndef ESP32SVELTEKIT_LAZY_START
+#define ESP32SVELTEKIT_LAZY_START 1
+#endif
+
+// start the lazy services anyway if startLazyServices() is not called within
+#ifndef ESP32SVELTEKIT_LAZY_START_DELAY
+#define ESP32SVELTEKIT_LAZY_START_DELAY 5000
+#endif
+
 // define callback function to include into the main loop
 typedef std::function<void()> loopCallback;
 
@@ -83,7 +97,37 @@ enum class ConnectionStatus
     STA_MQTT
 };
 
-extern std::vector<std::function<void()>> runInLoopTask; //functions to be called in main loopTask (to avoid https to run out of stack space)
+// Functions to be called in the main loop task (to avoid https to run out of stack space). Pushed from the http,
+// socket and ESP32SvelteKit tasks while the loop task runs them on the other core, so the queue is locked
+class LoopTaskQueue
+{
+public:
+    void push_back(std::function<void()> function)
+    {
+        xSemaphoreTake(_mutex, portMAX_DELAY);
+        _functions.push_back(std::move(function));
+        xSemaphoreGive(_mutex);
+    }
+
+    // in the order they were pushed, outside the lock: a function may push another one, which runs the next time
+    void run()
+    {
+        std::vector<std::function<void()>> functions;
+        xSemaphoreTake(_mutex, portMAX_DELAY);
+        functions.swap(_functions);
+        xSemaphoreGive(_mutex);
+        for (auto &function : functions)
+        {
+            function();
+        }
+    }
+
+private:
+    std::vector<std::function<void()>> _functions;
+    SemaphoreHandle_t _mutex = xSemaphoreCreateMutex();
+};
+
+extern LoopTaskQueue runInLoopTask;
 
 class ESP32SvelteKit
 {
@@ -95,6 +139,12 @@ public:
 
     void begin();
 
+    // the app is up (e.g. first frame rendered): start the lazy services now
+    void startLazyServices()
+    {
+        _lazyStartMillis = millis();
+    }
+
     ConnectionStatus getConnectionStatus()
     {
         return _connectionStatus;
@@ -175,6 +225,13 @@ public:
     }
 #endif
 
+#if FT_ENABLED(FT_ANALYTICS)
+    AnalyticsService *getAnalyticsService()
+    {
+        return &_analyticsService;
+    }
+#endif
+
     FeaturesService *getFeatureService()
     {
         return &_featureService;
@@ -249,6 +306,20 @@ private:
 
     String _appName = APP_NAME;
 
+    typedef struct
+    {
+        const char *name;
+        std::function<void()> begin;
+    } lazy_service_t;
+
+    std::vector<lazy_service_t> _lazyServices;
+    unsigned long _lazyStartMillis = 0;
+    volatile bool _lazyQueued = false;
+    volatile bool _lazyStarted = false;
+
+    void startService(const char *name, std::function<void()> begin);
+    void loopLazyServices();
+
 protected:
     static void _loopImpl(void *_this) { static_cast<ESP32SvelteKit *>(_this)->_loop(); }
     void _loop();
@@ -35,7 +35,7 @@ public:
     {
         _statefulService->addUpdateHandler([&](const String &originId)
                                            { syncState(originId); },
-                                           false);
+                                           false, HandlerContext::NETWORK);
     }
 
     void begin()
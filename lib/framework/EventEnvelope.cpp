@@ -0,0 +1,297 @@
+/**
+ *   ESP32 SvelteKit
+ *
+ *   A simple, secure and extensible framework for IoT projects for ESP32 platforms
+ *   with responsive Sveltekit front-end built with TailwindCSS and DaisyUI.
+ *   https://github.com/theelims/ESP32-sveltekit
+ *
+ *   Copyright (C) 2018 - 2023 rjwats
+ *   Copyright (C) 2023 - 2024 theelims
+ *
+ *   All Rights Reserved. This software may be modified and distributed under
+ *   the terms of the LGPL v3 license. See the LICENSE file for details.
+ **/
+
+#include <EventEnvelope.h>
+#include <string.h>
+
+// JSON
+
+static const uint8_t *skipSpace(const uint8_t *p, const uint8_t *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+        p++;
+    return p;
+}
+
+// p at the opening quote, returns after the closing quote, nullptr if not terminated
+static const uint8_t *skipJsonString(const uint8_t *p, const uint8_t *end, bool *escaped = nullptr)
+{
+    for (p++; p < end; p++)
+    {
+        if (*p == '\\')
+        {
+            if (escaped)
+                *escaped = true;
+            p++;
+        }
+        else if (*p == '"')
+            return p + 1;
+    }
+    return nullptr;
+}
+
+static const uint8_t *skipJsonValue(const uint8_t *p, const uint8_t *end)
+{
+    if (p >= end)
+        return nullptr;
+    if (*p == '"')
+        return skipJsonString(p, end);
+    if (*p == '{' || *p == '[')
+    {
+        int depth = 0;
+        while (p < end)
+        {
+            if (*p == '"')
+            {
+                p = skipJsonString(p, end);
+                if (!p)
+                    return nullptr;
+                continue;
+            }
+            if (*p == '{' || *p == '[')
+            {
+                if (++depth > EVENT_ENVELOPE_MAX_DEPTH)
+                    return nullptr;
+            }
+            else if ((*p == '}' || *p == ']') && --depth == 0)
+                return p + 1;
+            p++;
+        }
+        return nullptr;
+    }
+    // number, true, false, null
+    const uint8_t *start = p;
+    while (p < end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r')
+        p++;
+    return p > start ? p : nullptr;
+}
+
+bool decodeJsonEnvelope(const uint8_t *payload, size_t len, event_envelope_t &envelope)
+{
+    const uint8_t *end = payload + len;
+    const uint8_t *p = skipSpace(payload, end);
+    envelope = event_envelope_t();
+    if (p >= end || *p != '{')
+        return false;
+    p = skipSpace(p + 1, end);
+
+    while (p < end && *p != '}')
+    {
+        // key
+        if (*p != '"')
+            return false;
+        const uint8_t *key = p + 1;
+        p = skipJsonString(p, end);
+        if (!p)
+            return false;
+        size_t keyLen = p - 1 - key;
+        p = skipSpace(p, end);
+        if (p >= end || *p != ':')
+            return false;
+        p = skipSpace(p + 1, end);
+
+        // value
+        const uint8_t *value = p;
+        bool escaped = false;
+        p = (p < end && *p == '"') ? skipJsonString(p, end, &escaped) : skipJsonValue(p, end);
+        if (!p)
+            return false;
+        if (keyLen == 5 && !memcmp(key, "event", 5))
+        {
+            if (*value != '"' || escaped)
+                return false;
+            envelope.event = (const char *)value + 1;
+            envelope.eventLen = p - value - 2;
+        }
+        else if (keyLen == 4 && !memcmp(key, "data", 4))
+        {
+            envelope.data = value;
+            envelope.dataLen = p - value;
+        }
+
+        p = skipSpace(p, end);
+        if (p < end && *p == ',')
+            p = skipSpace(p + 1, end);
+    }
+    return p < end && envelope.event;
+}
+
+bool envelopeJsonString(const event_envelope_t &envelope, const char *&string, size_t &len)
+{
+    if (!envelope.data || envelope.dataLen < 2 || envelope.data[0] != '"' || memchr(envelope.data, '\\', envelope.dataLen))
+        return false;
+    string = (const char *)envelope.data + 1;
+    len = envelope.dataLen - 2;
+    return true;
+}
+
+// MsgPack
+
+static uint32_t readBigEndian(const uint8_t *p, uint8_t bytes)
+{
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < bytes; i++)
+        value = (value << 8) | p[i];
+    return value;
+}
+
+// header size and payload size of a string / binary, false if p is not one
+static bool msgPackString(const uint8_t *p, const uint8_t *end, size_t &header, size_t &len)
+{
+    if (p >= end)
+        return false;
+    uint8_t type = *p;
+    uint8_t bytes;
+    if ((type & 0xE0) == 0xA0) // fixstr
+    {
+        header = 1;
+        len = type & 0x1F;
+        return p + header + len <= end;
+    }
+    else if (type == 0xD9 || type == 0xC4) // str8, bin8
+        bytes = 1;
+    else if (type == 0xDA || type == 0xC5) // str16, bin16
+        bytes = 2;
+    else if (type == 0xDB || type == 0xC6) // str32, bin32
+        bytes = 4;
+    else
+        return false;
+    if (p + 1 + bytes > end)
+        return false;
+    header = 1 + bytes;
+    len = readBigEndian(p + 1, bytes);
+    return len <= (size_t)(end - p - header);
+}
+
+static const uint8_t *skipMsgPackValue(const uint8_t *p, const uint8_t *end, int depth = 0)
+{
+    if (p >= end || depth > EVENT_ENVELOPE_MAX_DEPTH)
+        return nullptr;
+    uint8_t type = *p;
+    size_t header, len;
+    uint32_t items = 0; // of an array, pairs of a map count twice
+
+    if (type <= 0x7F || type >= 0xE0 || type == 0xC0 || type == 0xC2 || type == 0xC3) // fixint, nil, bool
+        return p + 1;
+    if (msgPackString(p, end, header, len))
+        return p + header + len;
+
+    switch (type)
+    {
+    case 0xCC: case 0xD0: return p + 2 <= end ? p + 2 : nullptr; // (u)int8
+    case 0xCD: case 0xD1: return p + 3 <= end ? p + 3 : nullptr; // (u)int16
+    case 0xCE: case 0xD2: case 0xCA: return p + 5 <= end ? p + 5 : nullptr; // (u)int32, float32
+    case 0xCF: case 0xD3: case 0xCB: return p + 9 <= end ? p + 9 : nullptr; // (u)int64, float64
+    case 0xD4: case 0xD5: case 0xD6: case 0xD7: case 0xD8: // fixext 1, 2, 4, 8, 16
+    {
+        size_t size = 2 + (1 << (type - 0xD4));
+        return p + size <= end ? p + size : nullptr;
+    }
+    case 0xC7: case 0xC8: case 0xC9: // ext 8, 16, 32
+    {
+        uint8_t bytes = type == 0xC7 ? 1 : type == 0xC8 ? 2 : 4;
+        if (p + 2 + bytes > end)
+            return nullptr;
+        size_t size = 2 + bytes + readBigEndian(p + 1, bytes);
+        return size <= (size_t)(end - p) ? p + size : nullptr;
+    }
+    case 0xDC: case 0xDE: // array16, map16
+        if (p + 3 > end)
+            return nullptr;
+        items = readBigEndian(p + 1, 2) * (type == 0xDE ? 2 : 1);
+        p += 3;
+        break;
+    case 0xDD: case 0xDF: // array32, map32
+        if (p + 5 > end)
+            return nullptr;
+        items = readBigEndian(p + 1, 4) * (type == 0xDF ? 2 : 1);
+        p += 5;
+        break;
+    default:
+        if ((type & 0xF0) == 0x80) // fixmap
+            items = (type & 0x0F) * 2;
+        else if ((type & 0xF0) == 0x90) // fixarray
+            items = type & 0x0F;
+        else
+            return nullptr; // 0xC1: never used
+        p += 1;
+        break;
+    }
+
+    for (uint32_t i = 0; i < items && p; i++)
+        p = skipMsgPackValue(p, end, depth + 1);
+    return p;
+}
+
+bool decodeMsgPackEnvelope(const uint8_t *payload, size_t len, event_envelope_t &envelope)
+{
+    const uint8_t *end = payload + len;
+    const uint8_t *p = payload;
+    envelope = event_envelope_t();
+    if (p >= end)
+        return false;
+
+    uint32_t pairs;
+    if ((*p & 0xF0) == 0x80) // fixmap
+        pairs = *p++ & 0x0F;
+    else if (*p == 0xDE && p + 3 <= end)
+    {
+        pairs = readBigEndian(p + 1, 2);
+        p += 3;
+    }
+    else if (*p == 0xDF && p + 5 <= end)
+    {
+        pairs = readBigEndian(p + 1, 4);
+        p += 5;
+    }
+    else
+        return false;
+
+    for (uint32_t i = 0; i < pairs; i++)
+    {
+        size_t header, keyLen;
+        if (!msgPackString(p, end, header, keyLen))
+            return false;
+        const uint8_t *key = p + header;
+        p = key + keyLen;
+
+        const uint8_t *value = p;
+        p = skipMsgPackValue(p, end);
+        if (!p)
+            return false;
+        if (keyLen == 5 && !memcmp(key, "event", 5))
+        {
+            size_t valueLen;
+            if (!msgPackString(value, end, header, valueLen))
+                return false;
+            envelope.event = (const char *)value + header;
+            envelope.eventLen = valueLen;
+        }
+        else if (keyLen == 4 && !memcmp(key, "data", 4))
+        {
+            envelope.data = value;
+            envelope.dataLen = p - value;
+        }
+    }
+    return envelope.event;
+}
+
+bool envelopeMsgPackString(const event_envelope_t &envelope, const char *&string, size_t &len)
+{
+    size_t header;
+    if (!envelope.data || !msgPackString(envelope.data, envelope.data + envelope.dataLen, header, len))
+        return false;
+    string = (const char *)envelope.data + header;
+    return true;
+}
@@ -0,0 +1,53 @@
+#ifndef EventEnvelope_h
+#define EventEnvelope_h
+
+/**
+ *   ESP32 SvelteKit
+ *
+ *   A simple, secure and extensible framework for IoT projects for ESP32 platforms
+ *   with responsive Sveltekit front-end built with TailwindCSS and DaisyUI.
+ *   https://github.com/theelims/ESP32-sveltekit
+ *
+ *   Copyright (C) 2018 - 2023 rjwats
+ *   Copyright (C) 2023 - 2024 theelims
+ *
+ *   All Rights Reserved. This software may be modified and distributed under
+ *   the terms of the LGPL v3 license. See the LICENSE file for details.
+ **/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define EVENT_ENVELOPE_MAX_DEPTH 16 // nesting of data the decoder skips over
+
+/**
+ * View on an inbound event socket frame {"event": <string>, "data": <any>}, pointing into the frame payload:
+ * nothing is copied or allocated. data is the encoded value (JSON text or MsgPack bytes), it can be deserialized
+ * on its own if a handler needs it. Strings with escapes are not decoded: event names and subscribe data are plain
+ * names, a frame with an escaped event name is rejected.
+ */
+typedef struct
+{
+    const char *event = nullptr;
+    size_t eventLen = 0;
+    const uint8_t *data = nullptr; // nullptr: no data
+    size_t dataLen = 0;
+} event_envelope_t;
+
+// false if the payload is not an object with a string event
+bool decodeJsonEnvelope(const uint8_t *payload, size_t len, event_envelope_t &envelope);
+bool decodeMsgPackEnvelope(const uint8_t *payload, size_t len, event_envelope_t &envelope);
+
+// data as a string without copying (subscribe, unsubscribe), false if data is not a plain string
+bool envelopeJsonString(const event_envelope_t &envelope, const char *&string, size_t &len);
+bool envelopeMsgPackString(const event_envelope_t &envelope, const char *&string, size_t &len);
+
+inline uint32_t eventHash(const char *name, size_t len)
+{
+    uint32_t hash = 2166136261u; // FNV-1a
+    for (size_t i = 0; i < len; i++)
+        hash = (hash ^ (uint8_t)name[i]) * 16777619u;
+    return hash;
+}
+
+#endif // end EventEnvelope_h
@@ -1,4 +1,5 @@
 #include <EventSocket.h>
+#include <HeapTrace.h>
 
 SemaphoreHandle_t clientSubscriptionsMutex = xSemaphoreCreateMutex();
 
@@ -8,6 +9,11 @@ EventSocket::EventSocket(PsychicHttpServer *server,
                                                                             _securityManager(securityManager),
                                                                             _authenticationPredicate(authenticationPredicate)
 {
+    events.reserve(EVENT_SOCKET_MAX_EVENTS);
+    eventHashes.reserve(EVENT_SOCKET_MAX_EVENTS);
+    client_subscriptions.reserve(EVENT_SOCKET_MAX_EVENTS);
+    event_callbacks.reserve(EVENT_SOCKET_MAX_EVENTS);
+    subscribe_callbacks.reserve(EVENT_SOCKET_MAX_EVENTS);
 }
 
 void EventSocket::begin()
@@ -23,15 +29,26 @@ void EventSocket::begin()
 
 void EventSocket::registerEvent(String event)
 {
-    if (!isEventValid(event))
+    xSemaphoreTake(clientSubscriptionsMutex, portMAX_DELAY);
+    if (isEventValid(event))
     {
-        ESP_LOGD("EventSocket", "Registering event: %s", event.c_str());
-        events.push_back(event);
+        ESP_LOGW("EventSocket", "Event already registered: %s", event.c_str());
+    }
+    else if (events.size() >= EVENT_SOCKET_MAX_EVENTS)
+    {
+        ESP_LOGE("EventSocket", "Too many events, not registered: %s", event.c_str());
     }
     else
     {
-        ESP_LOGW("EventSocket", "Event already registered: %s", event.c_str());
+        ESP_LOGD("EventSocket", "Registering event: %s", event.c_str());
+        // the hash is pushed last: eventId finds the event when its tables exist
+        events.push_back(event);
+        client_subscriptions.emplace_back();
+        event_callbacks.emplace_back();
+        subscribe_callbacks.emplace_back();
+        eventHashes.push_back(eventHash(event.c_str(), event.length()));
     }
+    xSemaphoreGive(clientSubscriptionsMutex);
 }
 
 void EventSocket::onWSOpen(PsychicWebSocketClient *client)
@@ -44,68 +61,102 @@ void EventSocket::onWSClose(PsychicWebSocketClient *client)
     xSemaphoreTake(clientSubscriptionsMutex, portMAX_DELAY);
     for (auto &event_subscriptions : client_subscriptions)
     {
-        event_subscriptions.second.remove(client->socket());
+        event_subscriptions.remove(client->socket());
     }
     xSemaphoreGive(clientSubscriptionsMutex);
     ESP_LOGI("EventSocket", "ws[%s][%u] disconnect", client->remoteIP().toString().c_str(), client->socket());
 }
 
+// Only the envelope is decoded, in place: subscribe and unsubscribe need no document at all,
+// other events are only deserialized (data only) if a callback is registered for them
 esp_err_t EventSocket::onFrame(PsychicWebSocketRequest *request, httpd_ws_frame *frame)
 {
     ESP_LOGV("EventSocket", "ws[%s][%u] opcode[%d]", request->client()->remoteIP().toString().c_str(),
              request->client()->socket(), frame->type);
 
-    JsonDocument doc;
+    event_envelope_t envelope;
+    const char *name;
+    size_t nameLen;
 #if FT_ENABLED(EVENT_USE_JSON)
-    if (frame->type == HTTPD_WS_TYPE_TEXT)
+    if (frame->type != HTTPD_WS_TYPE_TEXT)
     {
-        ESP_LOGV("EventSocket", "ws[%s][%u] request: %s", request->client()->remoteIP().toString().c_str(),
-                 request->client()->socket(), (char *)frame->payload);
-
-        DeserializationError error = deserializeJson(doc, (char *)frame->payload, frame->len);
+        return ESP_OK;
+    }
+    ESP_LOGV("EventSocket", "ws[%s][%u] request: %.*s", request->client()->remoteIP().toString().c_str(),
+             request->client()->socket(), (int)frame->len, (char *)frame->payload);
+    bool decoded = decodeJsonEnvelope(frame->payload, frame->len, envelope);
+    bool nameDecoded = decoded && envelopeJsonString(envelope, name, nameLen);
 #else
-    if (frame->type == HTTPD_WS_TYPE_BINARY)
+    if (frame->type != HTTPD_WS_TYPE_BINARY)
     {
-        ESP_LOGV("EventSocket", "ws[%s][%u] request: %s", request->client()->remoteIP().toString().c_str(),
-                 request->client()->socket(), (char *)frame->payload);
-
-        DeserializationError error = deserializeMsgPack(doc, (char *)frame->payload, frame->len);
+        return ESP_OK;
+    }
+    bool decoded = decodeMsgPackEnvelope(frame->payload, frame->len, envelope);
+    bool nameDecoded = decoded && envelopeMsgPackString(envelope, name, nameLen);
 #endif
+    if (!decoded)
+    {
+        ESP_LOGW("EventSocket", "ws[%s][%u] invalid event frame of %d bytes", request->client()->remoteIP().toString().c_str(),
+                 request->client()->socket(), frame->len);
+        return ESP_OK;
+    }
 
-        if (!error && doc.is<JsonObject>())
+    int socket = request->client()->socket();
+    bool subscribe = envelope.eventLen == 9 && !memcmp(envelope.event, "subscribe", 9);
+    if (subscribe || (envelope.eventLen == 11 && !memcmp(envelope.event, "unsubscribe", 11)))
+    {
+        // only subscribe to events that are registered
+        int event = nameDecoded ? eventId(name, nameLen) : -1;
+        if (event < 0)
         {
-            String event = doc["event"];
-            if (event == "subscribe")
+            if (subscribe)
             {
-                // only subscribe to events that are registered
-                if (isEventValid(doc["data"].as<String>()))
-                {
-                    client_subscriptions[doc["data"]].push_back(request->client()->socket());
-                    handleSubscribeCallbacks(doc["data"], String(request->client()->socket()));
-                }
-                else
-                {
-                    ESP_LOGW("EventSocket", "Client tried to subscribe to unregistered event: %s", doc["data"].as<String>().c_str());
-                }
-            }
-            else if (event == "unsubscribe")
-            {
-                client_subscriptions[doc["data"]].remove(request->client()->socket());
-            }
-            else
-            {
-                JsonObject jsonObject = doc["data"].as<JsonObject>();
-                handleEventCallbacks(event, jsonObject, request->client()->socket());
+                ESP_LOGW("EventSocket", "Client tried to subscribe to unregistered event: %.*s", nameDecoded ? (int)nameLen : 0, nameDecoded ? name : "");
             }
             return ESP_OK;
         }
-        ESP_LOGW("EventSocket", "Error[%d] parsing JSON: %s", error, (char *)frame->payload);
+        xSemaphoreTake(clientSubscriptionsMutex, portMAX_DELAY);
+        client_subscriptions[event].remove(socket); // a client subscribing twice gets the event once
+        if (subscribe)
+        {
+            client_subscriptions[event].push_back(socket);
+        }
+        xSemaphoreGive(clientSubscriptionsMutex);
+        if (subscribe)
+        {
+            handleSubscribeCallbacks(event, String(socket));
+        }
+        return ESP_OK;
     }
+
+    int event = eventId(envelope.event, envelope.eventLen);
+    if (event < 0 || event_callbacks[event].empty())
+    {
+        return ESP_OK; // nobody needs the data
+    }
+
+    JsonDocument doc;
+    if (envelope.data)
+    {
+#if FT_ENABLED(EVENT_USE_JSON)
+        DeserializationError error = deserializeJson(doc, (const char *)envelope.data, envelope.dataLen);
+#else
+        DeserializationError error = deserializeMsgPack(doc, (const char *)envelope.data, envelope.dataLen);
+#endif
+        if (error)
+        {
+            ESP_LOGW("EventSocket", "Error[%s] parsing data of event: %.*s", error.c_str(), (int)envelope.eventLen, envelope.event);
+            return ESP_OK;
+        }
+    }
+    JsonObject jsonObject = doc.as<JsonObject>();
+    handleEventCallbacks(event, jsonObject, socket);
     return ESP_OK;
 }
 
-void EventSocket::emitEvent(String event, JsonObject &jsonObject, const char *originId, bool onlyToSameOrigin)
+void EventSocket::emitEvent(const String &event, JsonObject &jsonObject, const char *originId, bool onlyToSameOrigin)
 {
+    HEAP_TAG("events");
     JsonDocument doc;
     doc["event"] = event;
     doc["data"] = jsonObject;
@@ -132,18 +183,19 @@ void EventSocket::emitEvent(String event, JsonObject &jsonObject, const char *or
     delete[] output;
 }
 
-void EventSocket::emitEvent(String event, char *output, size_t len, const char *originId, bool onlyToSameOrigin)
+void EventSocket::emitEvent(const String &event, char *output, size_t len, const char *originId, bool onlyToSameOrigin)
 {
     // Only process valid events
-    if (!isEventValid(String(event)))
+    int id = eventId(event);
+    if (id < 0)
     {
-        ESP_LOGW("EventSocket", "Method tried to emit unregistered event: %s", event);
+        ESP_LOGW("EventSocket", "Method tried to emit unregistered event: %s", event.c_str());
         return;
     }
 
     int originSubscriptionId = originId[0] ? atoi(originId) : -1;
     xSemaphoreTake(clientSubscriptionsMutex, portMAX_DELAY);
-    auto &subscriptions = client_subscriptions[event];
+    auto &subscriptions = client_subscriptions[id];
     if (subscriptions.empty())
     {
         xSemaphoreGive(clientSubscriptionsMutex);
@@ -156,7 +208,7 @@ void EventSocket::emitEvent(String event, char *output, size_t len, const char *
         auto *client = _socket.getClient(originSubscriptionId);
         if (client)
         {
-            ESP_LOGV("EventSocket", "Emitting event: %s to %s, Message[%d]: %s", event, client->remoteIP().toString().c_str(), len, output);
+            ESP_LOGV("EventSocket", "Emitting event: %s to %s, Message[%d]: %s", event.c_str(), client->remoteIP().toString().c_str(), len, output);
 #if FT_ENABLED(EVENT_USE_JSON)
             client->sendMessage(HTTPD_WS_TYPE_TEXT, output, len);
 #else
@@ -167,17 +219,22 @@ void EventSocket::emitEvent(String event, char *output, size_t len, const char *
     else
     { // else send the message to all other clients
 
-        for (int subscription : client_subscriptions[event])
+        for (auto it = subscriptions.begin(); it != subscriptions.end();)
         {
+            int subscription = *it;
             if (subscription == originSubscriptionId)
+            {
+                ++it;
                 continue;
+            }
             auto *client = _socket.getClient(subscription);
             if (!client)
             {
-                subscriptions.remove(subscription);
+                it = subscriptions.erase(it); // closed without onWSClose
                 continue;
             }
-            ESP_LOGV("EventSocket", "Emitting event: %s to %s, Message[%d]: %s", event, client->remoteIP().toString().c_str(), len, output);
+            ++it;
+            ESP_LOGV("EventSocket", "Emitting event: %s to %s, Message[%d]: %s", event.c_str(), client->remoteIP().toString().c_str(), len, output);
 #if FT_ENABLED(EVENT_USE_JSON)
             client->sendMessage(HTTPD_WS_TYPE_TEXT, output, len);
 #else
@@ -189,7 +246,7 @@ void EventSocket::emitEvent(String event, char *output, size_t len, const char *
     xSemaphoreGive(clientSubscriptionsMutex);
 }
 
-void EventSocket::handleEventCallbacks(String event, JsonObject &jsonObject, int originId)
+void EventSocket::handleEventCallbacks(int event, JsonObject &jsonObject, int originId)
 {
     for (auto &callback : event_callbacks[event])
     {
@@ -197,7 +254,7 @@ void EventSocket::handleEventCallbacks(String event, JsonObject &jsonObject, int
     }
 }
 
-void EventSocket::handleSubscribeCallbacks(String event, const String &originId)
+void EventSocket::handleSubscribeCallbacks(int event, const String &originId)
 {
     for (auto &callback : subscribe_callbacks[event])
     {
@@ -207,31 +264,55 @@ void EventSocket::handleSubscribeCallbacks(String event, const String &originId)
 
 void EventSocket::onEvent(String event, EventCallback callback)
 {
-    if (!isEventValid(event))
+    int id = eventId(event);
+    if (id < 0)
     {
         ESP_LOGW("EventSocket", "Method tried to register unregistered event: %s", event.c_str());
         return;
     }
-    event_callbacks[event].push_back(callback);
+    event_callbacks[id].push_back(callback);
 }
 
 void EventSocket::onSubscribe(String event, SubscribeCallback callback)
 {
-    if (!isEventValid(event))
+    int id = eventId(event);
+    if (id < 0)
     {
         ESP_LOGW("EventSocket", "Method tried to subscribe to unregistered event: %s", event.c_str());
         return;
     }
-    subscribe_callbacks[event].push_back(callback);
+    subscribe_callbacks[id].push_back(callback);
     ESP_LOGI("EventSocket", "onSubscribe for event: %s", event.c_str());
 }
 
-bool EventSocket::isEventValid(String event)
+int EventSocket::eventId(const char *event, size_t len)
 {
-    return std::find(events.begin(), events.end(), event) != events.end();
+    uint32_t hash = eventHash(event, len);
+    size_t count = eventHashes.size();
+    for (size_t i = 0; i < count; i++)
+    {
+        if (eventHashes[i] == hash && events[i].length() == len && !memcmp(events[i].c_str(), event, len))
+        {
+            return i;
+        }
+    }
+    return -1;
 }
 
 unsigned int EventSocket::getConnectedClients()
 {
     return (unsigned int)_socket.getClientList().size();
 }
+
+std::list<int> EventSocket::getSubscribers(const String &event)
+{
+    int id = eventId(event);
+    if (id < 0)
+    {
+        return {};
+    }
+    xSemaphoreTake(clientSubscriptionsMutex, portMAX_DELAY);
+    std::list<int> subscribers = client_subscriptions[id];
+    xSemaphoreGive(clientSubscriptionsMutex);
+    return subscribers;
+}
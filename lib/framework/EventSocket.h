@@ -18,12 +18,16 @@
 #include <PsychicHttp.h>
 #include <SecurityManager.h>
 #include <StatefulService.h>
+#include <EventEnvelope.h>
 #include <list>
-#include <map>
 #include <vector>
 
 #define EVENT_SERVICE_PATH "/ws/events"
 
+#ifndef EVENT_SOCKET_MAX_EVENTS
+#define EVENT_SOCKET_MAX_EVENTS 48 // the tables are reserved up front, registering does not move them under readers
+#endif
+
 typedef std::function<void(JsonObject &root, int originId)> EventCallback;
 typedef std::function<void(const String &originId)> SubscribeCallback;
 
@@ -40,26 +44,33 @@ public:
 
   void onSubscribe(String event, SubscribeCallback callback);
 
-  void emitEvent(String event, JsonObject &jsonObject, const char *originId = "", bool onlyToSameOrigin = false);
+  void emitEvent(const String &event, JsonObject &jsonObject, const char *originId = "", bool onlyToSameOrigin = false);
   // if onlyToSameOrigin == true, the message will be sent to the originId only, otherwise it will be broadcasted to all clients except the originId
-  void emitEvent(String event, char *output, size_t len, const char *originId = "", bool onlyToSameOrigin = false);
+  void emitEvent(const String &event, char *output, size_t len, const char *originId = "", bool onlyToSameOrigin = false);
 
   unsigned int getConnectedClients();
 
+  // copy of the clients subscribed to event, to send client specific data with onlyToSameOrigin
+  std::list<int> getSubscribers(const String &event);
+
 private:
   PsychicHttpServer *_server;
   PsychicWebSocketHandler _socket;
   SecurityManager *_securityManager;
   AuthenticationPredicate _authenticationPredicate;
 
+  // interned events: the index in events is the id of an event in the other tables
   std::vector<String> events;
-  std::map<String, std::list<int>> client_subscriptions;
-  std::map<String, std::list<EventCallback>> event_callbacks;
-  std::map<String, std::list<SubscribeCallback>> subscribe_callbacks;
-  void handleEventCallbacks(String event, JsonObject &jsonObject, int originId);
-  void handleSubscribeCallbacks(String event, const String &originId);
-
-  bool isEventValid(String event);
+  std::vector<uint32_t> eventHashes;
+  std::vector<std::list<int>> client_subscriptions;
+  std::vector<std::list<EventCallback>> event_callbacks;
+  std::vector<std::list<SubscribeCallback>> subscribe_callbacks;
+  void handleEventCallbacks(int event, JsonObject &jsonObject, int originId);
+  void handleSubscribeCallbacks(int event, const String &originId);
+
+  int eventId(const char *event, size_t len); // -1: not registered
+  int eventId(const String &event) { return eventId(event.c_str(), event.length()); }
+  bool isEventValid(const String &event) { return eventId(event) >= 0; }
 
   void onWSOpen(PsychicWebSocketClient *client);
   void onWSClose(PsychicWebSocketClient *client);
@@ -17,6 +17,7 @@
 
 #include <StatefulService.h>
 #include <FS.h>
+#include <HeapTrace.h>
 
 template <class T>
 class FSPersistence
@@ -38,6 +39,7 @@ public:
 
     void readFromFS()
     {
+        HEAP_TAG("persistence");
         File settingsFile = _fs->open(_filePath, "r");
 
         if (settingsFile)
@@ -63,6 +65,7 @@ public:
 
     bool writeToFS()
     {
+        HEAP_TAG("persistence");
         // create and populate a new json object
         JsonDocument jsonDocument;
         JsonObject jsonObject = jsonDocument.to<JsonObject>();
@@ -100,7 +103,8 @@ public:
         if (!_updateHandlerId)
         {
             _updateHandlerId = _statefulService->addUpdateHandler([&](const String &originId)
-                                                                  { writeToFS(); });
+                                                                  { writeToFS(); },
+                                                                  true, HandlerContext::BACKGROUND);
         }
     }
 
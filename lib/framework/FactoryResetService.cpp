@@ -54,5 +54,5 @@ void FactoryResetService::factoryReset()
         file.close();
         fs->remove(path);
     }
-    RestartService::restartNow();
+    RestartService::restartNow(false); // queued writes would bring back the removed files
 }
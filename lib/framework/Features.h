@@ -57,6 +57,11 @@
 #define FT_ANALYTICS 1
 #endif
 
+// heap allocation tracing off by default, needs the linker flags of [HEAP_TRACE] in platformio.ini
+#ifndef FT_HEAP_TRACE
+#define FT_HEAP_TRACE 0
+#endif
+
 // Use JSON for events. Default, use MessagePack for events
 #ifndef EVENT_USE_JSON
 #define EVENT_USE_JSON 0
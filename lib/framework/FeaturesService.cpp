@@ -97,6 +97,11 @@ void FeaturesService::createJSON(JsonObject &root)
 #else
     root["analytics"] = false;
 #endif
+#if FT_ENABLED(FT_HEAP_TRACE)
+    root["heap_trace"] = true;
+#else
+    root["heap_trace"] = false;
+#endif
 
 #if FT_ENABLED(EVENT_USE_JSON)
     root["event_use_json"] = true;
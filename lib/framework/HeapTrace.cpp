@@ -0,0 +1,346 @@
+/**
+ *   ESP32 SvelteKit
+ *
+ *   A simple, secure and extensible framework for IoT projects for ESP32 platforms
+ *   with responsive Sveltekit front-end built with TailwindCSS and DaisyUI.
+ *   https://github.com/theelims/ESP32-sveltekit
+ *
+ *   Copyright (C) 2018 - 2023 rjwats
+ *   Copyright (C) 2023 - 2024 theelims
+ *
+ *   All Rights Reserved. This software may be modified and distributed under
+ *   the terms of the LGPL v3 license. See the LICENSE file for details.
+ **/
+
+#include <HeapTrace.h>
+
+#if FT_ENABLED(FT_HEAP_TRACE)
+
+#include <esp_heap_caps.h>
+#include <algorithm>
+
+HeapTrace heapTrace; // see .h
+
+// -Wl,--wrap=malloc etc: calls to malloc resolve to __wrap_malloc, which calls the original as __real_malloc
+extern "C"
+{
+    void *__real_malloc(size_t size);
+    void *__real_calloc(size_t count, size_t size);
+    void *__real_realloc(void *ptr, size_t size);
+    void __real_free(void *ptr);
+
+    void *__wrap_malloc(size_t size)
+    {
+        void *ptr = __real_malloc(size);
+        if (ptr)
+        {
+            heapTrace.allocated(ptr, size);
+        }
+        return ptr;
+    }
+
+    void *__wrap_calloc(size_t count, size_t size)
+    {
+        void *ptr = __real_calloc(count, size);
+        if (ptr)
+        {
+            heapTrace.allocated(ptr, count * size);
+        }
+        return ptr;
+    }
+
+    void *__wrap_realloc(void *ptr, size_t size)
+    {
+        // removed before the block is released: another task can get the same address right after
+        uint32_t sizeTag;
+        bool tracked = ptr && heapTrace.freed(ptr, &sizeTag);
+        void *newPtr = __real_realloc(ptr, size);
+        if (newPtr)
+        {
+            heapTrace.allocated(newPtr, size, true);
+        }
+        else if (tracked && size)
+        {
+            heapTrace.restore(ptr, sizeTag); // failed, ptr is still allocated
+        }
+        return newPtr;
+    }
+
+    void __wrap_free(void *ptr)
+    {
+        if (ptr)
+        {
+            heapTrace.freed(ptr);
+        }
+        __real_free(ptr);
+    }
+}
+
+static inline uint32_t slotHash(uintptr_t ptr)
+{
+    return ((ptr >> 2) * 2654435761u) & (HEAP_TRACE_SLOTS - 1);
+}
+
+void HeapTrace::begin(PsychicHttpServer *server, SecurityManager *securityManager)
+{
+    static_assert((HEAP_TRACE_SLOTS & (HEAP_TRACE_SLOTS - 1)) == 0, "HEAP_TRACE_SLOTS must be a power of 2");
+
+    // heap_caps: not traced itself
+    uint32_t caps = psramFound() ? MALLOC_CAP_SPIRAM : MALLOC_CAP_8BIT;
+    heap_slot_t *slots = (heap_slot_t *)heap_caps_calloc(HEAP_TRACE_SLOTS, sizeof(heap_slot_t), caps);
+    if (!slots)
+    {
+        ESP_LOGE("HeapTrace", "No memory for %d slots", HEAP_TRACE_SLOTS);
+        return;
+    }
+    portENTER_CRITICAL_SAFE(&_mux);
+    _tags[HEAP_TRACE_OTHER].name = "other";
+    _slots = slots;
+    portEXIT_CRITICAL_SAFE(&_mux);
+
+    server->on(HEAP_TRACE_SERVICE_PATH,
+               HTTP_GET,
+               securityManager->wrapRequest(std::bind(&HeapTrace::trace, this, std::placeholders::_1),
+                                            AuthenticationPredicates::IS_ADMIN));
+
+    ESP_LOGV("HeapTrace", "Registered GET endpoint: %s", HEAP_TRACE_SERVICE_PATH);
+}
+
+uint8_t HeapTrace::tag(const char *name)
+{
+    portENTER_CRITICAL_SAFE(&_mux);
+    uint8_t tag = addTag(name, false);
+    portEXIT_CRITICAL_SAFE(&_mux);
+    return tag;
+}
+
+// in the critical section, the same name gives the same tag
+uint8_t HeapTrace::addTag(const char *name, bool copy)
+{
+    for (uint8_t i = 1; i < _tagCount; i++)
+    {
+        if (!strcmp(_tags[i].name, name))
+        {
+            return i;
+        }
+    }
+    if (_tagCount == HEAP_TRACE_MAX_TAGS)
+    {
+        return HEAP_TRACE_OTHER;
+    }
+    heap_tag_t &tag = _tags[_tagCount];
+    memset(&tag, 0, sizeof(tag));
+    if (copy)
+    {
+        strlcpy(tag.taskName, name, sizeof(tag.taskName));
+        tag.name = tag.taskName;
+    }
+    else
+    {
+        tag.name = name;
+    }
+    return _tagCount++;
+}
+
+// in the critical section (also of an ISR: the interrupted task), registers the task on its first allocation
+heap_task_t *HeapTrace::currentTask()
+{
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    if (!task)
+    {
+        return nullptr;
+    }
+    bool added;
+    heap_task_t *entry = _tasks.find(task, pcTaskGetTaskName(task), added);
+    if (added)
+    {
+        entry->taskTag = addTag(entry->name, true);
+    }
+    return entry;
+}
+
+uint8_t HeapTrace::enter(uint8_t tag)
+{
+    portENTER_CRITICAL_SAFE(&_mux);
+    heap_task_t *task = currentTask();
+    uint8_t previous = task ? task->scopeTag : 0;
+    if (task)
+    {
+        task->scopeTag = tag;
+    }
+    portEXIT_CRITICAL_SAFE(&_mux);
+    return previous;
+}
+
+void HeapTrace::leave(uint8_t previous)
+{
+    portENTER_CRITICAL_SAFE(&_mux);
+    heap_task_t *task = currentTask();
+    if (task)
+    {
+        task->scopeTag = previous;
+    }
+    portEXIT_CRITICAL_SAFE(&_mux);
+}
+
+void HeapTrace::allocated(void *ptr, size_t size, bool realloc)
+{
+    if (!_slots)
+    {
+        return;
+    }
+    portENTER_CRITICAL_SAFE(&_mux);
+    heap_task_t *task = currentTask();
+    uint8_t tagId = !task ? HEAP_TRACE_OTHER : task->scopeTag ? task->scopeTag : task->taskTag;
+    heap_tag_t &tag = _tags[tagId];
+    tag.allocs++;
+    tag.reallocs += realloc;
+    tag.bytes += size;
+
+    // at most 3/4 full, so a probe ends soon
+    if (_used < HEAP_TRACE_SLOTS / 4 * 3 && size < (1 << 24))
+    {
+        uint32_t i = slotHash((uintptr_t)ptr);
+        while (_slots[i].ptr)
+        {
+            i = (i + 1) & (HEAP_TRACE_SLOTS - 1);
+        }
+        _slots[i] = {(uintptr_t)ptr, (uint32_t)size << 8 | tagId};
+        _used++;
+        tag.live += size;
+        tag.liveCount++;
+        tag.highWater = MAX(tag.highWater, tag.live);
+    }
+    else
+    {
+        _untracked++;
+    }
+    portEXIT_CRITICAL_SAFE(&_mux);
+}
+
+bool HeapTrace::freed(void *ptr, uint32_t *sizeTag)
+{
+    if (!_slots)
+    {
+        return false;
+    }
+    portENTER_CRITICAL_SAFE(&_mux);
+    uint32_t i = find((uintptr_t)ptr);
+    bool tracked = i < HEAP_TRACE_SLOTS;
+    if (tracked)
+    {
+        uint32_t value = _slots[i].sizeTag;
+        heap_tag_t &tag = _tags[value & 0xFF];
+        tag.live -= value >> 8;
+        tag.liveCount--;
+        tag.frees++;
+        remove(i);
+        if (sizeTag)
+        {
+            *sizeTag = value;
+        }
+    }
+    portEXIT_CRITICAL_SAFE(&_mux);
+    return tracked;
+}
+
+void HeapTrace::restore(void *ptr, uint32_t sizeTag)
+{
+    portENTER_CRITICAL_SAFE(&_mux);
+    uint32_t i = slotHash((uintptr_t)ptr);
+    while (_slots[i].ptr)
+    {
+        i = (i + 1) & (HEAP_TRACE_SLOTS - 1);
+    }
+    _slots[i] = {(uintptr_t)ptr, sizeTag};
+    _used++;
+    heap_tag_t &tag = _tags[sizeTag & 0xFF];
+    tag.live += sizeTag >> 8;
+    tag.liveCount++;
+    tag.frees--;
+    portEXIT_CRITICAL_SAFE(&_mux);
+}
+
+// slot of ptr, HEAP_TRACE_SLOTS if not tracked
+uint32_t HeapTrace::find(uintptr_t ptr)
+{
+    for (uint32_t i = slotHash(ptr); _slots[i].ptr; i = (i + 1) & (HEAP_TRACE_SLOTS - 1))
+    {
+        if (_slots[i].ptr == ptr)
+        {
+            return i;
+        }
+    }
+    return HEAP_TRACE_SLOTS;
+}
+
+// linear probing without tombstones: moves the following entries of the probe sequence back into the gap
+void HeapTrace::remove(uint32_t i)
+{
+    uint32_t j = i;
+    for (;;)
+    {
+        j = (j + 1) & (HEAP_TRACE_SLOTS - 1);
+        if (!_slots[j].ptr)
+        {
+            break;
+        }
+        uint32_t home = slotHash(_slots[j].ptr);
+        // stays if its home is cyclically in (i, j]
+        if (i <= j ? (i < home && home <= j) : (i < home || home <= j))
+        {
+            continue;
+        }
+        _slots[i] = _slots[j];
+        i = j;
+    }
+    _slots[i].ptr = 0;
+    _used--;
+}
+
+esp_err_t HeapTrace::trace(PsychicRequest *request)
+{
+    int top = request->hasParam("top") ? request->getParam("top")->value().toInt() : 10;
+
+    // copied: the response is built outside the critical section
+    heap_tag_t *tags = (heap_tag_t *)heap_caps_malloc(sizeof(_tags), MALLOC_CAP_8BIT);
+    if (!tags)
+    {
+        return request->reply(500);
+    }
+    portENTER_CRITICAL_SAFE(&_mux);
+    uint8_t count = _tagCount;
+    memcpy(tags, _tags, count * sizeof(heap_tag_t));
+    uint32_t used = _used;
+    uint32_t untracked = _untracked;
+    portEXIT_CRITICAL_SAFE(&_mux);
+
+    std::sort(tags, tags + count, [](const heap_tag_t &a, const heap_tag_t &b)
+              { return a.live > b.live; });
+
+    PsychicJsonResponse response = PsychicJsonResponse(request, false);
+    JsonObject root = response.getRoot();
+    root["tracked"] = used;
+    root["slots"] = HEAP_TRACE_SLOTS;
+    root["untracked"] = untracked;
+    root["free_heap"] = ESP.getFreeHeap();
+    root["max_alloc_heap"] = ESP.getMaxAllocHeap();
+    root["min_free_heap"] = ESP.getMinFreeHeap();
+    JsonArray array = root["tags"].to<JsonArray>();
+    for (uint8_t i = 0; i < count && i < top; i++)
+    {
+        JsonObject tag = array.add<JsonObject>();
+        tag["name"] = tags[i].name; // literal or taskName of _tags, which are never overwritten
+        tag["allocs"] = tags[i].allocs;
+        tag["reallocs"] = tags[i].reallocs;
+        tag["frees"] = tags[i].frees;
+        tag["bytes"] = tags[i].bytes;
+        tag["live"] = tags[i].live;
+        tag["live_count"] = tags[i].liveCount;
+        tag["high_water"] = tags[i].highWater;
+    }
+    heap_caps_free(tags);
+    return response.send();
+}
+
+#endif // FT_HEAP_TRACE
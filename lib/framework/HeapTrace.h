@@ -0,0 +1,119 @@
+#ifndef HeapTrace_h
+#define HeapTrace_h
+
+/**
+ *   ESP32 SvelteKit
+ *
+ *   A simple, secure and extensible framework for IoT projects for ESP32 platforms
+ *   with responsive Sveltekit front-end built with TailwindCSS and DaisyUI.
+ *   https://github.com/theelims/ESP32-sveltekit
+ *
+ *   Copyright (C) 2018 - 2023 rjwats
+ *   Copyright (C) 2023 - 2024 theelims
+ *
+ *   All Rights Reserved. This software may be modified and distributed under
+ *   the terms of the LGPL v3 license. See the LICENSE file for details.
+ **/
+
+#include <Features.h>
+
+#if FT_ENABLED(FT_HEAP_TRACE)
+
+#include <Arduino.h>
+#include <PsychicHttp.h>
+#include <SecurityManager.h>
+#include <HeapTraceTasks.h>
+
+#define HEAP_TRACE_SERVICE_PATH "/rest/heapTrace"
+
+#ifndef HEAP_TRACE_SLOTS
+#define HEAP_TRACE_SLOTS 4096 // live allocations tracked, power of 2, 8 bytes each
+#endif
+#define HEAP_TRACE_MAX_TAGS 32
+#define HEAP_TRACE_OTHER 0 // tag of allocations before the scheduler runs or beyond HEAP_TRACE_MAX_TAGS
+
+typedef struct
+{
+    const char *name; // literal of a scope tag, or taskName
+    char taskName[16];
+    uint32_t allocs;    // including reallocs
+    uint32_t reallocs;  // String and JsonDocument growth
+    uint32_t frees;     // of tracked allocations
+    uint64_t bytes;     // allocated in total
+    uint32_t live;      // bytes allocated and not freed
+    uint32_t liveCount; // allocations not freed
+    uint32_t highWater; // of live
+} heap_tag_t;
+
+/**
+ * Opt-in (FT_HEAP_TRACE) accounting of malloc, calloc, realloc and free per tag, to find who holds the heap or
+ * fragments it. The calls are wrapped by the linker (see [HEAP_TRACE] in platformio.ini). An allocation is tagged by
+ * the innermost HEAP_TAG scope of its task, else by the name of its task (httpd, loopTask, async_req_worker, ...).
+ * Live allocations are kept in a table of HEAP_TRACE_SLOTS pointers, so a free is credited to the tag of its allocation.
+ * Costs a task lookup (HeapTraceTasks) and a hash table insert or remove per call, in a critical section. Allocations
+ * made with heap_caps_malloc (ps_malloc) or before begin() are not counted. GET HEAP_TRACE_SERVICE_PATH (?top=n)
+ * returns the tags with the most live bytes; the largest free block over time is in the metrics history.
+ */
+class HeapTrace
+{
+public:
+    void begin(PsychicHttpServer *server, SecurityManager *securityManager);
+
+    uint8_t tag(const char *name); // id of a scope tag, name must be a literal
+
+    // called by the wrappers
+    void allocated(void *ptr, size_t size, bool realloc = false);
+    bool freed(void *ptr, uint32_t *sizeTag = nullptr); // false if not tracked
+    void restore(void *ptr, uint32_t sizeTag);          // after a failed realloc
+
+    uint8_t enter(uint8_t tag); // HeapTag, returns the scope tag to leave() with
+    void leave(uint8_t previous);
+
+private:
+    typedef struct
+    {
+        uintptr_t ptr;    // 0: empty
+        uint32_t sizeTag; // size << 8 | tag
+    } heap_slot_t;
+
+    heap_slot_t *_slots = nullptr;
+    uint32_t _used = 0;
+    uint32_t _untracked = 0; // allocations counted while the table was full
+    heap_tag_t _tags[HEAP_TRACE_MAX_TAGS];
+    uint8_t _tagCount = 1; // HEAP_TRACE_OTHER
+    HeapTraceTasks _tasks;
+    portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+
+    heap_task_t *currentTask(); // in the critical section
+    uint8_t addTag(const char *name, bool copy);
+    uint32_t find(uintptr_t ptr);
+    void remove(uint32_t i);
+    esp_err_t trace(PsychicRequest *request);
+};
+
+extern HeapTrace heapTrace;
+
+// tags the allocations of the task until the end of the scope
+class HeapTag
+{
+public:
+    HeapTag(uint8_t tag) : _previous(heapTrace.enter(tag)) {}
+    ~HeapTag() { heapTrace.leave(_previous); }
+
+private:
+    uint8_t _previous;
+};
+
+#define HEAP_TAG_CONCAT(a, b) a##b
+#define HEAP_TAG_VARIABLE(line) HEAP_TAG_CONCAT(heapTag, line)
+#define HEAP_TAG(name)                                                \
+    static uint8_t HEAP_TAG_VARIABLE(__LINE__) = heapTrace.tag(name); \
+    HeapTag HEAP_TAG_CONCAT(heapTagScope, __LINE__)(HEAP_TAG_VARIABLE(__LINE__))
+
+#else
+
+#define HEAP_TAG(name)
+
+#endif // FT_HEAP_TRACE
+
+#endif // end HeapTrace_h
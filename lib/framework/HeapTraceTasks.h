@@ -0,0 +1,101 @@
+#ifndef HeapTraceTasks_h
+#define HeapTraceTasks_h
+
+/**
+ *   ESP32 SvelteKit
+ *
+ *   A simple, secure and extensible framework for IoT projects for ESP32 platforms
+ *   with responsive Sveltekit front-end built with TailwindCSS and DaisyUI.
+ *   https://github.com/theelims/ESP32-sveltekit
+ *
+ *   Copyright (C) 2018 - 2023 rjwats
+ *   Copyright (C) 2023 - 2024 theelims
+ *
+ *   All Rights Reserved. This software may be modified and distributed under
+ *   the terms of the LGPL v3 license. See the LICENSE file for details.
+ **/
+
+#include <Arduino.h>
+
+#define HEAP_TRACE_MAX_TASKS 32
+#define HEAP_TRACE_TASK_NAME 16 // configMAX_TASK_NAME_LEN
+
+typedef struct
+{
+    TaskHandle_t task;
+    char name[HEAP_TRACE_TASK_NAME];
+    uint8_t taskTag;
+    uint8_t scopeTag; // 0: none
+    uint32_t lastUse;
+} heap_task_t;
+
+/**
+ * Tasks seen by HeapTrace, keyed by handle and name. FreeRTOS has no hook on task deletion and reuses the memory of a
+ * deleted task for the next one, so a handle alone can belong to a task which is gone: a handle with another name is a
+ * new task and gets its entry afresh. When all entries are taken, the least recently used one is reused, which is the
+ * entry of a deleted task unless more than HEAP_TRACE_MAX_TASKS tasks allocate. Not thread safe: HeapTrace calls it in
+ * its critical section. The cost per call is in test/test_heaptrace.
+ */
+class HeapTraceTasks
+{
+public:
+    // entry of task, added is true if the entry is new (or reused) and needs its taskTag
+    heap_task_t *find(TaskHandle_t task, const char *name, bool &added)
+    {
+        _uses++;
+        added = false;
+        for (uint8_t i = 0; i < _count; i++)
+        {
+            heap_task_t &entry = _tasks[i];
+            if (entry.task == task)
+            {
+                if (strncmp(entry.name, name, HEAP_TRACE_TASK_NAME - 1))
+                {
+                    set(entry, task, name); // a deleted task's handle
+                    added = true;
+                }
+                entry.lastUse = _uses;
+                return &entry;
+            }
+        }
+        uint8_t i = _count;
+        if (_count < HEAP_TRACE_MAX_TASKS)
+        {
+            _count++;
+        }
+        else
+        {
+            i = 0;
+            for (uint8_t j = 1; j < _count; j++)
+            {
+                if (_uses - _tasks[j].lastUse > _uses - _tasks[i].lastUse)
+                {
+                    i = j;
+                }
+            }
+        }
+        set(_tasks[i], task, name);
+        _tasks[i].lastUse = _uses;
+        added = true;
+        return &_tasks[i];
+    }
+
+    uint8_t count() const { return _count; }
+
+private:
+    heap_task_t _tasks[HEAP_TRACE_MAX_TASKS];
+    uint8_t _count = 0;
+    uint32_t _uses = 0;
+
+    static void set(heap_task_t &entry, TaskHandle_t task, const char *name)
+    {
+        entry.task = task;
+        size_t len = strnlen(name, sizeof(entry.name) - 1);
+        memcpy(entry.name, name, len);
+        entry.name[len] = 0;
+        entry.taskTag = 0;
+        entry.scopeTag = 0;
+    }
+};
+
+#endif // end HeapTraceTasks_h
@@ -6,6 +6,7 @@
 #include <PsychicHttp.h>
 
 #include <SecurityManager.h>
+#include <HeapTrace.h>
 #include <StatefulService.h>
 
 #define HTTP_ENDPOINT_ORIGIN_ID "http"
@@ -64,6 +65,7 @@ public:
                     _securityManager->wrapRequest(
                         [this](PsychicRequest *request)
                         {
+                            HEAP_TAG("json http");
                             PsychicJsonResponse response = PsychicJsonResponse(request, false);
                             JsonObject jsonObject = response.getRoot();
                             _statefulService->read(jsonObject, _stateReader);
@@ -78,6 +80,7 @@ public:
                     _securityManager->wrapCallback(
                         [this](PsychicRequest *request, JsonVariant &json)
                         {
+                            HEAP_TAG("json http");
                             if (!json.is<JsonObject>())
                             {
                                 return request->reply(400);
@@ -0,0 +1,208 @@
+/**
+ *   ESP32 SvelteKit
+ *
+ *   A simple, secure and extensible framework for IoT projects for ESP32 platforms
+ *   with responsive Sveltekit front-end built with TailwindCSS and DaisyUI.
+ *   https://github.com/theelims/ESP32-sveltekit
+ *
+ *   Copyright (C) 2018 - 2023 rjwats
+ *   Copyright (C) 2023 - 2024 theelims
+ *
+ *   All Rights Reserved. This software may be modified and distributed under
+ *   the terms of the LGPL v3 license. See the LICENSE file for details.
+ **/
+
+#include <MetricsHistory.h>
+#include <esp_attr.h>
+#include <esp_system.h>
+#include <time.h>
+
+MetricsHistory metricsHistory; // see .h
+
+// newest samples, not initialized at boot: valid after a soft reset, checked with magic and the ring sizes
+typedef struct
+{
+    uint32_t magic;
+    uint16_t resets;
+    metrics_ring_t seconds;
+    metrics_ring_t minutes;
+    metrics_sample_t secondSamples[METRICS_HISTORY_RTC_SECONDS];
+    metrics_sample_t minuteSamples[METRICS_HISTORY_RTC_MINUTES];
+} metrics_rtc_t;
+
+RTC_NOINIT_ATTR static metrics_rtc_t rtcHistory;
+
+static bool validRing(const metrics_ring_t &ring, uint16_t size)
+{
+    return ring.size == size && ring.head < size && ring.count <= size;
+}
+
+void MetricsHistory::begin(PsychicHttpServer *server, SecurityManager *securityManager)
+{
+    _mutex = xSemaphoreCreateMutex();
+
+    size_t bytes = (METRICS_HISTORY_SECONDS + METRICS_HISTORY_MINUTES) * sizeof(metrics_sample_t);
+    _storage = (metrics_sample_t *)(psramFound() ? ps_malloc(bytes) : malloc(bytes));
+    if (_storage)
+    {
+        _seconds = {_storage, METRICS_HISTORY_SECONDS, 0, 0};
+        _minutes = {_storage + METRICS_HISTORY_SECONDS, METRICS_HISTORY_MINUTES, 0, 0};
+    }
+    else
+    {
+        ESP_LOGE("MetricsHistory", "No memory for the history, only the newest samples are kept");
+    }
+    restore();
+
+    server->on(METRICS_HISTORY_SERVICE_PATH,
+               HTTP_GET,
+               securityManager->wrapRequest(std::bind(&MetricsHistory::history, this, std::placeholders::_1),
+                                            AuthenticationPredicates::IS_AUTHENTICATED));
+
+    ESP_LOGV("MetricsHistory", "Registered GET endpoint: %s", METRICS_HISTORY_SERVICE_PATH);
+}
+
+void MetricsHistory::restore()
+{
+    esp_reset_reason_t reason = esp_reset_reason();
+    bool valid = rtcHistory.magic == METRICS_HISTORY_MAGIC &&
+                 validRing(rtcHistory.seconds, METRICS_HISTORY_RTC_SECONDS) &&
+                 validRing(rtcHistory.minutes, METRICS_HISTORY_RTC_MINUTES) &&
+                 reason != ESP_RST_POWERON && reason != ESP_RST_UNKNOWN;
+
+    if (!valid)
+    {
+        memset(&rtcHistory, 0, sizeof(rtcHistory));
+        rtcHistory.magic = METRICS_HISTORY_MAGIC;
+        rtcHistory.seconds.size = METRICS_HISTORY_RTC_SECONDS;
+        rtcHistory.minutes.size = METRICS_HISTORY_RTC_MINUTES;
+    }
+    rtcHistory.seconds.samples = rtcHistory.secondSamples;
+    rtcHistory.minutes.samples = rtcHistory.minuteSamples;
+    if (!valid)
+    {
+        return;
+    }
+
+    // oldest first, the rtc rings keep them for the next reset
+    metrics_ring_t *rings[2][2] = {{&rtcHistory.seconds, &_seconds}, {&rtcHistory.minutes, &_minutes}};
+    for (auto &ring : rings)
+    {
+        metrics_ring_t &from = *ring[0];
+        for (uint16_t i = 0; i < from.count; i++)
+        {
+            add(*ring[1], from.samples[(from.head + from.size - from.count + i) % from.size]);
+        }
+    }
+    rtcHistory.resets++;
+    _flags = METRICS_FLAG_RESET;
+    ESP_LOGI("MetricsHistory", "Restored %d s and %d min of history after reset %d", rtcHistory.seconds.count, rtcHistory.minutes.count, reason);
+}
+
+void MetricsHistory::add(metrics_ring_t &ring, const metrics_sample_t &sample)
+{
+    if (!ring.size)
+    {
+        return;
+    }
+    ring.samples[ring.head] = sample;
+    ring.head = (ring.head + 1) % ring.size;
+    if (ring.count < ring.size)
+    {
+        ring.count++;
+    }
+}
+
+void MetricsHistory::sample(uint8_t cpu, uint16_t fps, uint8_t sockets)
+{
+    if (!_mutex)
+    {
+        return;
+    }
+
+    metrics_sample_t sample;
+    sample.freeHeap = MIN(ESP.getFreeHeap() / 16, UINT16_MAX);
+    sample.maxAlloc = MIN(ESP.getMaxAllocHeap() / 16, UINT16_MAX);
+    sample.freePsram = psramFound() ? MIN(ESP.getFreePsram() / 1024, UINT16_MAX) : 0;
+    sample.fps = fps;
+    sample.cpu = cpu;
+    sample.temperature = constrain(temperatureRead(), INT8_MIN, INT8_MAX);
+    sample.sockets = sockets;
+    sample.flags = _flags;
+    _flags = 0;
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    add(_seconds, sample);
+    add(rtcHistory.seconds, sample);
+
+    if (!_minuteCount)
+    {
+        _minute = sample;
+        _fpsSum = _cpuSum = 0;
+    }
+    else
+    {
+        _minute.freeHeap = MIN(_minute.freeHeap, sample.freeHeap);
+        _minute.maxAlloc = MIN(_minute.maxAlloc, sample.maxAlloc);
+        _minute.freePsram = MIN(_minute.freePsram, sample.freePsram);
+        _minute.temperature = MAX(_minute.temperature, sample.temperature);
+        _minute.sockets = MAX(_minute.sockets, sample.sockets);
+        _minute.flags |= sample.flags;
+    }
+    _fpsSum += fps;
+    _cpuSum += cpu;
+    if (++_minuteCount == 60)
+    {
+        _minute.fps = _fpsSum / 60;
+        _minute.cpu = _cpuSum / 60;
+        add(_minutes, _minute);
+        add(rtcHistory.minutes, _minute);
+        _minuteCount = 0;
+    }
+    _uptime = millis() / 1000;
+    xSemaphoreGive(_mutex);
+}
+
+esp_err_t MetricsHistory::history(PsychicRequest *request)
+{
+    bool minutes = request->hasParam("interval") && request->getParam("interval")->value().toInt() == 60;
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    // without memory for the history the rtc rings are the history
+    const metrics_ring_t &ring = minutes ? (_minutes.size ? _minutes : rtcHistory.minutes)
+                                         : (_seconds.size ? _seconds : rtcHistory.seconds);
+    size_t len = sizeof(metrics_history_header_t) + ring.count * sizeof(metrics_sample_t);
+    uint8_t *buffer = (uint8_t *)(psramFound() ? ps_malloc(len) : malloc(len));
+    if (!buffer)
+    {
+        xSemaphoreGive(_mutex);
+        return request->reply(500);
+    }
+
+    metrics_history_header_t *header = (metrics_history_header_t *)buffer;
+    header->magic = METRICS_HISTORY_MAGIC;
+    header->interval = minutes ? 60 : 1;
+    header->count = ring.count;
+    // the newest minute sample is of the last full minute
+    header->uptime = minutes ? _uptime - _minuteCount : _uptime;
+    time_t now = time(nullptr);
+    header->time = now > 1000000000 ? now - (millis() / 1000 - header->uptime) : 0; // synchronized: after 2001
+    header->resets = rtcHistory.resets;
+    header->sampleSize = sizeof(metrics_sample_t);
+    header->reserved = 0;
+
+    // oldest first: from head - count to the end of the ring, then from the start
+    metrics_sample_t *samples = (metrics_sample_t *)(buffer + sizeof(metrics_history_header_t));
+    uint16_t start = (ring.head + ring.size - ring.count) % MAX(ring.size, 1);
+    uint16_t first = MIN(ring.count, ring.size - start);
+    memcpy(samples, ring.samples + start, first * sizeof(metrics_sample_t));
+    memcpy(samples + first, ring.samples, (ring.count - first) * sizeof(metrics_sample_t));
+    xSemaphoreGive(_mutex);
+
+    PsychicResponse response(request);
+    response.setContentType("application/octet-stream");
+    response.setContent(buffer, len);
+    esp_err_t result = response.send();
+    free(buffer);
+    return result;
+}
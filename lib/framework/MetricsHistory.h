@@ -0,0 +1,111 @@
+#ifndef MetricsHistory_h
+#define MetricsHistory_h
+
+/**
+ *   ESP32 SvelteKit
+ *
+ *   A simple, secure and extensible framework for IoT projects for ESP32 platforms
+ *   with responsive Sveltekit front-end built with TailwindCSS and DaisyUI.
+ *   https://github.com/theelims/ESP32-sveltekit
+ *
+ *   Copyright (C) 2018 - 2023 rjwats
+ *   Copyright (C) 2023 - 2024 theelims
+ *
+ *   All Rights Reserved. This software may be modified and distributed under
+ *   the terms of the LGPL v3 license. See the LICENSE file for details.
+ **/
+
+#include <Arduino.h>
+#include <PsychicHttp.h>
+#include <SecurityManager.h>
+
+#define METRICS_HISTORY_SERVICE_PATH "/rest/metricsHistory"
+#define METRICS_HISTORY_MAGIC 0x484D4C4D // "MLMH"
+
+#ifndef METRICS_HISTORY_SECONDS
+#define METRICS_HISTORY_SECONDS 600 // 10 minutes at 1 s
+#endif
+#ifndef METRICS_HISTORY_MINUTES
+#define METRICS_HISTORY_MINUTES 1440 // 24 hours at 1 min
+#endif
+// the newest samples are also kept in RTC memory, which survives a soft reset (panic, watchdog, restart)
+#ifndef METRICS_HISTORY_RTC_SECONDS
+#define METRICS_HISTORY_RTC_SECONDS 120
+#endif
+#ifndef METRICS_HISTORY_RTC_MINUTES
+#define METRICS_HISTORY_RTC_MINUTES 120
+#endif
+
+#define METRICS_FLAG_RESET 0x01 // first sample after a (soft) reset
+
+// one sample, minute samples hold the minimum of the heap values, the average of fps and cpu and the maximum of the others
+typedef struct __attribute__((packed))
+{
+    uint16_t freeHeap;  // 16 bytes
+    uint16_t maxAlloc;  // largest free heap block, 16 bytes
+    uint16_t freePsram; // KB
+    uint16_t fps;       // main loops per second
+    uint8_t cpu;        // %
+    int8_t temperature; // °C
+    uint8_t sockets;    // open http sockets
+    uint8_t flags;      // METRICS_FLAG_
+} metrics_sample_t;
+
+// the response of METRICS_HISTORY_SERVICE_PATH, followed by count samples, oldest first, little endian
+typedef struct __attribute__((packed))
+{
+    uint32_t magic;     // METRICS_HISTORY_MAGIC
+    uint16_t interval;  // s between samples: 1 or 60
+    uint16_t count;
+    uint32_t uptime;    // s since boot of the newest sample
+    uint32_t time;      // unix time of the newest sample, 0 if not synchronized
+    uint16_t resets;    // soft resets survived by the history
+    uint8_t sampleSize; // sizeof(metrics_sample_t)
+    uint8_t reserved;
+} metrics_history_header_t;
+
+// ring of samples, storage is not owned
+typedef struct
+{
+    metrics_sample_t *samples;
+    uint16_t size;
+    uint16_t head; // next to write
+    uint16_t count;
+} metrics_ring_t;
+
+/**
+ * Multi resolution history of the analytics: a sample every second for METRICS_HISTORY_SECONDS and a sample every
+ * minute for METRICS_HISTORY_MINUTES, in PSRAM if found. The newest samples of both are kept in RTC memory as well and
+ * are restored after a soft reset, so the minutes before a crash can be seen after it. GET METRICS_HISTORY_SERVICE_PATH
+ * (?interval=60 for minutes) returns a metrics_history_header_t and the samples.
+ */
+class MetricsHistory
+{
+public:
+    void begin(PsychicHttpServer *server, SecurityManager *securityManager);
+
+    // every second
+    void sample(uint8_t cpu, uint16_t fps, uint8_t sockets);
+
+private:
+    metrics_sample_t *_storage = nullptr; // seconds, then minutes
+    metrics_ring_t _seconds = {};
+    metrics_ring_t _minutes = {};
+    SemaphoreHandle_t _mutex = nullptr;
+    uint8_t _flags = 0; // of the next sample
+    uint32_t _uptime = 0; // s since boot of the newest sample
+
+    // minute in progress
+    metrics_sample_t _minute;
+    uint32_t _fpsSum = 0;
+    uint16_t _cpuSum = 0;
+    uint8_t _minuteCount = 0;
+
+    void restore();
+    void add(metrics_ring_t &ring, const metrics_sample_t &sample);
+    esp_err_t history(PsychicRequest *request);
+};
+
+extern MetricsHistory metricsHistory;
+
+#endif // end MetricsHistory_h
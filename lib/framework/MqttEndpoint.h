@@ -17,11 +17,49 @@
 
 #include <StatefulService.h>
 #include <PsychicMqttClient.h>
+#include <MqttRouter.h>
+#include <esp_timer.h>
+#include <vector>
 
 #define MQTT_ORIGIN_ID "mqtt"
 
+#ifndef MQTT_PUBLISH_INTERVAL
+#define MQTT_PUBLISH_INTERVAL 100 // ms, minimum time between two publishes of an endpoint, changes in between are coalesced
+#endif
+
+#ifndef MQTT_PAYLOAD_BUFFER
+#define MQTT_PAYLOAD_BUFFER 512 // preallocated per endpoint, grows once if a state does not fit
+#endif
+
+// totals of all endpoints, reported by MqttStatus
+struct MqttPublishStats
+{
+    volatile uint32_t sent = 0;
+    volatile uint32_t suppressed = 0; // coalesced into a later publish or same payload as last time
+};
+
+extern MqttPublishStats mqttPublishStats;
+
+// A publish deferred to the end of the publish interval is done by flushDue(), called from the ESP32SvelteKit loop
+// task: the esp_timer task only marks the endpoint as due, publishing there would hold up the other timers
+class MqttPublisher
+{
+public:
+    static void flushDue();
+
+protected:
+    MqttPublisher() : _next(_first) { _first = this; }
+
+    virtual void flush() = 0;
+    volatile bool _due = false;
+
+private:
+    static MqttPublisher *_first; // endpoints live as long as their services, they are never removed
+    MqttPublisher *_next;
+};
+
 template <class T>
-class MqttEndpoint
+class MqttEndpoint : public MqttPublisher
 {
 public:
     MqttEndpoint(JsonStateReader<T> stateReader,
@@ -39,19 +77,19 @@ public:
                                         _retain(retain)
 
     {
+        _payload = (char *)malloc(_payloadSize);
+        esp_timer_create_args_t timerArgs = {};
+        timerArgs.callback = [](void *endpoint)
+        { ((MqttEndpoint<T> *)endpoint)->_due = true; };
+        timerArgs.arg = this;
+        timerArgs.name = "MqttEndpoint";
+        esp_timer_create(&timerArgs, &_timer);
+
         _statefulService->addUpdateHandler([&](const String &originId)
                                            { publish(); },
-                                           false);
+                                           false, HandlerContext::NETWORK);
 
         _mqttClient->onConnect(std::bind(&MqttEndpoint::onConnect, this));
-
-        _mqttClient->onMessage(std::bind(&MqttEndpoint::onMqttMessage,
-                                         this,
-                                         std::placeholders::_1,
-                                         std::placeholders::_2,
-                                         std::placeholders::_3,
-                                         std::placeholders::_4,
-                                         std::placeholders::_5));
     }
 
 public:
@@ -65,47 +103,93 @@ public:
     {
         if (!_subTopic.equals(subTopic))
         {
-            // unsubscribe from the existing topic if one was set
-            if (_subTopic.length() > 0)
-            {
-                _mqttClient->unsubscribe(_subTopic.c_str());
-            }
+            // unsubscribe from the existing topics if one was set
+            unsubscribe();
             // set the new topic and re-configure the subscription
             _subTopic = subTopic;
             subscribe();
         }
     }
 
+    /*
+     * Plain value command topic, e.g. onCommand("brightness", ...) for <subTopic without /set>/brightness/set
+     * with payload "128". The handler parses the value (see MqttRouter::parseInt and parseBool) and updates
+     * the state directly, no JSON is involved.
+     */
+    void onCommand(const String &name, std::function<StateUpdateResult(const char *value, T &state)> handler)
+    {
+        _commands.push_back({name, handler, 0});
+        if (_routeId)
+        {
+            // already subscribed, add this one
+            subscribeCommand(_commands.back());
+        }
+    }
+
     void setPubTopic(const String &pubTopic)
     {
         _pubTopic = pubTopic;
-        publish();
+        republish();
     }
 
     void setRetain(const bool retain)
     {
         _retain = retain;
-        publish();
+        republish();
+    }
+
+    // 0: publish every change immediately
+    void setPublishInterval(uint32_t publishInterval)
+    {
+        _publishInterval = publishInterval;
     }
 
+    // publish each changed key of the state to <pubTopic>/<key> instead of the whole state to pubTopic
+    void setFieldTopics(bool fieldTopics)
+    {
+        _fieldTopics = fieldTopics;
+        republish();
+    }
+
+    // Publishes the state, at most once per publish interval: changes within the interval are coalesced,
+    // the last state is published when the interval has passed
     void publish()
     {
-        if (_pubTopic.length() > 0 && _mqttClient->connected())
+        if (_pubTopic.length() == 0 || !_mqttClient->connected())
         {
-            // serialize to json doc
-            JsonDocument json;
-            JsonObject jsonObject = json.to<JsonObject>();
-            _statefulService->read(jsonObject, _stateReader);
+            return;
+        }
 
-            // serialize to string
-            String payload;
-            serializeJson(json, payload);
+        uint32_t wait = 0;
+        portENTER_CRITICAL(&_mux);
+        if (_pending)
+        {
+            portEXIT_CRITICAL(&_mux);
+            _suppressed++;
+            mqttPublishStats.suppressed++;
+            return;
+        }
+        unsigned long elapsed = millis() - _lastPublish;
+        if (elapsed < _publishInterval)
+        {
+            _pending = true;
+            wait = _publishInterval - elapsed;
+        }
+        portEXIT_CRITICAL(&_mux);
 
-            // publish the payload
-            _mqttClient->publish(_pubTopic.c_str(), 0, _retain, payload.c_str());
+        if (wait)
+        {
+            esp_timer_start_once(_timer, wait * 1000);
+        }
+        else
+        {
+            flush();
         }
     }
 
+    uint32_t getSent() { return _sent; }
+    uint32_t getSuppressed() { return _suppressed; }
+
     PsychicMqttClient *getMqttClient()
     {
         return _mqttClient;
@@ -120,21 +204,148 @@ protected:
     String _pubTopic;
     bool _retain;
 
-    void onMqttMessage(char *topic,
-                       char *payload,
-                       int retain,
-                       int qos,
-                       bool dup)
+    struct Command
+    {
+        String name;
+        std::function<StateUpdateResult(const char *value, T &state)> handler;
+        uint32_t routeId;
+    };
+    std::vector<Command> _commands;
+    uint32_t _routeId = 0; // of _subTopic in mqttRouter, 0: not routed
+
+    uint32_t _publishInterval = MQTT_PUBLISH_INTERVAL;
+    bool _fieldTopics = false;
+    esp_timer_handle_t _timer = nullptr;
+    portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+    volatile bool _pending = false;
+    unsigned long _lastPublish = 0;
+    SemaphoreHandle_t _flushMutex = xSemaphoreCreateMutex();
+    char *_payload = nullptr;
+    size_t _payloadSize = MQTT_PAYLOAD_BUFFER;
+    uint32_t _lastHash = 0;                                 // of the last published state
+    std::vector<std::pair<uint32_t, uint32_t>> _fieldHashes; // key hash, hash of the last published value
+    uint32_t _sent = 0;
+    uint32_t _suppressed = 0;
+
+    static uint32_t hash(const char *data, size_t len, uint32_t hash = 2166136261u)
+    {
+        for (size_t i = 0; i < len; i++)
+        {
+            hash = (hash ^ (uint8_t)data[i]) * 16777619u; // FNV-1a
+        }
+        return hash;
+    }
+
+    // serializes value into _payload, strings without quotes so field topics carry plain values
+    size_t serializePayload(JsonVariantConst value)
+    {
+        size_t len = value.is<const char *>() ? strlen(value.as<const char *>()) : measureJson(value);
+        if (len + 1 > _payloadSize)
+        {
+            char *payload = (char *)realloc(_payload, len + 1);
+            if (!payload)
+            {
+                return 0;
+            }
+            _payload = payload;
+            _payloadSize = len + 1;
+        }
+        if (value.is<const char *>())
+        {
+            memcpy(_payload, value.as<const char *>(), len + 1);
+        }
+        else
+        {
+            serializeJson(value, _payload, _payloadSize);
+        }
+        return len;
+    }
+
+    // the next publish sends everything, e.g. after (re)connecting
+    void republish()
+    {
+        xSemaphoreTake(_flushMutex, portMAX_DELAY);
+        _lastHash = 0;
+        _fieldHashes.clear();
+        xSemaphoreGive(_flushMutex);
+        publish();
+    }
+
+    // publishes the current state, runs in the task calling publish() or in the loop task (flushDue)
+    void flush() override
     {
-        // we only care about the topic we are watching in this class
-        if (strcmp(_subTopic.c_str(), topic))
+        portENTER_CRITICAL(&_mux);
+        _pending = false;
+        _lastPublish = millis();
+        portEXIT_CRITICAL(&_mux);
+
+        if (_pubTopic.length() == 0 || !_mqttClient->connected() || !_payload)
         {
             return;
         }
 
+        JsonDocument json;
+        JsonObject jsonObject = json.to<JsonObject>();
+        _statefulService->read(jsonObject, _stateReader);
+
+        xSemaphoreTake(_flushMutex, portMAX_DELAY);
+        if (_fieldTopics)
+        {
+            for (JsonPair field : jsonObject)
+            {
+                const char *key = field.key().c_str();
+                size_t len = serializePayload(field.value());
+                uint32_t keyHash = hash(key, strlen(key));
+                uint32_t valueHash = hash(_payload, len);
+
+                auto last = std::find_if(_fieldHashes.begin(), _fieldHashes.end(), [keyHash](const std::pair<uint32_t, uint32_t> &entry)
+                                         { return entry.first == keyHash; });
+                if (last != _fieldHashes.end() && last->second == valueHash)
+                {
+                    _suppressed++; // unchanged fields are not published
+                    mqttPublishStats.suppressed++;
+                    continue;
+                }
+                if (last != _fieldHashes.end())
+                {
+                    last->second = valueHash;
+                }
+                else
+                {
+                    _fieldHashes.push_back({keyHash, valueHash});
+                }
+
+                String topic = _pubTopic + "/" + key;
+                _mqttClient->publish(topic.c_str(), 0, _retain, _payload, len);
+                _sent++;
+                mqttPublishStats.sent++;
+            }
+        }
+        else
+        {
+            size_t len = serializePayload(jsonObject);
+            uint32_t payloadHash = hash(_payload, len);
+            if (payloadHash == _lastHash)
+            {
+                _suppressed++;
+                mqttPublishStats.suppressed++;
+            }
+            else
+            {
+                _lastHash = payloadHash;
+                _mqttClient->publish(_pubTopic.c_str(), 0, _retain, _payload, len);
+                _sent++;
+                mqttPublishStats.sent++;
+            }
+        }
+        xSemaphoreGive(_flushMutex);
+    }
+
+    void onMqttMessage(const char *topic, const char *payload, size_t len)
+    {
         // deserialize from string
         JsonDocument json;
-        DeserializationError error = deserializeJson(json, payload);
+        DeserializationError error = deserializeJson(json, payload, len);
         if (!error && json.is<JsonObject>())
         {
             JsonObject jsonObject = json.as<JsonObject>();
@@ -145,15 +356,65 @@ protected:
     void onConnect()
     {
         subscribe();
-        publish();
+        republish();
+    }
+
+    // <subTopic without /set>/<name>/set
+    String commandTopic(const Command &command)
+    {
+        String base = _subTopic.endsWith("/set") ? _subTopic.substring(0, _subTopic.length() - 4) : _subTopic;
+        return base + "/" + command.name + "/set";
+    }
+
+    void subscribeCommand(Command &command)
+    {
+        String topic = commandTopic(command);
+        if (!command.routeId)
+        {
+            size_t index = &command - _commands.data(); // _commands only grows, the index stays valid
+            command.routeId = mqttRouter.on(topic, [this, index](const char *topic, const char *payload, size_t len)
+                                            { _statefulService->update([&](T &state)
+                                                                       { return _commands[index].handler(payload, state); },
+                                                                       MQTT_ORIGIN_ID); });
+        }
+        _mqttClient->subscribe(topic.c_str(), 0);
     }
 
     void subscribe()
     {
         if (_subTopic.length() > 0)
         {
+            // routes are added once per topic, subscriptions again after every (re)connect
+            if (!_routeId)
+            {
+                _routeId = mqttRouter.on(_subTopic, std::bind(&MqttEndpoint::onMqttMessage,
+                                                              this,
+                                                              std::placeholders::_1,
+                                                              std::placeholders::_2,
+                                                              std::placeholders::_3));
+            }
             _mqttClient->subscribe(_subTopic.c_str(), 2);
+            for (Command &command : _commands)
+            {
+                subscribeCommand(command);
+            }
+        }
+    }
+
+    void unsubscribe()
+    {
+        if (_subTopic.length() > 0)
+        {
+            _mqttClient->unsubscribe(_subTopic.c_str());
+            for (Command &command : _commands)
+            {
+                _mqttClient->unsubscribe(commandTopic(command).c_str());
+                mqttRouter.off(command.routeId);
+                command.routeId = 0;
+            }
         }
+        mqttRouter.off(_routeId);
+        _routeId = 0;
     }
 };
 
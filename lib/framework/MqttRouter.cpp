@@ -0,0 +1,199 @@
+/**
+ *   ESP32 SvelteKit
+ *
+ *   A simple, secure and extensible framework for IoT projects for ESP32 platforms
+ *   with responsive Sveltekit front-end built with TailwindCSS and DaisyUI.
+ *   https://github.com/theelims/ESP32-sveltekit
+ *
+ *   Copyright (C) 2018 - 2023 rjwats
+ *   Copyright (C) 2023 - 2024 theelims
+ *
+ *   All Rights Reserved. This software may be modified and distributed under
+ *   the terms of the LGPL v3 license. See the LICENSE file for details.
+ **/
+
+#include <MqttRouter.h>
+
+MqttRouter mqttRouter;
+
+void MqttRouter::begin(PsychicMqttClient *mqttClient)
+{
+    if (!_mutex)
+    {
+        _mutex = xSemaphoreCreateMutex();
+    }
+    mqttClient->onMessage(std::bind(&MqttRouter::onMessage,
+                                    this,
+                                    std::placeholders::_1,
+                                    std::placeholders::_2,
+                                    std::placeholders::_3,
+                                    std::placeholders::_4,
+                                    std::placeholders::_5));
+}
+
+uint32_t MqttRouter::on(const String &topicFilter, MqttRouteHandler handler)
+{
+    if (topicFilter.length() == 0)
+    {
+        return 0;
+    }
+    if (!_mutex)
+    {
+        _mutex = xSemaphoreCreateMutex();
+    }
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    Route route = {_nextId++, topicFilter, handler};
+    if (topicFilter.indexOf('+') >= 0 || topicFilter.indexOf('#') >= 0)
+    {
+        _wildcards.push_back(route);
+    }
+    else
+    {
+        _exact.insert({hash(topicFilter.c_str()), route});
+    }
+    xSemaphoreGive(_mutex);
+
+    ESP_LOGV("MqttRouter", "Route %d: %s", route.id, topicFilter.c_str());
+    return route.id;
+}
+
+void MqttRouter::off(uint32_t routeId)
+{
+    if (!routeId || !_mutex)
+    {
+        return;
+    }
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    for (auto it = _exact.begin(); it != _exact.end(); it++)
+    {
+        if (it->second.id == routeId)
+        {
+            _exact.erase(it);
+            break;
+        }
+    }
+    for (auto it = _wildcards.begin(); it != _wildcards.end(); it++)
+    {
+        if (it->id == routeId)
+        {
+            _wildcards.erase(it);
+            break;
+        }
+    }
+    xSemaphoreGive(_mutex);
+}
+
+void MqttRouter::onMessage(char *topic, char *payload, int retain, int qos, bool dup)
+{
+    // handlers are copied and called without the mutex, so they can add and remove routes
+    MqttRouteHandler handlers[MQTT_ROUTER_MAX_HANDLERS];
+    uint8_t count = 0;
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    auto range = _exact.equal_range(hash(topic));
+    for (auto it = range.first; it != range.second && count < MQTT_ROUTER_MAX_HANDLERS; it++)
+    {
+        if (it->second.topicFilter.equals(topic))
+        {
+            handlers[count++] = it->second.handler;
+        }
+    }
+    for (Route &route : _wildcards)
+    {
+        if (count < MQTT_ROUTER_MAX_HANDLERS && matches(route.topicFilter.c_str(), topic))
+        {
+            handlers[count++] = route.handler;
+        }
+    }
+    xSemaphoreGive(_mutex);
+
+    if (!count)
+    {
+        _unrouted++;
+        return;
+    }
+    _dispatched++;
+    size_t len = payload ? strlen(payload) : 0;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        handlers[i](topic, payload ? payload : "", len);
+    }
+}
+
+bool MqttRouter::matches(const char *topicFilter, const char *topic)
+{
+    while (*topicFilter)
+    {
+        if (*topicFilter == '#')
+        {
+            return true; // the rest of the topic, including none ("a/#" matches "a")
+        }
+        if (*topicFilter == '+')
+        {
+            while (*topic && *topic != '/')
+            {
+                topic++;
+            }
+            topicFilter++;
+            continue;
+        }
+        if (*topicFilter == '/' && !*topic && topicFilter[1] == '#')
+        {
+            return true;
+        }
+        if (*topicFilter != *topic)
+        {
+            return false;
+        }
+        topicFilter++;
+        topic++;
+    }
+    return !*topic;
+}
+
+bool MqttRouter::parseInt(const char *payload, int32_t &value)
+{
+    char *end;
+    long result = strtol(payload, &end, 10);
+    if (end == payload)
+    {
+        return false;
+    }
+    while (*end == ' ' || *end == '\r' || *end == '\n')
+    {
+        end++;
+    }
+    if (*end)
+    {
+        return false;
+    }
+    value = result;
+    return true;
+}
+
+bool MqttRouter::parseBool(const char *payload, bool &value)
+{
+    if (!strcasecmp(payload, "ON") || !strcasecmp(payload, "true") || !strcmp(payload, "1"))
+    {
+        value = true;
+        return true;
+    }
+    if (!strcasecmp(payload, "OFF") || !strcasecmp(payload, "false") || !strcmp(payload, "0"))
+    {
+        value = false;
+        return true;
+    }
+    return false;
+}
+
+uint32_t MqttRouter::hash(const char *topic)
+{
+    uint32_t hash = 2166136261u;
+    while (*topic)
+    {
+        hash = (hash ^ (uint8_t)*topic++) * 16777619u; // FNV-1a
+    }
+    return hash;
+}
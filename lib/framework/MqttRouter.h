@@ -0,0 +1,72 @@
+#ifndef MqttRouter_h
+#define MqttRouter_h
+
+/**
+ *   ESP32 SvelteKit
+ *
+ *   A simple, secure and extensible framework for IoT projects for ESP32 platforms
+ *   with responsive Sveltekit front-end built with TailwindCSS and DaisyUI.
+ *   https://github.com/theelims/ESP32-sveltekit
+ *
+ *   Copyright (C) 2018 - 2023 rjwats
+ *   Copyright (C) 2023 - 2024 theelims
+ *
+ *   All Rights Reserved. This software may be modified and distributed under
+ *   the terms of the LGPL v3 license. See the LICENSE file for details.
+ **/
+
+#include <Arduino.h>
+#include <PsychicMqttClient.h>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#define MQTT_ROUTER_MAX_HANDLERS 4 // handlers called for one message
+
+typedef std::function<void(const char *topic, const char *payload, size_t len)> MqttRouteHandler;
+
+/*
+ * Dispatches incoming MQTT messages to the routes registered for their topic. The router is the only
+ * onMessage handler of the client: topics without wildcards are looked up by hash, only topic filters
+ * with wildcards (+ and #) are matched one by one. Routes are added at runtime (after begin).
+ */
+class MqttRouter
+{
+public:
+    void begin(PsychicMqttClient *mqttClient);
+
+    // returns the route id for off(), 0 if the filter is invalid
+    uint32_t on(const String &topicFilter, MqttRouteHandler handler);
+    void off(uint32_t routeId);
+
+    static bool matches(const char *topicFilter, const char *topic);
+
+    // plain value payloads, without JSON
+    static bool parseInt(const char *payload, int32_t &value);
+    static bool parseBool(const char *payload, bool &value); // ON / OFF, true / false, 1 / 0
+
+    uint32_t getDispatched() { return _dispatched; }
+    uint32_t getUnrouted() { return _unrouted; }
+
+private:
+    struct Route
+    {
+        uint32_t id;
+        String topicFilter;
+        MqttRouteHandler handler;
+    };
+
+    std::unordered_multimap<uint32_t, Route> _exact; // by hash of the topic
+    std::vector<Route> _wildcards;
+    SemaphoreHandle_t _mutex = nullptr;
+    uint32_t _nextId = 1;
+    uint32_t _dispatched = 0;
+    uint32_t _unrouted = 0;
+
+    static uint32_t hash(const char *topic);
+    void onMessage(char *topic, char *payload, int retain, int qos, bool dup);
+};
+
+extern MqttRouter mqttRouter;
+
+#endif // end MqttRouter_h
@@ -13,6 +13,7 @@
  **/
 
 #include <MqttSettingsService.h>
+#include <MqttRouter.h>
 
 extern const uint8_t rootca_crt_bundle_start[] asm("_binary_src_certs_x509_crt_bundle_bin_start");
 
@@ -73,6 +74,7 @@ void MqttSettingsService::begin()
     _mqttClient.onConnect(std::bind(&MqttSettingsService::onMqttConnect, this, std::placeholders::_1));
     _mqttClient.onDisconnect(std::bind(&MqttSettingsService::onMqttDisconnect, this, std::placeholders::_1));
     _mqttClient.onError(std::bind(&MqttSettingsService::onMqttError, this, std::placeholders::_1));
+    mqttRouter.begin(&_mqttClient); // the only onMessage handler, dispatches to the endpoints
 
     _httpEndpoint.begin();
     _fsPersistence.readFromFS();
@@ -13,6 +13,22 @@
  **/
 
 #include <MqttStatus.h>
+#include <MqttEndpoint.h>
+
+MqttPublishStats mqttPublishStats; // see MqttEndpoint.h
+MqttPublisher *MqttPublisher::_first = nullptr;
+
+void MqttPublisher::flushDue()
+{
+    for (MqttPublisher *publisher = _first; publisher; publisher = publisher->_next)
+    {
+        if (publisher->_due)
+        {
+            publisher->_due = false;
+            publisher->flush();
+        }
+    }
+}
 
 MqttStatus::MqttStatus(PsychicHttpServer *server,
                        MqttSettingsService *mqttSettingsService,
@@ -41,6 +57,8 @@ esp_err_t MqttStatus::mqttStatus(PsychicRequest *request)
     root["connected"] = _mqttSettingsService->isConnected();
     root["client_id"] = _mqttSettingsService->getClientId();
     root["last_error"] = _mqttSettingsService->getLastError();
+    root["published"] = mqttPublishStats.sent;
+    root["suppressed"] = mqttPublishStats.suppressed;
 
     return response.send();
 }
@@ -0,0 +1,260 @@
+/**
+ *   ESP32 SvelteKit
+ *
+ *   A simple, secure and extensible framework for IoT projects for ESP32 platforms
+ *   with responsive Sveltekit front-end built with TailwindCSS and DaisyUI.
+ *   https://github.com/theelims/ESP32-sveltekit
+ *
+ *   Copyright (C) 2018 - 2023 rjwats
+ *   Copyright (C) 2023 - 2024 theelims
+ *
+ *   All Rights Reserved. This software may be modified and distributed under
+ *   the terms of the LGPL v3 license. See the LICENSE file for details.
+ **/
+
+#include <OtaWriter.h>
+
+OtaWriter::~OtaWriter()
+{
+    abort();
+}
+
+bool OtaWriter::begin(size_t size, const char *md5)
+{
+    abort();
+    _error = nullptr;
+    _written = 0;
+    _digestValid = false;
+    _startMicros = micros();
+    _endMicros = 0;
+
+    size_t bytes = OTA_WRITER_BLOCKS * OTA_WRITER_BLOCK_SIZE;
+    _blocks = (uint8_t *)(psramFound() ? ps_malloc(bytes) : malloc(bytes)); // Update copies each block into its own buffer
+    _free = xQueueCreate(OTA_WRITER_BLOCKS, sizeof(uint8_t));
+    _filled = xQueueCreate(OTA_WRITER_BLOCKS, sizeof(uint8_t));
+    if (_blocks)
+    {
+        mbedtls_sha256_init(&_sha); // freed with the blocks
+    }
+    if (!_blocks || !_free || !_filled)
+    {
+        stop();
+        return fail("no memory for the ota writer");
+    }
+    mbedtls_sha256_starts_ret(&_sha, 0);
+
+    if (!Update.begin(size))
+    {
+        stop();
+        return fail(Update.errorString());
+    }
+    _updating = true;
+    if (md5 && strlen(md5) == 32)
+    {
+        Update.setMD5(md5);
+    }
+
+    for (uint8_t i = 0; i < OTA_WRITER_BLOCKS; i++)
+    {
+        xQueueSend(_free, &i, 0);
+    }
+    _stop = false;
+    // no affinity: the download task spins on core 1 while it waits for data
+    if (xTaskCreateUniversal(writerTask, "OtaWriter", OTA_WRITER_STACK_SIZE, this, 5, &_task, tskNO_AFFINITY) != pdPASS)
+    {
+        abort();
+        return fail("could not start the ota writer task");
+    }
+    return true;
+}
+
+bool OtaWriter::write(const uint8_t *data, size_t len)
+{
+    if (_error || !_task)
+    {
+        return false;
+    }
+
+    while (len)
+    {
+        if (_current < 0)
+        {
+            uint8_t i;
+            if (xQueueReceive(_free, &i, pdMS_TO_TICKS(OTA_WRITER_TIMEOUT)) != pdTRUE)
+            {
+                return fail("flash write timeout");
+            }
+            _current = i;
+            _lengths[i] = 0;
+        }
+
+        size_t n = MIN(len, OTA_WRITER_BLOCK_SIZE - _lengths[_current]);
+        memcpy(_blocks + _current * OTA_WRITER_BLOCK_SIZE + _lengths[_current], data, n);
+        _lengths[_current] += n;
+        _written += n;
+        data += n;
+        len -= n;
+
+        if (_lengths[_current] == OTA_WRITER_BLOCK_SIZE)
+        {
+            queue(_current);
+            _current = -1;
+        }
+    }
+    return !_error;
+}
+
+bool OtaWriter::end(bool evenIfRemaining, const uint8_t *sha256)
+{
+    if (!_task)
+    {
+        return fail("ota writer not started");
+    }
+
+    if (_current >= 0)
+    {
+        queue(_current); // the last, partial block
+        _current = -1;
+    }
+    if (!waitWriter() || _error)
+    {
+        abort();
+        return false;
+    }
+    _endMicros = micros();
+    mbedtls_sha256_finish_ret(&_sha, _digest);
+    _digestValid = true;
+    stop();
+
+    if (sha256 && memcmp(sha256, _digest, sizeof(_digest)))
+    {
+        abort();
+        return fail("sha256 of the image does not match");
+    }
+    _updating = false;
+    if (!Update.end(evenIfRemaining))
+    {
+        return fail(Update.errorString());
+    }
+
+    ESP_LOGI("OtaWriter", "Wrote %d bytes in %d ms: %.2f MB/s", _written, (_endMicros - _startMicros) / 1000, mbps());
+    return true;
+}
+
+void OtaWriter::abort()
+{
+    stop();
+    // only an update this writer began, another writer can be running (upload of a delta)
+    if (_updating)
+    {
+        Update.abort();
+        _updating = false;
+    }
+}
+
+String OtaWriter::sha256()
+{
+    if (!_digestValid)
+    {
+        return "";
+    }
+    char hex[65];
+    for (int i = 0; i < 32; i++)
+    {
+        sprintf(hex + i * 2, "%02x", _digest[i]);
+    }
+    return hex;
+}
+
+float OtaWriter::mbps()
+{
+    uint32_t elapsed = (_endMicros ? _endMicros : micros()) - _startMicros;
+    return elapsed ? (float)_written / elapsed : 0; // bytes per us is MB/s
+}
+
+void OtaWriter::writerTask(void *parameter)
+{
+    OtaWriter *writer = (OtaWriter *)parameter;
+    while (!writer->_stop)
+    {
+        uint8_t i;
+        if (xQueueReceive(writer->_filled, &i, pdMS_TO_TICKS(50)) != pdTRUE)
+        {
+            continue;
+        }
+
+        uint8_t *block = writer->_blocks + i * OTA_WRITER_BLOCK_SIZE;
+        size_t len = writer->_lengths[i];
+        if (!writer->_error)
+        {
+            if (Update.write(block, len) == len)
+            {
+                mbedtls_sha256_update_ret(&writer->_sha, block, len);
+            }
+            else
+            {
+                writer->fail(Update.errorString());
+            }
+        }
+        xQueueSend(writer->_free, &i, 0);
+    }
+    writer->_task = nullptr;
+    vTaskDelete(NULL);
+}
+
+bool OtaWriter::queue(uint8_t block)
+{
+    return xQueueSend(_filled, &block, portMAX_DELAY) == pdTRUE; // room for all blocks, does not wait
+}
+
+bool OtaWriter::waitWriter()
+{
+    unsigned long start = millis();
+    while (uxQueueMessagesWaiting(_free) < OTA_WRITER_BLOCKS)
+    {
+        if (millis() - start > OTA_WRITER_TIMEOUT)
+        {
+            return fail("flash write timeout");
+        }
+        delay(1);
+    }
+    return true;
+}
+
+bool OtaWriter::fail(const char *error)
+{
+    if (!_error)
+    {
+        _error = error;
+        ESP_LOGE("OtaWriter", "Firmware update failed: %s", error);
+    }
+    return false;
+}
+
+void OtaWriter::stop()
+{
+    if (_task)
+    {
+        _stop = true;
+        while (_task) // the task clears it when it stops
+        {
+            delay(1);
+        }
+    }
+    if (_blocks)
+    {
+        mbedtls_sha256_free(&_sha);
+    }
+    if (_free)
+    {
+        vQueueDelete(_free);
+    }
+    if (_filled)
+    {
+        vQueueDelete(_filled);
+    }
+    free(_blocks);
+    _blocks = nullptr;
+    _free = _filled = nullptr;
+    _current = -1;
+}
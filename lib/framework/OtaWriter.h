@@ -0,0 +1,76 @@
+#ifndef OtaWriter_h
+#define OtaWriter_h
+
+/**
+ *   ESP32 SvelteKit
+ *
+ *   A simple, secure and extensible framework for IoT projects for ESP32 platforms
+ *   with responsive Sveltekit front-end built with TailwindCSS and DaisyUI.
+ *   https://github.com/theelims/ESP32-sveltekit
+ *
+ *   Copyright (C) 2018 - 2023 rjwats
+ *   Copyright (C) 2023 - 2024 theelims
+ *
+ *   All Rights Reserved. This software may be modified and distributed under
+ *   the terms of the LGPL v3 license. See the LICENSE file for details.
+ **/
+
+#include <Arduino.h>
+#include <Update.h>
+#include <mbedtls/sha256.h>
+
+#define OTA_WRITER_BLOCK_SIZE SPI_FLASH_SEC_SIZE // one erase + write per block
+#ifndef OTA_WRITER_BLOCKS
+#define OTA_WRITER_BLOCKS 4
+#endif
+#define OTA_WRITER_STACK_SIZE 4096
+#define OTA_WRITER_TIMEOUT 10000 // ms write() waits for a free block
+
+/**
+ * Writes a firmware image with Update from a writer task, so receiving (httpd or download task) and flash erase / write
+ * overlap. write() copies into sector sized blocks of a ring of OTA_WRITER_BLOCKS, full blocks are queued to the writer
+ * task, which writes them with Update (sector aligned: Update erases and writes each block at once) and hashes them.
+ * write() only waits when all blocks are queued, that is when the flash is slower than the network.
+ * Update verifies the MD5 (if set) incrementally, the writer the SHA-256 of the image (if given to end()).
+ */
+class OtaWriter
+{
+public:
+    ~OtaWriter();
+
+    bool begin(size_t size, const char *md5 = nullptr); // see Update.begin, Update.setMD5
+    bool write(const uint8_t *data, size_t len);        // false: see error(), call abort()
+    // writes the last block, waits for the writer and verifies; evenIfRemaining: see Update.end
+    bool end(bool evenIfRemaining = false, const uint8_t *sha256 = nullptr);
+    void abort();
+
+    const char *error() { return _error; }
+    size_t written() { return _written; }
+    String sha256(); // of the written image, after end()
+    float mbps();    // from begin to end (or now), MB/s
+
+private:
+    uint8_t *_blocks = nullptr; // OTA_WRITER_BLOCKS x OTA_WRITER_BLOCK_SIZE
+    size_t _lengths[OTA_WRITER_BLOCKS];
+    QueueHandle_t _free = nullptr;   // block indexes write() can fill
+    QueueHandle_t _filled = nullptr; // block indexes for the writer task
+    TaskHandle_t _task = nullptr;
+    volatile bool _stop = false;
+    bool _updating = false; // Update began by this writer
+    int _current = -1; // block write() fills
+    size_t _written = 0;
+    mbedtls_sha256_context _sha;
+    uint8_t _digest[32];
+    bool _digestValid = false;
+    uint32_t _startMicros = 0;
+    uint32_t _endMicros = 0;
+    const char *volatile _error = nullptr;
+
+    static void writerTask(void *parameter);
+    bool queue(uint8_t block);
+    bool waitWriter(); // until the queued blocks are written
+    bool fail(const char *error);
+    void stop();
+};
+
+#endif // end OtaWriter_h
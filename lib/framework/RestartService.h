@@ -20,6 +20,7 @@
 #include <ESPmDNS.h>
 #include <PsychicHttp.h>
 #include <SecurityManager.h>
+#include <StateDispatcher.h>
 
 #define RESTART_SERVICE_PATH "/rest/restart"
 
@@ -30,18 +31,23 @@ public:
 
     void begin();
 
-    static void restartNow()
+    // flushState: the queued file system writes (FSPersistence) are done first, not after a factory reset
+    static void restartNow(bool flushState = true)
     {
         xTaskCreate(
             [](void *pvParams) {
                 delay(250);
+                if (pvParams)
+                {
+                    stateDispatcher.flush(HandlerContext::BACKGROUND, 3000 / portTICK_PERIOD_MS);
+                }
                 MDNS.end();
                 delay(100);
                 WiFi.disconnect(true);
                 delay(500);
                 ESP.restart();
             },
-            "Restart task", 4096, nullptr, 10, nullptr);
+            "Restart task", 4096, flushState ? (void *)1 : nullptr, 10, nullptr);
     }
 
 private:
@@ -0,0 +1,156 @@
+/**
+ *   ESP32 SvelteKit
+ *
+ *   A simple, secure and extensible framework for IoT projects for ESP32 platforms
+ *   with responsive Sveltekit front-end built with TailwindCSS and DaisyUI.
+ *   https://github.com/theelims/ESP32-sveltekit
+ *
+ *   Copyright (C) 2018 - 2023 rjwats
+ *   Copyright (C) 2023 - 2024 theelims
+ *
+ *   All Rights Reserved. This software may be modified and distributed under
+ *   the terms of the LGPL v3 license. See the LICENSE file for details.
+ **/
+
+#include <StateDispatcher.h>
+
+StateDispatcher stateDispatcher; // see .h
+
+StateDispatcher::StateDispatcher() : _mutex(xSemaphoreCreateMutex())
+{
+}
+
+void StateDispatcher::dispatch(const std::shared_ptr<deferred_handler_t> &handler, const String &originId)
+{
+    Queue &queue = _queues[handler->context == HandlerContext::BACKGROUND ? 1 : 0];
+    bool notify = false;
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (!queue.task && !startTask(handler->context))
+    {
+        xSemaphoreGive(_mutex);
+        handler->cb(originId); // no task: run inline rather than lose the update
+        return;
+    }
+
+    // a queued call of another origin is not merged into: it would get "" and be echoed to the client it came from
+    bool queued = false;
+    for (const Call &call : queue.calls)
+    {
+        if (call.handler == handler && call.originId == originId)
+        {
+            queued = true;
+            break;
+        }
+    }
+    if (queued)
+    {
+        // still queued: runs once with the latest state
+        _coalesced++;
+    }
+    else
+    {
+        queue.calls.push_back({handler, originId});
+        _dispatched++;
+        if (queue.calls.size() > _maxQueued)
+        {
+            _maxQueued = queue.calls.size();
+        }
+        notify = true;
+    }
+    xSemaphoreGive(_mutex);
+
+    if (notify)
+    {
+        xTaskNotifyGive(queue.task);
+    }
+}
+
+void StateDispatcher::remove(const std::shared_ptr<deferred_handler_t> &handler)
+{
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    handler->removed = true; // a queued handler is skipped, the queue keeps it alive until then
+    xSemaphoreGive(_mutex);
+}
+
+bool StateDispatcher::flush(HandlerContext context, TickType_t timeout)
+{
+    Queue &queue = _queues[context == HandlerContext::BACKGROUND ? 1 : 0];
+    TickType_t start = xTaskGetTickCount();
+    for (;;)
+    {
+        xSemaphoreTake(_mutex, portMAX_DELAY);
+        bool idle = queue.calls.empty() && !queue.running;
+        xSemaphoreGive(_mutex);
+        if (idle)
+        {
+            return true;
+        }
+        if (xTaskGetTickCount() - start >= timeout)
+        {
+            ESP_LOGW("StateDispatcher", "%d handlers still queued", queue.calls.size());
+            return false;
+        }
+        vTaskDelay(10 / portTICK_PERIOD_MS);
+    }
+}
+
+void StateDispatcher::read(JsonObject &root)
+{
+    root["dispatched"] = _dispatched;
+    root["coalesced"] = _coalesced;
+    root["max_queued"] = _maxQueued;
+}
+
+bool StateDispatcher::startTask(HandlerContext context)
+{
+    bool background = context == HandlerContext::BACKGROUND;
+    Queue &queue = _queues[background ? 1 : 0];
+    // not on the core of the loop task, which renders the effects
+    if (xTaskCreateUniversal(dispatchTask,
+                             background ? "StateBackground" : "StateNetwork",
+                             background ? STATE_DISPATCH_BACKGROUND_STACK_SIZE : STATE_DISPATCH_NETWORK_STACK_SIZE,
+                             &queue,
+                             background ? STATE_DISPATCH_BACKGROUND_PRIORITY : STATE_DISPATCH_NETWORK_PRIORITY,
+                             &queue.task,
+                             ARDUINO_RUNNING_CORE == 0 ? 1 : 0) != pdPASS)
+    {
+        ESP_LOGE("StateDispatcher", "Could not start the %s dispatch task", background ? "background" : "network");
+        queue.task = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void StateDispatcher::dispatchTask(void *parameter)
+{
+    Queue *queue = (Queue *)parameter;
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        for (;;)
+        {
+            Call call;
+            bool removed = true;
+            xSemaphoreTake(stateDispatcher._mutex, portMAX_DELAY);
+            queue->running = false;
+            if (!queue->calls.empty())
+            {
+                call = std::move(queue->calls.front());
+                queue->calls.pop_front();
+                // taken off before the call: an update while it runs queues it again
+                removed = call.handler->removed;
+                queue->running = true;
+            }
+            xSemaphoreGive(stateDispatcher._mutex);
+            if (!call.handler)
+            {
+                break;
+            }
+
+            if (!removed)
+            {
+                call.handler->cb(call.originId);
+            }
+        }
+    }
+}
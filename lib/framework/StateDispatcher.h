@@ -0,0 +1,93 @@
+#ifndef StateDispatcher_h
+#define StateDispatcher_h
+
+/**
+ *   ESP32 SvelteKit
+ *
+ *   A simple, secure and extensible framework for IoT projects for ESP32 platforms
+ *   with responsive Sveltekit front-end built with TailwindCSS and DaisyUI.
+ *   https://github.com/theelims/ESP32-sveltekit
+ *
+ *   Copyright (C) 2018 - 2023 rjwats
+ *   Copyright (C) 2023 - 2024 theelims
+ *
+ *   All Rights Reserved. This software may be modified and distributed under
+ *   the terms of the LGPL v3 license. See the LICENSE file for details.
+ **/
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#define STATE_DISPATCH_NETWORK_STACK_SIZE 6144
+#define STATE_DISPATCH_BACKGROUND_STACK_SIZE 8192 // file system persistence
+#define STATE_DISPATCH_NETWORK_PRIORITY 5         // as the http server
+#define STATE_DISPATCH_BACKGROUND_PRIORITY 1
+
+// Where an update handler of a StatefulService runs
+enum class HandlerContext
+{
+    INLINE = 0, // on the thread calling update(), before update() returns
+    NETWORK,    // on the network dispatch task: WebSocket, EventSocket and MQTT propagation
+    BACKGROUND  // on the low priority background task: file system persistence
+};
+
+typedef struct
+{
+    std::function<void(const String &originId)> cb;
+    HandlerContext context;
+    bool removed = false; // removed from its service while queued
+} deferred_handler_t;
+
+/**
+ * Runs the update handlers registered with HandlerContext::NETWORK or BACKGROUND on a task per context, so update()
+ * returns in bounded time whatever the handlers do. Notifications are coalesced per handler and origin: a handler
+ * which is still queued for the same origin is not queued again, it runs once with the latest state (handlers read
+ * the state when they run). An update of another origin is queued as a call of its own, so endpoints still know
+ * which client not to echo it to. A handler is queued at most once per origin. The tasks are started on the first dispatch.
+ */
+class StateDispatcher
+{
+public:
+    StateDispatcher();
+
+    void dispatch(const std::shared_ptr<deferred_handler_t> &handler, const String &originId);
+    void remove(const std::shared_ptr<deferred_handler_t> &handler);
+    // waits until the handlers queued for context ran, e.g. the file system writes before a restart,
+    // false on timeout. Not from the dispatch task of context itself
+    bool flush(HandlerContext context, TickType_t timeout);
+
+    void read(JsonObject &root);
+
+private:
+    struct Call
+    {
+        std::shared_ptr<deferred_handler_t> handler;
+        String originId;
+    };
+
+    struct Queue
+    {
+        std::deque<Call> calls;
+        TaskHandle_t task = nullptr;
+        bool running = false; // a call taken from calls has not returned yet
+    };
+
+    Queue _queues[2]; // NETWORK, BACKGROUND
+    SemaphoreHandle_t _mutex; // queues and the removed flags
+    uint32_t _dispatched = 0;
+    uint32_t _coalesced = 0;
+    uint32_t _maxQueued = 0;
+
+    bool startTask(HandlerContext context);
+    static void dispatchTask(void *parameter);
+};
+
+extern StateDispatcher stateDispatcher;
+
+#endif // end StateDispatcher_h
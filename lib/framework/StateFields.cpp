@@ -0,0 +1,430 @@
+/**
+ *   ESP32 SvelteKit
+ *
+ *   A simple, secure and extensible framework for IoT projects for ESP32 platforms
+ *   with responsive Sveltekit front-end built with TailwindCSS and DaisyUI.
+ *   https://github.com/theelims/ESP32-sveltekit
+ *
+ *   Copyright (C) 2018 - 2023 rjwats
+ *   Copyright (C) 2023 - 2024 theelims
+ *
+ *   All Rights Reserved. This software may be modified and distributed under
+ *   the terms of the LGPL v3 license. See the LICENSE file for details.
+ **/
+
+#include <StateFields.h>
+#include <string.h>
+
+static const uint8_t fieldSizes[] = {1, 1, 2, 4, 4, 4}; // by FieldType
+
+static uint32_t hashKey(const char *key, uint32_t hash = 2166136261u)
+{
+    while (*key)
+    {
+        hash = (hash ^ (uint8_t)*key++) * 16777619u;
+    }
+    return hash;
+}
+
+template <typename V>
+static uint32_t assign(void *field, V value, uint32_t bit)
+{
+    if (*(V *)field == value)
+    {
+        return 0;
+    }
+    *(V *)field = value;
+    return bit;
+}
+
+static uint32_t assign(const state_field_t &field, JsonVariant value, void *state, uint32_t bit)
+{
+    void *p = (uint8_t *)state + field.offset;
+    switch (field.type)
+    {
+    case FieldType::BOOL:
+        return assign(p, value.as<bool>(), bit);
+    case FieldType::UINT8:
+        return assign(p, value.as<uint8_t>(), bit);
+    case FieldType::UINT16:
+        return assign(p, value.as<uint16_t>(), bit);
+    case FieldType::UINT32:
+        return assign(p, value.as<uint32_t>(), bit);
+    case FieldType::INT32:
+        return assign(p, value.as<int32_t>(), bit);
+    case FieldType::FLOAT:
+        return assign(p, value.as<float>(), bit);
+    }
+    return 0;
+}
+
+static void readField(const state_field_t &field, const void *state, JsonObject &object, const char *key)
+{
+    const void *p = (const uint8_t *)state + field.offset;
+    switch (field.type)
+    {
+    case FieldType::BOOL:
+        object[key] = *(const bool *)p;
+        break;
+    case FieldType::UINT8:
+        object[key] = *(const uint8_t *)p;
+        break;
+    case FieldType::UINT16:
+        object[key] = *(const uint16_t *)p;
+        break;
+    case FieldType::UINT32:
+        object[key] = *(const uint32_t *)p;
+        break;
+    case FieldType::INT32:
+        object[key] = *(const int32_t *)p;
+        break;
+    case FieldType::FLOAT:
+        object[key] = *(const float *)p;
+        break;
+    }
+}
+
+void StateFields::read(const void *state, JsonObject &root) const
+{
+    JsonObject group;
+    const char *groupName = nullptr; // of group
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        const state_field_t &field = _fields[i];
+        if (!field.groupLength)
+        {
+            readField(field, state, root, field.name);
+            continue;
+        }
+        if (!groupName || memcmp(groupName, field.name, field.groupLength + 1))
+        {
+            char name[32];
+            size_t len = field.groupLength < sizeof(name) ? field.groupLength : sizeof(name) - 1;
+            memcpy(name, field.name, len);
+            name[len] = '\0';
+            // a char * key is copied, ArduinoJson 7 may keep a const char * or char array key by pointer
+            group = root[(char *)name].to<JsonObject>();
+            groupName = field.name;
+        }
+        readField(field, state, group, field.name + field.groupLength + 1);
+    }
+}
+
+int StateFields::find(uint32_t hash, const char *key) const
+{
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        const state_field_t &field = _fields[i];
+        // the hash covers the group, the name is compared to rule out a collision
+        if (field.hash == hash && !strcmp(field.name + (field.groupLength ? field.groupLength + 1 : 0), key))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+uint32_t StateFields::update(JsonObject &root, void *state) const
+{
+    uint32_t changed = 0;
+    for (JsonPair pair : root)
+    {
+        const char *key = pair.key().c_str();
+        JsonVariant value = pair.value();
+        if (value.is<JsonObject>())
+        {
+            uint32_t groupHash = hashKey(".", hashKey(key));
+            for (JsonPair member : value.as<JsonObject>())
+            {
+                const char *memberKey = member.key().c_str();
+                int i = find(hashKey(memberKey, groupHash), memberKey);
+                if (i >= 0)
+                {
+                    changed |= assign(_fields[i], member.value(), state, 1u << i);
+                }
+            }
+            continue;
+        }
+        int i = find(hashKey(key), key);
+        if (i >= 0)
+        {
+            changed |= assign(_fields[i], value, state, 1u << i);
+        }
+    }
+    return changed;
+}
+
+uint32_t StateFields::diff(const void *state, const void *other) const
+{
+    uint32_t changed = 0;
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        const state_field_t &field = _fields[i];
+        if (memcmp((const uint8_t *)state + field.offset, (const uint8_t *)other + field.offset, fieldSizes[(uint8_t)field.type]))
+        {
+            changed |= 1u << i;
+        }
+    }
+    return changed;
+}
+
+// MsgPack
+
+class MsgPackWriter
+{
+public:
+    MsgPackWriter(uint8_t *buffer, size_t size) : _p(buffer), _end(buffer + size) {}
+
+    bool overflow = false;
+
+    void byte(uint8_t b)
+    {
+        if (_p < _end)
+        {
+            *_p++ = b;
+        }
+        else
+        {
+            overflow = true;
+        }
+    }
+
+    void bigEndian(uint32_t value, uint8_t bytes)
+    {
+        while (bytes--)
+        {
+            byte(value >> (bytes * 8));
+        }
+    }
+
+    void map(uint8_t size)
+    {
+        if (size < 16)
+        {
+            byte(0x80 | size);
+        }
+        else
+        {
+            byte(0xDE);
+            bigEndian(size, 2);
+        }
+    }
+
+    void string(const char *string, size_t len)
+    {
+        if (len < 32)
+        {
+            byte(0xA0 | len);
+        }
+        else
+        {
+            byte(0xD9);
+            byte(len);
+        }
+        for (size_t i = 0; i < len; i++)
+        {
+            byte(string[i]);
+        }
+    }
+
+    void unsignedInt(uint32_t value)
+    {
+        if (value < 0x80)
+        {
+            byte(value);
+        }
+        else if (value <= UINT8_MAX)
+        {
+            byte(0xCC);
+            byte(value);
+        }
+        else if (value <= UINT16_MAX)
+        {
+            byte(0xCD);
+            bigEndian(value, 2);
+        }
+        else
+        {
+            byte(0xCE);
+            bigEndian(value, 4);
+        }
+    }
+
+    void signedInt(int32_t value)
+    {
+        if (value >= 0)
+        {
+            unsignedInt(value);
+        }
+        else if (value >= -32)
+        {
+            byte((uint8_t)value);
+        }
+        else if (value >= INT8_MIN)
+        {
+            byte(0xD0);
+            byte((uint8_t)value);
+        }
+        else if (value >= INT16_MIN)
+        {
+            byte(0xD1);
+            bigEndian((uint16_t)value, 2);
+        }
+        else
+        {
+            byte(0xD2);
+            bigEndian((uint32_t)value, 4);
+        }
+    }
+
+    void value(const state_field_t &field, const void *state)
+    {
+        const void *p = (const uint8_t *)state + field.offset;
+        switch (field.type)
+        {
+        case FieldType::BOOL:
+            byte(*(const bool *)p ? 0xC3 : 0xC2);
+            break;
+        case FieldType::UINT8:
+            unsignedInt(*(const uint8_t *)p);
+            break;
+        case FieldType::UINT16:
+            unsignedInt(*(const uint16_t *)p);
+            break;
+        case FieldType::UINT32:
+            unsignedInt(*(const uint32_t *)p);
+            break;
+        case FieldType::INT32:
+            signedInt(*(const int32_t *)p);
+            break;
+        case FieldType::FLOAT:
+        {
+            uint32_t bits;
+            memcpy(&bits, p, sizeof(bits));
+            byte(0xCA);
+            bigEndian(bits, 4);
+            break;
+        }
+        }
+    }
+
+    size_t written(uint8_t *buffer) { return overflow ? 0 : _p - buffer; }
+
+private:
+    uint8_t *_p;
+    uint8_t *_end;
+};
+
+size_t StateFields::writeMsgPack(const void *state, uint8_t *buffer, size_t size) const
+{
+    // entries of the root map: fields and nested objects
+    uint8_t entries = 0;
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        const state_field_t &field = _fields[i];
+        if (!field.groupLength || !i || memcmp(_fields[i - 1].name, field.name, field.groupLength + 1))
+        {
+            entries++;
+        }
+    }
+
+    MsgPackWriter writer(buffer, size);
+    writer.map(entries);
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        const state_field_t &field = _fields[i];
+        if (field.groupLength)
+        {
+            if (!i || memcmp(_fields[i - 1].name, field.name, field.groupLength + 1))
+            {
+                uint8_t members = 0;
+                while (i + members < _count && !memcmp(_fields[i + members].name, field.name, field.groupLength + 1))
+                {
+                    members++;
+                }
+                writer.string(field.name, field.groupLength);
+                writer.map(members);
+            }
+            writer.string(field.name + field.groupLength + 1, strlen(field.name) - field.groupLength - 1);
+        }
+        else
+        {
+            writer.string(field.name, strlen(field.name));
+        }
+        writer.value(field, state);
+    }
+    return writer.written(buffer);
+}
+
+// binary
+
+size_t StateFields::binarySize(uint32_t mask) const
+{
+    size_t size = sizeof(uint32_t);
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        if (mask & (1u << i))
+        {
+            size += fieldSizes[(uint8_t)_fields[i].type];
+        }
+    }
+    return size;
+}
+
+size_t StateFields::writeBinary(const void *state, uint8_t *buffer, size_t size, uint32_t mask) const
+{
+    mask &= all();
+    size_t len = binarySize(mask);
+    if (len > size)
+    {
+        return 0;
+    }
+    memcpy(buffer, &mask, sizeof(mask)); // the ESP32 is little endian
+    uint8_t *p = buffer + sizeof(mask);
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        if (mask & (1u << i))
+        {
+            uint8_t fieldSize = fieldSizes[(uint8_t)_fields[i].type];
+            memcpy(p, (const uint8_t *)state + _fields[i].offset, fieldSize);
+            p += fieldSize;
+        }
+    }
+    return len;
+}
+
+uint32_t StateFields::readBinary(const uint8_t *buffer, size_t len, void *state) const
+{
+    uint32_t mask;
+    if (len < sizeof(mask))
+    {
+        return 0;
+    }
+    memcpy(&mask, buffer, sizeof(mask));
+    if ((mask & ~all()) || binarySize(mask) != len)
+    {
+        return 0;
+    }
+
+    uint32_t changed = 0;
+    const uint8_t *p = buffer + sizeof(mask);
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        if (mask & (1u << i))
+        {
+            uint8_t *field = (uint8_t *)state + _fields[i].offset;
+            uint8_t fieldSize = fieldSizes[(uint8_t)_fields[i].type];
+            if (_fields[i].type == FieldType::BOOL)
+            {
+                changed |= assign(field, *p != 0, 1u << i); // any other byte than 0 or 1 is not a bool
+            }
+            else if (memcmp(field, p, fieldSize))
+            {
+                memcpy(field, p, fieldSize);
+                changed |= 1u << i;
+            }
+            p += fieldSize;
+        }
+    }
+    return changed;
+}
@@ -0,0 +1,159 @@
+#ifndef StateFields_h
+#define StateFields_h
+
+/**
+ *   ESP32 SvelteKit
+ *
+ *   A simple, secure and extensible framework for IoT projects for ESP32 platforms
+ *   with responsive Sveltekit front-end built with TailwindCSS and DaisyUI.
+ *   https://github.com/theelims/ESP32-sveltekit
+ *
+ *   Copyright (C) 2018 - 2023 rjwats
+ *   Copyright (C) 2023 - 2024 theelims
+ *
+ *   All Rights Reserved. This software may be modified and distributed under
+ *   the terms of the LGPL v3 license. See the LICENSE file for details.
+ **/
+
+#include <ArduinoJson.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+
+#define STATE_FIELDS_MAX 32 // one bit per field in a changed mask
+
+enum class FieldType : uint8_t
+{
+    BOOL = 0,
+    UINT8,
+    UINT16,
+    UINT32,
+    INT32,
+    FLOAT
+};
+
+template <typename V>
+struct StateFieldType;
+template <>
+struct StateFieldType<bool>
+{
+    static constexpr FieldType type = FieldType::BOOL;
+};
+template <>
+struct StateFieldType<uint8_t>
+{
+    static constexpr FieldType type = FieldType::UINT8;
+};
+template <>
+struct StateFieldType<uint16_t>
+{
+    static constexpr FieldType type = FieldType::UINT16;
+};
+template <>
+struct StateFieldType<uint32_t>
+{
+    static constexpr FieldType type = FieldType::UINT32;
+};
+template <>
+struct StateFieldType<int32_t>
+{
+    static constexpr FieldType type = FieldType::INT32;
+};
+template <>
+struct StateFieldType<float>
+{
+    static constexpr FieldType type = FieldType::FLOAT;
+};
+
+// FNV-1a, the same at compile time (field names) and run time (json keys)
+constexpr uint32_t fieldHash(const char *name, uint32_t hash = 2166136261u)
+{
+    return *name ? fieldHash(name + 1, (hash ^ (uint8_t)*name) * 16777619u) : hash;
+}
+
+// length of group in "group.name", 0 if the field is not nested
+constexpr uint8_t fieldGroupLength(const char *name, uint8_t i = 0)
+{
+    return !name[i] ? 0 : name[i] == '.' ? i : fieldGroupLength(name, i + 1);
+}
+
+constexpr bool fieldInGroup(const char *name, const char *group)
+{
+    return !*group ? *name == '.' : *name == *group && fieldInGroup(name + 1, group + 1);
+}
+
+typedef struct
+{
+    const char *name;    // json key, "group.name" for a member of a nested object
+    uint32_t hash;       // fieldHash(name)
+    uint16_t offset;     // in the state
+    FieldType type;
+    uint8_t groupLength; // see fieldGroupLength
+} state_field_t;
+
+// a member of State, its name is the json key; nested members (slice.x) are written as a nested object
+#define STATE_FIELD(State, member) STATE_FIELD_AS(State, member, #member)
+// a member of State with another json key
+#define STATE_FIELD_AS(State, member, key)                                                                           \
+    {                                                                                                                \
+        key, fieldHash(key), offsetof(State, member),                                                                \
+            StateFieldType<std::remove_reference<decltype(std::declval<State &>().member)>::type>::type,           \
+            fieldGroupLength(key)                                                                                    \
+    }
+
+/**
+ * Reflection of a state from one declaration, a constexpr table of its fields:
+ *
+ *   constexpr state_field_t lightStateFieldList[] = {STATE_FIELD_AS(LightState, ledOn, "led_on")};
+ *   constexpr StateFields lightStateFields(lightStateFieldList);
+ *
+ * Generates the json read and update of the state, the changed fields of an update as a bitmask (bit i is field i,
+ * bit() and groupBits() give them at compile time), MsgPack and a compact binary encoding. update() walks the json
+ * object once and finds fields by the hash of their key, instead of a lookup per field. Members of a nested object
+ * must be declared one after another. Fields missing in the json are left unchanged.
+ */
+class StateFields
+{
+public:
+    template <size_t N>
+    constexpr StateFields(const state_field_t (&fields)[N]) : _fields(fields), _count(N)
+    {
+        static_assert(N <= STATE_FIELDS_MAX, "a changed mask has a bit per field");
+    }
+
+    constexpr uint8_t count() const { return _count; }
+
+    constexpr uint32_t bit(const char *name, uint8_t i = 0) const
+    {
+        return i >= _count ? 0 : _fields[i].hash == fieldHash(name) ? 1u << i : bit(name, i + 1);
+    }
+
+    constexpr uint32_t groupBits(const char *group, uint8_t i = 0) const
+    {
+        return i >= _count ? 0 : (fieldInGroup(_fields[i].name, group) ? 1u << i : 0) | groupBits(group, i + 1);
+    }
+
+    constexpr uint32_t all() const { return _count == 32 ? UINT32_MAX : (1u << _count) - 1; }
+
+    void read(const void *state, JsonObject &root) const;
+    uint32_t update(JsonObject &root, void *state) const;     // changed fields
+    uint32_t diff(const void *state, const void *other) const; // differing fields
+
+    // 0 if buffer is too small
+    size_t writeMsgPack(const void *state, uint8_t *buffer, size_t size) const;
+
+    // the fields of mask: little endian uint32 mask, then the values in declaration order, 0 if buffer is too small
+    size_t binarySize(uint32_t mask = UINT32_MAX) const;
+    size_t writeBinary(const void *state, uint8_t *buffer, size_t size, uint32_t mask = UINT32_MAX) const;
+    uint32_t readBinary(const uint8_t *buffer, size_t len, void *state) const; // changed fields, 0 if invalid
+
+private:
+    const state_field_t *_fields;
+    uint8_t _count;
+
+    int find(uint32_t hash, const char *key) const;
+};
+
+#endif // end StateFields_h
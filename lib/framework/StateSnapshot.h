@@ -0,0 +1,81 @@
+#ifndef StateSnapshot_h
+#define StateSnapshot_h
+
+/**
+ *   ESP32 SvelteKit
+ *
+ *   A simple, secure and extensible framework for IoT projects for ESP32 platforms
+ *   with responsive Sveltekit front-end built with TailwindCSS and DaisyUI.
+ *   https://github.com/theelims/ESP32-sveltekit
+ *
+ *   Copyright (C) 2018 - 2023 rjwats
+ *   Copyright (C) 2023 - 2024 theelims
+ *
+ *   All Rights Reserved. This software may be modified and distributed under
+ *   the terms of the LGPL v3 license. See the LICENSE file for details.
+ **/
+
+#include <atomic>
+#include <string.h>
+#include <type_traits>
+
+/**
+ * Copy of a trivially copyable state which readers get without a lock, for readers which must not block behind a writer
+ * (the render loop). Writers publish into two slots in turn, each slot guarded by a sequence number (a seqlock), and
+ * then make the slot they wrote the latest. A reader copies the latest slot and retries if that slot was written while
+ * it copied, which takes two publishes during one copy of a few bytes. A writer never writes the latest slot, so a
+ * reader never waits for a writer which is preempted halfway.
+ * publish() must not be called concurrently: StatefulService calls it holding its access mutex.
+ */
+template <typename T>
+class StateSnapshot
+{
+public:
+    void publish(const T &state)
+    {
+        uint32_t version = _version.load(std::memory_order_relaxed) + 1;
+        Slot &slot = _slots[version & 1];
+        uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed); // odd: being written
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy((void *)&slot.state, &state, sizeof(T));
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+        _version.store(version, std::memory_order_release);
+    }
+
+    void read(T &state) const
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "StateSnapshot needs a trivially copyable state");
+        for (;;)
+        {
+            const Slot &slot = _slots[_version.load(std::memory_order_acquire) & 1];
+            uint32_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (!(sequence & 1))
+            {
+                memcpy((void *)&state, &slot.state, sizeof(T));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) == sequence)
+                {
+                    return;
+                }
+            }
+            _retries.fetch_add(1, std::memory_order_relaxed); // the other slot is the latest now
+        }
+    }
+
+    uint32_t version() const { return _version.load(std::memory_order_relaxed); } // number of publishes
+    uint32_t retries() const { return _retries.load(std::memory_order_relaxed); }  // reads which copied twice or more
+
+private:
+    struct Slot
+    {
+        std::atomic<uint32_t> sequence{0};
+        T state;
+    };
+
+    Slot _slots[2];
+    std::atomic<uint32_t> _version{0}; // the latest slot is _slots[_version & 1]
+    mutable std::atomic<uint32_t> _retries{0};
+};
+
+#endif // end StateSnapshot_h
@@ -20,9 +20,13 @@
 
 #include <list>
 #include <functional>
+#include <memory>
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
 
+#include <StateDispatcher.h>
+#include <StateSnapshot.h>
+
 enum class StateUpdateResult
 {
     CHANGED = 0, // The update changed the state and propagation should take place if required
@@ -47,7 +51,16 @@ typedef struct StateUpdateHandlerInfo
     update_handler_id_t _id;
     StateUpdateCallback _cb;
     bool _allowRemove;
-    StateUpdateHandlerInfo(StateUpdateCallback cb, bool allowRemove) : _id(++currentUpdatedHandlerId), _cb(cb), _allowRemove(allowRemove){};
+    std::shared_ptr<deferred_handler_t> _deferred; // NETWORK and BACKGROUND handlers, see StateDispatcher
+    StateUpdateHandlerInfo(StateUpdateCallback cb, bool allowRemove, HandlerContext context) : _id(++currentUpdatedHandlerId), _cb(cb), _allowRemove(allowRemove)
+    {
+        if (context != HandlerContext::INLINE)
+        {
+            _deferred = std::make_shared<deferred_handler_t>();
+            _deferred->cb = cb;
+            _deferred->context = context;
+        }
+    };
 } StateUpdateHandlerInfo_t;
 
 typedef struct StateHookHandlerInfo
@@ -68,13 +81,14 @@ public:
     {
     }
 
-    update_handler_id_t addUpdateHandler(StateUpdateCallback cb, bool allowRemove = true)
+    // context: where the handler runs, NETWORK and BACKGROUND handlers run after update() returned, see StateDispatcher
+    update_handler_id_t addUpdateHandler(StateUpdateCallback cb, bool allowRemove = true, HandlerContext context = HandlerContext::INLINE)
     {
         if (!cb)
         {
             return 0;
         }
-        StateUpdateHandlerInfo_t updateHandler(cb, allowRemove);
+        StateUpdateHandlerInfo_t updateHandler(cb, allowRemove, context);
         _updateHandlers.push_back(updateHandler);
         return updateHandler._id;
     }
@@ -85,6 +99,10 @@ public:
         {
             if ((*i)._allowRemove && (*i)._id == id)
             {
+                if ((*i)._deferred)
+                {
+                    stateDispatcher.remove((*i)._deferred);
+                }
                 i = _updateHandlers.erase(i);
             }
             else
@@ -124,6 +142,7 @@ public:
     {
         beginTransaction();
         StateUpdateResult result = stateUpdater(_state);
+        publishSnapshot(result);
         endTransaction();
         callHookHandlers(originId, result);
         if (result == StateUpdateResult::CHANGED)
@@ -137,6 +156,7 @@ public:
     {
         beginTransaction();
         StateUpdateResult result = stateUpdater(_state);
+        publishSnapshot(result);
         endTransaction();
         return result;
     }
@@ -145,6 +165,7 @@ public:
     {
         beginTransaction();
         StateUpdateResult result = stateUpdater(jsonObject, _state);
+        publishSnapshot(result);
         endTransaction();
         callHookHandlers(originId, result);
         if (result == StateUpdateResult::CHANGED)
@@ -158,6 +179,7 @@ public:
     {
         beginTransaction();
         StateUpdateResult result = stateUpdater(jsonObject, _state);
+        publishSnapshot(result);
         endTransaction();
         return result;
     }
@@ -176,11 +198,47 @@ public:
         endTransaction();
     }
 
+    // Readers which must not block behind a writer (the render loop) can read a snapshot of the state instead, which
+    // every update publishes, see StateSnapshot. Only for trivially copyable states, enable it before the first update.
+    void enableSnapshot()
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "a snapshot needs a trivially copyable state");
+        beginTransaction();
+        if (!_snapshot)
+        {
+            _snapshot = new StateSnapshot<T>();
+            _snapshot->publish(_state);
+        }
+        endTransaction();
+    }
+
+    // without a lock if the snapshot is enabled
+    void readSnapshot(T &state)
+    {
+        if (_snapshot)
+        {
+            _snapshot->read(state);
+        }
+        else
+        {
+            beginTransaction();
+            state = _state;
+            endTransaction();
+        }
+    }
+
     void callUpdateHandlers(const String &originId)
     {
         for (const StateUpdateHandlerInfo_t &updateHandler : _updateHandlers)
         {
-            updateHandler._cb(originId);
+            if (updateHandler._deferred)
+            {
+                stateDispatcher.dispatch(updateHandler._deferred, originId);
+            }
+            else
+            {
+                updateHandler._cb(originId);
+            }
         }
     }
 
@@ -205,8 +263,18 @@ protected:
         xSemaphoreGiveRecursive(_accessMutex);
     }
 
+    // call in a transaction, after changing _state other than with update()
+    inline void publishSnapshot(StateUpdateResult result = StateUpdateResult::CHANGED)
+    {
+        if (_snapshot && result != StateUpdateResult::ERROR)
+        {
+            _snapshot->publish(_state);
+        }
+    }
+
 private:
     SemaphoreHandle_t _accessMutex;
+    StateSnapshot<T> *_snapshot = nullptr;
     std::list<StateUpdateHandlerInfo_t> _updateHandlers;
     std::list<StateHookHandlerInfo_t> _hookHandlers;
 };
@@ -13,6 +13,8 @@
  **/
 
 #include <SystemStatus.h>
+#include <DeltaUpdate.h>
+#include <StateDispatcher.h>
 #include <esp32-hal.h>
 
 #if CONFIG_IDF_TARGET_ESP32 // ESP32/PICO-D4
@@ -134,6 +136,7 @@ esp_err_t SystemStatus::systemStatus(PsychicRequest *request)
     root["total_heap"] = ESP.getHeapSize();
     root["min_free_heap"] = ESP.getMinFreeHeap();
     root["sketch_size"] = ESP.getSketchSize();
+    root["firmware_sha256"] = DeltaUpdate::runningSha256(); // the base a delta update must be made against
     root["free_sketch_space"] = ESP.getFreeSketchSpace();
     root["sdk_version"] = ESP.getSdkVersion();
     root["arduino_version"] = ARDUINO_VERSION;
@@ -141,8 +144,35 @@ esp_err_t SystemStatus::systemStatus(PsychicRequest *request)
     root["flash_chip_speed"] = ESP.getFlashChipSpeed();
     root["fs_total"] = ESPFS.totalBytes();
     root["fs_used"] = ESPFS.usedBytes();
+    JsonObject stateDispatch = root["state_dispatch"].to<JsonObject>(); // deferred update handlers
+    stateDispatcher.read(stateDispatch);
     root["core_temp"] = temperatureRead();
     root["cpu_reset_reason"] = verbosePrintResetReason(rtc_get_reset_reason(0));
+    sockets(_server, root);
 
     return response.send();
 }
+
+void SystemStatus::sockets(PsychicHttpServer *server, JsonObject &root)
+{
+    PsychicConnectionStats &stats = server->connectionStats;
+    root["sockets_open"] = stats.open;
+    root["sockets_ws"] = stats.webSockets;
+    root["sockets_clients"] = stats.clients;
+    root["sockets_max"] = server->config.max_open_sockets;
+    root["sockets_peak"] = stats.peak;
+    root["sockets_accepted"] = stats.accepted;
+    root["sockets_evicted"] = stats.evictedIdle + stats.evictedQuota + stats.evictedPressure;
+
+    if (server->secure())
+    {
+        PsychicTlsStats &tls = server->tlsStats;
+        root["tls_key"] = tls.keyType;
+        root["tls_full"] = tls.full;
+        root["tls_resumed"] = tls.resumed;
+        root["tls_failed"] = tls.failed;
+        root["tls_full_ms"] = tls.full ? (uint32_t)(tls.fullMicros / tls.full / 1000) : 0;
+        root["tls_resumed_ms"] = tls.resumed ? (uint32_t)(tls.resumedMicros / tls.resumed / 1000) : 0;
+        root["tls_max_ms"] = tls.maxMicros / 1000;
+    }
+}
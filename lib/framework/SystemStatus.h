@@ -32,6 +32,9 @@ public:
 
     void begin();
 
+    // http socket usage of the connection manager, also added to the analytics event
+    static void sockets(PsychicHttpServer *server, JsonObject &root);
+
 private:
     PsychicHttpServer *_server;
     SecurityManager *_securityManager;
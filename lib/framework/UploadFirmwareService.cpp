@@ -80,6 +80,16 @@ esp_err_t UploadFirmwareService::handleUpload(PsychicRequest *request,
             }
             return ESP_OK;
         }
+        else if (extension == DELTA_EXTENSION)
+        {
+            // the delta is checked against the running firmware when its header is in, Update begins then
+            fileType = ft_delta;
+            md5[0] = '\0';
+            if (!_delta.begin())
+            {
+                return handleError(request, 507); // Insufficient Storage
+            }
+        }
         else
         {
             md5[0] = '\0';
@@ -110,16 +120,10 @@ esp_err_t UploadFirmwareService::handleUpload(PsychicRequest *request,
                 return handleError(request, 503); // service unavailable
             }
 #endif
-            // it's firmware - initialize the ArduinoOTA updater
-            if (Update.begin(fsize - sizeof(esp_image_header_t)))
-            {
-                if (strlen(md5) == 32)
-                {
-                    Update.setMD5(md5);
-                    md5[0] = '\0';
-                }
-            }
-            else
+            // it's firmware - initialize the ArduinoOTA updater through the writer task
+            bool begun = _writer.begin(fsize - sizeof(esp_image_header_t), md5);
+            md5[0] = '\0';
+            if (!begun)
             {
                 return handleError(request, 507); // failed to begin, send an error response Insufficient Storage
             }
@@ -129,16 +133,22 @@ esp_err_t UploadFirmwareService::handleUpload(PsychicRequest *request,
     // if we haven't delt with an error, continue with the firmware update
     if (!request->_tempObject)
     {
-        if (Update.write(data, len) != len)
-        {
-            handleError(request, 500);
-        }
-        if (final)
+        if (fileType == ft_delta)
         {
-            if (!Update.end(true))
+            if (!_delta.write(data, len) || (final && !_delta.end()))
             {
-                handleError(request, 500);
+                // 409 Conflict: the delta is not made for the running firmware, upload the full image
+                int code = _delta.baseMismatch() ? 409 : 500;
+                _delta.abort();
+                return handleError(request, code);
             }
+            return ESP_OK;
+        }
+
+        if (!_writer.write(data, len) || (final && !_writer.end(true)))
+        {
+            _writer.abort();
+            handleError(request, 500);
         }
     }
 
@@ -163,7 +173,13 @@ esp_err_t UploadFirmwareService::uploadComplete(PsychicRequest *request)
     // if no error, send the success response
     if (!request->_tempObject)
     {
-        request->reply(200);
+        OtaWriter &writer = fileType == ft_delta ? _delta.writer() : _writer;
+        PsychicJsonResponse response = PsychicJsonResponse(request, false);
+        JsonObject root = response.getRoot();
+        root["size"] = writer.written();
+        root["sha256"] = writer.sha256();
+        root["mbps"] = writer.mbps();
+        response.send();
         RestartService::restartNow();
         return ESP_OK;
     }
@@ -194,12 +210,8 @@ esp_err_t UploadFirmwareService::handleError(PsychicRequest *request, int code)
 
 esp_err_t UploadFirmwareService::handleEarlyDisconnect()
 {
-    // if updated has not ended on connection close, abort it
-    if (!Update.end(true))
-    {
-        Update.printError(Serial);
-        Update.abort();
-        return ESP_OK;
-    }
+    // if updated has not ended on connection close, abort it: the writers abort only an update they began
+    _writer.abort();
+    _delta.abort();
     return ESP_OK;
 }
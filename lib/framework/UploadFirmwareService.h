@@ -23,6 +23,8 @@
 #include <PsychicHttp.h>
 #include <SecurityManager.h>
 #include <RestartService.h>
+#include <DeltaUpdate.h>
+#include <OtaWriter.h>
 
 #define UPLOAD_FIRMWARE_PATH "/rest/uploadFirmware"
 
@@ -30,7 +32,8 @@ enum FileType
 {
     ft_none = 0,
     ft_firmware = 1,
-    ft_md5 = 2
+    ft_md5 = 2,
+    ft_delta = 3 // .mld, see DeltaUpdate.h
 };
 
 class UploadFirmwareService
@@ -43,6 +46,8 @@ public:
 private:
     PsychicHttpServer *_server;
     SecurityManager *_securityManager;
+    OtaWriter _writer; // flash writes overlap receiving the next chunks
+    DeltaUpdate _delta;
 
     esp_err_t handleUpload(PsychicRequest *request,
                            const String &filename,
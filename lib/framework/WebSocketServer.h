@@ -43,7 +43,7 @@ public:
         _statefulService->addUpdateHandler(
             [&](const String &originId)
             { transmitData(nullptr, originId); },
-            false);
+            false, HandlerContext::NETWORK);
     }
 
     void begin()
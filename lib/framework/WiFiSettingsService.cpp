@@ -22,7 +22,8 @@ WiFiSettingsService::WiFiSettingsService(PsychicHttpServer *server,
                                                                 _httpEndpoint(WiFiSettings::read, WiFiSettings::update, this, server, WIFI_SETTINGS_SERVICE_PATH, securityManager,
                                                                               AuthenticationPredicates::IS_ADMIN),
                                                                 _fsPersistence(WiFiSettings::read, WiFiSettings::update, this, fs, WIFI_SETTINGS_FILE), _lastConnectionAttempt(0),
-                                                                _socket(socket)
+                                                                _socket(socket),
+                                                                _fs(fs)
 {
     addUpdateHandler([&](const String &originId)
                      { reconfigureWiFiConnection(); },
@@ -42,8 +43,11 @@ void WiFiSettingsService::initWiFi()
         WiFiEvent_t::ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
     WiFi.onEvent(std::bind(&WiFiSettingsService::onStationModeStop, this, std::placeholders::_1, std::placeholders::_2),
                  WiFiEvent_t::ARDUINO_EVENT_WIFI_STA_STOP);
+    WiFi.onEvent(std::bind(&WiFiSettingsService::onStationModeGotIP, this, std::placeholders::_1, std::placeholders::_2),
+                 WiFiEvent_t::ARDUINO_EVENT_WIFI_STA_GOT_IP);
 
     _fsPersistence.readFromFS();
+    readFastConnect();
     reconfigureWiFiConnection();
 }
 
@@ -95,6 +99,24 @@ void WiFiSettingsService::loop()
         manageSTA();
     }
 
+    // directed connect did not succeed in time: forget it and scan
+    if (_fastConnecting && !WiFi.isConnected() && (unsigned long)(currentMillis - _connectStart) >= WIFI_FAST_CONNECT_TIMEOUT)
+    {
+        ESP_LOGW("WiFiSettingsService", "Fast connect timed out, scanning");
+        _fastConnecting = false;
+        portENTER_CRITICAL(&_fastConnectMux);
+        _fastConnectValid = false;
+        _fastConnectSave = true;
+        portEXIT_CRITICAL(&_fastConnectMux);
+        wifiConnectStats.fastFailures++;
+        if (WiFi.disconnect(true))
+        {
+            _stopping = true;
+        }
+    }
+
+    writeFastConnect();
+
     if (!_lastRssiUpdate || (unsigned long)(currentMillis - _lastRssiUpdate) >= RSSI_EVENT_DELAY)
     {
         _lastRssiUpdate = currentMillis;
@@ -121,12 +143,118 @@ void WiFiSettingsService::manageSTA()
 #ifdef SERIAL_INFO
         Serial.println("Connecting to WiFi...");
 #endif
-        connectToWiFi();
+        if (!fastConnect())
+        {
+            connectToWiFi();
+        }
+    }
+}
+
+bool WiFiSettingsService::fastConnect()
+{
+    portENTER_CRITICAL(&_fastConnectMux);
+    wifi_fast_connect_t cached = _fastConnect;
+    bool valid = _fastConnectValid;
+    portEXIT_CRITICAL(&_fastConnectMux);
+    if (!valid)
+    {
+        return false;
+    }
+
+    for (auto &network : _state.wifiSettings)
+    {
+        if (network.ssid.equals(cached.ssid))
+        {
+            ESP_LOGI("WiFiSettingsService", "Fast connect to %s, BSSID: " MACSTR ", Channel: %d", network.ssid.c_str(), MAC2STR(cached.bssid), cached.channel);
+            memcpy(network.bssid, cached.bssid, 6);
+            network.channel = cached.channel;
+            _fastConnecting = true;
+            _connectStart = millis();
+
+#if WIFI_FAST_CONNECT_LEASE
+            if (!network.staticIPConfig && cached.localIP)
+            {
+                wifi_settings_t lease = network;
+                lease.staticIPConfig = true;
+                lease.localIP = cached.localIP;
+                lease.gatewayIP = cached.gatewayIP;
+                lease.subnetMask = cached.subnetMask;
+                lease.dnsIP1 = cached.dnsIP1;
+                lease.dnsIP2 = cached.dnsIP2;
+                configureNetwork(lease);
+                return true;
+            }
+#endif
+            configureNetwork(network);
+            return true;
+        }
+    }
+
+    // the cached network is not configured anymore
+    portENTER_CRITICAL(&_fastConnectMux);
+    _fastConnectValid = false;
+    _fastConnectSave = true;
+    portEXIT_CRITICAL(&_fastConnectMux);
+    return false;
+}
+
+void WiFiSettingsService::readFastConnect()
+{
+    if (!_fs->exists(WIFI_FAST_CONNECT_FILE))
+    {
+        return;
+    }
+    // a file of the former layout (ssid[32]) is too short and dropped: one scan, then it is rewritten
+    wifi_fast_connect_t fastConnect = {};
+    bool valid = false;
+    File file = _fs->open(WIFI_FAST_CONNECT_FILE, "r");
+    if (file)
+    {
+        valid = file.read((uint8_t *)&fastConnect, sizeof(fastConnect)) == sizeof(fastConnect) &&
+                fastConnect.magic == WIFI_FAST_CONNECT_MAGIC && !fastConnect.ssid[sizeof(fastConnect.ssid) - 1];
+        file.close();
+    }
+    portENTER_CRITICAL(&_fastConnectMux);
+    _fastConnect = fastConnect;
+    _fastConnectValid = valid;
+    portEXIT_CRITICAL(&_fastConnectMux);
+    ESP_LOGV("WiFiSettingsService", "Fast connect cache %s", valid ? fastConnect.ssid : "invalid");
+}
+
+void WiFiSettingsService::writeFastConnect()
+{
+    // take the connection the event task handed over, the file is written without holding the event task up
+    portENTER_CRITICAL(&_fastConnectMux);
+    bool save = _fastConnectSave;
+    bool valid = _fastConnectValid;
+    wifi_fast_connect_t fastConnect = _fastConnect;
+    _fastConnectSave = false;
+    portEXIT_CRITICAL(&_fastConnectMux);
+    if (!save)
+    {
+        return;
+    }
+
+    if (!valid)
+    {
+        if (_fs->exists(WIFI_FAST_CONNECT_FILE))
+        {
+            _fs->remove(WIFI_FAST_CONNECT_FILE);
+        }
+        return;
+    }
+    File file = _fs->open(WIFI_FAST_CONNECT_FILE, "w");
+    if (file)
+    {
+        file.write((const uint8_t *)&fastConnect, sizeof(fastConnect));
+        file.close();
     }
 }
 
 void WiFiSettingsService::connectToWiFi()
 {
+    _connectStart = millis(); // includes the scan
+
     // reset availability flag for all stored networks
     for (auto &network : _state.wifiSettings)
     {
@@ -249,6 +377,18 @@ void WiFiSettingsService::updateRSSI()
 
 void WiFiSettingsService::onStationModeDisconnected(WiFiEvent_t event, WiFiEventInfo_t info)
 {
+    // directed connect failed (e.g. the AP moved to another channel): forget it and scan right away
+    if (_fastConnecting)
+    {
+        ESP_LOGW("WiFiSettingsService", "Fast connect failed, reason %d, scanning", info.wifi_sta_disconnected.reason);
+        _fastConnecting = false;
+        portENTER_CRITICAL(&_fastConnectMux);
+        _fastConnectValid = false;
+        _fastConnectSave = true;
+        portEXIT_CRITICAL(&_fastConnectMux);
+        wifiConnectStats.fastFailures++;
+        _stopping = true;
+    }
     WiFi.disconnect(true);
 }
 
@@ -260,3 +400,47 @@ void WiFiSettingsService::onStationModeStop(WiFiEvent_t event, WiFiEventInfo_t i
         _stopping = false;
     }
 }
+
+void WiFiSettingsService::onStationModeGotIP(WiFiEvent_t event, WiFiEventInfo_t info)
+{
+    unsigned long now = millis();
+    wifiConnectStats.lastConnect = now - _connectStart;
+    wifiConnectStats.fast = _fastConnecting;
+    if (_fastConnecting)
+    {
+        wifiConnectStats.fastConnects++;
+    }
+    else
+    {
+        wifiConnectStats.scanConnects++;
+    }
+    if (!wifiConnectStats.bootToConnected)
+    {
+        wifiConnectStats.bootToConnected = now;
+        bootProfile.mark("wifi connected");
+    }
+    _fastConnecting = false;
+
+    ESP_LOGI("WiFiSettingsService", "Connected in %d ms (%s), %d ms after boot", wifiConnectStats.lastConnect,
+             wifiConnectStats.fast ? "fast" : "scan", wifiConnectStats.bootToConnected);
+
+    // remember this connection, only written if it differs to spare the flash
+    wifi_fast_connect_t fastConnect = {};
+    fastConnect.magic = WIFI_FAST_CONNECT_MAGIC;
+    strlcpy(fastConnect.ssid, WiFi.SSID().c_str(), sizeof(fastConnect.ssid));
+    memcpy(fastConnect.bssid, WiFi.BSSID(), 6);
+    fastConnect.channel = WiFi.channel();
+    fastConnect.localIP = WiFi.localIP();
+    fastConnect.gatewayIP = WiFi.gatewayIP();
+    fastConnect.subnetMask = WiFi.subnetMask();
+    fastConnect.dnsIP1 = WiFi.dnsIP(0);
+    fastConnect.dnsIP2 = WiFi.dnsIP(1);
+    portENTER_CRITICAL(&_fastConnectMux);
+    if (!_fastConnectValid || memcmp(&fastConnect, &_fastConnect, sizeof(fastConnect)) != 0)
+    {
+        _fastConnect = fastConnect;
+        _fastConnectValid = true;
+        _fastConnectSave = true;
+    }
+    portEXIT_CRITICAL(&_fastConnectMux);
+}
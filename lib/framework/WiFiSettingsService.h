@@ -25,6 +25,8 @@
 #include <JsonUtils.h>
 #include <SecurityManager.h>
 #include <PsychicHttp.h>
+#include <WiFiStatus.h>
+#include <BootProfile.h>
 #include <vector>
 
 #ifndef FACTORY_WIFI_SSID
@@ -47,6 +49,20 @@
 #define WIFI_SETTINGS_SERVICE_PATH "/rest/wifiSettings"
 
 #define WIFI_RECONNECTION_DELAY 1000 * 30
+
+// last good connection, used for a directed connect without scanning
+#define WIFI_FAST_CONNECT_FILE "/config/wifiFastConnect.bin"
+#define WIFI_FAST_CONNECT_MAGIC 0x31434657 // "WFC1"
+
+#ifndef WIFI_FAST_CONNECT_TIMEOUT
+#define WIFI_FAST_CONNECT_TIMEOUT 5000 // fall back to a full scan if not connected within
+#endif
+
+// 1: reuse the last DHCP lease as static config on a fast connect, saves the DHCP round trip
+// but the lease is not renewed, only use it when the router reserves the address
+#ifndef WIFI_FAST_CONNECT_LEASE
+#define WIFI_FAST_CONNECT_LEASE 0
+#endif
 #define RSSI_EVENT_DELAY 500
 
 #define EVENT_RSSI "rssi"
@@ -67,6 +83,19 @@ typedef struct
     bool available;
 } wifi_settings_t;
 
+typedef struct __attribute__((packed))
+{
+    uint32_t magic;
+    char ssid[33]; // 32 characters and the terminator
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint32_t localIP; // the DHCP lease
+    uint32_t gatewayIP;
+    uint32_t subnetMask;
+    uint32_t dnsIP1;
+    uint32_t dnsIP2;
+} wifi_fast_connect_t;
+
 enum class STAConnectionMode
 {
     OFFLINE = 0,
@@ -229,6 +258,20 @@ private:
     bool _stopping;
     void onStationModeDisconnected(WiFiEvent_t event, WiFiEventInfo_t info);
     void onStationModeStop(WiFiEvent_t event, WiFiEventInfo_t info);
+    void onStationModeGotIP(WiFiEvent_t event, WiFiEventInfo_t info);
+
+    // fast connect: _fastConnect, _fastConnectValid and _fastConnectSave are set by the WiFi event task and used by
+    // loop(), both under _fastConnectMux. The file is written from a copy, outside of it
+    FS *_fs;
+    portMUX_TYPE _fastConnectMux = portMUX_INITIALIZER_UNLOCKED;
+    wifi_fast_connect_t _fastConnect = {};
+    bool _fastConnectValid = false;
+    bool _fastConnecting = false;
+    bool _fastConnectSave = false;
+    unsigned long _connectStart = 0;
+    void readFastConnect();
+    void writeFastConnect();
+    bool fastConnect();
 
     void reconfigureWiFiConnection();
     void manageSTA();
@@ -14,6 +14,8 @@
 
 #include <WiFiStatus.h>
 
+WiFiConnectStats wifiConnectStats; // see WiFiStatus.h
+
 WiFiStatus::WiFiStatus(PsychicHttpServer *server,
                        SecurityManager *securityManager) : _server(server),
                                                            _securityManager(securityManager)
@@ -88,6 +90,12 @@ esp_err_t WiFiStatus::wifiStatus(PsychicRequest *request)
             root["dns_ip_2"] = dnsIP2.toString();
         }
     }
+    root["boot_to_connected"] = wifiConnectStats.bootToConnected;
+    root["last_connect"] = wifiConnectStats.lastConnect;
+    root["fast_connect"] = wifiConnectStats.fast;
+    root["fast_connects"] = wifiConnectStats.fastConnects;
+    root["scan_connects"] = wifiConnectStats.scanConnects;
+    root["fast_failures"] = wifiConnectStats.fastFailures;
 
     return response.send();
 }
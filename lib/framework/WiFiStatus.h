@@ -24,6 +24,19 @@
 
 #define WIFI_STATUS_SERVICE_PATH "/rest/wifiStatus"
 
+// Connection timing, filled in by WiFiSettingsService
+struct WiFiConnectStats
+{
+    uint32_t bootToConnected = 0; // ms from boot to the first IP
+    uint32_t lastConnect = 0;     // ms of the last connection attempt until IP
+    bool fast = false;            // last connection used the fast connect cache
+    uint32_t fastConnects = 0;
+    uint32_t scanConnects = 0;
+    uint32_t fastFailures = 0; // fast connects which fell back to a scan
+};
+
+extern WiFiConnectStats wifiConnectStats;
+
 class WiFiStatus
 {
 public:
@@ -0,0 +1,169 @@
+/**
+    @title     MoonLight
+    @file      InstanceProtocol.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#include <InstanceProtocol.h>
+
+void InstanceProtocol::setState(uint8_t field, uint16_t value)
+{
+    uint16_t previous;
+    portENTER_CRITICAL(&_stateMux);
+    switch (field)
+    {
+    case INSTANCE_FIELD_ON:
+        previous = _state.on;
+        _state.on = value;
+        break;
+    case INSTANCE_FIELD_BRIGHTNESS:
+        previous = _state.brightness;
+        _state.brightness = value;
+        break;
+    case INSTANCE_FIELD_EFFECT:
+        previous = _state.effect;
+        _state.effect = value;
+        break;
+    case INSTANCE_FIELD_PROJECTION:
+        previous = _state.projection;
+        _state.projection = value;
+        break;
+    case INSTANCE_FIELD_PRESET:
+        previous = _state.preset;
+        _state.preset = value;
+        break;
+    default:
+        previous = value;
+        break;
+    }
+    if (previous != value)
+        _dirtyFields |= field; //last value wins, sent by the next buildState
+    portEXIT_CRITICAL(&_stateMux);
+}
+
+uint8_t InstanceProtocol::nrOfInstances()
+{
+    uint8_t count = 0;
+    for (Instance &instance : _instances)
+        if (instance.id)
+            count++;
+    return count;
+}
+
+void InstanceProtocol::writeHeader(InstanceHeader &header, InstancePacketType type)
+{
+    header.magic = INSTANCE_MAGIC;
+    header.version = INSTANCE_PROTOCOL_VERSION;
+    header.type = type;
+    header.id = _id;
+    header.boot = _boot;
+    header.seq = ++_seq;
+}
+
+size_t InstanceProtocol::buildBeacon(uint8_t *buffer, const char *name, uint32_t uptime)
+{
+    InstanceBeaconPacket *packet = (InstanceBeaconPacket *)buffer;
+    writeHeader(packet->header, INSTANCE_BEACON);
+    strncpy(packet->name, name ? name : "", sizeof(packet->name) - 1);
+    packet->name[sizeof(packet->name) - 1] = '\0';
+    packet->uptime = uptime;
+    packet->nrOfLeds = _nrOfLeds;
+    return sizeof(InstanceBeaconPacket);
+}
+
+size_t InstanceProtocol::buildState(uint8_t *buffer)
+{
+    InstanceStatePacket *packet = (InstanceStatePacket *)buffer;
+    portENTER_CRITICAL(&_stateMux);
+    packet->fields = _dirtyFields;
+    packet->state = _state;
+    _dirtyFields = 0;
+    portEXIT_CRITICAL(&_stateMux);
+    if (!packet->fields)
+        return 0;
+    writeHeader(packet->header, INSTANCE_STATE);
+    return sizeof(InstanceStatePacket);
+}
+
+bool InstanceProtocol::handlePacket(const uint8_t *buffer, size_t len, uint32_t ip, unsigned long now)
+{
+    if (len < sizeof(InstanceHeader))
+        return false;
+
+    const InstanceHeader *header = (const InstanceHeader *)buffer;
+    if (header->magic != INSTANCE_MAGIC || header->version != INSTANCE_PROTOCOL_VERSION || header->id == _id)
+        return false; //not ours, other version or our own broadcast
+    if (len < (header->type == INSTANCE_BEACON ? sizeof(InstanceBeaconPacket) : header->type == INSTANCE_STATE ? sizeof(InstanceStatePacket) : SIZE_MAX))
+        return false; //truncated or unknown type, before it counts as seen
+
+    Instance *instance = findInstance(header->id, header->type == INSTANCE_BEACON);
+    if (!instance)
+        return false;
+
+    // drop duplicates and reordered packets (seq wraps around), a restarted peer counts from 1 again
+    if (instance->lastSeen && header->boot == instance->boot && (int16_t)(header->seq - instance->lastSeq) <= 0)
+        return false;
+    if (instance->lastSeen && header->boot != instance->boot)
+        ESP_LOGI("InstanceService", "Instance %s (%08x) restarted", instance->name, instance->id);
+
+    instance->boot = header->boot;
+    instance->lastSeq = header->seq;
+    instance->lastSeen = now ? now : 1;
+    instance->ip = ip;
+
+    if (header->type == INSTANCE_BEACON)
+    {
+        const InstanceBeaconPacket *packet = (const InstanceBeaconPacket *)buffer;
+        memcpy(instance->name, packet->name, sizeof(instance->name));
+        instance->name[sizeof(instance->name) - 1] = '\0';
+        instance->uptime = packet->uptime;
+        instance->nrOfLeds = packet->nrOfLeds;
+    }
+    else
+    {
+        const InstanceStatePacket *packet = (const InstanceStatePacket *)buffer;
+        instance->state = packet->state;
+        if (_onState && packet->fields)
+            _onState(*instance, packet->state, packet->fields);
+    }
+
+    return true;
+}
+
+void InstanceProtocol::expire(unsigned long now)
+{
+    for (Instance &instance : _instances)
+    {
+        if (instance.id && now - instance.lastSeen > INSTANCE_TIMEOUT)
+        {
+            ESP_LOGI("InstanceService", "Instance %s (%08x) gone", instance.name, instance.id);
+            instance.id = 0;
+        }
+    }
+}
+
+Instance *InstanceProtocol::findInstance(uint32_t id, bool create)
+{
+    Instance *free = nullptr;
+    for (Instance &instance : _instances)
+    {
+        if (instance.id == id)
+            return &instance;
+        if (!instance.id && !free)
+            free = &instance;
+    }
+    if (!create || !free)
+        return nullptr;
+
+    // only beacons add peers, state from unknown peers is ignored until their beacon arrives
+    *free = Instance();
+    free->id = id;
+    free->name[0] = '\0';
+    free->lastSeen = 0;
+    ESP_LOGI("InstanceService", "Instance %08x found", id);
+    return free;
+}
@@ -0,0 +1,132 @@
+/**
+    @title     MoonLight
+    @file      InstanceProtocol.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#ifndef InstanceProtocol_h
+#define InstanceProtocol_h
+
+#include <Arduino.h>
+#include <functional>
+
+#define INSTANCE_MAGIC 0x4C4D // "ML" little endian
+#define INSTANCE_PROTOCOL_VERSION 2
+#define MAX_INSTANCES 32
+#define INSTANCE_BEACON_INTERVAL 1000
+#define INSTANCE_TIMEOUT (5 * INSTANCE_BEACON_INTERVAL) //dropped from the peer table after 5 missed beacons
+
+// Wire format: packed little endian structs (ESP32 and x86 hosts are both little endian), no JSON.
+enum InstancePacketType : uint8_t
+{
+    INSTANCE_BEACON = 1,
+    INSTANCE_STATE = 2
+};
+
+// bit per field in InstanceStatePacket.fields
+enum InstanceField : uint8_t
+{
+    INSTANCE_FIELD_ON = 1 << 0,
+    INSTANCE_FIELD_BRIGHTNESS = 1 << 1,
+    INSTANCE_FIELD_EFFECT = 1 << 2,
+    INSTANCE_FIELD_PROJECTION = 1 << 3,
+    INSTANCE_FIELD_PRESET = 1 << 4
+};
+
+struct __attribute__((packed)) InstanceHeader
+{
+    uint16_t magic;
+    uint8_t version;
+    uint8_t type;
+    uint32_t id; //sender, derived from the mac address
+    uint16_t boot; //random per boot of the sender, its seq starts again when it changes
+    uint16_t seq;
+};
+
+struct __attribute__((packed)) InstanceBeaconPacket
+{
+    InstanceHeader header;
+    char name[32];
+    uint32_t uptime; //seconds
+    uint16_t nrOfLeds;
+};
+
+struct __attribute__((packed)) InstanceState
+{
+    uint8_t on;
+    uint8_t brightness;
+    uint16_t effect;
+    uint16_t projection;
+    uint16_t preset;
+};
+
+struct __attribute__((packed)) InstanceStatePacket
+{
+    InstanceHeader header;
+    uint8_t fields; //InstanceField bits of the values which changed
+    InstanceState state;
+};
+
+struct Instance
+{
+    uint32_t id = 0; //0: free slot
+    uint32_t ip = 0;
+    char name[32];
+    uint32_t uptime;
+    uint16_t nrOfLeds;
+    uint16_t boot;
+    uint16_t lastSeq;
+    unsigned long lastSeen;
+    InstanceState state;
+};
+
+typedef std::function<void(const Instance &sender, const InstanceState &state, uint8_t fields)> InstanceStateCallback;
+
+// Packets and peer table without transport: InstanceService sends and receives them over UDP,
+// the host tests run several instances in one process.
+class InstanceProtocol
+{
+public:
+    // queue a state change for broadcast, multiple changes before the next buildState go out as one packet
+    // any task: the state is guarded by a spinlock
+    void setState(uint8_t field, uint16_t value);
+    void setNrOfLeds(uint16_t nrOfLeds) { _nrOfLeds = nrOfLeds; }
+    void onState(InstanceStateCallback callback) { _onState = callback; }
+
+    uint8_t nrOfInstances();
+    const Instance *instances() { return _instances; }
+
+    size_t buildBeacon(uint8_t *buffer, const char *name, uint32_t uptime);
+    size_t buildState(uint8_t *buffer); //0 if no state changed
+    bool handlePacket(const uint8_t *buffer, size_t len, uint32_t ip, unsigned long now);
+    void expire(unsigned long now);
+
+    uint32_t id() { return _id; }
+    void setId(uint32_t id, uint16_t boot)
+    {
+        _id = id;
+        _boot = boot;
+    }
+
+protected:
+    uint32_t _id = 0;
+    uint16_t _boot = 0;
+    uint16_t _seq = 0;
+    Instance _instances[MAX_INSTANCES];
+
+    InstanceState _state = {};
+    uint16_t _nrOfLeds = 0;
+    uint8_t _dirtyFields = 0;
+    portMUX_TYPE _stateMux = portMUX_INITIALIZER_UNLOCKED; //_state and _dirtyFields, set by update handlers of other tasks
+
+    InstanceStateCallback _onState;
+
+    Instance *findInstance(uint32_t id, bool create);
+    void writeHeader(InstanceHeader &header, InstancePacketType type);
+};
+
+#endif
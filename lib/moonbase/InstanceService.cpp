@@ -0,0 +1,111 @@
+/**
+    @title     MoonLight
+    @file      InstanceService.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#include <InstanceService.h>
+
+InstanceService::InstanceService(PsychicHttpServer *server,
+                                 ESP32SvelteKit *sveltekit) : _server(server),
+                                                              _securityManager(sveltekit->getSecurityManager())
+{
+}
+
+void InstanceService::begin()
+{
+    // the 3 device specific bytes of the mac address (mac[0] is the lowest byte of the efuse), the top byte folds in the
+    // vendor bytes. The first 4 bytes would only differ in one byte between devices of the same vendor
+    uint64_t mac = ESP.getEfuseMac();
+    uint32_t id = (uint32_t)(mac >> 24) & 0xFFFFFF;
+    id |= (uint32_t)(uint8_t)(mac ^ mac >> 8 ^ mac >> 16) << 24;
+    setId(id ? id : 1, esp_random());
+
+    _server->on(INSTANCES_SERVICE_PATH,
+                HTTP_GET,
+                _securityManager->wrapRequest(std::bind(&InstanceService::getInstances, this, std::placeholders::_1),
+                                              AuthenticationPredicates::IS_AUTHENTICATED));
+
+    ESP_LOGV("InstanceService", "Registered GET endpoint: %s", INSTANCES_SERVICE_PATH);
+}
+
+void InstanceService::loop()
+{
+    if (!WiFi.isConnected())
+    {
+        _udpStarted = false;
+        return;
+    }
+    if (!_udpStarted)
+        _udpStarted = _udp.begin(INSTANCE_UDP_PORT);
+
+    unsigned long now = millis();
+
+    // receive into the static buffer, a bounded number of packets per loop
+    for (int i = 0; i < INSTANCE_MAX_PACKETS_PER_LOOP; i++)
+    {
+        int packetSize = _udp.parsePacket();
+        if (packetSize <= 0)
+            break;
+        size_t len = _udp.read(_buffer, sizeof(_buffer));
+        _udp.flush(); //drop what did not fit
+        handlePacket(_buffer, len, (uint32_t)_udp.remoteIP(), now);
+    }
+
+    if (now - _lastStateSent >= INSTANCE_STATE_INTERVAL)
+    {
+        size_t len = buildState(_buffer);
+        if (len)
+        {
+            _lastStateSent = now;
+            send(len);
+        }
+    }
+
+    if (now - _lastBeaconSent >= INSTANCE_BEACON_INTERVAL)
+    {
+        _lastBeaconSent = now;
+        send(buildBeacon(_buffer, WiFi.getHostname(), now / 1000));
+        expire(now);
+    }
+}
+
+void InstanceService::send(size_t len)
+{
+    if (!_udpStarted)
+        return;
+    if (_udp.beginPacket(IPAddress(255, 255, 255, 255), INSTANCE_UDP_PORT))
+    {
+        _udp.write(_buffer, len);
+        _udp.endPacket();
+    }
+}
+
+esp_err_t InstanceService::getInstances(PsychicRequest *request)
+{
+    PsychicJsonResponse response = PsychicJsonResponse(request, false);
+    JsonObject root = response.getRoot();
+
+    unsigned long now = millis();
+    JsonArray instances = root["instances"].to<JsonArray>();
+    for (Instance &instance : _instances)
+    {
+        if (!instance.id)
+            continue;
+        JsonObject object = instances.add<JsonObject>();
+        object["id"] = instance.id;
+        object["name"] = instance.name;
+        object["ip"] = IPAddress(instance.ip).toString();
+        object["uptime"] = instance.uptime;
+        object["nrOfLeds"] = instance.nrOfLeds;
+        object["lastSeen"] = now - instance.lastSeen;
+        object["brightness"] = instance.state.brightness;
+        object["effect"] = instance.state.effect;
+    }
+
+    return response.send();
+}
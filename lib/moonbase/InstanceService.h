@@ -0,0 +1,50 @@
+/**
+    @title     MoonLight
+    @file      InstanceService.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#ifndef InstanceService_h
+#define InstanceService_h
+
+#include <WiFiUdp.h>
+#include <PsychicHttp.h>
+#include <ESP32SvelteKit.h>
+#include <InstanceProtocol.h>
+
+#define INSTANCES_SERVICE_PATH "/rest/instances"
+#define INSTANCE_UDP_PORT 65506
+#define INSTANCE_ORIGIN_ID "instances"
+
+#define INSTANCE_STATE_INTERVAL 50 //state changes within this time are coalesced in one packet
+#define INSTANCE_MAX_PACKETS_PER_LOOP 8
+
+class InstanceService : public InstanceProtocol
+{
+public:
+    InstanceService(PsychicHttpServer *server, ESP32SvelteKit *sveltekit);
+
+    void begin();
+    void loop(); //call from the main loop, sends beacons and coalesced state, receives and expires peers
+
+private:
+    PsychicHttpServer *_server;
+    SecurityManager *_securityManager;
+    WiFiUDP _udp;
+    bool _udpStarted = false;
+
+    unsigned long _lastStateSent = 0;
+    unsigned long _lastBeaconSent = 0;
+
+    // static buffer for receiving and sending: no heap allocation per packet
+    uint8_t _buffer[MAX(sizeof(InstanceBeaconPacket), sizeof(InstanceStatePacket))];
+
+    void send(size_t len);
+    esp_err_t getInstances(PsychicRequest *request);
+};
+
+#endif
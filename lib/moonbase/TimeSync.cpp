@@ -0,0 +1,118 @@
+/**
+    @title     MoonLight
+    @file      TimeSync.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#include <TimeSync.h>
+
+TimeSync timeSync; //see .h
+
+void TimeSync::begin(PsychicHttpServer *server, ESP32SvelteKit *sveltekit, InstanceService *instanceService)
+{
+    _instanceService = instanceService;
+    _id = instanceService->id();
+
+    if (_udp.listen(TIME_SYNC_UDP_PORT))
+        _udp.onPacket([this](AsyncUDPPacket packet) { onPacket(packet); });
+    else
+        ESP_LOGE("TimeSync", "Listen on port %d failed", TIME_SYNC_UDP_PORT);
+
+    server->on(TIME_SYNC_SERVICE_PATH,
+               HTTP_GET,
+               sveltekit->getSecurityManager()->wrapRequest(std::bind(&TimeSync::getTimeSync, this, std::placeholders::_1),
+                                                            AuthenticationPredicates::IS_AUTHENTICATED));
+
+    ESP_LOGV("TimeSync", "Registered GET endpoint: %s", TIME_SYNC_SERVICE_PATH);
+}
+
+void TimeSync::loop()
+{
+    // the instance with the lowest id is the leader, so all controllers agree without configuration
+    uint32_t leaderId = _id;
+    const Instance *instances = _instanceService->instances();
+    for (uint8_t i = 0; i < MAX_INSTANCES; i++)
+        if (instances[i].id && instances[i].id < leaderId)
+            leaderId = instances[i].id;
+
+    if (leaderId != _leaderId)
+    {
+        ESP_LOGI("TimeSync", "Leader %08x%s", leaderId, leaderId == _id ? " (this instance)" : "");
+        _leaderId = leaderId;
+        setLeader(leaderId == _id);
+        reset(); //other timebase
+    }
+
+    if (_leader && WiFi.isConnected() && ::millis() - _lastBroadcast >= TIME_SYNC_INTERVAL)
+    {
+        _lastBroadcast = ::millis();
+        sendPacket(TIME_SYNC, ++_seq, 0, esp_timer_get_time(), IPAddress(), true);
+    }
+}
+
+// runs in the AsyncUDP task: timestamps are taken on arrival, not when the main loop gets to it
+void TimeSync::onPacket(AsyncUDPPacket &packet)
+{
+    int64_t now = esp_timer_get_time();
+
+    if (packet.length() < sizeof(TimeSyncPacket))
+        return;
+    TimeSyncPacket message;
+    memcpy(&message, packet.data(), sizeof(message));
+    if (message.magic != INSTANCE_MAGIC || message.sender == _id)
+        return;
+
+    switch (message.type)
+    {
+    case TIME_SYNC:
+        if (!_leader && message.sender == _leaderId)
+        {
+            handleSync(message.seq, message.time, now);
+            uint8_t seq;
+            if (delayRequestPending(seq, esp_timer_get_time()))
+                sendPacket(TIME_DELAY_REQ, seq, message.sender, 0, packet.remoteIP(), false);
+        }
+        break;
+    case TIME_DELAY_REQ:
+        if (_leader && message.target == _id)
+            sendPacket(TIME_DELAY_RESP, message.seq, message.sender, now, packet.remoteIP(), false);
+        break;
+    case TIME_DELAY_RESP:
+        if (!_leader && message.target == _id)
+            handleDelayResp(message.seq, message.time);
+        break;
+    }
+}
+
+void TimeSync::sendPacket(TimeSyncPacketType type, uint8_t seq, uint32_t target, int64_t time, IPAddress ip, bool broadcast)
+{
+    TimeSyncPacket message = {INSTANCE_MAGIC, type, seq, _id, target, time};
+    if (broadcast)
+        _udp.broadcastTo((uint8_t *)&message, sizeof(message), TIME_SYNC_UDP_PORT);
+    else
+        _udp.writeTo((uint8_t *)&message, sizeof(message), ip, TIME_SYNC_UDP_PORT);
+}
+
+esp_err_t TimeSync::getTimeSync(PsychicRequest *request)
+{
+    PsychicJsonResponse response = PsychicJsonResponse(request, false);
+    JsonObject root = response.getRoot();
+
+    TimeSyncStats stats = this->stats();
+    root["leader"] = _leaderId;
+    root["isLeader"] = _leader;
+    root["offset_us"] = stats.offset;
+    root["delay_us"] = stats.delay;
+    root["skew_ppm"] = stats.skewPpm;
+    root["jitter_us"] = stats.jitter;
+    root["samples"] = stats.samples;
+    root["rejected"] = stats.rejected;
+    root["lastSync_ms"] = _leader ? 0 : ::millis() - _lastSync;
+    root["synced"] = synced();
+
+    return response.send();
+}
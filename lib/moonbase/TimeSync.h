@@ -0,0 +1,68 @@
+/**
+    @title     MoonLight
+    @file      TimeSync.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#ifndef TimeSync_h
+#define TimeSync_h
+
+#include <Arduino.h>
+#include <AsyncUDP.h>
+#include <PsychicHttp.h>
+#include <ESP32SvelteKit.h>
+#include "InstanceService.h"
+#include "TimeSyncClock.h"
+
+#define TIME_SYNC_SERVICE_PATH "/rest/timeSync"
+#define TIME_SYNC_UDP_PORT 65507
+
+// PTP-lite: the leader broadcasts SYNC (t1), followers answer with DELAY_REQ (t3) which the leader answers with DELAY_RESP (t4).
+// With t2 the follower receive time of SYNC: offset = ((t1 - t2) + (t4 - t3)) / 2 and delay = ((t4 - t3) - (t1 - t2)) / 2.
+// Timestamps are taken in the AsyncUDP callback, samples with a delay well above the window minimum are rejected
+// and offset and skew are the least squares fit of the remaining samples.
+enum TimeSyncPacketType : uint8_t
+{
+    TIME_SYNC = 1,
+    TIME_DELAY_REQ = 2,
+    TIME_DELAY_RESP = 3
+};
+
+struct __attribute__((packed)) TimeSyncPacket
+{
+    uint16_t magic; //INSTANCE_MAGIC
+    uint8_t type;
+    uint8_t seq;
+    uint32_t sender;
+    uint32_t target; //DELAY_RESP: the requester
+    int64_t time;    //SYNC: t1, DELAY_RESP: t4
+};
+
+class TimeSync : public TimeSyncClock
+{
+public:
+    // device, AsyncUDP transport
+    void begin(PsychicHttpServer *server, ESP32SvelteKit *sveltekit, InstanceService *instanceService);
+    void loop(); //leader election and sync broadcast, call from the main loop
+    uint32_t millis() { return globalMicros(esp_timer_get_time()) / 1000; } //synchronized effect clock
+
+private:
+    AsyncUDP _udp;
+    InstanceService *_instanceService = nullptr;
+    uint32_t _id = 0;
+    uint32_t _leaderId = 0;
+    uint8_t _seq = 0;
+    unsigned long _lastBroadcast = 0;
+
+    void onPacket(AsyncUDPPacket &packet);
+    void sendPacket(TimeSyncPacketType type, uint8_t seq, uint32_t target, int64_t time, IPAddress ip, bool broadcast);
+    esp_err_t getTimeSync(PsychicRequest *request);
+};
+
+extern TimeSync timeSync; //used by StarLight effects as synchronized clock
+
+#endif
@@ -0,0 +1,147 @@
+/**
+    @title     MoonLight
+    @file      TimeSyncClock.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#include <TimeSyncClock.h>
+
+void TimeSyncClock::handleSync(uint8_t seq, int64_t t1, int64_t t2)
+{
+    _syncSeq = seq;
+    _t1 = t1;
+    _t2 = t2;
+    _syncReceived = true;
+    _delaySent = false;
+    _lastSync = ::millis();
+}
+
+bool TimeSyncClock::delayRequestPending(uint8_t &seq, int64_t t3)
+{
+    if (!_syncReceived)
+        return false;
+    _syncReceived = false;
+    _delaySent = true;
+    _t3 = t3;
+    seq = _syncSeq;
+    return true;
+}
+
+void TimeSyncClock::handleDelayResp(uint8_t seq, int64_t t4)
+{
+    if (!_delaySent || seq != _syncSeq)
+        return; //late or unexpected response
+    _delaySent = false;
+
+    int64_t offset = ((_t1 - _t2) + (t4 - _t3)) / 2;
+    int32_t delay = ((t4 - _t3) - (_t1 - _t2)) / 2;
+    addSample((_t2 + _t3) / 2, offset, delay);
+}
+
+void TimeSyncClock::reset()
+{
+    portENTER_CRITICAL(&_mux);
+    _nrOfSamples = 0;
+    _nextSample = 0;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void TimeSyncClock::addSample(int64_t local, int64_t offset, int32_t delay)
+{
+    // the window is also reset by the loop task, the fit of 16 samples is short enough for the critical section
+    portENTER_CRITICAL(&_mux);
+
+    // reject samples which were queued somewhere: their delay is well above the best of the window
+    int32_t minDelay = delay;
+    for (uint8_t i = 0; i < _nrOfSamples; i++)
+        minDelay = MIN(minDelay, _samples[i].delay);
+    if (_nrOfSamples >= TIME_SYNC_WINDOW / 2 && delay > 2 * minDelay + 200)
+    {
+        _rejected++;
+        portEXIT_CRITICAL(&_mux);
+        return;
+    }
+
+    _samples[_nextSample] = {local, offset, delay};
+    _nextSample = (_nextSample + 1) % TIME_SYNC_WINDOW;
+    if (_nrOfSamples < TIME_SYNC_WINDOW)
+        _nrOfSamples++;
+    _accepted++;
+
+    fit();
+    portEXIT_CRITICAL(&_mux);
+}
+
+// in the critical section
+void TimeSyncClock::fit()
+{
+    // least squares of offset against local time, relative to the newest sample to keep the numbers small
+    int64_t reference = _samples[(_nextSample + TIME_SYNC_WINDOW - 1) % TIME_SYNC_WINDOW].local;
+    int64_t base = _samples[(_nextSample + TIME_SYNC_WINDOW - 1) % TIME_SYNC_WINDOW].offset;
+
+    double sx = 0, sy = 0;
+    for (uint8_t i = 0; i < _nrOfSamples; i++)
+    {
+        sx += _samples[i].local - reference;
+        sy += _samples[i].offset - base;
+    }
+    double mx = sx / _nrOfSamples, my = sy / _nrOfSamples;
+
+    double sxx = 0, sxy = 0;
+    for (uint8_t i = 0; i < _nrOfSamples; i++)
+    {
+        double dx = _samples[i].local - reference - mx;
+        sxx += dx * dx;
+        sxy += dx * (_samples[i].offset - base - my);
+    }
+    double skew = sxx > 0 ? sxy / sxx : 0;
+    double intercept = my - skew * mx;
+
+    double residuals = 0;
+    int32_t delay = 0;
+    for (uint8_t i = 0; i < _nrOfSamples; i++)
+    {
+        double r = (_samples[i].offset - base) - (intercept + skew * (_samples[i].local - reference));
+        residuals += r * r;
+        delay += _samples[i].delay;
+    }
+
+    _reference = reference;
+    _offset = base + (int64_t)intercept;
+    _skew = _nrOfSamples >= 4 ? skew : 0; //too few samples for a stable slope
+    _jitter = sqrt(residuals / _nrOfSamples);
+    _delay = delay / _nrOfSamples;
+}
+
+int64_t TimeSyncClock::globalMicros(int64_t local)
+{
+    if (_leader)
+        return local;
+    portENTER_CRITICAL(&_mux);
+    int64_t global = _nrOfSamples ? local + _offset + (int64_t)(_skew * (local - _reference)) : local;
+    portEXIT_CRITICAL(&_mux);
+    return global;
+}
+
+TimeSyncStats TimeSyncClock::stats()
+{
+    TimeSyncStats stats;
+    portENTER_CRITICAL(&_mux);
+    stats.offset = _offset;
+    stats.delay = _delay;
+    stats.skewPpm = -_skew * 1000000; //offset shrinks when the local clock runs fast
+    stats.jitter = _jitter;
+    stats.samples = _accepted;
+    stats.rejected = _rejected;
+    portEXIT_CRITICAL(&_mux);
+    return stats;
+}
+
+bool TimeSyncClock::synced()
+{
+    return _leader || (_nrOfSamples && ::millis() - _lastSync < TIME_SYNC_TIMEOUT);
+}
@@ -0,0 +1,82 @@
+/**
+    @title     MoonLight
+    @file      TimeSyncClock.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#ifndef TimeSyncClock_h
+#define TimeSyncClock_h
+
+#include <Arduino.h>
+#include <math.h>
+
+#define TIME_SYNC_INTERVAL 250 //ms between sync packets of the leader
+#define TIME_SYNC_TIMEOUT (8 * TIME_SYNC_INTERVAL) //no sync from the leader: keep free running on the last estimate
+#define TIME_SYNC_WINDOW 16 //samples used to estimate offset and skew
+
+struct TimeSyncStats
+{
+    int64_t offset; //us to add to the local clock
+    int32_t delay;  //us, one way
+    float skewPpm; //local clock rate vs the leader, positive: local runs fast
+    float jitter; //us, rms residual of the fit
+    uint32_t samples;
+    uint32_t rejected;
+};
+
+// Offset and skew estimation of TimeSync without transport, times in us of the local clock.
+// The exchange (handleSync, delayRequestPending, handleDelayResp) runs in one task, globalMicros and stats in any task:
+// the samples and the model are guarded by a spinlock.
+class TimeSyncClock
+{
+public:
+    void setLeader(bool leader) { _leader = leader; }
+    bool isLeader() { return _leader; }
+
+    void handleSync(uint8_t seq, int64_t t1, int64_t t2);
+    bool delayRequestPending(uint8_t &seq, int64_t t3); //call when sending the DELAY_REQ, returns false if no SYNC to answer
+    void handleDelayResp(uint8_t seq, int64_t t4);
+    void reset(); //other timebase: forget the samples
+
+    int64_t globalMicros(int64_t local); //leader timebase
+    TimeSyncStats stats();
+    bool synced(); //leader, or samples of the current leader
+
+protected:
+    struct Sample
+    {
+        int64_t local;
+        int64_t offset;
+        int32_t delay;
+    };
+
+    bool _leader = true;
+    Sample _samples[TIME_SYNC_WINDOW];
+    uint8_t _nrOfSamples = 0;
+    uint8_t _nextSample = 0;
+
+    // pending exchange
+    uint8_t _syncSeq = 0;
+    int64_t _t1 = 0, _t2 = 0, _t3 = 0;
+    bool _syncReceived = false, _delaySent = false;
+
+    // model: offset(local) = _offset + _skew * (local - _reference)
+    int64_t _reference = 0;
+    int64_t _offset = 0;
+    double _skew = 0;
+    float _jitter = 0;
+    int32_t _delay = 0;
+    uint32_t _accepted = 0, _rejected = 0;
+    unsigned long _lastSync = 0;
+
+    portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+
+    void addSample(int64_t local, int64_t offset, int32_t delay);
+    void fit();
+};
+
+#endif
@@ -0,0 +1,246 @@
+/**
+    @title     MoonLight
+    @file      EffectGraph.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/effects/
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#include "EffectGraph.h"
+#include <HeapTrace.h>
+
+EffectGraph effectGraph; //see .h
+
+EffectGraph::~EffectGraph()
+{
+    freeBuffers();
+}
+
+void EffectGraph::configure(const std::vector<NodeSettings> &nodes, uint16_t nrOfLeds)
+{
+    HEAP_TAG("starlight");
+    // node buffers go back to the pool, the pool only needs to go if the fixture size changed
+    for (Node &node : _nodes)
+        release(node.buffer);
+    if (nrOfLeds != _nrOfLeds)
+        freeBuffers();
+    _nrOfLeds = nrOfLeds;
+    _nodes.clear();
+    _output = -1;
+
+    size_t n = MIN(nodes.size(), MAX_NODES);
+    auto find = [&](uint8_t id) -> int8_t {
+        for (size_t i = 0; i < n; i++)
+            if (id && nodes[i].id == id)
+                return i;
+        return -1;
+    };
+
+    int8_t output = -1;
+    for (size_t i = 0; i < n && output < 0; i++)
+        if (nodes[i].type == NODE_OUTPUT && nodes[i].on)
+            output = i;
+    if (output < 0)
+        return;
+
+    // the nodes the output depends on
+    bool needed[MAX_NODES] = {};
+    int8_t stack[MAX_NODES];
+    uint8_t top = 0;
+    stack[top++] = output;
+    needed[output] = true;
+    while (top) {
+        const NodeSettings &node = nodes[stack[--top]];
+        for (uint8_t input : node.inputs) {
+            int8_t i = find(input);
+            if (i >= 0 && !needed[i]) {
+                needed[i] = true;
+                stack[top++] = i;
+            }
+        }
+    }
+
+    // topological order (Kahn): a node is scheduled when all its inputs are
+    int8_t scheduled[MAX_NODES]; //node -> schedule index
+    memset(scheduled, -1, sizeof(scheduled));
+    bool progress = true;
+    while (progress) {
+        progress = false;
+        for (size_t i = 0; i < n; i++) {
+            if (!needed[i] || scheduled[i] >= 0)
+                continue;
+            bool ready = true;
+            for (uint8_t input : nodes[i].inputs) {
+                int8_t j = find(input);
+                if (j >= 0 && scheduled[j] < 0)
+                    ready = false;
+            }
+            if (!ready)
+                continue;
+
+            Node node;
+            node.settings = nodes[i];
+            for (uint8_t k = 0; k < MAX_NODE_INPUTS; k++) {
+                int8_t j = find(nodes[i].inputs[k]);
+                node.inputs[k] = j >= 0 ? scheduled[j] : -1;
+            }
+            scheduled[i] = _nodes.size();
+            _nodes.push_back(node);
+            progress = true;
+        }
+    }
+
+    if (scheduled[output] < 0) {
+        ESP_LOGW("", "EffectGraph: the output depends on a cycle, graph not used");
+        _nodes.clear();
+        return;
+    }
+    _output = scheduled[output];
+
+    for (uint8_t i = 0; i < _nodes.size(); i++)
+        for (int8_t input : _nodes[i].inputs)
+            if (input >= 0)
+                _nodes[input].lastUse = i;
+
+    ESP_LOGI("", "EffectGraph::configure %d of %d nodes scheduled", _nodes.size(), nodes.size());
+}
+
+void EffectGraph::onRender(uint8_t type, NodeRenderer renderer)
+{
+    if (type < NODE_TYPE_COUNT)
+        _renderers[type] = renderer;
+}
+
+bool EffectGraph::render(CRGB *ledsP, uint16_t nrOfLeds)
+{
+    if (_output < 0)
+        return false;
+    if (nrOfLeds != _nrOfLeds) { //new fixture
+        freeBuffers();
+        _nrOfLeds = nrOfLeds;
+        for (Node &node : _nodes)
+            node.dirty = true;
+    }
+
+    uint32_t start = micros();
+    size_t size = nrOfLeds * sizeof(CRGB);
+
+    for (uint8_t i = 0; i < _nodes.size(); i++) {
+        Node &node = _nodes[i];
+        const NodeSettings &settings = node.settings;
+        const CRGB *inputs[MAX_NODE_INPUTS];
+        bool inputsChanged = false;
+        for (uint8_t k = 0; k < MAX_NODE_INPUTS; k++) {
+            inputs[k] = node.inputs[k] >= 0 ? _nodes[node.inputs[k]].buffer : nullptr;
+            if (node.inputs[k] >= 0 && _nodes[node.inputs[k]].changed)
+                inputsChanged = true;
+        }
+
+        uint32_t nodeStart = micros();
+        if (settings.type == NODE_OUTPUT) {
+            layerCompositor.keepFrame(ledsP, nrOfLeds); //the StarLight effect continues from its own frame
+            if (inputs[0])
+                memcpy(ledsP, inputs[0], size);
+            else
+                memset(ledsP, 0, size);
+            node.micros = micros() - nodeStart;
+        } else if (!node.dirty && !inputsChanged && node.buffer && !(settings.type == NODE_EFFECT && settings.on)) {
+            node.changed = false; //cached: same settings, same inputs, same output
+            node.cached = true;
+            node.micros = 0;
+        } else {
+            if (!node.buffer)
+                node.buffer = acquire();
+            if (!node.buffer) {
+                node.changed = false;
+                continue;
+            }
+
+            bool changed = inputsChanged; //all but effects: same inputs, same output
+            if (!settings.on || (settings.type != NODE_BLEND && !_renderers[settings.type])) { //bypassed
+                if (inputs[0])
+                    memcpy(node.buffer, inputs[0], size);
+                else
+                    memset(node.buffer, 0, size);
+            } else if (settings.type == NODE_BLEND) {
+                if (inputs[0])
+                    memcpy(node.buffer, inputs[0], size);
+                else
+                    memset(node.buffer, 0, size);
+                if (inputs[1])
+                    blendLeds(node.buffer, inputs[1], nrOfLeds, settings.opacity, settings.blend);
+            } else {
+                // effects get the frame of loopStar: ledsP until the output node, which comes last
+                bool rendered = _renderers[settings.type](settings, settings.type == NODE_EFFECT ? ledsP : inputs[0], node.buffer, nrOfLeds);
+                if (settings.type == NODE_EFFECT)
+                    changed = rendered;
+            }
+
+            node.changed = changed || node.dirty;
+            node.dirty = false;
+            node.cached = false;
+            node.micros = micros() - nodeStart;
+        }
+
+        // inputs which changed are rerun next frame anyway, their buffers can be reused after the last consumer
+        for (int8_t input : node.inputs)
+            if (input >= 0 && _nodes[input].lastUse == i && _nodes[input].changed)
+                release(_nodes[input].buffer);
+    }
+
+    _renderMicros = micros() - start;
+    _frames++;
+    return true;
+}
+
+CRGB *EffectGraph::acquire()
+{
+    if (!_pool.empty()) {
+        CRGB *buffer = _pool.back();
+        _pool.pop_back();
+        return buffer;
+    }
+    if (_buffers >= MAX_NODES)
+        return nullptr;
+    size_t size = _nrOfLeds * sizeof(CRGB);
+    CRGB *buffer = (CRGB *)(psramFound() ? ps_malloc(size) : malloc(size));
+    if (buffer)
+        _buffers++;
+    else
+        ESP_LOGW("", "EffectGraph: no memory for node buffer of %d leds", _nrOfLeds);
+    return buffer;
+}
+
+void EffectGraph::release(CRGB *&buffer)
+{
+    if (!buffer)
+        return;
+    _pool.push_back(buffer);
+    buffer = nullptr;
+}
+
+void EffectGraph::freeBuffers()
+{
+    for (Node &node : _nodes)
+        release(node.buffer);
+    for (CRGB *buffer : _pool)
+        free(buffer);
+    _pool.clear();
+    _buffers = 0;
+}
+
+void EffectGraph::timing(JsonObject &root)
+{
+    root["total_us"] = _renderMicros;
+    root["buffers"] = _buffers;
+    JsonArray array = root["nodes"].to<JsonArray>();
+    for (Node &node : _nodes) {
+        JsonObject object = array.add<JsonObject>();
+        object["id"] = node.settings.id;
+        object["us"] = node.micros;
+        object["cached"] = node.cached;
+    }
+}
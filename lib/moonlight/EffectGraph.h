@@ -0,0 +1,113 @@
+/**
+    @title     MoonLight
+    @file      EffectGraph.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/effects/
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#ifndef EffectGraph_h
+#define EffectGraph_h
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <FastLED.h>
+#include <functional>
+#include <vector>
+#include "LayerCompositor.h"
+
+#define MAX_NODES 16
+#define MAX_NODE_INPUTS 2
+
+enum NodeType : uint8_t
+{
+    NODE_EFFECT = 0, //renders an effect, no input node, see EffectNodes
+    NODE_MODIFIER,   //modifier on input 0
+    NODE_PROJECTION, //projection of input 0
+    NODE_BLEND,      //input 1 blended on input 0 (opacity, blend)
+    NODE_OUTPUT,     //input 0 to the fixture
+    NODE_TYPE_COUNT
+};
+
+//one node as stored in EffectsState
+struct NodeSettings
+{
+    String name;
+    uint8_t id = 0; //1..255, referred to by inputs, 0: no node
+    uint8_t type = NODE_EFFECT;
+    uint16_t index = UINT16_MAX; //effect, modifier or projection, see EffectNodes
+    uint8_t inputs[MAX_NODE_INPUTS] = {0, 0};
+    uint8_t opacity = UINT8_MAX;
+    uint8_t blend = BLEND_ALPHA;
+    bool on = true;
+
+    bool operator!=(const NodeSettings &other) const
+    {
+        return name != other.name || id != other.id || type != other.type || index != other.index || inputs[0] != other.inputs[0] ||
+               inputs[1] != other.inputs[1] || opacity != other.opacity || blend != other.blend || on != other.on;
+    }
+};
+
+// Renders a node into output (input: output of node input 0, for effects the frame of loopStar).
+// Output is written completely. Effects return false if their frame is the same as in the previous call, so nodes
+// depending only on it are not rerun. Modifiers and projections only depend on their input (return value not used).
+typedef std::function<bool(const NodeSettings &node, const CRGB *input, CRGB *output, uint16_t nrOfLeds)> NodeRenderer;
+
+// Evaluates the effect node graph every frame.
+// configure() keeps the nodes an output node depends on, in topological order (nodes in a cycle are left out).
+// render() runs them in that order: each node writes a buffer from a pool, which goes back to the pool after its last
+// consumer ran. A node whose settings and inputs did not change keeps its buffer and is not rerun (cached), effects
+// always run and report if their frame changed. Effects, modifiers and projections are rendered by the renderers
+// registered with onRender() (EffectNodes), blend and output nodes are built in. A node without a renderer passes its
+// input.
+class EffectGraph
+{
+public:
+    ~EffectGraph();
+
+    // call from the loop task
+    void configure(const std::vector<NodeSettings> &nodes, uint16_t nrOfLeds);
+    void onRender(uint8_t type, NodeRenderer renderer);
+
+    bool active() { return _output >= 0; }
+    // renders the graph into ledsP, false if there is no graph (ledsP unchanged)
+    bool render(CRGB *ledsP, uint16_t nrOfLeds);
+    uint32_t frames() { return _frames; } //rendered by render(), timing() is of the last one
+
+    // per node: id, us (render time, 0 if cached), cached; total_us, buffers
+    void timing(JsonObject &root);
+
+private:
+    struct Node
+    {
+        NodeSettings settings;
+        int8_t inputs[MAX_NODE_INPUTS] = {-1, -1}; //schedule index of input nodes
+        uint8_t lastUse = 0;   //schedule index of the last node using this output
+        CRGB *buffer = nullptr;
+        bool changed = true;   //output changed this frame
+        bool dirty = true;     //settings changed, rerun
+        bool cached = false;
+        uint32_t micros = 0;
+    };
+
+    std::vector<Node> _nodes; //in schedule order
+    int8_t _output = -1;
+    uint16_t _nrOfLeds = 0;
+    NodeRenderer _renderers[NODE_TYPE_COUNT];
+    uint32_t _frames = 0;
+
+    std::vector<CRGB *> _pool; //free buffers
+    uint8_t _buffers = 0;      //allocated buffers
+    uint32_t _renderMicros = 0;
+
+    CRGB *acquire();
+    void release(CRGB *&buffer);
+    void freeBuffers();
+};
+
+extern EffectGraph effectGraph; //EffectsService registers the renderers with onRender
+
+#endif
@@ -0,0 +1,163 @@
+/**
+    @title     MoonLight
+    @file      EffectNodes.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/effects/
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#include "EffectNodes.h"
+
+// hue 0..255 to a fully saturated color, red - green - blue - red
+static CRGB wheel(uint8_t hue)
+{
+    if (hue < 85)
+        return CRGB(255 - hue * 3, hue * 3, 0);
+    if (hue < 170) {
+        hue -= 85;
+        return CRGB(0, 255 - hue * 3, hue * 3);
+    }
+    hue -= 170;
+    return CRGB(hue * 3, 0, 255 - hue * 3);
+}
+
+// 0..255..0 over period ms
+static uint8_t triangle(unsigned long now, uint16_t period)
+{
+    uint32_t t = now % period;
+    return t < period / 2 ? t * 255 / (period / 2) : (period - t) * 255 / (period / 2);
+}
+
+static bool renderEffect(const NodeSettings &node, const CRGB *input, CRGB *output, uint16_t nrOfLeds)
+{
+    unsigned long now = millis();
+    switch (node.index) {
+    case NODE_EFFECT_STARLIGHT:
+        if (input)
+            memcpy(output, input, nrOfLeds * sizeof(CRGB));
+        else
+            memset(output, 0, nrOfLeds * sizeof(CRGB));
+        return true;
+    case NODE_EFFECT_RAINBOW:
+        for (uint16_t i = 0; i < nrOfLeds; i++)
+            output[i] = wheel(i * 256 / nrOfLeds + now / 10);
+        return true;
+    case NODE_EFFECT_DOT: {
+        // bounces from the first to the last led and back in 4 seconds, a few leds wide
+        uint32_t range = nrOfLeds > 1 ? 2 * (nrOfLeds - 1) : 1;
+        uint32_t position = (now % 4000) * range / 4000;
+        if (position >= nrOfLeds)
+            position = range - position;
+        uint16_t width = MAX(nrOfLeds / 32, 1);
+        for (uint16_t i = 0; i < nrOfLeds; i++) {
+            uint16_t distance = i > position ? i - position : position - i;
+            uint8_t level = distance < width ? 255 - distance * 255 / width : 0;
+            output[i] = CRGB(level, level, level);
+        }
+        return true;
+    }
+    case NODE_EFFECT_BREATHE: {
+        uint8_t level = triangle(now, 2000);
+        for (uint16_t i = 0; i < nrOfLeds; i++)
+            output[i] = CRGB(level, 0, level);
+        return true;
+    }
+    case NODE_EFFECT_GRADIENT:
+        for (uint16_t i = 0; i < nrOfLeds; i++) {
+            uint8_t level = nrOfLeds > 1 ? i * 255 / (nrOfLeds - 1) : 0;
+            output[i] = CRGB(255 - level, 0, level);
+        }
+        return false; //the same frame every time: nodes using only this are rendered once
+    case NODE_EFFECT_PLANE: {
+        // front to back and back in 4 seconds: a plane is one range of virtual leds, only its mapped leds are visited.
+        // A 2D fixture has one plane, a row moves then, a 1D fixture one row, a led moves then
+        memset(output, 0, nrOfLeds * sizeof(CRGB));
+        uint32_t slices = mappingTable.depth(), slice = (uint32_t)mappingTable.width() * mappingTable.height();
+        if (slices <= 1) {
+            slices = mappingTable.height();
+            slice = mappingTable.width();
+        }
+        if (slices <= 1) {
+            slices = mappingTable.width();
+            slice = 1;
+        }
+        if (!slices)
+            return true;
+        uint32_t range = slices > 1 ? 2 * (slices - 1) : 1;
+        uint32_t position = (now % 4000) * range / 4000;
+        if (position >= slices)
+            position = range - position;
+        CRGB color = wheel(now / 20);
+        mappingTable.forRange(position * slice, (position + 1) * slice, [&](uint32_t, uint16_t physical) {
+            if (physical < nrOfLeds)
+                output[physical] = color;
+        });
+        return true;
+    }
+    default:
+        memset(output, 0, nrOfLeds * sizeof(CRGB));
+        return false;
+    }
+}
+
+static bool renderModifier(const NodeSettings &node, const CRGB *input, CRGB *output, uint16_t nrOfLeds)
+{
+    if (!input) {
+        memset(output, 0, nrOfLeds * sizeof(CRGB));
+        return false;
+    }
+    switch (node.index) {
+    case NODE_MODIFIER_REVERSE:
+        for (uint16_t i = 0; i < nrOfLeds; i++)
+            output[i] = input[nrOfLeds - 1 - i];
+        break;
+    case NODE_MODIFIER_MIRROR:
+        for (uint16_t i = 0; i < (nrOfLeds + 1) / 2; i++)
+            output[i] = output[nrOfLeds - 1 - i] = input[i];
+        break;
+    case NODE_MODIFIER_BLUR:
+        for (uint16_t i = 0; i < nrOfLeds; i++) {
+            const CRGB &previous = input[i ? i - 1 : i];
+            const CRGB &next = input[i + 1 < nrOfLeds ? i + 1 : i];
+            output[i] = CRGB((previous.r + 2 * input[i].r + next.r) / 4, (previous.g + 2 * input[i].g + next.g) / 4,
+                             (previous.b + 2 * input[i].b + next.b) / 4);
+        }
+        break;
+    default:
+        memcpy(output, input, nrOfLeds * sizeof(CRGB));
+    }
+    return true;
+}
+
+static bool renderProjection(const NodeSettings &node, const CRGB *input, CRGB *output, uint16_t nrOfLeds)
+{
+    if (!input) {
+        memset(output, 0, nrOfLeds * sizeof(CRGB));
+        return false;
+    }
+    switch (node.index) {
+    case NODE_PROJECTION_TILE:
+        for (uint16_t i = 0; i < nrOfLeds; i++)
+            output[i] = input[(2 * (uint32_t)i) % nrOfLeds];
+        break;
+    case NODE_PROJECTION_CENTER: {
+        uint16_t center = nrOfLeds / 2;
+        for (uint16_t i = 0; i < nrOfLeds; i++)
+            output[i] = input[MIN(2 * (uint32_t)(i > center ? i - center : center - i), nrOfLeds - 1U)];
+        break;
+    }
+    default:
+        memcpy(output, input, nrOfLeds * sizeof(CRGB));
+    }
+    return true;
+}
+
+void addNodeRenderers(EffectGraph &graph)
+{
+    graph.onRender(NODE_EFFECT, renderEffect);
+    graph.onRender(NODE_MODIFIER, renderModifier);
+    graph.onRender(NODE_PROJECTION, renderProjection);
+}
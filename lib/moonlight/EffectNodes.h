@@ -0,0 +1,53 @@
+/**
+    @title     MoonLight
+    @file      EffectNodes.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/effects/
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#ifndef EffectNodes_h
+#define EffectNodes_h
+
+#include "EffectGraph.h"
+#include "MappingTable.h"
+
+// index of effect nodes, keep in sync with nodeIndexes in Effects.svelte
+enum NodeEffect : uint16_t
+{
+    NODE_EFFECT_STARLIGHT = 0, //the frame of loopStar: the effect of layer 0, composed
+    NODE_EFFECT_RAINBOW,       //moving rainbow
+    NODE_EFFECT_DOT,           //dot bouncing along the leds
+    NODE_EFFECT_BREATHE,       //all leds fading in and out
+    NODE_EFFECT_GRADIENT,      //static red to blue, rendered once
+    NODE_EFFECT_PLANE,         //plane of the virtual grid moving through the fixture, via mappingTable
+    NODE_EFFECT_COUNT
+};
+
+// index of modifier nodes, keep in sync with nodeIndexes in Effects.svelte
+enum NodeModifier : uint16_t
+{
+    NODE_MODIFIER_REVERSE = 0, //last led first
+    NODE_MODIFIER_MIRROR,      //first half, mirrored onto the second half
+    NODE_MODIFIER_BLUR,        //each led averaged with its neighbours
+    NODE_MODIFIER_COUNT
+};
+
+// index of projection nodes, keep in sync with nodeIndexes in Effects.svelte
+enum NodeProjection : uint16_t
+{
+    NODE_PROJECTION_TILE = 0, //input shrunk to half, shown twice
+    NODE_PROJECTION_CENTER,   //input shrunk to half, from the center outwards
+    NODE_PROJECTION_COUNT
+};
+
+// The renderers of effect, modifier and projection nodes, registered with onRender. They work on the led index and
+// millis(), so they run on any fixture, except Plane which works on the coordinates via mappingTable. An unknown index
+// renders black (effects) or passes its input (modifiers, projections). The StarLight effect renders whatever loopStar
+// made, so a graph can combine the effect of layer 0 with the effects here
+void addNodeRenderers(EffectGraph &graph);
+
+#endif
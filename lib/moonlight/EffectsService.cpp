@@ -10,24 +10,43 @@
 **/
 
 #include <EffectsService.h>
+#include "EffectNodes.h"
 
-#include "Sys/SysModModel.h" // use Variable
+#include "App/LedModFixture.h" // use fix-> (and Variable)
 
 void EffectsState::read(EffectsState &state, JsonObject &root)
 {
     root["effect"] = state.effect;
     root["projection"] = state.projection;
+    root["transition"] = state.transition;
+    root["transitionDuration"] = state.transitionDuration;
 
-    JsonArray array = root["nodes"].to<JsonArray>();
-    JsonObject object = array.add<JsonObject>();
-    object["name"] = "Ripples effect";
-    array.add(object);
-    object["name"] = "Lissajous effect";
-    array.add(object);
-    object["name"] = "Blender";
-    array.add(object);
-    object["name"] = "Game of life";
-    // array.add(object);
+    JsonArray layers = root["layers"].to<JsonArray>();
+    for (LayerSettings &layer : state.layers) {
+        JsonObject object = layers.add<JsonObject>();
+        object["effect"] = layer.effect;
+        object["projection"] = layer.projection;
+        object["opacity"] = layer.opacity;
+        object["blend"] = layer.blend;
+        object["start"] = layer.start;
+        object["end"] = layer.end;
+        object["on"] = layer.on;
+    }
+
+    JsonArray nodes = root["nodes"].to<JsonArray>();
+    for (NodeSettings &node : state.nodes) {
+        JsonObject object = nodes.add<JsonObject>();
+        object["name"] = node.name;
+        object["id"] = node.id;
+        object["type"] = node.type;
+        object["index"] = node.index;
+        JsonArray inputs = object["inputs"].to<JsonArray>();
+        for (uint8_t input : node.inputs)
+            inputs.add(input);
+        object["opacity"] = node.opacity;
+        object["blend"] = node.blend;
+        object["on"] = node.on;
+    }
 }
 
 StateUpdateResult EffectsState::update(JsonObject &root, EffectsState &state)
@@ -36,36 +55,134 @@ StateUpdateResult EffectsState::update(JsonObject &root, EffectsState &state)
 
     ESP_LOGD("", "EffectsState::update");
 
-    if (state.effect != root["effect"]) {
-        state.effect = root["effect"]; changed = true;
+    // layers above 0 would be accepted but not shown, see LayerCompositor
+    if (root["layers"].size() > MAX_LAYERS) {
+        ESP_LOGW("", "Effects.layers max %d layers", MAX_LAYERS);
+        return StateUpdateResult::ERROR;
+    }
 
-        ESP_LOGD("", "Effects.effect.update %d", state.effect);
+    uint8_t transition = MIN(root["transition"] | (uint8_t)TRANSITION_CROSSFADE, TRANSITION_COUNT - 1);
+    uint16_t transitionDuration = root["transitionDuration"] | 1000;
+    bool transitionChanged = transition != state.transition || transitionDuration != state.transitionDuration;
+    if (transitionChanged) {
+        state.transition = transition;
+        state.transitionDuration = transitionDuration;
+        changed = true;
+    }
 
-        runInLoopTask.push_back([&] {
-            // if (!sys->safeMode && false) {
-                ESP_LOGD("", "Effects.effect.update %d call set effect", state.effect);
-                Variable("layers", "effect")[0] = state.effect;
-            // }
-        });
+    // clients not using layers only send effect and projection, the other layers stay
+    std::vector<LayerSettings> layers;
+    if (root["layers"].is<JsonArray>()) {
+        for (JsonObject object : root["layers"].as<JsonArray>()) {
+            LayerSettings layer;
+            layer.effect = object["effect"] | UINT16_MAX;
+            layer.projection = object["projection"] | UINT16_MAX;
+            layer.opacity = object["opacity"] | UINT8_MAX;
+            layer.blend = MIN(object["blend"] | (uint8_t)BLEND_ALPHA, BLEND_COUNT - 1);
+            layer.start = object["start"] | 0;
+            layer.end = object["end"] | UINT16_MAX;
+            layer.on = object["on"] | true;
+            layers.push_back(layer);
+        }
+    } else
+        layers = state.layers;
+    if (layers.empty())
+        layers.push_back(LayerSettings());
+
+    // effect and projection (clients not using layers) apply to layer 0
+    if (root["effect"].is<uint16_t>() && state.effect != root["effect"])
+        layers[0].effect = root["effect"];
+    if (root["projection"].is<uint16_t>() && state.projection != root["projection"])
+        layers[0].projection = root["projection"];
+
+    uint8_t effectRows = 0; //bit per layer which switches effect
+    uint8_t projectionRows = 0;
+    for (uint8_t rowNr = 0; rowNr < layers.size(); rowNr++) {
+        LayerSettings layer = layers[rowNr];
+        LayerSettings current = rowNr < state.layers.size()?state.layers[rowNr]:LayerSettings();
+
+        if (layer.effect != current.effect) {
+            ESP_LOGD("", "Effects.effect.update [%d] %d", rowNr, layer.effect);
+            effectRows |= 1 << rowNr;
+        }
+        if (layer.projection != current.projection) {
+            ESP_LOGD("", "Effects.projection.update [%d] %d", rowNr, layer.projection);
+            projectionRows |= 1 << rowNr;
+        }
+
+        if (layer != current) changed = true;
     }
 
-    if (state.projection != root["projection"]) {
-        state.projection = root["projection"]; changed = true;
+    if (layers.size() != state.layers.size())
+        changed = true;
+
+    std::vector<NodeSettings> nodes;
+    if (root["nodes"].is<JsonArray>()) {
+        for (JsonObject object : root["nodes"].as<JsonArray>()) {
+            if (nodes.size() >= MAX_NODES) {
+                ESP_LOGW("", "Effects.nodes max %d nodes", MAX_NODES);
+                break;
+            }
+            NodeSettings node;
+            node.name = object["name"] | "";
+            node.id = object["id"] | (uint8_t)(nodes.size() + 1);
+            node.type = MIN(object["type"] | (uint8_t)NODE_EFFECT, NODE_TYPE_COUNT - 1);
+            node.index = object["index"] | UINT16_MAX;
+            for (uint8_t k = 0; k < MAX_NODE_INPUTS; k++)
+                node.inputs[k] = object["inputs"][k] | 0;
+            node.opacity = object["opacity"] | UINT8_MAX;
+            node.blend = MIN(object["blend"] | (uint8_t)BLEND_ALPHA, BLEND_COUNT - 1);
+            node.on = object["on"] | true;
+            bool duplicate = false; //inputs refer to ids, the graph would use the first node with it
+            for (const NodeSettings &other : nodes)
+                duplicate |= other.id == node.id;
+            if (duplicate) {
+                ESP_LOGW("", "Effects.nodes duplicate id %d skipped", node.id);
+                continue;
+            }
+            nodes.push_back(node);
+        }
+    } else
+        nodes = state.nodes;
+    bool nodesChanged = nodes.size() != state.nodes.size();
+    for (size_t i = 0; i < nodes.size() && !nodesChanged; i++)
+        nodesChanged = nodes[i] != state.nodes[i];
+    if (nodesChanged) {
+        state.nodes = nodes;
+        changed = true;
+    }
 
-        ESP_LOGD("", "Effects.projection.update %d", state.projection);
+    if (changed) {
+        state.layers = layers;
+        state.effect = layers[0].effect;
+        state.projection = layers[0].projection;
 
-        runInLoopTask.push_back([&] {
-            // if (!sys->safeMode && false) {
-                ESP_LOGD("", "Effects.projection.update %d call set projection", state.projection);
-                Variable("layers", "projection")[0] = state.projection;
-            // }
+        // one task, so the steps run in this order: the transition is set before it starts,
+        // the layers are configured before a layer keeps its outgoing frame
+        runInLoopTask.push_back([transitionChanged, transition, transitionDuration, layers, effectRows, projectionRows, nodesChanged, nodes] {
+            if (transitionChanged)
+                layerCompositor.setTransition(transition, transitionDuration);
+            layerCompositor.configure(layers, fix->nrOfLeds);
+            for (uint8_t rowNr = 0; rowNr < layers.size(); rowNr++) {
+                // if (!sys->safeMode && false) {
+                if (effectRows & (1 << rowNr)) {
+                    ESP_LOGD("", "Effects.effect.update [%d] %d call set effect", rowNr, layers[rowNr].effect);
+                    layerCompositor.startTransition(rowNr, fix->ledsP, fix->nrOfLeds); //keep the last frame of the outgoing effect
+                    Variable("layers", "effect")[rowNr] = layers[rowNr].effect;
+                }
+                if (projectionRows & (1 << rowNr)) {
+                    ESP_LOGD("", "Effects.projection.update [%d] %d call set projection", rowNr, layers[rowNr].projection);
+                    Variable("layers", "projection")[rowNr] = layers[rowNr].projection;
+                }
+                // }
+            }
+            if (nodesChanged)
+                effectGraph.configure(nodes, fix->nrOfLeds);
         });
 
+        ESP_LOGI("", "EffectsState::update %d layers", layers.size());
     }
 
-    if (changed)
-        ESP_LOGI("", "EffectsState::update");
-
     return changed?StateUpdateResult::CHANGED:StateUpdateResult::UNCHANGED;
 }
 
@@ -109,6 +226,8 @@ void EffectsService::begin()
 {
     _httpEndpoint.begin();
     _eventEndpoint.begin();
+    _socket->registerEvent(EVENT_NODE_TIMING);
+    addNodeRenderers(effectGraph); //effects, modifiers and projections of the node graph, see EffectNodes
     _fsPersistence.readFromFS();
 
     onConfigUpdated();
@@ -122,6 +241,21 @@ void EffectsService::begin()
     
 }
 
+void EffectsService::loop50ms()
+{
+    // per node render time for the UI, to see which node takes the frame budget. Only of a frame the graph rendered
+    static unsigned long timingMillis = 0;
+    static uint32_t timingFrames = 0;
+    if (effectGraph.active() && effectGraph.frames() != timingFrames && millis() - timingMillis >= 1000) {
+        timingMillis = millis();
+        timingFrames = effectGraph.frames();
+        JsonDocument doc;
+        JsonObject root = doc.to<JsonObject>();
+        effectGraph.timing(root);
+        _socket->emitEvent(EVENT_NODE_TIMING, root);
+    }
+}
+
 void EffectsService::onConfigUpdated()
 {
     ESP_LOGI("", "EffectsService::onConfigUpdated");
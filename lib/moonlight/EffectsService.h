@@ -19,13 +19,21 @@
 #include <PsychicHttp.h>
 #include <FSPersistence.h>
 #include "FixtureService.h"
+#include "LayerCompositor.h"
+#include "EffectGraph.h"
+
+#define EVENT_NODE_TIMING "nodeTiming"
 
 class EffectsState
 {
 public:
 
-    uint16_t effect = UINT16_MAX;
-    uint16_t projection = UINT16_MAX;
+    uint16_t effect = UINT16_MAX; //of layer 0, kept for clients not using layers
+    uint16_t projection = UINT16_MAX; //of layer 0
+    std::vector<LayerSettings> layers;
+    uint8_t transition = TRANSITION_CROSSFADE;
+    uint16_t transitionDuration = 1000; //ms, 0: hard switch
+    std::vector<NodeSettings> nodes; //effect node graph, used instead of layers if it has an output node
 
     static void read(EffectsState &state, JsonObject &root);
 
@@ -39,6 +47,7 @@ public:
                       ESP32SvelteKit *sveltekit, FixtureService *fixtureService);
 
     void begin();
+    void loop50ms();
 
 protected:
     EventSocket *_socket;
@@ -10,102 +10,80 @@
 **/
 
 #include <FixtureService.h>
+#include "MappingTable.h"
+#include <SettingValue.h>
 
 #include "App/LedModFixture.h" // use fix-> (and Variable)
 
 #if FT_ENABLED(FT_MONITOR)
     #define EVENT_MONITOR "monitor"
+    #define EVENT_GEOMETRY "geometry"
+    #define EVENT_MONITOR_LOD "monitorLod"
 #endif
 
+StateSnapshot<FixtureSlice> fixtureSlice; //see .h
+bool fixtureShowDriver = false; //see .h
+
+// one declaration for the json read / update of the state, see StateFields
+static constexpr state_field_t fixtureFieldList[] = {
+    STATE_FIELD(FixtureState, lightsOn),
+    STATE_FIELD(FixtureState, brightness),
+    STATE_FIELD(FixtureState, fixture),
+    STATE_FIELD(FixtureState, driverOn),
+    #if FT_ENABLED(FT_MONITOR)
+        STATE_FIELD(FixtureState, monitorOn),
+    #endif
+    STATE_FIELD(FixtureState, slice.x),
+    STATE_FIELD(FixtureState, slice.y),
+    STATE_FIELD(FixtureState, slice.z),
+    STATE_FIELD(FixtureState, slice.width),
+    STATE_FIELD(FixtureState, slice.height),
+    STATE_FIELD(FixtureState, slice.depth),
+};
+static constexpr StateFields fixtureFields(fixtureFieldList);
+// changed bits, resolved at compile time
+static constexpr uint32_t fixtureLightsOn = fixtureFields.bit("lightsOn");
+static constexpr uint32_t fixtureBrightness = fixtureFields.bit("brightness");
+static constexpr uint32_t fixtureFixture = fixtureFields.bit("fixture");
+static constexpr uint32_t fixtureDriverOn = fixtureFields.bit("driverOn");
+static constexpr uint32_t fixtureSliceBits = fixtureFields.groupBits("slice");
+static_assert(fixtureLightsOn && fixtureBrightness && fixtureFixture && fixtureDriverOn && fixtureSliceBits, "unknown fixture field");
+
 void FixtureState::read(FixtureState &state, JsonObject &root)
 {
     ESP_LOGI("", "FixtureState::read");
-    root["lightsOn"] = state.lightsOn;
-    root["brightness"] = state.brightness = Variable("Fixture", "brightness").getValue();
-    root["fixture"] = state.fixture;
-    // root["width"] = state.width;
-    // root["height"] = state.height;
-    // root["depth"] = state.depth;
-    root["driverOn"] = state.driverOn;
-    #if FT_ENABLED(FT_MONITOR)
-        root["monitorOn"] = state.monitorOn;
-    #endif
-    // root["pin"] = state.pin;
+    state.brightness = Variable("Fixture", "brightness").getValue();
+    fixtureFields.read(&state, root);
 }
 
 StateUpdateResult FixtureState::update(JsonObject &root, FixtureState &state)
 {
-    bool changed = false;
-    // bool sizeChanged = false;
-    // bool pinChanged = false;
-
     print->printJson("FixtureState::update", root);
 
-    if (state.lightsOn != root["lightsOn"]) {
-        state.lightsOn = root["lightsOn"]; changed = true;
+    uint32_t changed = fixtureFields.update(root, &state);
+
+    if (changed & fixtureLightsOn) {
         Variable("Fixture", "on") = state.lightsOn;
     }
-    if (state.brightness != root["brightness"]) {
-        state.brightness = root["brightness"]; changed = true;
+    if (changed & fixtureBrightness) {
         Variable("Fixture", "brightness") = state.brightness;
-
         ESP_LOGI("", "Fixture.brightness.update %d", state.brightness);
     }
-    if (state.fixture != root["fixture"]) {
-        state.fixture = root["fixture"]; changed = true;
-
+    if (changed & fixtureFixture) {
         ESP_LOGI("", "Fixture.fixture.update task: %s e:%d", pcTaskGetTaskName(nullptr), state.fixture);
-
-        // if (!sys->safeMode && false) {
-            Variable("Fixture", "fixture") = state.fixture;
-        // }
+        Variable("Fixture", "fixture") = state.fixture;
     }
-
-    // if (state.width != root["width"]) {
-    //     state.width = root["width"]; changed = true;
-    //     sizeChanged = true;
-    // }
-    // if (state.height != root["height"]) {
-    //     state.height = root["height"]; changed = true;
-    //     sizeChanged = true;
-    // }
-    // if (state.depth != root["depth"]) {
-    //     state.depth = root["depth"]; changed = true;
-    //     sizeChanged = true;
-    // }
-    if (state.driverOn != root["driverOn"]) {
-        state.driverOn = root["driverOn"]; changed = true;
-        fix->showDriver = state.driverOn;
+    if (changed & fixtureDriverOn) {
+        #ifdef STARLIGHT_VIRTUAL_DRIVER
+            fix->showDriver = state.driverOn;
+        #else
+            fixtureShowDriver = state.driverOn;
+        #endif
+    }
+    if (changed & fixtureSliceBits) {
+        fixtureSlice.publish(state.slice); //under the access mutex of the service, see StateSnapshot
+        ESP_LOGI("", "Fixture.slice.update %d,%d,%d of %dx%dx%d", state.slice.x, state.slice.y, state.slice.z, state.slice.width, state.slice.height, state.slice.depth);
     }
-    #if FT_ENABLED(FT_MONITOR)
-        if (state.monitorOn != root["monitorOn"]) {state.monitorOn = root["monitorOn"]; changed = true;}
-    #endif
-    // if (state.pin != root["pin"]) {
-    //     state.pin = root["pin"]; changed = true;
-    //     pinChanged = true;
-    //     fix->doAllocPins = true;
-    //     fix->currPin = state.pin;
-    //     ESP_LOGI("", "Fixture.pin.update %d", state.pin);
-    // }
-
-    // if (sizeChanged) {
-    //     ESP_LOGI("", "FixtureState::sizeChanged %dx%dx%d", state.width, state.height, state.depth);
-
-    //     if (state.width > 0 && state.height > 0 && state.depth > 0) {
-    //         // Coord3D fixSize = {state.width, state.height, state.depth};
-    //         // Variable("Fixture", "fixture") = fixSize;
-
-    //         fix->fixSize.x = state.width;
-    //         fix->fixSize.y = state.height;
-    //         fix->fixSize.z = state.depth;
-    //     }
-    // }
-
-    // if (sizeChanged || pinChanged) {
-    //     fix->mappingStatus = 1; // ask starlight to recalculate mapping (including pins)
-    // }
-    // if (changed)
-    //     Variable("Model", "saveModel").setValue(true);
 
     return changed?StateUpdateResult::CHANGED:StateUpdateResult::UNCHANGED;
 }
@@ -123,6 +101,10 @@ FixtureService::FixtureService(PsychicHttpServer *server,
                                                                                                           this,
                                                                                                           sveltekit->getSocket(),
                                                                                                           "fixture"),
+                                                                                           _mqttEndpoint(FixtureState::read,
+                                                                                                         FixtureState::update,
+                                                                                                         this,
+                                                                                                         sveltekit->getMqttClient()),
                                                                                            _webSocketServer(FixtureState::read,
                                                                                                             FixtureState::update,
                                                                                                             this,
@@ -136,6 +118,10 @@ FixtureService::FixtureService(PsychicHttpServer *server,
                                                                                                       this,
                                                                                                       sveltekit->getFS(),
                                                                                                       "/config/fixtureState.json")
+    #if FT_ENABLED(FT_MONITOR)
+                                                                                            ,_server(server),
+                                                                                             _securityManager(sveltekit->getSecurityManager())
+    #endif
 {
 
     // configure settings service update handler to update state
@@ -144,18 +130,78 @@ FixtureService::FixtureService(PsychicHttpServer *server,
                      false);
 
     //difference with state::update ???
+
+    // plain value command topics for automations, no JSON: the handlers do what FixtureState::update does for the field
+    _mqttEndpoint.onCommand("brightness", [](const char *value, FixtureState &state) {
+        int32_t brightness;
+        if (!MqttRouter::parseInt(value, brightness) || brightness < 0 || brightness > UINT8_MAX)
+            return StateUpdateResult::ERROR;
+        if (state.brightness == brightness)
+            return StateUpdateResult::UNCHANGED;
+        state.brightness = brightness;
+        Variable("Fixture", "brightness") = state.brightness;
+        return StateUpdateResult::CHANGED;
+    });
+    _mqttEndpoint.onCommand("on", [](const char *value, FixtureState &state) {
+        bool lightsOn;
+        if (!MqttRouter::parseBool(value, lightsOn))
+            return StateUpdateResult::ERROR;
+        if (state.lightsOn == lightsOn)
+            return StateUpdateResult::UNCHANGED;
+        state.lightsOn = lightsOn;
+        Variable("Fixture", "on") = state.lightsOn;
+        return StateUpdateResult::CHANGED;
+    });
 }
 
 void FixtureService::begin()
 {
     _httpEndpoint.begin();
     _eventEndpoint.begin();
+    enableSnapshot(); //loop50ms reads the state without waiting for http clients updating it
+    _state.driverOn = fix->showDriver; //StarLight's default if driverOn is not persisted (missing fields are not updated)
     _fsPersistence.readFromFS();
+    // update only sets it when driverOn changes, the loop task needs it from the first frame
+    #ifdef STARLIGHT_VIRTUAL_DRIVER
+        fix->showDriver = _state.driverOn;
+    #else
+        fixtureShowDriver = _state.driverOn;
+    #endif
+
+    String mqttPath = SettingValue::format(FIXTURE_MQTT_PATH);
+    _mqttEndpoint.configureTopics(mqttPath + "/state", mqttPath + "/set");
 
     onConfigUpdated();
 
     #if FT_ENABLED(FT_MONITOR)
         _socket->registerEvent(EVENT_MONITOR);
+        _socket->registerEvent(EVENT_GEOMETRY);
+        _socket->registerEvent(EVENT_MONITOR_LOD);
+
+        // a (re)connecting client gets the hash right away, if it has that geometry cached it can show colors immediately
+        _socket->onSubscribe(EVENT_GEOMETRY, [&](const String &originId) {
+            emitGeometry(originId.toInt());
+        });
+
+        // {budget}: max number of points the client wants to show, 0: all leds
+        _socket->onEvent(EVENT_MONITOR_LOD, [&](JsonObject &root, int originId) {
+            uint16_t budget = root["budget"] | 0;
+            xSemaphoreTake(_geometryMutex, portMAX_DELAY);
+            if (budget)
+                _monitorBudgets[originId] = MonitorLod::bucket(budget);
+            else
+                _monitorBudgets.erase(originId);
+            findLod(originId); //build it now, not in the loop task
+            xSemaphoreGive(_geometryMutex);
+            emitGeometry(originId);
+        });
+
+        _server->on(FIXTURE_GEOMETRY_PATH,
+                    HTTP_GET,
+                    _securityManager->wrapRequest(std::bind(&FixtureService::getGeometry, this, std::placeholders::_1),
+                                                  AuthenticationPredicates::IS_AUTHENTICATED));
+
+        ESP_LOGV("FixtureService", "Registered GET endpoint: %s", FIXTURE_GEOMETRY_PATH);
     #endif
 }
 
@@ -168,14 +214,222 @@ void FixtureService::loop50ms()
 {
     #if FT_ENABLED(FT_MONITOR)
         static int monitorMillis = 0;
-        if (_state.monitorOn && fix->mappingStatus == 0 && millis() - monitorMillis >= fix->nrOfLeds / 12) { //max 12000 leds per second
+        FixtureState state;
+        readSnapshot(state);
+        if (state.monitorOn && fix->mappingStatus == 0 && fix->ledsPExtended.type == 0 && millis() - monitorMillis >= fix->nrOfLeds / 12) { //max 12000 leds per second
             monitorMillis = millis();
-            _socket->emitEvent(EVENT_MONITOR, (char *)(&fix->ledsPExtended), MIN(fix->nrOfLeds, STARLIGHT_MAXLEDS) * sizeof(CRGB) + 3); //3 bytes for type and factor and ...
+            emitMonitor();
         }
     #endif
     if (fix->ledsPExtended.type == 1) {
         ESP_LOGI("", "New fixture!");
+        updateMapping(); //ledsP contains the coordinates now
+        #if FT_ENABLED(FT_MONITOR)
+            updateGeometry(); //ledsP contains the coordinates now
+        #endif
         fix->ledsPExtended.type = 0; //reset fixChange
     }
     //ran by httpd, is that okay or better to run in other task?
-}
\ No newline at end of file
+}
+
+void FixtureService::updateMapping()
+{
+    const uint8_t *coords = (uint8_t *)(&fix->ledsPExtended) + 3; //3 bytes for type and factor and size
+    uint16_t nrOfLeds = MIN(fix->nrOfLeds, STARLIGHT_MAXLEDS);
+    if (!nrOfLeds) {
+        mappingTable.clear();
+        return;
+    }
+
+    // the virtual grid is the bounding box of the coordinates
+    uint8_t lo[3] = {UINT8_MAX, UINT8_MAX, UINT8_MAX}, hi[3] = {0, 0, 0};
+    for (uint16_t i = 0; i < nrOfLeds; i++)
+        for (uint8_t a = 0; a < 3; a++) {
+            lo[a] = MIN(lo[a], coords[i * 3 + a]);
+            hi[a] = MAX(hi[a], coords[i * 3 + a]);
+        }
+    uint16_t width = hi[0] - lo[0] + 1, height = hi[1] - lo[1] + 1, depth = hi[2] - lo[2] + 1;
+
+    mappingTable.begin(width, height, depth);
+    for (uint16_t i = 0; i < nrOfLeds; i++)
+        mappingTable.add((coords[i * 3] - lo[0]) + width * ((coords[i * 3 + 1] - lo[1]) + (uint32_t)height * (coords[i * 3 + 2] - lo[2])), i);
+    mappingTable.end();
+}
+
+#if FT_ENABLED(FT_MONITOR)
+
+void FixtureService::updateGeometry()
+{
+    uint16_t nrOfLeds = MIN(fix->nrOfLeds, STARLIGHT_MAXLEDS);
+    size_t len = 2 + nrOfLeds * sizeof(CRGB);
+    uint8_t *geometry = (uint8_t *)(psramFound() ? ps_malloc(len) : malloc(len));
+    if (!geometry) {
+        ESP_LOGW("", "FixtureService geometry alloc %d failed", len);
+        return;
+    }
+    geometry[0] = fix->ledsPExtended.factor;
+    geometry[1] = fix->ledsPExtended.size;
+    memcpy(geometry + 2, (uint8_t *)(&fix->ledsPExtended) + 3, nrOfLeds * sizeof(CRGB)); //3 bytes for type and factor and size
+
+    // FNV-1a of the whole table: same fixture, same hash, also after a reboot
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++)
+        hash = (hash ^ geometry[i]) * 16777619u;
+    if (!hash) hash = 1; //0 is no geometry
+
+    xSemaphoreTake(_geometryMutex, portMAX_DELAY);
+    _lods.clear(); //freed when no response is sending them anymore
+    _geometry = std::shared_ptr<uint8_t>(geometry, free);
+    _geometryLen = len;
+    _geometryHash = hash;
+    _geometryLeds = nrOfLeds;
+    xSemaphoreGive(_geometryMutex);
+
+    ESP_LOGI("", "FixtureService geometry %d leds hash %08x", nrOfLeds, hash);
+    emitGeometry();
+}
+
+void FixtureService::emitGeometry()
+{
+    for (int clientId : _socket->getSubscribers(EVENT_GEOMETRY))
+        emitGeometry(clientId);
+}
+
+void FixtureService::emitGeometry(int clientId)
+{
+    JsonDocument doc;
+    JsonObject root = doc.to<JsonObject>();
+
+    xSemaphoreTake(_geometryMutex, portMAX_DELAY);
+    std::shared_ptr<MonitorLod> lod = findLod(clientId);
+    root["hash"] = _geometryHash;
+    root["nrOfLeds"] = _geometryLeds;
+    root["budget"] = lod ? lod->budget() : 0;
+    root["points"] = lod ? lod->nrOfPoints() : _geometryLeds;
+    xSemaphoreGive(_geometryMutex);
+
+    _socket->emitEvent(EVENT_GEOMETRY, root, String(clientId).c_str(), true);
+}
+
+void FixtureService::emitMonitor()
+{
+    char *leds = (char *)(&fix->ledsPExtended); //3 bytes for type and factor and ..., colors only: coordinates go via FIXTURE_GEOMETRY_PATH
+    size_t len = MIN(fix->nrOfLeds, STARLIGHT_MAXLEDS) * sizeof(CRGB) + 3;
+
+    // the level of detail of each client is looked up under the mutex (monitorLod events change _monitorBudgets in the
+    // httpd task), the frames are built and emitted without it
+    std::list<int> subscribers;
+    std::vector<std::shared_ptr<MonitorLod>> lods; //per subscriber, nullptr: all leds
+    xSemaphoreTake(_geometryMutex, portMAX_DELAY);
+    if (!_monitorBudgets.empty()) {
+        subscribers = _socket->getSubscribers(EVENT_MONITOR);
+        for (auto it = _monitorBudgets.begin(); it != _monitorBudgets.end();) { //forget clients which are gone
+            if (std::find(subscribers.begin(), subscribers.end(), it->first) == subscribers.end())
+                it = _monitorBudgets.erase(it);
+            else
+                ++it;
+        }
+        for (int clientId : subscribers)
+            lods.push_back(findLod(clientId));
+    }
+    xSemaphoreGive(_geometryMutex);
+
+    if (subscribers.empty()) { //everybody gets all leds
+        _socket->emitEvent(EVENT_MONITOR, leds, len);
+        return;
+    }
+
+    // each level of detail is built once per frame, whatever the number of clients using it. Only this (loop) task
+    // builds frames, so the frame buffer of a level is not shared
+    struct LodFrame
+    {
+        MonitorLod *lod;
+        uint8_t *output;
+        size_t len;
+    };
+    std::vector<LodFrame> frames;
+    auto lod = lods.begin();
+    for (int clientId : subscribers) {
+        if (!*lod)
+            _socket->emitEvent(EVENT_MONITOR, leds, len, String(clientId).c_str(), true);
+        else {
+            auto frame = std::find_if(frames.begin(), frames.end(), [&](const LodFrame &built) { return built.lod == lod->get(); });
+            if (frame == frames.end()) {
+                LodFrame built = {lod->get()};
+                built.len = built.lod->frame((uint8_t *)leds, built.output);
+                frames.push_back(built);
+                frame = frames.end() - 1;
+            }
+            _socket->emitEvent(EVENT_MONITOR, (char *)frame->output, frame->len, String(clientId).c_str(), true);
+        }
+        ++lod;
+    }
+}
+
+std::shared_ptr<MonitorLod> FixtureService::findLod(int clientId)
+{
+    auto budget = _monitorBudgets.find(clientId);
+    if (budget == _monitorBudgets.end() || !_geometry || budget->second >= _geometryLeds)
+        return nullptr;
+
+    for (std::shared_ptr<MonitorLod> &lod : _lods)
+        if (lod->budget() == budget->second)
+            return lod;
+
+    if (_lods.size() >= MONITOR_MAX_LODS)
+        return nullptr; //too many different budgets, all leds
+    std::shared_ptr<MonitorLod> lod = std::make_shared<MonitorLod>();
+    if (!lod->build(_geometry.get(), _geometryLeds, budget->second))
+        return nullptr;
+    _lods.push_back(lod);
+    return lod;
+}
+
+esp_err_t FixtureService::getGeometry(PsychicRequest *request)
+{
+    // ?hash=... (hex, from the geometry event): the url names one geometry, so it can be cached forever.
+    // Another hash: the fixture changed since the client got the event, it gets the new hash with the next one
+    bool hashed = request->hasParam("hash");
+    uint32_t requested = hashed ? strtoul(request->getParam("hash")->value().c_str(), nullptr, 16) : 0;
+    // ?budget=...: the geometry of that level of detail, see emitGeometry
+    uint16_t budget = request->hasParam("budget") ? request->getParam("budget")->value().toInt() : 0;
+
+    // the pointers are taken under the mutex, the response is sent without it: it can take long (up to 48KB)
+    xSemaphoreTake(_geometryMutex, portMAX_DELAY);
+    std::shared_ptr<uint8_t> geometry = _geometry;
+    size_t len = _geometryLen;
+    uint32_t hash = _geometryHash;
+    uint16_t nrOfLeds = _geometryLeds;
+    std::shared_ptr<MonitorLod> lod;
+    if (budget)
+        for (std::shared_ptr<MonitorLod> &built : _lods)
+            if (built->budget() == budget)
+                lod = built;
+    xSemaphoreGive(_geometryMutex);
+
+    if (!geometry)
+        return request->reply(404);
+    if (hashed && requested != hash)
+        return request->reply(409);
+    if (budget && !lod && budget < nrOfLeds) //only levels requested via monitorLod are built
+        return request->reply(404);
+
+    char etag[18];
+    snprintf(etag, sizeof(etag), "\"%08x-%d\"", hash, lod ? budget : 0);
+
+    PsychicResponse response(request);
+    response.addHeader("ETag", etag);
+    response.addHeader("Cache-Control", hashed ? "private, max-age=31536000, immutable" : "no-cache"); //without hash: revalidate with the ETag
+    if (request->hasHeader("If-None-Match") && request->header("If-None-Match") == etag) {
+        response.setCode(304);
+        return response.send();
+    }
+    response.setContentType("application/octet-stream");
+    if (lod)
+        response.setContent(lod->geometry(), lod->geometryLen());
+    else
+        response.setContent(geometry.get(), len);
+    return response.send(); //geometry and lod are released after sending
+}
+
+#endif
@@ -15,10 +15,36 @@
 #include <EventSocket.h>
 #include <HttpEndpoint.h>
 #include <EventEndpoint.h>
+#include <MqttEndpoint.h>
 #include <WebSocketServer.h>
 #include <PsychicHttp.h>
 #include <FSPersistence.h>
+#include <StateFields.h>
+#include <StateSnapshot.h>
 #include <ESP32SvelteKit.h>
+#include <map>
+#include <memory>
+#include "MonitorLod.h"
+
+#define FIXTURE_GEOMETRY_PATH "/rest/fixtureGeometry"
+#define FIXTURE_MQTT_PATH "moonlight/#{unique_id}/fixture" // state, set (json), brightness/set (0..255), on/set (ON / OFF)
+
+// Part of a fixture spread over several controllers: offset of this controller's leds in the global coordinate space
+// and the size of the whole installation (0: same as this fixture). Only playback uses it: FramePlayer plays this
+// slice of a recording of the whole installation, on timeSync.millis() so all controllers show the same frame.
+// StarLight effects render in the coordinates of this fixture, they do not know the slice.
+struct FixtureSlice
+{
+    uint16_t x = 0, y = 0, z = 0;
+    uint16_t width = 0, height = 0, depth = 0;
+};
+
+// written by FixtureState::update (httpd, mqtt), read in the loop task by RecorderService
+extern StateSnapshot<FixtureSlice> fixtureSlice;
+
+// driverOn: the loop task shows the frame after the layers, the effect graph and playback made it (see main.cpp),
+// StarLight's own show in loopStar is off. With the virtual driver StarLight shows it (fix->showDriver)
+extern bool fixtureShowDriver;
 
 class FixtureState
 {
@@ -35,6 +61,7 @@ public:
         bool monitorOn;
     #endif
     // uint8_t pin = UINT8_MAX;
+    FixtureSlice slice;
 
     static void read(FixtureState &state, JsonObject &root);
 
@@ -57,10 +84,37 @@ protected:
 private:
     HttpEndpoint<FixtureState> _httpEndpoint;
     EventEndpoint<FixtureState> _eventEndpoint;
+    MqttEndpoint<FixtureState> _mqttEndpoint;
     WebSocketServer<FixtureState> _webSocketServer;
     FSPersistence<FixtureState> _fsPersistence;
 
     void onConfigUpdated();
+    void updateMapping(); //mappingTable of the new fixture, from the led coordinates
+
+    #if FT_ENABLED(FT_MONITOR)
+        // led coordinates of the fixture, [factor, size, x,y,z per led], only rebuilt when StarLight maps a new fixture.
+        // Monitor clients fetch it once per hash from FIXTURE_GEOMETRY_PATH, monitor frames only carry colors.
+        // The geometry and the levels of detail are shared pointers: taken under _geometryMutex, sent without it, so a
+        // slow client does not block the loop task and a new fixture does not free what is being sent
+        PsychicHttpServer *_server;
+        SecurityManager *_securityManager;
+        SemaphoreHandle_t _geometryMutex = xSemaphoreCreateMutex();
+        std::shared_ptr<uint8_t> _geometry;
+        size_t _geometryLen = 0;
+        uint32_t _geometryHash = 0;
+        uint16_t _geometryLeds = 0;
+
+        // level of detail requested by a monitor client (event monitorLod), clients without one get all leds
+        std::map<int, uint16_t> _monitorBudgets;
+        std::list<std::shared_ptr<MonitorLod>> _lods; //built on request, cleared on a new fixture
+
+        void updateGeometry();
+        void emitGeometry(); //to all subscribers, each with its own level of detail
+        void emitGeometry(int clientId);
+        void emitMonitor();
+        std::shared_ptr<MonitorLod> findLod(int clientId); //nullptr: all leds, call with _geometryMutex taken
+        esp_err_t getGeometry(PsychicRequest *request);
+    #endif
 };
 
 #endif
@@ -0,0 +1,107 @@
+/**
+    @title     MoonLight
+    @file      FrameCodec.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/recorder/
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#include "FrameCodec.h"
+
+static inline CRGB framePixel(const CRGB *leds, const CRGB *previous, uint16_t i)
+{
+    CRGB c = leds[i];
+    if (previous) {
+        c.r ^= previous[i].r;
+        c.g ^= previous[i].g;
+        c.b ^= previous[i].b;
+    }
+    return c;
+}
+
+static inline bool samePixel(const CRGB &a, const CRGB &b)
+{
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+size_t frameEncode(const CRGB *leds, const CRGB *previous, uint16_t nrOfLeds, uint8_t *payload)
+{
+    size_t o = 0;
+    uint16_t i = 0;
+    while (i < nrOfLeds) {
+        CRGB c = framePixel(leds, previous, i);
+        uint16_t run = 1;
+        while (i + run < nrOfLeds && run < 129 && samePixel(framePixel(leds, previous, i + run), c))
+            run++;
+        if (run >= 2) {
+            payload[o++] = 126 + run;
+            payload[o++] = c.r;
+            payload[o++] = c.g;
+            payload[o++] = c.b;
+            i += run;
+            continue;
+        }
+
+        // literals until the next run starts
+        uint16_t start = i;
+        uint8_t count = 0;
+        while (i < nrOfLeds && count < 128) {
+            if (i + 1 < nrOfLeds && samePixel(framePixel(leds, previous, i), framePixel(leds, previous, i + 1)))
+                break;
+            i++;
+            count++;
+        }
+        payload[o++] = count - 1;
+        for (uint16_t k = start; k < start + count; k++) {
+            CRGB p = framePixel(leds, previous, k);
+            payload[o++] = p.r;
+            payload[o++] = p.g;
+            payload[o++] = p.b;
+        }
+    }
+    return o;
+}
+
+bool frameDecode(const uint8_t *payload, size_t len, uint8_t type, CRGB *leds, uint16_t nrOfLeds)
+{
+    size_t p = 0;
+    uint16_t i = 0;
+    while (p < len) {
+        uint8_t c = payload[p++];
+        if (c < 128) {
+            uint16_t count = c + 1;
+            if (i + count > nrOfLeds || p + count * 3 > len)
+                return false;
+            if (type == FRAME_KEY)
+                memcpy(&leds[i], payload + p, count * 3);
+            else
+                for (uint16_t k = 0; k < count; k++) {
+                    leds[i + k].r ^= payload[p + k * 3];
+                    leds[i + k].g ^= payload[p + k * 3 + 1];
+                    leds[i + k].b ^= payload[p + k * 3 + 2];
+                }
+            p += count * 3;
+            i += count;
+        } else {
+            uint16_t count = c - 126;
+            if (i + count > nrOfLeds || p + 3 > len)
+                return false;
+            CRGB v(payload[p], payload[p + 1], payload[p + 2]);
+            p += 3;
+            if (type == FRAME_KEY)
+                for (uint16_t k = 0; k < count; k++)
+                    leds[i + k] = v;
+            else if (v.r | v.g | v.b) //a run of 0 is unchanged leds
+                for (uint16_t k = 0; k < count; k++) {
+                    leds[i + k].r ^= v.r;
+                    leds[i + k].g ^= v.g;
+                    leds[i + k].b ^= v.b;
+                }
+            i += count;
+        }
+    }
+    return i == nrOfLeds;
+}
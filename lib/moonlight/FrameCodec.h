@@ -0,0 +1,58 @@
+/**
+    @title     MoonLight
+    @file      FrameCodec.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/recorder/
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#ifndef FrameCodec_h
+#define FrameCodec_h
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+// Recording file format (.mlr), little endian, see also scripts/frames.py:
+//   FrameFileHeader
+//   frame records: uint8_t type (FRAME_KEY, FRAME_DELTA), uint32_t length, length bytes of payload
+//   index block at header.indexOffset: uint32_t count, count x FrameIndexEntry (one per keyframe)
+// Payload: the leds run length encoded, a control byte c < 128 is followed by c + 1 literal leds,
+// c >= 128 by one led repeated c - 126 times. A keyframe encodes the leds, a delta the leds XOR the previous frame,
+// so unchanged leds are runs of black.
+#define FRAME_FILE_MAGIC 0x52434C4D // "MLCR"
+#define FRAME_FILE_VERSION 1
+#define FRAME_KEY 0
+#define FRAME_DELTA 1
+#define FRAME_RECORD_HEADER 5
+#define FRAME_KEY_INTERVAL 50 //a keyframe every 50 frames: seek cost vs size
+
+struct __attribute__((packed)) FrameFileHeader
+{
+    uint32_t magic;
+    uint8_t version;
+    uint8_t reserved;
+    uint16_t nrOfLeds;
+    uint16_t fps;
+    uint16_t keyInterval;
+    uint32_t frameCount;
+    uint32_t indexOffset; //0: recording not finished
+};
+
+struct __attribute__((packed)) FrameIndexEntry
+{
+    uint32_t frame;
+    uint32_t offset; //of the frame record
+};
+
+// worst case payload size: all literals
+inline size_t frameMaxPayload(uint16_t nrOfLeds) { return nrOfLeds * sizeof(CRGB) + (nrOfLeds + 127) / 128; }
+
+// key: leds, delta: leds XOR previous, returns the payload length
+size_t frameEncode(const CRGB *leds, const CRGB *previous, uint16_t nrOfLeds, uint8_t *payload);
+// applies a payload to leds (replace for a keyframe, XOR for a delta), false if corrupt
+bool frameDecode(const uint8_t *payload, size_t len, uint8_t type, CRGB *leds, uint16_t nrOfLeds);
+
+#endif
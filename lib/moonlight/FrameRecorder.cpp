@@ -0,0 +1,311 @@
+/**
+    @title     MoonLight
+    @file      FrameRecorder.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/recorder/
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#include "FrameRecorder.h"
+#include <TimeSync.h>
+
+FrameRecorder frameRecorder; //see .h
+FramePlayer framePlayer;     //see .h
+
+static void *allocBuffer(size_t size)
+{
+    return psramFound() ? ps_malloc(size) : malloc(size);
+}
+
+bool FrameRecorder::begin(fs::FS &fs, const char *path, uint16_t nrOfLeds, uint16_t fps)
+{
+    end();
+    _previous = (CRGB *)allocBuffer(nrOfLeds * sizeof(CRGB));
+    _payload = (uint8_t *)allocBuffer(frameMaxPayload(nrOfLeds));
+    _file = fs.open(path, "w");
+    if (!_previous || !_payload || !_file) {
+        ESP_LOGW("", "FrameRecorder %s could not start", path);
+        if (_file) _file.close();
+        freeBuffers();
+        return false;
+    }
+
+    _header = {FRAME_FILE_MAGIC, FRAME_FILE_VERSION, 0, nrOfLeds, MAX(fps, (uint16_t)1), FRAME_KEY_INTERVAL, 0, 0};
+    _file.write((uint8_t *)&_header, sizeof(_header)); //rewritten by end()
+    _index.clear();
+    _lastFrame = 0;
+    ESP_LOGI("", "FrameRecorder %s %d leds %d fps", path, nrOfLeds, fps);
+    return true;
+}
+
+bool FrameRecorder::addFrame(const CRGB *leds, uint16_t nrOfLeds)
+{
+    if (!_file || nrOfLeds != _header.nrOfLeds)
+        return false;
+    if (_lastFrame && millis() - _lastFrame < 1000 / _header.fps)
+        return true; //not yet
+    _lastFrame = millis();
+
+    bool key = _header.frameCount % _header.keyInterval == 0;
+    if (key)
+        _index.push_back({_header.frameCount, (uint32_t)_file.position()});
+
+    uint32_t length = frameEncode(leds, key ? nullptr : _previous, nrOfLeds, _payload);
+    uint8_t record[FRAME_RECORD_HEADER] = {key ? (uint8_t)FRAME_KEY : (uint8_t)FRAME_DELTA};
+    memcpy(record + 1, &length, sizeof(length));
+    if (_file.write(record, sizeof(record)) != sizeof(record) || _file.write(_payload, length) != length) {
+        ESP_LOGW("", "FrameRecorder write failed at frame %d, file system full?", _header.frameCount);
+        end();
+        return false;
+    }
+    memcpy(_previous, leds, nrOfLeds * sizeof(CRGB));
+    _header.frameCount++;
+    return true;
+}
+
+bool FrameRecorder::end()
+{
+    if (!_file)
+        return false;
+
+    _header.indexOffset = _file.position();
+    uint32_t count = _index.size();
+    _file.write((uint8_t *)&count, sizeof(count));
+    _file.write((uint8_t *)_index.data(), count * sizeof(FrameIndexEntry));
+    _file.seek(0);
+    _file.write((uint8_t *)&_header, sizeof(_header));
+    ESP_LOGI("", "FrameRecorder %d frames %d bytes", _header.frameCount, _header.indexOffset);
+    _file.close();
+
+    freeBuffers();
+    return true;
+}
+
+void FrameRecorder::freeBuffers()
+{
+    free(_previous);
+    free(_payload);
+    _previous = nullptr;
+    _payload = nullptr;
+    _index.clear();
+    _index.shrink_to_fit();
+}
+
+bool FramePlayer::begin(fs::FS &fs, const char *path, bool loop)
+{
+    end();
+    _file = fs.open(path, "r");
+    if (!_file)
+        return false;
+
+    uint32_t count = 0;
+    if (_file.read((uint8_t *)&_header, sizeof(_header)) != sizeof(_header) || _header.magic != FRAME_FILE_MAGIC ||
+        _header.version != FRAME_FILE_VERSION || !_header.indexOffset || !_header.fps || !_file.seek(_header.indexOffset) ||
+        _file.read((uint8_t *)&count, sizeof(count)) != sizeof(count)) {
+        ESP_LOGW("", "FramePlayer %s is not a (finished) recording", path);
+        _file.close();
+        return false;
+    }
+    // the count is read from the file: at most the entries which fit in it, and the first frame is a keyframe
+    size_t maxCount = (_file.size() - _header.indexOffset - sizeof(count)) / sizeof(FrameIndexEntry);
+    if (!count || count > maxCount) {
+        ESP_LOGW("", "FramePlayer %s index of %d keyframes, room for %d", path, count, maxCount);
+        _file.close();
+        return false;
+    }
+    _index.resize(count);
+    bool valid = _file.read((uint8_t *)_index.data(), count * sizeof(FrameIndexEntry)) == count * sizeof(FrameIndexEntry);
+    for (const FrameIndexEntry &entry : _index)
+        valid = valid && entry.offset >= sizeof(FrameFileHeader) && entry.offset < _header.indexOffset; //in the frame records
+    if (!valid) {
+        ESP_LOGW("", "FramePlayer %s index is corrupt", path);
+        _index.clear();
+        _file.close();
+        return false;
+    }
+    _file.seek(sizeof(FrameFileHeader));
+
+    _current = (CRGB *)allocBuffer(_header.nrOfLeds * sizeof(CRGB));
+    for (Buffer &buffer : _buffers)
+        buffer.data = (uint8_t *)allocBuffer(frameMaxPayload(_header.nrOfLeds));
+    if (!_current || !_buffers[0].data || !_buffers[1].data) {
+        ESP_LOGW("", "FramePlayer no memory for %d leds", _header.nrOfLeds);
+        end();
+        return false;
+    }
+    memset(_current, 0, _header.nrOfLeds * sizeof(CRGB));
+
+    _loop = loop;
+    _readFrame = 0;
+    _frameNr = 0;
+    _dropped = 0;
+    _free = xQueueCreate(2, sizeof(uint8_t));
+    _filled = xQueueCreate(2, sizeof(uint8_t));
+    _fileMutex = xSemaphoreCreateMutex();
+    for (uint8_t i = 0; i < 2; i++)
+        xQueueSend(_free, &i, 0);
+
+    // a looping recording starts at a multiple of its length on the shared clock, at the frame the other controllers show
+    _start = alignedStart(timeSync.millis());
+    seekKey(dueFrame(timeSync.millis()));
+
+    _stop = false;
+    xTaskCreateUniversal(readerTask, "FramePlayer", 3072, this, 1, &_task, ARDUINO_RUNNING_CORE == 0 ? 1 : 0); //not on the core of the loop task
+
+    ESP_LOGI("", "FramePlayer %s %d frames %d leds %d fps", path, _header.frameCount, _header.nrOfLeds, _header.fps);
+    return true;
+}
+
+void FramePlayer::end()
+{
+    if (_task) {
+        _stop = true;
+        while (_task) //the task clears it when it stops
+            delay(1);
+    }
+    if (_free) vQueueDelete(_free);
+    if (_filled) vQueueDelete(_filled);
+    if (_fileMutex) vSemaphoreDelete(_fileMutex);
+    _free = _filled = nullptr;
+    _fileMutex = nullptr;
+    if (_file) _file.close();
+    freeBuffers();
+}
+
+void FramePlayer::freeBuffers()
+{
+    free(_current);
+    _current = nullptr;
+    for (Buffer &buffer : _buffers) {
+        free(buffer.data);
+        buffer.data = nullptr;
+    }
+    _index.clear();
+}
+
+// called with _fileMutex taken
+bool FramePlayer::readRecord(Buffer &buffer)
+{
+    if (_file.position() >= _header.indexOffset)
+        return false;
+    uint8_t record[FRAME_RECORD_HEADER];
+    if (_file.read(record, sizeof(record)) != sizeof(record))
+        return false;
+    buffer.type = record[0];
+    memcpy(&buffer.length, record + 1, sizeof(buffer.length));
+    if (buffer.length > frameMaxPayload(_header.nrOfLeds) || _file.read(buffer.data, buffer.length) != buffer.length)
+        return false;
+    buffer.frame = _readFrame++;
+    return true;
+}
+
+void FramePlayer::readerTask(void *parameter)
+{
+    FramePlayer *player = (FramePlayer *)parameter;
+    while (!player->_stop) {
+        uint8_t i;
+        if (xQueueReceive(player->_free, &i, pdMS_TO_TICKS(50)) != pdTRUE)
+            continue;
+
+        xSemaphoreTake(player->_fileMutex, portMAX_DELAY);
+        bool read = player->readRecord(player->_buffers[i]);
+        if (!read && player->_loop && player->_header.frameCount) { //start over
+            player->_file.seek(sizeof(FrameFileHeader));
+            player->_readFrame = 0;
+            read = player->readRecord(player->_buffers[i]);
+        }
+        // queued while holding the mutex, so a seek never sees a stale buffer arrive after it
+        xQueueSend(read ? player->_filled : player->_free, &i, 0);
+        xSemaphoreGive(player->_fileMutex);
+
+        if (!read)
+            vTaskDelay(pdMS_TO_TICKS(50)); //end of a recording which does not loop
+    }
+    player->_task = nullptr;
+    vTaskDelete(NULL);
+}
+
+// the clock is timeSync.millis(): the leader's clock, so controllers playing the same recording stay in step
+unsigned long FramePlayer::alignedStart(unsigned long now)
+{
+    unsigned long length = _header.frameCount * 1000 / _header.fps; //ms
+    return _loop && length ? now - now % length : now;
+}
+
+uint32_t FramePlayer::dueFrame(unsigned long now)
+{
+    return (now - _start) * _header.fps / 1000;
+}
+
+// reader continues at the keyframe at or before frame, returns false if there is no index
+bool FramePlayer::seekKey(uint32_t frame)
+{
+    if (!_file || _index.empty())
+        return false;
+    const FrameIndexEntry *key = &_index[0];
+    for (const FrameIndexEntry &entry : _index)
+        if (entry.frame <= frame)
+            key = &entry;
+
+    if (_fileMutex)
+        xSemaphoreTake(_fileMutex, portMAX_DELAY);
+    uint8_t i;
+    while (_filled && xQueueReceive(_filled, &i, 0) == pdTRUE) //read ahead buffers are from before the seek
+        xQueueSend(_free, &i, 0);
+    _file.seek(key->offset);
+    _readFrame = key->frame;
+    if (_fileMutex)
+        xSemaphoreGive(_fileMutex);
+
+    _frameNr = key->frame;
+    return true;
+}
+
+bool FramePlayer::seek(uint32_t frame)
+{
+    if (!seekKey(frame))
+        return false;
+    _start = timeSync.millis() - _frameNr * 1000 / _header.fps;
+    return true;
+}
+
+bool FramePlayer::frame(CRGB *leds, uint16_t nrOfLeds, uint32_t offset)
+{
+    if (!_file)
+        return false;
+
+    unsigned long now = timeSync.millis();
+    uint32_t due = dueFrame(now);
+    // the clock jumped (new leader, first sync): continue at the frame of the new time
+    if ((long)(now - _start) < 0 || due > _frameNr + _header.keyInterval + _header.fps) {
+        _start = _loop ? alignedStart(now) : now - _frameNr * 1000 / _header.fps;
+        due = dueFrame(now);
+        if (_loop)
+            seekKey(due);
+    }
+    // decode the frames which are due, at most 2 per loop to catch up without stalling the loop
+    for (uint8_t decoded = 0; decoded < 2 && _frameNr <= due; decoded++) {
+        uint8_t i;
+        if (xQueueReceive(_filled, &i, 0) != pdTRUE) {
+            if (decoded == 0 && due > _frameNr) _dropped++; //reader task behind
+            break;
+        }
+        Buffer &buffer = _buffers[i];
+        if (buffer.frame < _frameNr) { //recording started over
+            _start = alignedStart(now);
+            due = dueFrame(now);
+        }
+        uint32_t start = micros();
+        frameDecode(buffer.data, buffer.length, buffer.type, _current, _header.nrOfLeds);
+        _decodeMicros = micros() - start;
+        _frameNr = buffer.frame + 1;
+        xQueueSend(_free, &i, 0);
+    }
+
+    offset = MIN(offset, _header.nrOfLeds);
+    memcpy(leds, _current + offset, MIN(nrOfLeds, _header.nrOfLeds - offset) * sizeof(CRGB));
+    return true;
+}
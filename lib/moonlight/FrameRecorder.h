@@ -0,0 +1,99 @@
+/**
+    @title     MoonLight
+    @file      FrameRecorder.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/recorder/
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#ifndef FrameRecorder_h
+#define FrameRecorder_h
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <FS.h>
+#include "FrameCodec.h"
+#include <vector>
+
+// Captures frames to a file on LittleFS, call addFrame from the loop task after the frame is composed
+class FrameRecorder
+{
+public:
+    bool begin(fs::FS &fs, const char *path, uint16_t nrOfLeds, uint16_t fps);
+    bool addFrame(const CRGB *leds, uint16_t nrOfLeds);
+    bool end(); //writes the index and header
+    bool recording() { return _file; }
+    uint32_t frameCount() { return _header.frameCount; }
+    uint32_t bytes() { return _file ? _file.position() : 0; }
+
+private:
+    File _file;
+    FrameFileHeader _header = {};
+    std::vector<FrameIndexEntry> _index;
+    CRGB *_previous = nullptr;
+    uint8_t *_payload = nullptr;
+    unsigned long _lastFrame = 0;
+
+    void freeBuffers();
+};
+
+// Plays a recording into the fixture. A reader task streams the frame records from flash into two buffers
+// (read ahead one frame), the loop task decodes the current one, so flash latency does not hit the frame rate.
+class FramePlayer
+{
+public:
+    bool begin(fs::FS &fs, const char *path, bool loop = true);
+    void end();
+    bool playing() { return _file; }
+
+    // call every loop: writes the current frame into leds, advances at the recorded fps on the synchronized clock.
+    // offset: first led of the recording to play, a controller plays its slice of a recording of the whole installation
+    bool frame(CRGB *leds, uint16_t nrOfLeds, uint32_t offset = 0);
+    bool seek(uint32_t frame); //to the keyframe at or before frame
+
+    uint32_t frameNr() { return _frameNr; }
+    uint32_t frameCount() { return _header.frameCount; }
+    uint32_t dropped() { return _dropped; } //frames not read in time
+    uint32_t decodeMicros() { return _decodeMicros; }
+
+private:
+    struct Buffer
+    {
+        uint8_t *data = nullptr;
+        uint8_t type;
+        uint32_t length;
+        uint32_t frame;
+    };
+
+    File _file;
+    FrameFileHeader _header = {};
+    std::vector<FrameIndexEntry> _index;
+    bool _loop = true;
+    CRGB *_current = nullptr;
+    Buffer _buffers[2];
+    QueueHandle_t _free = nullptr;   //buffer indexes the reader task can fill
+    QueueHandle_t _filled = nullptr; //buffer indexes ready to decode
+    SemaphoreHandle_t _fileMutex = nullptr;
+    TaskHandle_t _task = nullptr;
+    volatile bool _stop = false;
+    uint32_t _readFrame = 0; //next frame the reader task reads
+    uint32_t _frameNr = 0;
+    unsigned long _start = 0;
+    uint32_t _dropped = 0;
+    uint32_t _decodeMicros = 0;
+
+    unsigned long alignedStart(unsigned long now);
+    uint32_t dueFrame(unsigned long now);
+    bool seekKey(uint32_t frame);
+    static void readerTask(void *parameter);
+    bool readRecord(Buffer &buffer);
+    void freeBuffers();
+};
+
+extern FrameRecorder frameRecorder;
+extern FramePlayer framePlayer;
+
+#endif
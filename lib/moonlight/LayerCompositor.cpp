@@ -0,0 +1,251 @@
+/**
+    @title     MoonLight
+    @file      LayerCompositor.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/effects/
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#include <LayerCompositor.h>
+#include <HeapTrace.h>
+
+LayerCompositor layerCompositor; //see .h
+
+// The kernels work on the raw r,g,b bytes in one branch-free loop over 3 * n bytes,
+// no per pixel function calls or CRGB operators, so the compiler can unroll and vectorize them.
+template <typename Op>
+static inline void blendBytes(uint8_t *__restrict d, const uint8_t *__restrict s, size_t len, Op op)
+{
+    for (size_t i = 0; i < len; i++)
+        d[i] = op(d[i], s[i]);
+}
+
+// scale is opacity + 1 (1..256) so opacity 255 results in s exactly
+static inline uint8_t mix(uint8_t d, uint8_t s, uint16_t scale)
+{
+    return d + ((((int16_t)s - d) * scale) >> 8);
+}
+
+void blendLeds(CRGB *__restrict dest, const CRGB *__restrict src, uint16_t n, uint8_t opacity, uint8_t blend)
+{
+    if (opacity == 0)
+        return;
+
+    uint8_t *d = (uint8_t *)dest;
+    const uint8_t *s = (const uint8_t *)src;
+    size_t len = n * sizeof(CRGB);
+    uint16_t scale = opacity + 1;
+
+    switch (blend)
+    {
+    case BLEND_ADD:
+        blendBytes(d, s, len, [scale](uint8_t a, uint8_t b) -> uint8_t {
+            uint16_t v = a + ((b * scale) >> 8);
+            return v > 255 ? 255 : v;
+        });
+        break;
+    case BLEND_MULTIPLY:
+        blendBytes(d, s, len, [scale](uint8_t a, uint8_t b) -> uint8_t {
+            return mix(a, (a * b + 255) >> 8, scale);
+        });
+        break;
+    case BLEND_SCREEN:
+        blendBytes(d, s, len, [scale](uint8_t a, uint8_t b) -> uint8_t {
+            return mix(a, 255 - (((255 - a) * (255 - b) + 255) >> 8), scale);
+        });
+        break;
+    default: // BLEND_ALPHA
+        if (opacity == UINT8_MAX)
+            memcpy(d, s, len);
+        else
+            blendBytes(d, s, len, [scale](uint8_t a, uint8_t b) -> uint8_t {
+                return mix(a, b, scale);
+            });
+        break;
+    }
+}
+
+static CRGB *allocLeds(uint16_t nrOfLeds)
+{
+    size_t size = nrOfLeds * sizeof(CRGB);
+    return (CRGB *)(psramFound() ? ps_malloc(size) : malloc(size));
+}
+
+LayerCompositor::~LayerCompositor()
+{
+    freeBuffers();
+    free(_frame);
+}
+
+void LayerCompositor::configure(const std::vector<LayerSettings> &layers, uint16_t nrOfLeds)
+{
+    HEAP_TAG("starlight");
+    size_t nrOfLayers = MIN(layers.size(), MAX_LAYERS);
+
+    //the render buffer (transitions) is allocated when needed
+    if (nrOfLayers != _layers.size() || nrOfLeds != _nrOfLeds)
+    {
+        freeBuffers();
+        _layers.resize(nrOfLayers);
+        _nrOfLeds = nrOfLeds;
+    }
+
+    for (size_t i = 0; i < nrOfLayers; i++)
+    {
+        LayerSettings settings = layers[i];
+        settings.end = MIN(settings.end, nrOfLeds);
+        settings.start = MIN(settings.start, settings.end);
+        _layers[i].settings = settings;
+    }
+
+    ESP_LOGD("", "LayerCompositor::configure %d layers %d leds", nrOfLayers, nrOfLeds);
+}
+
+// fixture size, compose mixes transitions in it
+bool LayerCompositor::renderBuffer()
+{
+    if (!_render) {
+        _render = allocLeds(_nrOfLeds);
+        if (!_render) {
+            ESP_LOGE("", "LayerCompositor: no memory for render buffer of %d leds", _nrOfLeds);
+            return false;
+        }
+        memset(_render, 0, _nrOfLeds * sizeof(CRGB));
+    }
+    return true;
+}
+
+void LayerCompositor::compose(CRGB *ledsP, uint16_t nrOfLeds)
+{
+    if (_layers.empty() || nrOfLeds != _nrOfLeds)
+        return;
+
+    uint32_t startMicros = micros();
+
+    //StarLight rendered layer 0 into the fixture buffer, nothing to do if it covers the fixture as is
+    Layer &layer = _layers[0];
+    const LayerSettings &settings = layer.settings;
+    if (settings.on && settings.opacity == UINT8_MAX && settings.blend != BLEND_MULTIPLY && settings.start == 0 &&
+        settings.end == nrOfLeds && !layer.snapshot)
+        return;
+
+    keepFrame(ledsP, nrOfLeds);
+    if (!_kept)
+        return; //no memory to keep the frame of the effect, shown as rendered
+
+    memset(ledsP, 0, nrOfLeds * sizeof(CRGB));
+    if (settings.on && settings.opacity && settings.start < settings.end) {
+        uint16_t n = settings.end - settings.start;
+        const CRGB *leds = layer.snapshot ? transition(layer, _frame + settings.start, n) : _frame + settings.start;
+        blendLeds(ledsP + settings.start, leds, n, settings.opacity, settings.blend);
+    }
+    layer.micros = micros() - startMicros;
+
+    _composeMicros = micros() - startMicros;
+    if (_composeMicros > COMPOSITOR_BUDGET_US)
+        _overBudget++;
+}
+
+void LayerCompositor::keepFrame(const CRGB *ledsP, uint16_t nrOfLeds)
+{
+    if (_kept)
+        return;
+    if (nrOfLeds != _frameLeds) {
+        HEAP_TAG("starlight");
+        free(_frame);
+        _frame = nrOfLeds ? allocLeds(nrOfLeds) : nullptr;
+        _frameLeds = _frame ? nrOfLeds : 0;
+        if (!_frame)
+            return;
+    }
+    memcpy(_frame, ledsP, nrOfLeds * sizeof(CRGB));
+    _kept = true;
+}
+
+void LayerCompositor::restoreFrame(CRGB *ledsP, uint16_t nrOfLeds)
+{
+    if (_kept && nrOfLeds == _frameLeds)
+        memcpy(ledsP, _frame, nrOfLeds * sizeof(CRGB));
+    _kept = false;
+}
+
+void LayerCompositor::setTransition(uint8_t type, uint16_t duration)
+{
+    _transitionType = MIN(type, TRANSITION_COUNT - 1);
+    _transitionDuration = duration;
+}
+
+void LayerCompositor::startTransition(uint8_t layer, const CRGB *ledsP, uint16_t nrOfLeds)
+{
+    if (!_transitionDuration || layer >= _layers.size() || nrOfLeds != _nrOfLeds)
+        return;
+
+    // the outgoing frame: the frame of the effect in the fixture
+    Layer &l = _layers[layer];
+    uint16_t n = l.settings.end - l.settings.start;
+    const CRGB *source = (_kept ? _frame : ledsP) + l.settings.start;
+    if (!n)
+        return;
+
+    size_t size = n * sizeof(CRGB);
+    if (!l.snapshot) { //a transition during a transition continues from the current frame
+        if (!psramFound() && size > TRANSITION_MAX_HEAP) {
+            ESP_LOGD("", "LayerCompositor: %d leds too large for a transition without PSRAM", n);
+            return;
+        }
+        HEAP_TAG("starlight");
+        l.snapshot = allocLeds(n);
+        if (!l.snapshot) {
+            ESP_LOGW("", "LayerCompositor: no memory for transition of %d leds, hard switch", n);
+            return;
+        }
+    }
+    memcpy(l.snapshot, source, size);
+    l.warmup = TRANSITION_WARMUP_FRAMES;
+}
+
+// leds is the new frame of the incoming effect in the bounding region (n leds), returns the frame to show:
+// mixed with the kept frame of the outgoing effect in the render buffer, the effect's own frame is never changed
+const CRGB *LayerCompositor::transition(Layer &layer, const CRGB *leds, uint16_t n)
+{
+    if (layer.warmup) {
+        // incoming effect renders its first frames (allocations, first state) behind the kept frame
+        if (--layer.warmup == 0)
+            layer.transitionStart = millis();
+        return layer.snapshot;
+    }
+
+    unsigned long elapsed = millis() - layer.transitionStart;
+    if (elapsed >= _transitionDuration || !renderBuffer()) {
+        free(layer.snapshot);
+        layer.snapshot = nullptr;
+        return leds;
+    }
+    uint8_t progress = elapsed * 256 / _transitionDuration;
+
+    CRGB *mixed = _render + layer.settings.start;
+    if (_transitionType == TRANSITION_WIPE) {
+        uint16_t edge = (uint32_t)n * progress / 256; //incoming up to edge, outgoing after it
+        memcpy(mixed, leds, edge * sizeof(CRGB));
+        memcpy(mixed + edge, layer.snapshot + edge, (n - edge) * sizeof(CRGB));
+    } else {
+        memcpy(mixed, leds, n * sizeof(CRGB));
+        blendLeds(mixed, layer.snapshot, n, 255 - progress, BLEND_ALPHA);
+    }
+    return mixed;
+}
+
+void LayerCompositor::freeBuffers()
+{
+    for (Layer &layer : _layers)
+    {
+        free(layer.snapshot);
+        layer.snapshot = nullptr;
+    }
+    _layers.clear();
+    free(_render);
+    _render = nullptr;
+}
@@ -0,0 +1,123 @@
+/**
+    @title     MoonLight
+    @file      LayerCompositor.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/effects/
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#ifndef LayerCompositor_h
+#define LayerCompositor_h
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <vector>
+
+#define MAX_LAYERS 1 //StarLight renders all its layer rows into the fixture buffer, only layer 0 can be composed
+#define COMPOSITOR_BUDGET_US 4000 //frames blending longer than this are counted in overBudget()
+#define TRANSITION_WARMUP_FRAMES 2 //frames the incoming effect renders before it is shown
+#define TRANSITION_MAX_HEAP 16384 //bytes, without PSRAM larger fixtures switch without transition
+
+enum BlendMode : uint8_t
+{
+    BLEND_ALPHA = 0,
+    BLEND_ADD,
+    BLEND_MULTIPLY,
+    BLEND_SCREEN,
+    BLEND_COUNT
+};
+
+enum TransitionType : uint8_t
+{
+    TRANSITION_CROSSFADE = 0,
+    TRANSITION_WIPE,
+    TRANSITION_COUNT
+};
+
+//settings of one layer as stored in EffectsState
+struct LayerSettings
+{
+    uint16_t effect = UINT16_MAX;
+    uint16_t projection = UINT16_MAX;
+    uint8_t opacity = UINT8_MAX;
+    uint8_t blend = BLEND_ALPHA;
+    uint16_t start = 0;          //first physical led of the bounding region
+    uint16_t end = UINT16_MAX;   //last physical led + 1, UINT16_MAX: until end of fixture
+    bool on = true;
+
+    bool operator!=(const LayerSettings &other) const
+    {
+        return effect != other.effect || projection != other.projection || opacity != other.opacity || blend != other.blend ||
+               start != other.start || end != other.end || on != other.on;
+    }
+};
+
+//blends a layer (opacity 0..255) into dest, n is the number of leds
+void blendLeds(CRGB *__restrict dest, const CRGB *__restrict src, uint16_t n, uint8_t opacity, uint8_t blend);
+
+// Composites the layer into the fixture buffer: the frame loopStar rendered into the fixture buffer, with the opacity,
+// blend mode and bounding region of layer 0. StarLight renders all its layer rows into that one buffer, so layers above
+// 0 can not be told apart and are rejected by EffectsState (MAX_LAYERS). The blending cost is one pass over the
+// bounding region, test/test_compositor checks it stays within COMPOSITOR_BUDGET_US for STARLIGHT_MAXLEDS.
+// Effects keep reading their own last frame: when the fixture buffer is changed after loopStar (composed, graph,
+// playback), keepFrame() saves the frame of the effect and restoreFrame() puts it back before the next loopStar.
+class LayerCompositor
+{
+public:
+    ~LayerCompositor();
+
+    // reallocates buffers if the number of layers or the fixture size changed, call from the loop task
+    void configure(const std::vector<LayerSettings> &layers, uint16_t nrOfLeds);
+
+    void compose(CRGB *ledsP, uint16_t nrOfLeds);
+
+    // before a stage overwrites the fixture buffer after loopStar, once per frame
+    void keepFrame(const CRGB *ledsP, uint16_t nrOfLeds);
+    // before loopStar: the effect of layer 0 continues from its own frame, not the one shown
+    void restoreFrame(CRGB *ledsP, uint16_t nrOfLeds);
+
+    // Effect transitions: call startTransition right before StarLight switches the effect of a layer.
+    // The last frame of the outgoing effect is kept, the incoming effect warms up behind it for TRANSITION_WARMUP_FRAMES
+    // and is then crossfaded or wiped in over duration ms, after which the kept frame is freed. duration 0: hard switch
+    void setTransition(uint8_t type, uint16_t duration);
+    void startTransition(uint8_t layer, const CRGB *ledsP, uint16_t nrOfLeds);
+    bool inTransition(uint8_t layer) { return layer < _layers.size() && _layers[layer].snapshot; }
+
+    uint8_t nrOfLayers() { return _layers.size(); }
+    uint32_t composeMicros() { return _composeMicros; } //of the last frame
+    uint32_t layerMicros(uint8_t layer) { return layer < _layers.size() ? _layers[layer].micros : 0; }
+    uint32_t overBudget() { return _overBudget; }
+
+private:
+    struct Layer
+    {
+        LayerSettings settings;
+        uint32_t micros = 0;
+        // transition
+        CRGB *snapshot = nullptr; //last frame of the outgoing effect
+        uint8_t warmup = 0;
+        unsigned long transitionStart = 0;
+    };
+
+    std::vector<Layer> _layers;
+    uint16_t _nrOfLeds = 0;
+    CRGB *_render = nullptr; //fixture size, compose mixes transitions in it
+    CRGB *_frame = nullptr;  //the frame of layer 0 while the fixture buffer shows another one
+    uint16_t _frameLeds = 0;
+    bool _kept = false;
+    uint32_t _composeMicros = 0;
+    uint32_t _overBudget = 0;
+    uint8_t _transitionType = TRANSITION_CROSSFADE;
+    uint16_t _transitionDuration = 0;
+
+    const CRGB *transition(Layer &layer, const CRGB *leds, uint16_t n);
+    bool renderBuffer();
+    void freeBuffers();
+};
+
+extern LayerCompositor layerCompositor; //composes the frame of loopStar, see main.cpp
+
+#endif
@@ -0,0 +1,155 @@
+/**
+    @title     MoonLight
+    @file      MappingTable.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/fixture/
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#include "MappingTable.h"
+#include <HeapTrace.h>
+
+#include <algorithm>
+
+MappingTable mappingTable; //see .h
+
+MappingTable::~MappingTable()
+{
+    clear();
+}
+
+void MappingTable::begin(uint16_t width, uint16_t height, uint16_t depth, bool psram)
+{
+    clear();
+    _width = width;
+    _height = height;
+    _depth = depth;
+    _wide = (uint32_t)width * height * depth > UINT16_MAX + 1;
+    _psram = psram && psramFound();
+}
+
+void MappingTable::add(uint32_t virtualIndex, uint16_t physicalIndex)
+{
+    if (virtualIndex >= (uint32_t)_width * _height * _depth)
+        return;
+    if (_wide)
+        addSpan<uint32_t>(virtualIndex, physicalIndex);
+    else
+        addSpan<uint16_t>(virtualIndex, physicalIndex);
+}
+
+template <typename V>
+void MappingTable::addSpan(uint32_t virtualIndex, uint16_t physicalIndex)
+{
+    MappingSpan<V> *spans = (MappingSpan<V> *)_spans;
+    if (_nrOfSpans) {
+        MappingSpan<V> &last = spans[_nrOfSpans - 1];
+        if ((uint32_t)last.virtualStart + last.length == virtualIndex && last.physicalStart + last.length == physicalIndex && last.length < UINT16_MAX) {
+            last.length++;
+            return;
+        }
+        if (virtualIndex < last.virtualStart)
+            _sorted = false;
+    }
+
+    if (_nrOfSpans == _capacity) {
+        HEAP_TAG("starlight");
+        size_t capacity = _capacity ? _capacity * 2 : 64;
+        void *spans = _psram ? ps_realloc(_spans, capacity * sizeof(MappingSpan<V>)) : realloc(_spans, capacity * sizeof(MappingSpan<V>));
+        if (!spans) {
+            ESP_LOGE("", "MappingTable: no memory for %d spans", capacity);
+            return;
+        }
+        _spans = spans;
+        _capacity = capacity;
+    }
+    ((MappingSpan<V> *)_spans)[_nrOfSpans++] = {(V)virtualIndex, physicalIndex, 1};
+}
+
+template <typename V>
+void MappingTable::sortAndMerge()
+{
+    MappingSpan<V> *spans = (MappingSpan<V> *)_spans;
+    if (!_sorted)
+        std::sort(spans, spans + _nrOfSpans, [](const MappingSpan<V> &a, const MappingSpan<V> &b) {
+            return a.virtualStart != b.virtualStart ? a.virtualStart < b.virtualStart : a.physicalStart < b.physicalStart;
+        });
+    _sorted = true;
+
+    // leds added out of order end up as spans of one, join the contiguous ones
+    size_t n = 0;
+    _maxLength = 0;
+    for (size_t i = 0; i < _nrOfSpans; i++) {
+        if (n) {
+            MappingSpan<V> &last = spans[n - 1];
+            if ((uint32_t)last.virtualStart + last.length == spans[i].virtualStart && last.physicalStart + last.length == spans[i].physicalStart &&
+                last.length + spans[i].length <= UINT16_MAX) {
+                last.length += spans[i].length;
+                _maxLength = MAX(_maxLength, last.length);
+                continue;
+            }
+        }
+        spans[n++] = spans[i];
+        _maxLength = MAX(_maxLength, spans[i].length);
+    }
+    _nrOfSpans = n;
+}
+
+void MappingTable::end()
+{
+    if (_wide)
+        sortAndMerge<uint32_t>();
+    else
+        sortAndMerge<uint16_t>();
+
+    HEAP_TAG("starlight");
+    // give back the unused capacity
+    if (_nrOfSpans && _nrOfSpans < _capacity) {
+        void *spans = _psram ? ps_realloc(_spans, _nrOfSpans * spanSize()) : realloc(_spans, _nrOfSpans * spanSize());
+        if (spans) {
+            _spans = spans;
+            _capacity = _nrOfSpans;
+        }
+    }
+
+    // spans in PSRAM are slow to read, walk the hot range in internal RAM
+    if (_psram && _nrOfSpans > MAPPING_HOT_SPANS)
+        _hot = malloc(MAPPING_HOT_SPANS * spanSize());
+
+    ESP_LOGI("", "MappingTable %dx%dx%d: %d spans %d bytes (dense %d bytes)%s", _width, _height, _depth, _nrOfSpans, bytes(), denseBytes(),
+             _psram ? " in PSRAM" : "");
+}
+
+void MappingTable::clear()
+{
+    free(_spans);
+    free(_hot);
+    _spans = _hot = nullptr;
+    _nrOfSpans = _capacity = _hotFirst = _hotCount = 0;
+    _maxLength = 0;
+    _sorted = true;
+    _walks = _hotHits = 0;
+}
+
+// the first span which can contain from or a later virtual led: spans are sorted by start, not by end, so step back
+// over the spans starting less than _maxLength before from
+template <typename V>
+size_t MappingTable::first(uint32_t from)
+{
+    const MappingSpan<V> *spans = (const MappingSpan<V> *)_spans;
+    size_t i = std::lower_bound(spans, spans + _nrOfSpans, from, [](const MappingSpan<V> &s, uint32_t v) { return s.virtualStart < v; }) - spans;
+    while (i && spans[i - 1].virtualStart + _maxLength > from)
+        i--;
+    return i;
+}
+
+void MappingTable::analytics(JsonObject &root)
+{
+    root["mapping_spans"] = _nrOfSpans;
+    root["mapping_bytes"] = bytes();
+    root["mapping_dense_bytes"] = denseBytes();
+    root["mapping_hot_hit_pct"] = _walks ? _hotHits * 100 / _walks : 0;
+}
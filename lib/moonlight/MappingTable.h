@@ -0,0 +1,123 @@
+/**
+    @title     MoonLight
+    @file      MappingTable.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/fixture/
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#ifndef MappingTable_h
+#define MappingTable_h
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#define MAPPING_HOT_SPANS 64 //spans of the hot range cache, in internal RAM
+
+// A run of virtual leds mapped to a run of physical leds: virtual v..v+length-1 -> physical p..p+length-1
+template <typename V>
+struct MappingSpan
+{
+    V virtualStart;
+    uint16_t physicalStart;
+    uint16_t length;
+};
+
+// Sparse mapping between the virtual grid of a fixture (its bounding box, index x + width * (y + height * z)) and its
+// physical leds. A dense table has an entry for every virtual led, most of them unmapped in a sparse 3D fixture. This
+// table only stores runs of contiguous indexes (spans), sorted by virtual index, so memory scales with the fixture,
+// not with the virtual volume. Spans are 6 bytes if the grid has at most 65536 leds, else 8 bytes, in PSRAM if
+// available. forRange() walks the spans of a range of virtual leds through a hot range cache: the spans of the last
+// walk copied to internal RAM, effects walk the same or the next range each frame so most walks hit it.
+// FixtureService fills it on a new fixture: begin(), add() for every led, end(). Call from the loop task.
+class MappingTable
+{
+public:
+    ~MappingTable();
+
+    void begin(uint16_t width, uint16_t height, uint16_t depth, bool psram = true);
+    void add(uint32_t virtualIndex, uint16_t physicalIndex); //in any order, one virtual led may map to more physical leds
+    void end(); //sorts and merges the spans
+    void clear();
+
+    uint16_t width() { return _width; }
+    uint16_t height() { return _height; }
+    uint16_t depth() { return _depth; }
+
+    // calls f(virtualIndex, physicalIndex) for every mapped virtual led from <= virtualIndex < to, in virtual order
+    template <typename F>
+    void forRange(uint32_t from, uint32_t to, F f)
+    {
+        if (_wide)
+            walk<uint32_t>(from, to, f);
+        else
+            walk<uint16_t>(from, to, f);
+    }
+
+    size_t nrOfSpans() { return _nrOfSpans; }
+    size_t bytes() { return _nrOfSpans * spanSize() + (_hot ? MAPPING_HOT_SPANS * spanSize() : 0); }
+    size_t denseBytes() { return (size_t)_width * _height * _depth * sizeof(uint16_t); } //what an entry per virtual led needs
+
+    void analytics(JsonObject &root);
+
+private:
+    void *_spans = nullptr;
+    size_t _nrOfSpans = 0;
+    size_t _capacity = 0;
+    uint16_t _maxLength = 0; //spans covering a virtual led start at most this far before it
+    bool _wide = false;      //32 bit virtual indexes
+    bool _psram = false;
+    bool _sorted = true;
+    uint16_t _width = 0, _height = 0, _depth = 0;
+
+    void *_hot = nullptr; //copy of spans _hotFirst.._hotFirst + _hotCount - 1
+    size_t _hotFirst = 0;
+    size_t _hotCount = 0;
+
+    uint32_t _walks = 0, _hotHits = 0;
+
+    size_t spanSize() { return _wide ? sizeof(MappingSpan<uint32_t>) : sizeof(MappingSpan<uint16_t>); }
+
+    template <typename V>
+    void addSpan(uint32_t virtualIndex, uint16_t physicalIndex);
+    template <typename V>
+    void sortAndMerge();
+    template <typename V>
+    size_t first(uint32_t from);
+
+    template <typename V, typename F>
+    void walk(uint32_t from, uint32_t to, F f)
+    {
+        if (!_nrOfSpans || from >= to)
+            return;
+        _walks++;
+        const MappingSpan<V> *spans = (const MappingSpan<V> *)_spans;
+        const MappingSpan<V> *hot = (const MappingSpan<V> *)_hot;
+        size_t i = first<V>(from);
+        if (hot) {
+            if (i >= _hotFirst && i < _hotFirst + _hotCount)
+                _hotHits++;
+            else { //reload the hot range from here on
+                _hotFirst = i;
+                _hotCount = MIN((size_t)MAPPING_HOT_SPANS, _nrOfSpans - i);
+                memcpy(_hot, spans + i, _hotCount * sizeof(MappingSpan<V>));
+            }
+        }
+        for (; i < _nrOfSpans; i++) {
+            const MappingSpan<V> &span = hot && i - _hotFirst < _hotCount ? hot[i - _hotFirst] : spans[i];
+            if (span.virtualStart >= to)
+                break;
+            uint32_t start = MAX((uint32_t)span.virtualStart, from);
+            uint32_t end = MIN((uint32_t)span.virtualStart + span.length, to);
+            for (uint32_t v = start; v < end; v++)
+                f(v, (uint16_t)(span.physicalStart + (v - span.virtualStart)));
+        }
+    }
+};
+
+extern MappingTable mappingTable; //the fixture, filled by FixtureService, used by the Plane effect node
+
+#endif
@@ -0,0 +1,117 @@
+/**
+    @title     MoonLight
+    @file      MonitorLod.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/fixture/
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#include "MonitorLod.h"
+
+#include <algorithm>
+#include <math.h>
+
+uint16_t MonitorLod::bucket(uint16_t budget)
+{
+    if (budget < MONITOR_LOD_MIN_BUDGET)
+        return MONITOR_LOD_MIN_BUDGET;
+    uint16_t bucket = MONITOR_LOD_MIN_BUDGET;
+    while (bucket <= budget / 2)
+        bucket *= 2;
+    return bucket;
+}
+
+bool MonitorLod::build(const uint8_t *geometry, uint16_t nrOfLeds, uint16_t budget)
+{
+    const uint8_t *coords = geometry + 2;
+
+    uint8_t lo[3] = {UINT8_MAX, UINT8_MAX, UINT8_MAX}, hi[3] = {0, 0, 0};
+    for (uint16_t i = 0; i < nrOfLeds; i++)
+        for (uint8_t a = 0; a < 3; a++) {
+            lo[a] = MIN(lo[a], coords[i * 3 + a]);
+            hi[a] = MAX(hi[a], coords[i * 3 + a]);
+        }
+    if (!nrOfLeds)
+        return false;
+
+    // start with the cell size which gives budget voxels if the bounding box were full, grow until few enough are occupied
+    float volume = (float)(hi[0] - lo[0] + 1) * (hi[1] - lo[1] + 1) * (hi[2] - lo[2] + 1);
+    float cell = MAX(1.0f, cbrtf(volume / budget));
+
+    std::vector<uint64_t> entries(nrOfLeds); //voxel << 16 | led, sorted: leds of a voxel are adjacent
+    uint16_t nrOfPoints = 0;
+    while (true) {
+        uint32_t nx = (hi[0] - lo[0]) / cell + 1, ny = (hi[1] - lo[1]) / cell + 1;
+        for (uint16_t i = 0; i < nrOfLeds; i++) {
+            uint32_t cx = (coords[i * 3] - lo[0]) / cell;
+            uint32_t cy = (coords[i * 3 + 1] - lo[1]) / cell;
+            uint32_t cz = (coords[i * 3 + 2] - lo[2]) / cell;
+            entries[i] = ((uint64_t)(cx + nx * (cy + ny * cz)) << 16) | i;
+        }
+        std::sort(entries.begin(), entries.end());
+
+        uint32_t occupied = 1;
+        for (uint16_t i = 1; i < nrOfLeds; i++)
+            if ((entries[i] >> 16) != (entries[i - 1] >> 16))
+                occupied++;
+
+        if (occupied <= budget || cell > UINT8_MAX) { //one voxel at most
+            nrOfPoints = occupied;
+            break;
+        }
+        cell *= 1.25f;
+    }
+
+    _budget = budget;
+    _nrOfPoints = nrOfPoints;
+    _samples.assign(nrOfPoints * MONITOR_LOD_SAMPLES, UINT16_MAX);
+    _geometry.resize(2 + nrOfPoints * 3);
+    _geometry[0] = geometry[0];
+    _geometry[1] = geometry[1];
+    _frame.resize(3 + nrOfPoints * 3);
+
+    uint16_t point = 0;
+    for (uint16_t first = 0; first < nrOfLeds; point++) {
+        uint16_t last = first;
+        while (last < nrOfLeds && (entries[last] >> 16) == (entries[first] >> 16))
+            last++;
+        uint16_t count = last - first;
+
+        uint32_t sum[3] = {0, 0, 0};
+        for (uint16_t i = first; i < last; i++)
+            for (uint8_t a = 0; a < 3; a++)
+                sum[a] += coords[(entries[i] & 0xFFFF) * 3 + a];
+        for (uint8_t a = 0; a < 3; a++)
+            _geometry[2 + point * 3 + a] = sum[a] / count;
+
+        // samples spread over the leds of the voxel
+        for (uint8_t s = 0; s < MIN(count, MONITOR_LOD_SAMPLES); s++)
+            _samples[point * MONITOR_LOD_SAMPLES + s] = entries[first + s * count / MIN(count, MONITOR_LOD_SAMPLES)] & 0xFFFF;
+
+        first = last;
+    }
+
+    ESP_LOGI("", "MonitorLod budget %d: %d leds to %d points, cell %.1f", budget, nrOfLeds, nrOfPoints, cell);
+    return true;
+}
+
+size_t MonitorLod::frame(const uint8_t *ledsPExtended, uint8_t *&output)
+{
+    memcpy(_frame.data(), ledsPExtended, 3); //3 bytes for type and factor and size
+    const uint8_t *leds = ledsPExtended + 3;
+    for (uint16_t point = 0; point < _nrOfPoints; point++) {
+        const uint16_t *samples = &_samples[point * MONITOR_LOD_SAMPLES];
+        uint16_t sum[3] = {0, 0, 0};
+        uint8_t count = 0;
+        for (; count < MONITOR_LOD_SAMPLES && samples[count] != UINT16_MAX; count++)
+            for (uint8_t c = 0; c < 3; c++)
+                sum[c] += leds[samples[count] * 3 + c];
+        for (uint8_t c = 0; c < 3; c++)
+            _frame[3 + point * 3 + c] = sum[c] / count;
+    }
+    output = _frame.data();
+    return _frame.size();
+}
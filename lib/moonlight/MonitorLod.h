@@ -0,0 +1,52 @@
+/**
+    @title     MoonLight
+    @file      MonitorLod.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/fixture/
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#ifndef MonitorLod_h
+#define MonitorLod_h
+
+#include <Arduino.h>
+#include <vector>
+
+#define MONITOR_LOD_MIN_BUDGET 64
+#define MONITOR_LOD_SAMPLES 4 //leds per point averaged each frame
+#define MONITOR_MAX_LODS 4    //different budgets kept at the same time
+
+// Level of detail of the monitor: the leds are grouped in a voxel grid with at most budget occupied voxels.
+// Each voxel is one point at the average position of its leds. Its color is the average of up to MONITOR_LOD_SAMPLES
+// of its leds, so building a frame costs budget x MONITOR_LOD_SAMPLES, not nrOfLeds.
+class MonitorLod
+{
+public:
+    // geometry as in FixtureService: [factor, size, x,y,z per led]
+    bool build(const uint8_t *geometry, uint16_t nrOfLeds, uint16_t budget);
+
+    uint16_t budget() { return _budget; }
+    uint16_t nrOfPoints() { return _nrOfPoints; }
+
+    // [factor, size, x,y,z per point]
+    const uint8_t *geometry() { return _geometry.data(); }
+    size_t geometryLen() { return _geometry.size(); }
+
+    // [3 header bytes, r,g,b per point] in a buffer owned by this object
+    size_t frame(const uint8_t *ledsPExtended, uint8_t *&output);
+
+    // rounds down to a power of 2 so clients with similar screens share a map
+    static uint16_t bucket(uint16_t budget);
+
+private:
+    uint16_t _budget = 0;
+    uint16_t _nrOfPoints = 0;
+    std::vector<uint16_t> _samples; //MONITOR_LOD_SAMPLES led indexes per point, UINT16_MAX: unused
+    std::vector<uint8_t> _geometry;
+    std::vector<uint8_t> _frame;
+};
+
+#endif
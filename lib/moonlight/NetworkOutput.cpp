@@ -0,0 +1,163 @@
+/**
+    @title     MoonLight
+    @file      NetworkOutput.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/output/
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#include <NetworkOutput.h>
+
+// FNV-1a, brightness is part of the hash as it changes the bytes sent
+static uint32_t hashLeds(const CRGB *leds, uint16_t n, uint8_t brightness)
+{
+    uint32_t hash = 2166136261u ^ brightness;
+    const uint8_t *bytes = (const uint8_t *)leds;
+    for (size_t i = 0; i < n * sizeof(CRGB); i++)
+        hash = (hash ^ bytes[i]) * 16777619u;
+    return hash;
+}
+
+void NetworkOutput::show(const CRGB *ledsP, uint16_t nrOfLeds, uint8_t brightness, uint32_t elapsed, uint8_t *packet, const OutputSend &sender)
+{
+    uint16_t start = MIN(settings.start, nrOfLeds);
+    uint16_t count = MIN(settings.count, nrOfLeds - start);
+    if (!count)
+        return;
+
+    const CRGB *leds = ledsP + start;
+    uint16_t perPacket = (settings.protocol == OUTPUT_DDP ? DDP_MAX_DATA : ARTNET_MAX_DATA) / sizeof(CRGB);
+    uint16_t nrOfPackets = (count + perPacket - 1) / perPacket;
+    size_t maxPacketSize = settings.protocol == OUTPUT_DDP ? DDP_HEADER_SIZE + DDP_MAX_DATA : ARTNET_HEADER_SIZE + ARTNET_MAX_DATA;
+
+    if (_hashes.size() != nrOfPackets) { //only reallocates when the fixture size changes
+        _hashes.assign(nrOfPackets, 0);
+        _changed.assign(nrOfPackets, true);
+    }
+
+    // token buckets: allow bursts of 100ms, but always at least one frame
+    if (settings.maxPacketsPerSecond)
+        _packetTokens = MIN(_packetTokens + elapsed * (settings.maxPacketsPerSecond / 1000000.0f),
+                            MAX(settings.maxPacketsPerSecond / 10.0f, nrOfPackets + 1.0f));
+    if (settings.maxKbps)
+        _byteTokens = MIN(_byteTokens + elapsed * (settings.maxKbps * 125 / 1000000.0f),
+                          MAX(settings.maxKbps * 125 / 10.0f, (float)nrOfPackets * maxPacketSize));
+
+    bool keepAlive = millis() - _lastKeepAlive >= OUTPUT_KEEPALIVE;
+    if (keepAlive)
+        _lastKeepAlive = millis();
+
+    // first find the changed packets: DDP pushes with the last packet of the frame
+    uint16_t last = UINT16_MAX;
+    for (uint16_t p = 0; p < nrOfPackets; p++) {
+        uint32_t hash = hashLeds(leds + p * perPacket, MIN(perPacket, count - p * perPacket), brightness);
+        _changed[p] = !settings.skipUnchanged || keepAlive || hash != _hashes[p];
+        _hashes[p] = hash; //cleared below if throttled
+        if (_changed[p])
+            last = p;
+    }
+    if (last == UINT16_MAX) {
+        skipped += nrOfPackets;
+        return;
+    }
+
+    _sequence = settings.protocol == OUTPUT_DDP ? _sequence % 15 + 1 : _sequence % 255 + 1;
+
+    bool throttle = false;
+    bool sent = false;
+    for (uint16_t p = 0; p < nrOfPackets; p++) {
+        if (!_changed[p]) {
+            skipped++;
+            continue;
+        }
+        if (throttle || (settings.maxPacketsPerSecond && _packetTokens < 1) || (settings.maxKbps && _byteTokens < maxPacketSize)) {
+            throttle = true;
+            _hashes[p] = 0; //send next frame
+            throttled++;
+            continue;
+        }
+
+        uint16_t n = MIN(perPacket, count - p * perPacket);
+        size_t len = settings.protocol == OUTPUT_DDP ? buildDDP(packet, leds + p * perPacket, n, p * perPacket * sizeof(CRGB), p == last, brightness)
+                                                     : buildArtDmx(packet, leds + p * perPacket, n, settings.universe + p, brightness);
+        if (settings.maxPacketsPerSecond)
+            _packetTokens -= 1;
+        if (settings.maxKbps)
+            _byteTokens -= len;
+        send(packet, len, sender);
+        sent = true;
+    }
+
+    if (sent && settings.protocol == OUTPUT_ARTNET)
+        send(packet, buildArtSync(packet), sender); //receivers show the universes of this frame together
+}
+
+static void copyLeds(uint8_t *dest, const CRGB *leds, uint16_t n, uint8_t brightness)
+{
+    if (brightness == UINT8_MAX)
+        memcpy(dest, leds, n * sizeof(CRGB));
+    else {
+        const uint8_t *bytes = (const uint8_t *)leds;
+        for (size_t i = 0; i < n * sizeof(CRGB); i++)
+            dest[i] = scale8(bytes[i], brightness);
+    }
+}
+
+size_t NetworkOutput::buildDDP(uint8_t *packet, const CRGB *leds, uint16_t n, uint32_t offset, bool push, uint8_t brightness)
+{
+    uint16_t len = n * sizeof(CRGB);
+    packet[0] = 0x40 | (push ? 0x01 : 0x00); //version 1, push
+    packet[1] = _sequence & 0x0F;
+    packet[2] = 0x0B; //RGB, 8 bit per channel
+    packet[3] = 1;    //default output device
+    packet[4] = offset >> 24;
+    packet[5] = offset >> 16;
+    packet[6] = offset >> 8;
+    packet[7] = offset;
+    packet[8] = len >> 8;
+    packet[9] = len;
+    copyLeds(packet + DDP_HEADER_SIZE, leds, n, brightness);
+    return DDP_HEADER_SIZE + len;
+}
+
+size_t NetworkOutput::buildArtDmx(uint8_t *packet, const CRGB *leds, uint16_t n, uint16_t universe, uint8_t brightness)
+{
+    uint16_t len = n * sizeof(CRGB);
+    memcpy(packet, "Art-Net", 8);
+    packet[8] = 0x00; //OpDmx, little endian
+    packet[9] = 0x50;
+    packet[10] = 0; //protocol version 14
+    packet[11] = 14;
+    packet[12] = _sequence;
+    packet[13] = 0;
+    packet[14] = universe;
+    packet[15] = (universe >> 8) & 0x7F;
+    copyLeds(packet + ARTNET_HEADER_SIZE, leds, n, brightness);
+    if (len & 1) //length must be even
+        packet[ARTNET_HEADER_SIZE + len++] = 0;
+    packet[16] = len >> 8;
+    packet[17] = len;
+    return ARTNET_HEADER_SIZE + len;
+}
+
+size_t NetworkOutput::buildArtSync(uint8_t *packet)
+{
+    memcpy(packet, "Art-Net", 8);
+    packet[8] = 0x00; //OpSync
+    packet[9] = 0x52;
+    packet[10] = 0;
+    packet[11] = 14;
+    packet[12] = 0;
+    packet[13] = 0;
+    return 14;
+}
+
+void NetworkOutput::send(const uint8_t *packet, size_t len, const OutputSend &sender)
+{
+    sender(settings, packet, len);
+    packets++;
+    bytes += len;
+}
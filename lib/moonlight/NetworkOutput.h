@@ -0,0 +1,84 @@
+/**
+    @title     MoonLight
+    @file      NetworkOutput.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/output/
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#ifndef NetworkOutput_h
+#define NetworkOutput_h
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <vector>
+
+#define OUTPUT_KEEPALIVE 1000 //ms, unchanged packets are resent so receivers do not time out
+
+#define DDP_PORT 4048
+#define DDP_HEADER_SIZE 10
+#define DDP_MAX_DATA 1440 //480 leds, fits one ethernet frame
+#define ARTNET_PORT 6454
+#define ARTNET_HEADER_SIZE 18
+#define ARTNET_MAX_DATA 510 //170 leds per universe
+
+enum OutputProtocol : uint8_t
+{
+    OUTPUT_DDP = 0,
+    OUTPUT_ARTNET,
+    OUTPUT_PROTOCOL_COUNT
+};
+
+struct OutputDestination
+{
+    uint8_t protocol = OUTPUT_DDP;
+    uint32_t ip = 0xFFFFFFFF; //255.255.255.255: broadcast
+    uint16_t start = 0;          //first led of the fixture to send
+    uint16_t count = UINT16_MAX; //number of leds, UINT16_MAX: until end of fixture
+    uint16_t universe = 0;       //Art-Net: first universe
+    uint16_t maxPacketsPerSecond = 0; //0: no limit
+    uint16_t maxKbps = 0;             //0: no limit
+    bool skipUnchanged = true;
+    bool on = true;
+
+    bool operator!=(const OutputDestination &other) const
+    {
+        return protocol != other.protocol || ip != other.ip || start != other.start || count != other.count || universe != other.universe ||
+               maxPacketsPerSecond != other.maxPacketsPerSecond || maxKbps != other.maxKbps || skipUnchanged != other.skipUnchanged || on != other.on;
+    }
+};
+
+// sends one packet to the destination, the packet buffer is reused for the next one
+typedef std::function<void(const OutputDestination &destination, const uint8_t *packet, size_t len)> OutputSend;
+
+// One destination of NetworkOutputService: builds the DDP or Art-Net packets of a frame, skips packets (DDP) or
+// universes (Art-Net) whose leds did not change since they were last sent and limits the traffic with token buckets.
+// No network or locking here, so it runs on the host, see test/test_networkoutput
+class NetworkOutput
+{
+public:
+    OutputDestination settings;
+    // stats
+    uint32_t packets = 0, bytes = 0, skipped = 0, throttled = 0;
+
+    // all packets of the frame go out back to back, ending with the DDP push flag or an ArtSync. packet is the buffer
+    // to build them in, DDP_HEADER_SIZE + DDP_MAX_DATA bytes. elapsed: us since the previous frame, for the rate limits
+    void show(const CRGB *ledsP, uint16_t nrOfLeds, uint8_t brightness, uint32_t elapsed, uint8_t *packet, const OutputSend &send);
+
+private:
+    std::vector<uint32_t> _hashes; //per packet, of the leds last sent
+    std::vector<bool> _changed;    //per packet, this frame
+    uint8_t _sequence = 0;
+    float _packetTokens = 0, _byteTokens = 0;
+    unsigned long _lastKeepAlive = 0;
+
+    size_t buildDDP(uint8_t *packet, const CRGB *leds, uint16_t n, uint32_t offset, bool push, uint8_t brightness);
+    size_t buildArtDmx(uint8_t *packet, const CRGB *leds, uint16_t n, uint16_t universe, uint8_t brightness);
+    size_t buildArtSync(uint8_t *packet);
+    void send(const uint8_t *packet, size_t len, const OutputSend &sender);
+};
+
+#endif
@@ -0,0 +1,210 @@
+/**
+    @title     MoonLight
+    @file      NetworkOutputService.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/output/
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#include <NetworkOutputService.h>
+
+void NetworkOutputState::read(NetworkOutputState &state, JsonObject &root)
+{
+    root["on"] = state.on;
+    root["fps"] = state.fps;
+
+    JsonArray destinations = root["destinations"].to<JsonArray>();
+    for (OutputDestination &destination : state.destinations) {
+        JsonObject object = destinations.add<JsonObject>();
+        object["protocol"] = destination.protocol;
+        object["ip"] = IPAddress(destination.ip).toString();
+        object["start"] = destination.start;
+        object["count"] = destination.count;
+        object["universe"] = destination.universe;
+        object["maxPacketsPerSecond"] = destination.maxPacketsPerSecond;
+        object["maxKbps"] = destination.maxKbps;
+        object["skipUnchanged"] = destination.skipUnchanged;
+        object["on"] = destination.on;
+    }
+}
+
+StateUpdateResult NetworkOutputState::update(JsonObject &root, NetworkOutputState &state)
+{
+    bool on = root["on"] | false;
+    uint8_t fps = MAX(root["fps"] | (uint8_t)OUTPUT_MAX_FPS, 1);
+    bool changed = state.on != on || state.fps != fps;
+
+    std::vector<OutputDestination> destinations;
+    if (root["destinations"].is<JsonArray>()) {
+        for (JsonObject object : root["destinations"].as<JsonArray>()) {
+            if (destinations.size() >= MAX_OUTPUT_DESTINATIONS) {
+                ESP_LOGW("", "NetworkOutput.destinations max %d destinations", MAX_OUTPUT_DESTINATIONS);
+                break;
+            }
+            OutputDestination destination;
+            destination.protocol = MIN(object["protocol"] | (uint8_t)OUTPUT_DDP, OUTPUT_PROTOCOL_COUNT - 1);
+            IPAddress ip;
+            const char *address = object["ip"] | "255.255.255.255";
+            if (!ip.fromString(address)) {
+                ESP_LOGW("", "NetworkOutput.destinations[%d].ip %s is not an ip address", destinations.size(), address);
+                return StateUpdateResult::ERROR; //nothing changed, a typo must not broadcast
+            }
+            destination.ip = (uint32_t)ip;
+            destination.start = object["start"] | 0;
+            destination.count = object["count"] | UINT16_MAX;
+            destination.universe = object["universe"] | 0;
+            destination.maxPacketsPerSecond = object["maxPacketsPerSecond"] | 0;
+            destination.maxKbps = object["maxKbps"] | 0;
+            destination.skipUnchanged = object["skipUnchanged"] | true;
+            destination.on = object["on"] | true;
+            destinations.push_back(destination);
+        }
+    }
+
+    if (destinations.size() != state.destinations.size())
+        changed = true;
+    else
+        for (uint8_t i = 0; i < destinations.size(); i++)
+            if (destinations[i] != state.destinations[i]) changed = true;
+
+    if (changed) {
+        state.on = on;
+        state.fps = fps;
+        state.destinations = destinations;
+        ESP_LOGI("", "NetworkOutputState::update on:%d fps:%d %d destinations", state.on, state.fps, destinations.size());
+    }
+
+    return changed?StateUpdateResult::CHANGED:StateUpdateResult::UNCHANGED;
+}
+
+NetworkOutputService::NetworkOutputService(PsychicHttpServer *server,
+                                           ESP32SvelteKit *sveltekit) : _httpEndpoint(NetworkOutputState::read,
+                                                                                      NetworkOutputState::update,
+                                                                                      this,
+                                                                                      server,
+                                                                                      "/rest/networkOutputState",
+                                                                                      sveltekit->getSecurityManager(),
+                                                                                      AuthenticationPredicates::IS_AUTHENTICATED),
+                                                                        _eventEndpoint(NetworkOutputState::read,
+                                                                                       NetworkOutputState::update,
+                                                                                       this,
+                                                                                       sveltekit->getSocket(),
+                                                                                       "networkOutput"),
+                                                                        _webSocketServer(NetworkOutputState::read,
+                                                                                         NetworkOutputState::update,
+                                                                                         this,
+                                                                                         server,
+                                                                                         "/ws/networkOutputState",
+                                                                                         sveltekit->getSecurityManager(),
+                                                                                         AuthenticationPredicates::IS_AUTHENTICATED),
+                                                                        _socket(sveltekit->getSocket()),
+                                                                        _fsPersistence(NetworkOutputState::read,
+                                                                                       NetworkOutputState::update,
+                                                                                       this,
+                                                                                       sveltekit->getFS(),
+                                                                                       "/config/networkOutputState.json"),
+                                                                        _server(server),
+                                                                        _securityManager(sveltekit->getSecurityManager())
+{
+    // the outputs are used by show() in the loop task, so they are rebuilt there
+    addUpdateHandler([&](const String &originId)
+                     {
+                         bool on = _state.on;
+                         uint8_t fps = _state.fps;
+                         std::vector<OutputDestination> destinations = _state.destinations;
+                         runInLoopTask.push_back([this, on, fps, destinations] { configure(on, fps, destinations); });
+                     },
+                     false);
+
+    _send = [this](const OutputDestination &destination, const uint8_t *packet, size_t len)
+    {
+        uint16_t port = destination.protocol == OUTPUT_DDP ? DDP_PORT : ARTNET_PORT;
+        if (destination.ip == 0xFFFFFFFF)
+            _udp.broadcastTo((uint8_t *)packet, len, port);
+        else
+            _udp.writeTo(packet, len, IPAddress(destination.ip), port);
+    };
+}
+
+void NetworkOutputService::begin()
+{
+    _httpEndpoint.begin();
+    _eventEndpoint.begin();
+    _fsPersistence.readFromFS();
+
+    configure(_state.on, _state.fps, _state.destinations);
+
+    _server->on(NETWORK_OUTPUT_STATS_PATH,
+                HTTP_GET,
+                _securityManager->wrapRequest(std::bind(&NetworkOutputService::getStats, this, std::placeholders::_1),
+                                              AuthenticationPredicates::IS_AUTHENTICATED));
+
+    ESP_LOGV("NetworkOutputService", "Registered GET endpoint: %s", NETWORK_OUTPUT_STATS_PATH);
+}
+
+void NetworkOutputService::configure(bool on, uint8_t fps, const std::vector<OutputDestination> &destinations)
+{
+    xSemaphoreTake(_outputsMutex, portMAX_DELAY);
+    _on = on;
+    _fps = fps;
+    _outputs.resize(destinations.size());
+    for (uint8_t i = 0; i < destinations.size(); i++) {
+        if (_outputs[i].settings != destinations[i])
+            _outputs[i] = NetworkOutput(); //reset stats, hashes and rate limits
+        _outputs[i].settings = destinations[i];
+    }
+    xSemaphoreGive(_outputsMutex);
+}
+
+void NetworkOutputService::show(const CRGB *ledsP, uint16_t nrOfLeds, uint8_t brightness)
+{
+    if (!_on || _outputs.empty() || !WiFi.isConnected())
+        return;
+
+    // the loop task calls show() every pass, hashing and sending the fixture that often would only repeat frames
+    uint32_t now = micros();
+    uint32_t elapsed = now - _lastShow;
+    if (elapsed < 1000000 / _fps)
+        return;
+    _lastShow = now;
+
+    xSemaphoreTake(_outputsMutex, portMAX_DELAY); //getStats reads the outputs
+    for (NetworkOutput &output : _outputs)
+        if (output.settings.on)
+            output.show(ledsP, nrOfLeds, brightness, elapsed, _packet, _send);
+    xSemaphoreGive(_outputsMutex);
+
+    _showMicros = micros() - now;
+}
+
+esp_err_t NetworkOutputService::getStats(PsychicRequest *request)
+{
+    struct OutputStats
+    {
+        uint32_t ip, packets, bytes, skipped, throttled;
+    };
+    std::vector<OutputStats> stats;
+    xSemaphoreTake(_outputsMutex, portMAX_DELAY); //copied, the response is built and sent without the lock
+    for (NetworkOutput &output : _outputs)
+        stats.push_back({output.settings.ip, output.packets, output.bytes, output.skipped, output.throttled});
+    xSemaphoreGive(_outputsMutex);
+
+    PsychicJsonResponse response = PsychicJsonResponse(request, false);
+    JsonObject root = response.getRoot();
+
+    root["showMicros"] = _showMicros;
+    JsonArray outputs = root["outputs"].to<JsonArray>();
+    for (OutputStats &output : stats) {
+        JsonObject object = outputs.add<JsonObject>();
+        object["ip"] = IPAddress(output.ip).toString();
+        object["packets"] = output.packets;
+        object["bytes"] = output.bytes;
+        object["skipped"] = output.skipped;
+        object["throttled"] = output.throttled;
+    }
+
+    return response.send();
+}
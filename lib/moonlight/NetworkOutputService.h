@@ -0,0 +1,78 @@
+/**
+    @title     MoonLight
+    @file      NetworkOutputService.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/output/
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#ifndef NetworkOutputService_h
+#define NetworkOutputService_h
+
+#include <EventSocket.h>
+#include <HttpEndpoint.h>
+#include <EventEndpoint.h>
+#include <WebSocketServer.h>
+#include <PsychicHttp.h>
+#include <FSPersistence.h>
+#include <AsyncUDP.h>
+#include <NetworkOutput.h>
+
+#define NETWORK_OUTPUT_STATS_PATH "/rest/networkOutputStats"
+#define MAX_OUTPUT_DESTINATIONS 8
+#define OUTPUT_MAX_FPS 50 //default frame rate of the output
+
+class NetworkOutputState
+{
+public:
+    bool on = false;
+    uint8_t fps = OUTPUT_MAX_FPS; //frames per second sent at most, the loop runs more often than StarLight renders
+    std::vector<OutputDestination> destinations;
+
+    static void read(NetworkOutputState &state, JsonObject &root);
+
+    static StateUpdateResult update(JsonObject &root, NetworkOutputState &state);
+};
+
+// Sends the fixture buffer to remote pixel controllers as DDP or Art-Net, one NetworkOutput per destination.
+class NetworkOutputService : public StatefulService<NetworkOutputState>
+{
+public:
+    NetworkOutputService(PsychicHttpServer *server,
+                         ESP32SvelteKit *sveltekit);
+
+    void begin();
+
+    // call from the loop task after the frame is complete, sends at most fps frames per second.
+    // Brightness is applied while building the packets
+    void show(const CRGB *ledsP, uint16_t nrOfLeds, uint8_t brightness);
+
+protected:
+    EventSocket *_socket;
+
+private:
+    HttpEndpoint<NetworkOutputState> _httpEndpoint;
+    EventEndpoint<NetworkOutputState> _eventEndpoint;
+    WebSocketServer<NetworkOutputState> _webSocketServer;
+    FSPersistence<NetworkOutputState> _fsPersistence;
+    PsychicHttpServer *_server;
+    SecurityManager *_securityManager;
+
+    bool _on = false;
+    uint8_t _fps = OUTPUT_MAX_FPS;
+    std::vector<NetworkOutput> _outputs; //changed in the loop task, read by getStats
+    SemaphoreHandle_t _outputsMutex = xSemaphoreCreateMutex();
+    unsigned long _lastShow = 0;   //us
+    uint32_t _showMicros = 0;
+    AsyncUDP _udp;
+    uint8_t _packet[DDP_HEADER_SIZE + DDP_MAX_DATA]; //reused for all packets, AsyncUDP copies it
+    OutputSend _send;
+
+    void configure(bool on, uint8_t fps, const std::vector<OutputDestination> &destinations);
+    esp_err_t getStats(PsychicRequest *request);
+};
+
+#endif
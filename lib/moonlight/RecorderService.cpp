@@ -0,0 +1,109 @@
+/**
+    @title     MoonLight
+    @file      RecorderService.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/recorder/
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#include "RecorderService.h"
+#include "LayerCompositor.h"
+#include "FixtureService.h"
+
+#include <ESPFS.h>
+
+RecorderService recorderService; //see .h
+
+void RecorderService::begin(PsychicHttpServer *server, ESP32SvelteKit *sveltekit)
+{
+    SecurityManager *securityManager = sveltekit->getSecurityManager();
+    server->on(RECORDER_SERVICE_PATH,
+               HTTP_GET,
+               securityManager->wrapRequest(std::bind(&RecorderService::getStatus, this, std::placeholders::_1),
+                                            AuthenticationPredicates::IS_AUTHENTICATED));
+
+    ESP_LOGV("RecorderService", "Registered GET endpoint: %s", RECORDER_SERVICE_PATH);
+
+    server->on(RECORDER_SERVICE_PATH,
+               HTTP_POST,
+               securityManager->wrapCallback(std::bind(&RecorderService::postCommand, this, std::placeholders::_1, std::placeholders::_2),
+                                             AuthenticationPredicates::IS_AUTHENTICATED));
+
+    ESP_LOGV("RecorderService", "Registered POST endpoint: %s", RECORDER_SERVICE_PATH);
+}
+
+void RecorderService::loop(CRGB *ledsP, uint16_t nrOfLeds)
+{
+    _nrOfLeds = nrOfLeds;
+    if (framePlayer.playing()) {
+        layerCompositor.keepFrame(ledsP, nrOfLeds); //the effects continue from their own frame after playback
+        // a recording of the whole installation: play the slice of this controller, its leds are consecutive in the recording
+        FixtureSlice slice;
+        fixtureSlice.read(slice);
+        uint32_t offset = slice.width ? ((uint32_t)slice.z * slice.height + slice.y) * slice.width + slice.x : 0;
+        framePlayer.frame(ledsP, nrOfLeds, offset);
+    }
+    if (frameRecorder.recording())
+        frameRecorder.addFrame(ledsP, nrOfLeds);
+}
+
+esp_err_t RecorderService::getStatus(PsychicRequest *request)
+{
+    PsychicJsonResponse response = PsychicJsonResponse(request, false);
+    JsonObject root = response.getRoot();
+
+    root["recording"] = frameRecorder.recording();
+    root["recordedFrames"] = frameRecorder.frameCount();
+    root["recordedBytes"] = frameRecorder.bytes();
+    root["playing"] = framePlayer.playing();
+    root["frame"] = framePlayer.frameNr();
+    root["frameCount"] = framePlayer.frameCount();
+    root["dropped"] = framePlayer.dropped();
+    root["decode_us"] = framePlayer.decodeMicros();
+
+    return response.send();
+}
+
+esp_err_t RecorderService::postCommand(PsychicRequest *request, JsonVariant &json)
+{
+    if (!json.is<JsonObject>())
+        return request->reply(400);
+
+    String action = json["action"] | "";
+    String path = json["path"] | RECORDER_DEFAULT_PATH;
+    uint16_t fps = json["fps"] | 40;
+    bool loop = json["loop"] | true;
+    uint32_t frame = json["frame"] | 0;
+
+    // record overwrites the file: no config, certificates or scripts, only recordings
+    if ((action == "record" || action == "play") &&
+        (!path.startsWith(RECORDER_DIR "/") || path.indexOf("..") >= 0 || path.indexOf("//") >= 0 || !path.endsWith(".mlr")))
+        return request->reply(400, "text/plain", "path must be a .mlr file in " RECORDER_DIR);
+
+    if (action == "record")
+        runInLoopTask.push_back([this, path, fps] {
+            framePlayer.end();
+            if (!ESPFS.exists(RECORDER_DIR))
+                ESPFS.mkdir(RECORDER_DIR);
+            frameRecorder.begin(ESPFS, path.c_str(), _nrOfLeds, fps);
+        });
+    else if (action == "play")
+        runInLoopTask.push_back([path, loop] {
+            frameRecorder.end();
+            framePlayer.begin(ESPFS, path.c_str(), loop);
+        });
+    else if (action == "seek")
+        runInLoopTask.push_back([frame] { framePlayer.seek(frame); });
+    else if (action == "stop")
+        runInLoopTask.push_back([] {
+            frameRecorder.end();
+            framePlayer.end();
+        });
+    else
+        return request->reply(400);
+
+    return request->reply(200);
+}
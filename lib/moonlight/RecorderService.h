@@ -0,0 +1,46 @@
+/**
+    @title     MoonLight
+    @file      RecorderService.h
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Doc       https://moonmodules.org/MoonLight/moonlight/recorder/
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+#ifndef RecorderService_h
+#define RecorderService_h
+
+#include <Arduino.h>
+#include <PsychicHttp.h>
+#include <ESP32SvelteKit.h>
+#include "FrameRecorder.h"
+
+#define RECORDER_SERVICE_PATH "/rest/recorder"
+#define RECORDER_DIR "/recordings" //record and play only in here
+#define RECORDER_DEFAULT_PATH RECORDER_DIR "/recording.mlr"
+
+// REST control of frameRecorder and framePlayer:
+//   GET  /rest/recorder: status
+//   POST /rest/recorder {"action": "record" | "play" | "seek" | "stop", "path": ..., "fps": 40, "loop": true, "frame": 0}
+//   path: a .mlr file in RECORDER_DIR
+// Commands run in the loop task, where frames are composed, recorded and played.
+class RecorderService
+{
+public:
+    void begin(PsychicHttpServer *server, ESP32SvelteKit *sveltekit);
+
+    // call after the frame is composed: playback replaces it, recording captures it
+    void loop(CRGB *ledsP, uint16_t nrOfLeds);
+
+private:
+    uint16_t _nrOfLeds = 0;
+
+    esp_err_t getStatus(PsychicRequest *request);
+    esp_err_t postCommand(PsychicRequest *request, JsonVariant &json);
+};
+
+extern RecorderService recorderService;
+
+#endif
@@ -0,0 +1,198 @@
+#!/usr/bin/env python
+#
+# Delta firmware updates (.mld), see lib/framework/DeltaUpdate.h for the format
+#
+#   python scripts/delta.py make <running.bin> <new.bin> <out.mld>   patch from the firmware running on the device
+#   python scripts/delta.py apply <running.bin> <patch.mld> <out.bin> rebuild new.bin as the device does
+#   python scripts/delta.py test <old.bin> <new.bin> [...]            make + apply for each pair, verify, show sizes
+#   python scripts/delta.py hash <firmware.bin>                       the sha256 the device reports as firmware_sha256
+#
+# Upload the .mld on the firmware upload page or pass it as delta_url to POST /rest/downloadUpdate.
+# The device only applies a patch made against the exact image it runs, otherwise upload the full .bin.
+
+import hashlib
+import struct
+import sys
+import zlib
+
+MAGIC = 0x31444C4D  # "MLD1"
+HEADER = struct.Struct("<II32sI32sI")
+CONTROL = struct.Struct("<iii")
+KEY = 8  # bytes hashed to find match candidates
+STEP = 4  # index every STEP-th old position, search tries STEP new positions
+CANDIDATES = 4  # old positions kept per key
+
+
+def match_len(a, ai, b, bi):
+    # length of the exact match a[ai:] == b[bi:], slices compare in C so grow and halve the step
+    n = 0
+    limit = min(len(a) - ai, len(b) - bi)
+    step = 64
+    while n < limit:
+        s = min(step, limit - n)
+        if a[ai + n : ai + n + s] == b[bi + n : bi + n + s]:
+            n += s
+            step *= 2
+        elif step > 1:
+            step //= 2
+        else:
+            break
+    return n
+
+
+def index(old):
+    table = {}
+    for i in range(0, len(old) - KEY, STEP):
+        positions = table.setdefault(old[i : i + KEY], [])
+        if len(positions) < CANDIDATES:
+            positions.append(i)
+    return table
+
+
+def search(table, old, new, scan):
+    # longest match of new[scan:] in old
+    best_len, best_pos = 0, 0
+    for k in range(STEP):
+        for pos in table.get(new[scan + k : scan + k + KEY], ()):
+            pos -= k
+            if pos < 0 or (best_len and pos == best_pos):
+                continue
+            n = match_len(old, pos, new, scan)
+            if n > best_len:
+                best_len, best_pos = n, pos
+    return best_len, best_pos
+
+
+def diff(old, new):
+    # bsdiff: split new in runs that mostly match old at one offset (stored as byte differences, which are
+    # mostly 0 after a code change moved addresses and compress well) and extra bytes not found in old
+    table = index(old)
+    records = []
+    scan = length = pos = lastscan = lastpos = lastoffset = 0
+    while scan < len(new):
+        oldscore = 0
+        scan += length
+        scsc = scan
+        while scan < len(new):
+            length, pos = search(table, old, new, scan)
+            while scsc < scan + length:
+                if scsc + lastoffset < len(old) and old[scsc + lastoffset] == new[scsc]:
+                    oldscore += 1
+                scsc += 1
+            if (length == oldscore and length) or length > oldscore + 8:
+                break
+            if scan + lastoffset < len(old) and old[scan + lastoffset] == new[scan]:
+                oldscore -= 1
+            scan += 1
+
+        if length != oldscore or scan == len(new):
+            s = sf = lenf = i = 0
+            while lastscan + i < scan and lastpos + i < len(old):
+                if old[lastpos + i] == new[lastscan + i]:
+                    s += 1
+                i += 1
+                if s * 2 - i > sf * 2 - lenf:
+                    sf, lenf = s, i
+
+            lenb = 0
+            if scan < len(new):
+                s = sb = 0
+                i = 1
+                while scan >= lastscan + i and pos >= i:
+                    if old[pos - i] == new[scan - i]:
+                        s += 1
+                    if s * 2 - i > sb * 2 - lenb:
+                        sb, lenb = s, i
+                    i += 1
+
+            if lastscan + lenf > scan - lenb:
+                overlap = (lastscan + lenf) - (scan - lenb)
+                s = ss = lens = 0
+                for i in range(overlap):
+                    if new[lastscan + lenf - overlap + i] == old[lastpos + lenf - overlap + i]:
+                        s += 1
+                    if new[scan - lenb + i] == old[pos - lenb + i]:
+                        s -= 1
+                    if s > ss:
+                        ss, lens = s, i + 1
+                lenf += lens - overlap
+                lenb -= lens
+
+            delta = bytes((new[lastscan + i] - old[lastpos + i]) & 0xFF for i in range(lenf))
+            extra = new[lastscan + lenf : scan - lenb]
+            seek = (pos - lenb) - (lastpos + lenf)
+            records.append((delta, extra, seek))
+
+            lastscan, lastpos, lastoffset = scan - lenb, pos - lenb, pos - scan
+    return records
+
+
+def make(old, new):
+    body = bytearray()
+    for delta, extra, seek in diff(old, new):
+        body += CONTROL.pack(len(delta), len(extra), seek) + delta + extra
+    header = HEADER.pack(MAGIC, len(old), hashlib.sha256(old).digest(), len(new), hashlib.sha256(new).digest(), 0)
+    return header + zlib.compress(bytes(body), 9)
+
+
+def apply(old, patch):
+    magic, old_size, old_sha, new_size, new_sha, _ = HEADER.unpack_from(patch)
+    if magic != MAGIC:
+        raise ValueError("not a delta file")
+    if old_size != len(old) or hashlib.sha256(old).digest() != old_sha:
+        raise ValueError("patch is not made for this firmware")
+    body = zlib.decompress(patch[HEADER.size :])
+    new = bytearray()
+    p = oldpos = 0
+    while len(new) < new_size:
+        diff_len, extra_len, seek = CONTROL.unpack_from(body, p)
+        p += CONTROL.size
+        if diff_len < 0 or extra_len < 0 or oldpos + diff_len > len(old) or len(new) + diff_len + extra_len > new_size:
+            raise ValueError("corrupt patch")
+        new += bytes((body[p + i] + old[oldpos + i]) & 0xFF for i in range(diff_len))
+        p += diff_len
+        new += body[p : p + extra_len]
+        p += extra_len
+        oldpos += diff_len + seek
+    if hashlib.sha256(new).digest() != new_sha:
+        raise ValueError("sha256 mismatch")
+    return bytes(new)
+
+
+def read(path):
+    with open(path, "rb") as f:
+        return f.read()
+
+
+def write(path, data):
+    with open(path, "wb") as f:
+        f.write(data)
+
+
+def main(args):
+    if len(args) == 4 and args[0] == "make":
+        patch = make(read(args[1]), read(args[2]))
+        write(args[3], patch)
+        print(f"{args[3]}: {len(patch)} bytes")
+    elif len(args) == 4 and args[0] == "apply":
+        write(args[3], apply(read(args[1]), read(args[2])))
+    elif len(args) == 2 and args[0] == "hash":
+        print(hashlib.sha256(read(args[1])).hexdigest())
+    elif len(args) >= 3 and len(args) % 2 == 1 and args[0] == "test":
+        for i in range(1, len(args), 2):
+            old, new = read(args[i]), read(args[i + 1])
+            patch = make(old, new)
+            assert apply(old, patch) == new, "roundtrip failed"
+            full = len(zlib.compress(new, 9))
+            try:  # the device refuses a patch for another base image
+                apply(new, patch)
+                raise AssertionError("patch applied to the wrong base")
+            except ValueError:
+                pass
+            print(f"{args[i]} -> {args[i + 1]}: image {len(new)}, compressed {full}, delta {len(patch)} ({100 * len(patch) / len(new):.1f}%) ok")
+    else:
+        sys.exit("usage: delta.py make <running.bin> <new.bin> <out.mld> | apply <running.bin> <patch.mld> <out.bin> | test <old.bin> <new.bin> [...] | hash <firmware.bin>")
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,175 @@
+#!/usr/bin/env python
+#
+# Encode and verify MoonLight frame recordings (.mlr), see lib/moonlight/FrameRecorder.h for the format
+#
+#   python scripts/frames.py encode <raw rgb file> <nrOfLeds> <fps> <out.mlr>   raw: frames of nrOfLeds x r,g,b bytes
+#   python scripts/frames.py encode --pattern <nrOfLeds> <frames> <fps> <out.mlr> a moving rainbow test pattern
+#   python scripts/frames.py verify <file.mlr> [raw rgb file]                    check structure, decode all frames,
+#                                                                                optionally compare with the raw frames
+#
+# Upload the .mlr with the file manager (e.g. to /recordings) and play it with POST /rest/recorder
+
+import colorsys
+import struct
+import sys
+
+MAGIC = 0x52434C4D
+VERSION = 1
+KEY = 0
+DELTA = 1
+KEY_INTERVAL = 50
+HEADER = struct.Struct("<IBBHHHII")
+RECORD = struct.Struct("<BI")
+INDEX_ENTRY = struct.Struct("<II")
+
+
+def encode_frame(leds, previous):
+    pixels = leds if previous is None else bytes(a ^ b for a, b in zip(leds, previous))
+    n = len(pixels) // 3
+    px = [pixels[i * 3 : i * 3 + 3] for i in range(n)]
+    out = bytearray()
+    i = 0
+    while i < n:
+        run = 1
+        while i + run < n and run < 129 and px[i + run] == px[i]:
+            run += 1
+        if run >= 2:
+            out.append(126 + run)
+            out += px[i]
+            i += run
+            continue
+        start = i
+        while i < n and i - start < 128:
+            if i + 1 < n and px[i] == px[i + 1]:
+                break
+            i += 1
+        out.append(i - start - 1)
+        for k in range(start, i):
+            out += px[k]
+    return bytes(out)
+
+
+def decode_frame(payload, kind, leds):
+    n = len(leds) // 3
+    p = 0
+    i = 0
+    while p < len(payload):
+        c = payload[p]
+        p += 1
+        if c < 128:
+            count = c + 1
+            if i + count > n or p + count * 3 > len(payload):
+                return False
+            data = payload[p : p + count * 3]
+            p += count * 3
+        else:
+            count = c - 126
+            if i + count > n or p + 3 > len(payload):
+                return False
+            data = payload[p : p + 3] * count
+            p += 3
+        for k in range(count * 3):
+            leds[i * 3 + k] = data[k] if kind == KEY else leds[i * 3 + k] ^ data[k]
+        i += count
+    return i == n
+
+
+def encode(frames, nrOfLeds, fps, path):
+    index = []
+    previous = None
+    with open(path, "wb") as f:
+        f.write(HEADER.pack(MAGIC, VERSION, 0, nrOfLeds, fps, KEY_INTERVAL, 0, 0))
+        count = 0
+        for leds in frames:
+            key = count % KEY_INTERVAL == 0
+            if key:
+                index.append((count, f.tell()))
+            payload = encode_frame(leds, None if key else previous)
+            f.write(RECORD.pack(KEY if key else DELTA, len(payload)))
+            f.write(payload)
+            previous = leds
+            count += 1
+        indexOffset = f.tell()
+        f.write(struct.pack("<I", len(index)))
+        for entry in index:
+            f.write(INDEX_ENTRY.pack(*entry))
+        size = f.tell()
+        f.seek(0)
+        f.write(HEADER.pack(MAGIC, VERSION, 0, nrOfLeds, fps, KEY_INTERVAL, count, indexOffset))
+    print("%s: %d frames of %d leds, %d bytes (%.1f%% of raw)" % (path, count, nrOfLeds, size, 100.0 * size / max(1, count * nrOfLeds * 3)))
+
+
+def raw_frames(path, nrOfLeds):
+    with open(path, "rb") as f:
+        while True:
+            leds = f.read(nrOfLeds * 3)
+            if len(leds) < nrOfLeds * 3:
+                return
+            yield leds
+
+
+def pattern_frames(nrOfLeds, frames):
+    for t in range(frames):
+        leds = bytearray()
+        for i in range(nrOfLeds):
+            r, g, b = colorsys.hsv_to_rgb(((i + t) % 256) / 256.0, 1.0, 1.0 if i % 64 < 32 else 0.0)
+            leds += bytes((int(r * 255), int(g * 255), int(b * 255)))
+        yield bytes(leds)
+
+
+def verify(path, rawPath=None):
+    data = open(path, "rb").read()
+    errors = []
+    magic, version, _, nrOfLeds, fps, keyInterval, frameCount, indexOffset = HEADER.unpack_from(data, 0)
+    if magic != MAGIC or version != VERSION:
+        sys.exit("%s: not a recording (magic %08x version %d)" % (path, magic, version))
+    if not indexOffset:
+        sys.exit("%s: recording not finished (no index)" % path)
+
+    raw = raw_frames(rawPath, nrOfLeds) if rawPath else None
+    leds = bytearray(nrOfLeds * 3)
+    keys = {}
+    pos = HEADER.size
+    frame = 0
+    while pos < indexOffset:
+        kind, length = RECORD.unpack_from(data, pos)
+        if kind == KEY:
+            keys[frame] = pos
+        elif frame == 0:
+            errors.append("frame 0 is not a keyframe")
+        payload = data[pos + RECORD.size : pos + RECORD.size + length]
+        if len(payload) != length or not decode_frame(payload, kind, leds):
+            errors.append("frame %d: corrupt payload" % frame)
+            break
+        if raw is not None and bytes(leds) != next(raw, None):
+            errors.append("frame %d differs from %s" % (frame, rawPath))
+        pos += RECORD.size + length
+        frame += 1
+
+    if pos != indexOffset:
+        errors.append("frame records end at %d, index at %d" % (pos, indexOffset))
+    if frame != frameCount:
+        errors.append("header frameCount %d, %d frames found" % (frameCount, frame))
+    (count,) = struct.unpack_from("<I", data, indexOffset)
+    index = [INDEX_ENTRY.unpack_from(data, indexOffset + 4 + i * INDEX_ENTRY.size) for i in range(count)]
+    if indexOffset + 4 + count * INDEX_ENTRY.size != len(data):
+        errors.append("index size mismatch")
+    if dict(index) != keys:
+        errors.append("index does not match the keyframes")
+
+    print("%s: %d leds, %d fps, %d frames, %d keyframes (interval %d), %d bytes" % (path, nrOfLeds, fps, frame, len(keys), keyInterval, len(data)))
+    for error in errors:
+        print("  error: " + error)
+    return not errors
+
+
+if __name__ == "__main__":
+    args = sys.argv[1:]
+    if len(args) == 6 and args[0] == "encode" and args[1] == "--pattern":
+        encode(pattern_frames(int(args[2]), int(args[3])), int(args[2]), int(args[4]), args[5])
+    elif len(args) == 5 and args[0] == "encode":
+        encode(raw_frames(args[1], int(args[2])), int(args[2]), int(args[3]), args[4])
+    elif len(args) in (2, 3) and args[0] == "verify":
+        sys.exit(0 if verify(args[1], args[2] if len(args) == 3 else None) else 1)
+    else:
+        sys.exit("usage: frames.py encode <raw> <nrOfLeds> <fps> <out.mlr> | encode --pattern <nrOfLeds> <frames> <fps> <out.mlr> | verify <file.mlr> [raw]")
@@ -57,6 +57,21 @@ LightStateService::LightStateService(PsychicHttpServer *server,
     addUpdateHandler([&](const String &originId)
                      { onConfigUpdated(); },
                      false);
+
+    // plain value command topic <mqtt path>/led/set: ON or OFF, without JSON
+    _mqttEndpoint.onCommand("led", [](const char *value, LightState &state)
+                            {
+        bool ledOn;
+        if (!MqttRouter::parseBool(value, ledOn))
+        {
+            return StateUpdateResult::ERROR;
+        }
+        if (state.ledOn == ledOn)
+        {
+            return StateUpdateResult::UNCHANGED;
+        }
+        state.ledOn = ledOn;
+        return StateUpdateResult::CHANGED; });
 }
 
 void LightStateService::begin()
@@ -23,6 +23,7 @@
 #include <EventEndpoint.h>
 #include <WebSocketServer.h>
 #include <ESP32SvelteKit.h>
+#include <StateFields.h>
 
 #define DEFAULT_LED_STATE false
 #define OFF_STATE "OFF"
@@ -37,21 +38,8 @@ class LightState
 public:
     bool ledOn;
 
-    static void read(LightState &settings, JsonObject &root)
-    {
-        root["led_on"] = settings.ledOn;
-    }
-
-    static StateUpdateResult update(JsonObject &root, LightState &lightState)
-    {
-        boolean newState = root["led_on"] | DEFAULT_LED_STATE;
-        if (lightState.ledOn != newState)
-        {
-            lightState.ledOn = newState;
-            return StateUpdateResult::CHANGED;
-        }
-        return StateUpdateResult::UNCHANGED;
-    }
+    static void read(LightState &settings, JsonObject &root);
+    static StateUpdateResult update(JsonObject &root, LightState &lightState);
 
     static void homeAssistRead(LightState &settings, JsonObject &root)
     {
@@ -81,6 +69,19 @@ public:
     }
 };
 
+constexpr state_field_t lightStateFieldList[] = {STATE_FIELD_AS(LightState, ledOn, "led_on")};
+constexpr StateFields lightStateFields(lightStateFieldList);
+
+inline void LightState::read(LightState &settings, JsonObject &root)
+{
+    lightStateFields.read(&settings, root);
+}
+
+inline StateUpdateResult LightState::update(JsonObject &root, LightState &lightState)
+{
+    return lightStateFields.update(root, &lightState) ? StateUpdateResult::CHANGED : StateUpdateResult::UNCHANGED;
+}
+
 class LightStateService : public StatefulService<LightState>
 {
 public:
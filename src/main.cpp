@@ -19,8 +19,13 @@
 
 #include <StarService.h>
 #include <FilesService.h>
+#include <InstanceService.h>
+#include <TimeSync.h>
 #include <FixtureService.h>
 #include <EffectsService.h>
+#include <MappingTable.h>
+#include <NetworkOutputService.h>
+#include <RecorderService.h>
 
 #define SERIAL_BAUD_RATE 115200
 
@@ -42,6 +47,8 @@ LightStateService lightStateService = LightStateService(&server,
     StarService starService = StarService(&server, &esp32sveltekit);
     FixtureService fixtureService = FixtureService(&server, &esp32sveltekit);
     EffectsService effectsService = EffectsService(&server, &esp32sveltekit, &fixtureService);
+    InstanceService instanceService = InstanceService(&server, &esp32sveltekit);
+    NetworkOutputService networkOutputService = NetworkOutputService(&server, &esp32sveltekit);
     #include "mainStar.h"
 #endif
 
@@ -53,15 +60,14 @@ int my_vprintf(const char *format, va_list args)
     return 1;//vprintf(format, args);
 }
 
-WiFiUDP instanceUDP;
-const int instanceUDPPort = 65506;
-
 // AsyncUDP artnetudp;// AsyncUDP so we can just blast packets.
 
 void setup()
 {
     // sys->safeMode = true; //e.g. in case of a crash
 
+    bootProfile.mark("setup");
+
     // start serial and filesystem
     Serial.begin(SERIAL_BAUD_RATE);
 
@@ -71,10 +77,12 @@ void setup()
 
     #if FT_ENABLED(FT_MOONLIGHT)
         setupStar(); //before ESK as ESK loop uses star stuff
+        bootProfile.mark("star");
     #endif
 
-    // start ESP32-SvelteKit
+    // start ESP32-SvelteKit, non critical services start after the first frame, see loop
     esp32sveltekit.begin();
+    bootProfile.mark("esp32sveltekit services");
 
     #if FT_ENABLED(FT_FILEMANAGER)
         filesService.begin();
@@ -83,12 +91,14 @@ void setup()
         starService.begin();
         fixtureService.begin(); //before effectservice!
         effectsService.begin();
+        bootProfile.mark("fixture and effects");
     #endif
 
     // load the initial light settings
     lightStateService.begin();
     // start the light service
     lightMqttSettingsService.begin();
+    bootProfile.mark("light state");
 
     // ESP_LOGV("Star", "Starting loop task");
     // xTaskCreateUniversal(
@@ -101,7 +111,60 @@ void setup()
     //     ARDUINO_RUNNING_CORE // Pin to application core
     // );
 
-    instanceUDP.begin(instanceUDPPort); //instances
+    #if FT_ENABLED(FT_MOONLIGHT)
+        instanceService.begin();
+        timeSync.begin(&server, &esp32sveltekit, &instanceService);
+        networkOutputService.begin();
+        recorderService.begin(&server, &esp32sveltekit);
+        bootProfile.mark("moonlight services");
+
+        #if FT_ENABLED(FT_ANALYTICS)
+            esp32sveltekit.getAnalyticsService()->addAnalytics([](JsonObject &root) {
+                mappingTable.analytics(root);
+                root["compose_over_budget"] = layerCompositor.overBudget();
+            });
+        #endif
+
+        // broadcast local changes to the other instances, not the ones received from them
+        fixtureService.addUpdateHandler([&](const String &originId)
+        {
+            if (originId == INSTANCE_ORIGIN_ID) return;
+            fixtureService.read([&](FixtureState &state) {
+                instanceService.setState(INSTANCE_FIELD_ON, state.lightsOn);
+                instanceService.setState(INSTANCE_FIELD_BRIGHTNESS, state.brightness);
+            });
+        });
+        effectsService.addUpdateHandler([&](const String &originId)
+        {
+            if (originId == INSTANCE_ORIGIN_ID) return;
+            effectsService.read([&](EffectsState &state) {
+                instanceService.setState(INSTANCE_FIELD_EFFECT, state.effect);
+                instanceService.setState(INSTANCE_FIELD_PROJECTION, state.projection);
+            });
+        });
+
+        // apply changes of other instances (runs in the loop task, see instanceService.loop)
+        instanceService.onState([&](const Instance &sender, const InstanceState &state, uint8_t fields)
+        {
+            ESP_LOGD("", "Instance %s state fields %x", sender.name, fields);
+            if (fields & (INSTANCE_FIELD_ON | INSTANCE_FIELD_BRIGHTNESS)) {
+                JsonDocument doc;
+                JsonObject root = doc.to<JsonObject>();
+                fixtureService.read(root, FixtureState::read);
+                if (fields & INSTANCE_FIELD_ON) root["lightsOn"] = (bool)state.on;
+                if (fields & INSTANCE_FIELD_BRIGHTNESS) root["brightness"] = state.brightness;
+                fixtureService.update(root, FixtureState::update, INSTANCE_ORIGIN_ID);
+            }
+            if (fields & (INSTANCE_FIELD_EFFECT | INSTANCE_FIELD_PROJECTION)) {
+                JsonDocument doc;
+                JsonObject root = doc.to<JsonObject>();
+                effectsService.read(root, EffectsState::read);
+                if (fields & INSTANCE_FIELD_EFFECT) root["effect"] = state.effect;
+                if (fields & INSTANCE_FIELD_PROJECTION) root["projection"] = state.projection;
+                effectsService.update(root, EffectsState::update, INSTANCE_ORIGIN_ID);
+            }
+        });
+    #endif
 
     #if FT_ENABLED(FT_FILEMANAGER)
         update_handler_id_t _updateHandlerId = filesService.addUpdateHandler([&](const String &originId)
@@ -114,6 +177,8 @@ void setup()
             });
         });
     #endif
+
+    bootProfile.mark("setup done");
 }
 
 void loop()
@@ -126,54 +191,49 @@ void loop()
 
     #if FT_ENABLED(FT_MOONLIGHT)
     
-        int packetSize = 0;
-        
         static int fiftyMsMillis = 0;
         if (millis() - fiftyMsMillis >= 50) {
             fiftyMsMillis = millis();
 
             fixtureService.loop50ms();
+            effectsService.loop50ms();
 
-            if (false) {
-                //send udp broadcast packet
-                packetSize = instanceUDP.parsePacket();
-                instanceUDP.remoteIP();
-                if (packetSize > 0) {
-                    byte *udpIn = (byte *)malloc(packetSize);
-                    instanceUDP.read(udpIn, packetSize);
-                    // free(udpIn);
-                }
+            instanceService.setNrOfLeds(fix->nrOfLeds);
+            instanceService.loop(); //coalesced state is sent at most every 50ms
+            timeSync.loop(); //after instanceService.loop: leader election uses its peer table
+        }
 
-                if (instanceUDP.beginPacket(IPAddress(255, 255, 255, 255), instanceUDPPort)) {  // WLEDMM beginPacket == 0 --> error
-                    JsonDocument message;
-                    message["pid"] = "pid";
-                    message["id"] = "id";
-                    message["value"] = "value";
-            
-                    size_t len = measureJson(message);
-            
-                    char buffer[len];
-            
-                    serializeJson(message, buffer, len);
-            
-                    instanceUDP.write((byte *)buffer, len);
-                    instanceUDP.endPacket();
-                }
+        layerCompositor.restoreFrame(fix->ledsP, fix->nrOfLeds); //effects continue from their own frame, not the composed or played one
 
-                // if (!artnetudp.writeTo(packet_buffer, packetSize+18, targetIp, ARTNET_DEFAULT_PORT)) {
-            }
-        }
+        #ifndef STARLIGHT_VIRTUAL_DRIVER
+            fix->showDriver = false; //the frame is not complete after loopStar, shown below
+        #endif
 
         loopStar();
+
+        layerCompositor.compose(fix->ledsP, fix->nrOfLeds); //blend the layers rendered by loopStar into the fixture
+
+        effectGraph.render(fix->ledsP, fix->nrOfLeds); //if nodes with an output node are defined, they make the frame
+
+        recorderService.loop(fix->ledsP, fix->nrOfLeds); //playback replaces the composed frame, recording captures it
+
+        #ifndef STARLIGHT_VIRTUAL_DRIVER
+            if (fixtureShowDriver)
+                FastLED.show(); //the frame as composed, rendered by the graph or played
+        #endif
+
+        networkOutputService.show(fix->ledsP, fix->nrOfLeds, FastLED.getBrightness());
     #endif
 
+    static bool firstFrame = true;
+    if (firstFrame) {
+        firstFrame = false;
+        bootProfile.mark("first frame");
+        esp32sveltekit.startLazyServices();
+    }
+
     esp32sveltekit.cyclesPerSecond += (ESP.getCycleCount() - cycles); //add the new cycles to the total cpu time
 
-    while (!runInLoopTask.empty())
-    {
-        ESP_LOGD("Main", "Running queued function");
-        runInLoopTask.back()(); //calls the last function
-        runInLoopTask.pop_back();
-    }
+    runInLoopTask.run(); //functions queued by other tasks, in order
 
 }
@@ -0,0 +1,55 @@
+// Host replacements of the Arduino and FreeRTOS calls used by the classes under test, see test/README
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <functional>
+#include <string>
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+#define ESP_LOGE(tag, ...)
+#define ESP_LOGW(tag, ...)
+#define ESP_LOGI(tag, ...)
+#define ESP_LOGD(tag, ...)
+#define ESP_LOGV(tag, ...)
+
+// single threaded tests: critical sections do nothing
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) (void)(mux)
+#define portEXIT_CRITICAL(mux) (void)(mux)
+#define portENTER_CRITICAL_SAFE(mux) (void)(mux)
+#define portEXIT_CRITICAL_SAFE(mux) (void)(mux)
+
+typedef void *TaskHandle_t;
+
+// names in settings structs: compared and copied only
+class String : public std::string
+{
+public:
+    String(const char *s = "") : std::string(s) {}
+};
+
+// the tests set the clock
+extern unsigned long hostMillis;
+inline unsigned long millis() { return hostMillis; }
+inline unsigned long micros() { return hostMillis * 1000; }
+
+// no PSRAM unless a test sets hostPsram() = true
+inline bool &hostPsram()
+{
+    static bool psram = false;
+    return psram;
+}
+inline bool psramFound() { return hostPsram(); }
+inline void *ps_malloc(size_t size) { return malloc(size); }
+inline void *ps_realloc(void *ptr, size_t size) { return realloc(ptr, size); }
+
+#endif
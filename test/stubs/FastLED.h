@@ -0,0 +1,19 @@
+// Host replacement of the FastLED pixel type, see test/README
+#ifndef FastLED_h
+#define FastLED_h
+
+#include <stdint.h>
+
+struct CRGB
+{
+    uint8_t r, g, b;
+    CRGB() = default;
+    CRGB(uint8_t r, uint8_t g, uint8_t b) : r(r), g(g), b(b) {}
+    bool operator==(const CRGB &other) const { return r == other.r && g == other.g && b == other.b; }
+    bool operator!=(const CRGB &other) const { return !(*this == other); }
+};
+
+// FASTLED_SCALE8_FIXED: scale8(255, 255) is 255
+inline uint8_t scale8(uint8_t i, uint8_t scale) { return ((uint16_t)i * (1 + scale)) >> 8; }
+
+#endif
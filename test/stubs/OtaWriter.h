@@ -0,0 +1,63 @@
+// Host replacement of OtaWriter, see test/README: the image is kept in memory, end() checks its size and SHA-256 as
+// the device does before activating it
+#ifndef OtaWriter_h
+#define OtaWriter_h
+
+#include <Arduino.h>
+#include <mbedtls/sha256.h>
+#include <vector>
+
+class OtaWriter
+{
+public:
+    bool begin(size_t size, const char *md5 = nullptr)
+    {
+        _image.clear();
+        _size = size;
+        _error = nullptr;
+        mbedtls_sha256_init(&_sha);
+        mbedtls_sha256_starts_ret(&_sha, 0);
+        return true;
+    }
+
+    bool write(const uint8_t *data, size_t len)
+    {
+        if (_image.size() + len > _size)
+            return fail("image larger than announced");
+        _image.insert(_image.end(), data, data + len);
+        mbedtls_sha256_update_ret(&_sha, data, len);
+        return true;
+    }
+
+    bool end(bool evenIfRemaining = false, const uint8_t *sha256 = nullptr)
+    {
+        if (!evenIfRemaining && _image.size() != _size)
+            return fail("image incomplete");
+        uint8_t digest[32];
+        mbedtls_sha256_finish_ret(&_sha, digest);
+        if (sha256 && memcmp(digest, sha256, sizeof(digest)))
+            return fail("sha256 mismatch");
+        return true;
+    }
+
+    void abort() { _image.clear(); }
+
+    const char *error() { return _error; }
+    size_t written() { return _image.size(); }
+    const std::vector<uint8_t> &image() { return _image; } //host only
+
+private:
+    std::vector<uint8_t> _image;
+    size_t _size = 0;
+    mbedtls_sha256_context _sha;
+    const char *_error = nullptr;
+
+    bool fail(const char *error)
+    {
+        if (!_error)
+            _error = error;
+        return false;
+    }
+};
+
+#endif
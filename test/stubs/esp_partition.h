@@ -0,0 +1,39 @@
+// Host replacement of the partition API, see test/README: the running app partition holds hostPartition(), the running
+// image is all of it (ESP.getSketchSize())
+#ifndef esp_partition_h
+#define esp_partition_h
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_ERR_INVALID_SIZE 0x104
+
+typedef struct
+{
+    uint32_t address;
+} esp_partition_t;
+
+inline std::vector<uint8_t> &hostPartition()
+{
+    static std::vector<uint8_t> partition;
+    return partition;
+}
+
+inline esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset, void *dst, size_t size)
+{
+    if (src_offset + size > hostPartition().size())
+        return ESP_ERR_INVALID_SIZE;
+    memcpy(dst, hostPartition().data() + src_offset, size);
+    return ESP_OK;
+}
+
+struct EspClass
+{
+    uint32_t getSketchSize() { return hostPartition().size(); }
+};
+static EspClass ESP;
+
+#endif
@@ -0,0 +1,72 @@
+// Host replacement of the inflate part (tinfl) of the miniz in the ESP32 ROM, on zlib (link with -lz), see test/README.
+// As tinfl it writes into the circular window of TINFL_LZ_DICT_SIZE bytes of the caller and reports HAS_MORE_OUTPUT
+// when it filled it. The zlib state lives in the decompressor, so free() of it is all the cleanup, as with tinfl
+#ifndef miniz_h
+#define miniz_h
+
+#include <stdint.h>
+#include <string.h>
+#include <zlib.h>
+
+#define TINFL_LZ_DICT_SIZE 32768
+#define TINFL_FLAG_PARSE_ZLIB_HEADER 1
+#define TINFL_FLAG_HAS_MORE_INPUT 2
+
+typedef enum
+{
+    TINFL_STATUS_BAD_PARAM = -3,
+    TINFL_STATUS_ADLER32_MISMATCH = -2,
+    TINFL_STATUS_FAILED = -1,
+    TINFL_STATUS_DONE = 0,
+    TINFL_STATUS_NEEDS_MORE_INPUT = 1,
+    TINFL_STATUS_HAS_MORE_OUTPUT = 2
+} tinfl_status;
+
+typedef struct
+{
+    z_stream stream;
+    size_t used;
+    uint8_t arena[48 * 1024]; //zlib inflate state and its 32 KB window
+} tinfl_decompressor;
+
+static inline voidpf tinflAlloc(voidpf opaque, uInt items, uInt size)
+{
+    tinfl_decompressor *r = (tinfl_decompressor *)opaque;
+    size_t bytes = ((size_t)items * size + 15) & ~(size_t)15;
+    if (r->used + bytes > sizeof(r->arena))
+        return Z_NULL;
+    voidpf p = r->arena + r->used;
+    r->used += bytes;
+    return p;
+}
+
+static inline void tinflFree(voidpf opaque, voidpf address) {}
+
+static inline void tinfl_init(tinfl_decompressor *r)
+{
+    memset(&r->stream, 0, sizeof(r->stream));
+    r->used = 0;
+    r->stream.zalloc = tinflAlloc;
+    r->stream.zfree = tinflFree;
+    r->stream.opaque = r;
+    inflateInit(&r->stream);
+}
+
+static inline tinfl_status tinfl_decompress(tinfl_decompressor *r, const uint8_t *pIn_buf_next, size_t *pIn_buf_size, uint8_t *pOut_buf_start,
+                                            uint8_t *pOut_buf_next, size_t *pOut_buf_size, const uint32_t decomp_flags)
+{
+    r->stream.next_in = (Bytef *)pIn_buf_next;
+    r->stream.avail_in = *pIn_buf_size;
+    r->stream.next_out = pOut_buf_next;
+    r->stream.avail_out = *pOut_buf_size;
+    int ret = inflate(&r->stream, Z_NO_FLUSH);
+    *pIn_buf_size -= r->stream.avail_in;
+    *pOut_buf_size -= r->stream.avail_out;
+    if (ret == Z_STREAM_END)
+        return TINFL_STATUS_DONE;
+    if (ret != Z_OK && ret != Z_BUF_ERROR)
+        return TINFL_STATUS_FAILED;
+    return r->stream.avail_out ? TINFL_STATUS_NEEDS_MORE_INPUT : TINFL_STATUS_HAS_MORE_OUTPUT;
+}
+
+#endif
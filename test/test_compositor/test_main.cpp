@@ -0,0 +1,207 @@
+/**
+    @title     MoonLight
+    @file      test_main.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+// LayerCompositor: the blend modes, layer 0 composed into its bounding region, the frame of the effect restored before
+// the next loopStar, transitions, and the frame time of composing 16K leds (STARLIGHT_MAXLEDS of the n16r8v boards)
+// against COMPOSITOR_BUDGET_US. Times are of the build machine, the device counts frames over budget (overBudget).
+
+#include <unity.h>
+#include <LayerCompositor.cpp>
+#include <chrono>
+#include <vector>
+
+unsigned long hostMillis = 0;
+
+#define BENCH_LEDS 16384
+#define BENCH_FRAMES 200
+
+static LayerCompositor *compositor;
+
+static LayerSettings layer(uint8_t opacity, uint8_t blend, uint16_t start = 0, uint16_t end = UINT16_MAX)
+{
+    LayerSettings settings;
+    settings.opacity = opacity;
+    settings.blend = blend;
+    settings.start = start;
+    settings.end = end;
+    return settings;
+}
+
+static void fill(std::vector<CRGB> &leds, CRGB color)
+{
+    for (CRGB &led : leds)
+        led = color;
+}
+
+void setUp()
+{
+    hostMillis = 1000;
+    compositor = new LayerCompositor();
+}
+
+void tearDown()
+{
+    delete compositor;
+}
+
+void test_blend_modes()
+{
+    CRGB dest, src(200, 100, 0);
+
+    dest = CRGB(100, 100, 100);
+    blendLeds(&dest, &src, 1, 255, BLEND_ALPHA);
+    TEST_ASSERT_TRUE(dest == src);
+
+    dest = CRGB(100, 100, 100);
+    blendLeds(&dest, &src, 1, 127, BLEND_ALPHA); //half way
+    TEST_ASSERT_EQUAL(150, dest.r);
+    TEST_ASSERT_EQUAL(100, dest.g);
+    TEST_ASSERT_EQUAL(50, dest.b);
+
+    dest = CRGB(100, 200, 100);
+    blendLeds(&dest, &src, 1, 255, BLEND_ADD); //saturates
+    TEST_ASSERT_EQUAL(255, dest.r);
+    TEST_ASSERT_EQUAL(255, dest.g);
+    TEST_ASSERT_EQUAL(100, dest.b);
+
+    dest = CRGB(255, 128, 100);
+    blendLeds(&dest, &src, 1, 255, BLEND_MULTIPLY);
+    TEST_ASSERT_EQUAL(200, dest.r);
+    TEST_ASSERT_EQUAL(50, dest.g);
+    TEST_ASSERT_EQUAL(0, dest.b);
+
+    dest = CRGB(0, 128, 255);
+    blendLeds(&dest, &src, 1, 255, BLEND_SCREEN);
+    TEST_ASSERT_EQUAL(200, dest.r);
+    TEST_ASSERT_EQUAL(178, dest.g);
+    TEST_ASSERT_EQUAL(255, dest.b);
+
+    dest = CRGB(1, 2, 3);
+    blendLeds(&dest, &src, 1, 0, BLEND_ADD); //opacity 0: unchanged
+    TEST_ASSERT_TRUE(dest == CRGB(1, 2, 3));
+}
+
+// more layers than StarLight can render separately are not configured
+void test_layer_0_only()
+{
+    compositor->configure({layer(255, BLEND_ALPHA), layer(128, BLEND_ADD)}, 10);
+    TEST_ASSERT_EQUAL(MAX_LAYERS, compositor->nrOfLayers());
+}
+
+void test_full_layer_untouched()
+{
+    std::vector<CRGB> leds(10);
+    fill(leds, CRGB(10, 20, 30));
+    compositor->configure({layer(255, BLEND_ALPHA)}, leds.size());
+    compositor->compose(leds.data(), leds.size());
+    TEST_ASSERT_TRUE(leds[0] == CRGB(10, 20, 30));
+    compositor->restoreFrame(leds.data(), leds.size()); //nothing kept, nothing restored
+    TEST_ASSERT_TRUE(leds[9] == CRGB(10, 20, 30));
+}
+
+void test_region_and_restore()
+{
+    std::vector<CRGB> leds(10);
+    fill(leds, CRGB(200, 100, 0));
+    compositor->configure({layer(127, BLEND_ALPHA, 2, 5)}, leds.size());
+    compositor->compose(leds.data(), leds.size());
+    TEST_ASSERT_TRUE(leds[1] == CRGB(0, 0, 0)); //outside the bounding region
+    TEST_ASSERT_TRUE(leds[2] == CRGB(100, 50, 0)); //half on black
+    TEST_ASSERT_TRUE(leds[4] == CRGB(100, 50, 0));
+    TEST_ASSERT_TRUE(leds[5] == CRGB(0, 0, 0));
+
+    compositor->restoreFrame(leds.data(), leds.size()); //the effect continues from its own frame
+    for (CRGB &led : leds)
+        TEST_ASSERT_TRUE(led == CRGB(200, 100, 0));
+}
+
+void test_transition()
+{
+    std::vector<CRGB> leds(10);
+    compositor->setTransition(TRANSITION_CROSSFADE, 1000);
+    compositor->configure({layer(255, BLEND_ALPHA)}, leds.size());
+    fill(leds, CRGB(200, 0, 0)); //outgoing effect
+    compositor->startTransition(0, leds.data(), leds.size());
+    TEST_ASSERT_TRUE(compositor->inTransition(0));
+
+    for (int frame = 0; frame < TRANSITION_WARMUP_FRAMES; frame++) {
+        compositor->restoreFrame(leds.data(), leds.size());
+        fill(leds, CRGB(0, 0, 200)); //incoming effect warms up behind the kept frame
+        compositor->compose(leds.data(), leds.size());
+        TEST_ASSERT_TRUE(leds[0] == CRGB(200, 0, 0));
+    }
+
+    hostMillis += 500;
+    compositor->restoreFrame(leds.data(), leds.size());
+    TEST_ASSERT_TRUE(leds[0] == CRGB(0, 0, 200)); //the incoming effect's own frame
+    compositor->compose(leds.data(), leds.size());
+    TEST_ASSERT_INT_WITHIN(2, 100, leds[0].r);
+    TEST_ASSERT_INT_WITHIN(2, 100, leds[0].b);
+
+    hostMillis += 500;
+    compositor->restoreFrame(leds.data(), leds.size());
+    compositor->compose(leds.data(), leds.size());
+    TEST_ASSERT_TRUE(leds[0] == CRGB(0, 0, 200));
+    TEST_ASSERT_FALSE(compositor->inTransition(0));
+}
+
+// us per frame of the loop task's restoreFrame + compose, the steps the compositor adds to a frame
+static double bench(const LayerSettings &settings, bool transition)
+{
+    std::vector<CRGB> leds(BENCH_LEDS);
+    for (size_t i = 0; i < leds.size(); i++)
+        leds[i] = CRGB(i, i >> 4, i >> 8);
+    compositor->setTransition(TRANSITION_CROSSFADE, 60000);
+    compositor->configure({settings}, leds.size());
+    if (transition) {
+        compositor->startTransition(0, leds.data(), leds.size());
+        for (int frame = 0; frame < TRANSITION_WARMUP_FRAMES; frame++) {
+            compositor->restoreFrame(leds.data(), leds.size());
+            compositor->compose(leds.data(), leds.size());
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        hostMillis++;
+        compositor->restoreFrame(leds.data(), leds.size());
+        compositor->compose(leds.data(), leds.size());
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / BENCH_FRAMES;
+
+    char message[128];
+    snprintf(message, sizeof(message), "compose %d leds opacity %d blend %d%s: %.1f us/frame (budget %d us)", BENCH_LEDS,
+             settings.opacity, settings.blend, transition ? " in transition" : "", us, COMPOSITOR_BUDGET_US);
+    TEST_MESSAGE(message);
+    return us;
+}
+
+void test_bench_alpha() { TEST_ASSERT_LESS_THAN(COMPOSITOR_BUDGET_US, bench(layer(128, BLEND_ALPHA), false)); }
+void test_bench_screen() { TEST_ASSERT_LESS_THAN(COMPOSITOR_BUDGET_US, bench(layer(200, BLEND_SCREEN), false)); }
+void test_bench_transition()
+{
+    // without PSRAM (as on the build machine) a transition keeps at most TRANSITION_MAX_HEAP bytes of the outgoing frame
+    TEST_ASSERT_LESS_THAN(COMPOSITOR_BUDGET_US, bench(layer(128, BLEND_MULTIPLY, 0, TRANSITION_MAX_HEAP / sizeof(CRGB)), true));
+    TEST_ASSERT_TRUE(compositor->inTransition(0)); //all frames were mixed
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_blend_modes);
+    RUN_TEST(test_layer_0_only);
+    RUN_TEST(test_full_layer_untouched);
+    RUN_TEST(test_region_and_restore);
+    RUN_TEST(test_transition);
+    RUN_TEST(test_bench_alpha);
+    RUN_TEST(test_bench_screen);
+    RUN_TEST(test_bench_transition);
+    return UNITY_END();
+}
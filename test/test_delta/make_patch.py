@@ -0,0 +1,59 @@
+#!/usr/bin/env python
+#
+# Writes patch.h for test_delta: a patch made by scripts/delta.py between two images built from the same generator
+# as base() in test_main.cpp.
+#
+#   python test/test_delta/make_patch.py
+#
+# The new image reorders blocks of the base (negative seeks), changes every 97th byte of the first block (non zero
+# diff bytes) and inserts random bytes (extra blocks). Its records inflate to more than the 32 KB window of the device.
+
+import os
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "..", "..", "scripts"))
+import delta  # noqa: E402
+
+BASE_SIZE = 96 * 1024
+
+
+def xorshift(seed, size):
+    x = seed
+    out = bytearray(size)
+    for i in range(size):
+        x ^= (x << 13) & 0xFFFFFFFF
+        x ^= x >> 17
+        x ^= (x << 5) & 0xFFFFFFFF
+        out[i] = x & 0xFF
+    return out
+
+
+def images():
+    base = bytes(xorshift(2463534242, BASE_SIZE))
+    changed = bytearray(base[0:20000])
+    for i in range(0, len(changed), 97):
+        changed[i] = (changed[i] + 1) & 0xFF
+    new = bytes(changed) + bytes(xorshift(88675123, 3000)) + base[60000:90000] + base[10000:40000] + base[90000:]
+    return base, new
+
+
+def main():
+    base, new = images()
+    patch = delta.make(base, new)
+    assert delta.apply(base, patch) == new
+    lines = [
+        "// made by make_patch.py with scripts/delta.py, do not edit",
+        f"#define DELTA_BASE_SIZE {BASE_SIZE}",
+        f"#define DELTA_NEW_SIZE {len(new)}",
+        f"static const uint8_t deltaPatch[{len(patch)}] = {{",
+    ]
+    for i in range(0, len(patch), 16):
+        lines.append("    " + ", ".join(f"0x{b:02x}" for b in patch[i : i + 16]) + ",")
+    lines.append("};")
+    with open(os.path.join(os.path.dirname(__file__), "patch.h"), "w") as f:
+        f.write("\n".join(lines) + "\n")
+    print(f"patch.h: image {len(new)}, delta {len(patch)} bytes")
+
+
+if __name__ == "__main__":
+    main()
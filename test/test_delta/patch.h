@@ -0,0 +1,225 @@
+// made by make_patch.py with scripts/delta.py, do not edit
+#define DELTA_BASE_SIZE 98304
+#define DELTA_NEW_SIZE 91304
+static const uint8_t deltaPatch[3506] = {
+    0x4d, 0x4c, 0x44, 0x31, 0x00, 0x80, 0x01, 0x00, 0x7b, 0x7b, 0x5d, 0xa7, 0x41, 0xac, 0x87, 0xd9,
+    0x00, 0xf5, 0x49, 0xef, 0x8a, 0x22, 0xc9, 0x43, 0x96, 0x45, 0xa1, 0x37, 0x4d, 0x2b, 0xbb, 0x38,
+    0xfa, 0x84, 0xb4, 0x67, 0xad, 0xe7, 0x72, 0x76, 0xa8, 0x64, 0x01, 0x00, 0x2c, 0x71, 0x7d, 0x65,
+    0xde, 0x14, 0xf2, 0x74, 0x33, 0x8c, 0xb9, 0x2a, 0xc0, 0x02, 0x38, 0x17, 0xb1, 0x24, 0x23, 0x55,
+    0x7e, 0xca, 0x8b, 0x07, 0x27, 0x5e, 0x17, 0xa2, 0x93, 0xca, 0xf0, 0xaa, 0x00, 0x00, 0x00, 0x00,
+    0x78, 0xda, 0xed, 0xdd, 0x57, 0x3c, 0x17, 0x8e, 0xfe, 0xc7, 0xf1, 0xaf, 0x51, 0x54, 0x46, 0x8a,
+    0x94, 0x95, 0x4d, 0x76, 0xf8, 0x66, 0xef, 0x99, 0xad, 0x64, 0xa5, 0x14, 0x12, 0x92, 0x2d, 0x23,
+    0x32, 0xb2, 0xca, 0xcc, 0x28, 0x4a, 0xf8, 0x21, 0x65, 0x46, 0x99, 0xa5, 0x45, 0x8a, 0x10, 0xb2,
+    0x53, 0x94, 0x3d, 0xca, 0x96, 0x15, 0xce, 0xc5, 0x79, 0xfc, 0xef, 0xff, 0xe7, 0xf1, 0x38, 0xe7,
+    0xee, 0xfd, 0xbc, 0xf9, 0x5c, 0xbe, 0x1e, 0x8f, 0xcf, 0xd5, 0xe7, 0xee, 0xc3, 0x6e, 0x40, 0x20,
+    0x54, 0xef, 0x23, 0x10, 0x94, 0xd3, 0x09, 0x04, 0x12, 0xc2, 0xff, 0x18, 0x02, 0x08, 0x20, 0x80,
+    0x00, 0x02, 0x08, 0x20, 0x80, 0x00, 0x02, 0x08, 0x20, 0x80, 0x00, 0x02, 0x08, 0x20, 0x80, 0x00,
+    0x02, 0x08, 0x20, 0x80, 0x00, 0x02, 0x08, 0x20, 0x80, 0x00, 0x02, 0x08, 0x20, 0x80, 0x00, 0x02,
+    0x08, 0x20, 0x80, 0x00, 0x02, 0x08, 0x20, 0x80, 0x00, 0x02, 0x08, 0x20, 0x80, 0x00, 0x02, 0x08,
+    0x20, 0x80, 0x00, 0x02, 0x08, 0x20, 0x80, 0x00, 0x02, 0x08, 0x20, 0x80, 0x00, 0x02, 0x08, 0x20,
+    0x80, 0x00, 0x02, 0x08, 0x20, 0x80, 0x00, 0x02, 0x08, 0x20, 0x80, 0x00, 0x02, 0x08, 0x20, 0x80,
+    0x00, 0x02, 0x08, 0x20, 0x80, 0x00, 0x02, 0x08, 0x20, 0x80, 0x00, 0x02, 0xff, 0xaf, 0x00, 0xf7,
+    0x44, 0x82, 0x95, 0xff, 0x66, 0x97, 0xd3, 0x7b, 0x81, 0xeb, 0xe2, 0x6e, 0xe7, 0xe6, 0x35, 0xf2,
+    0x0d, 0x46, 0x22, 0xc8, 0xfa, 0xb5, 0xc7, 0xcb, 0x3c, 0x7f, 0xa7, 0xe9, 0x76, 0xcf, 0xb2, 0x67,
+    0xfc, 0xf6, 0x74, 0x89, 0x51, 0xb8, 0xb2, 0xa8, 0x3f, 0x64, 0x2d, 0x6a, 0x1a, 0xdf, 0xb0, 0xcc,
+    0x2a, 0xbf, 0xad, 0xb1, 0xff, 0x70, 0xa8, 0xe1, 0xb9, 0x25, 0xed, 0xd8, 0x69, 0x2d, 0xbe, 0x84,
+    0xe4, 0xd4, 0xd2, 0x57, 0xe9, 0xf9, 0x63, 0xd7, 0x87, 0xa3, 0x14, 0x4f, 0xdc, 0xe2, 0xce, 0xd3,
+    0xbb, 0x3e, 0x2c, 0xa9, 0x60, 0x68, 0xd1, 0x25, 0x67, 0x7c, 0xd2, 0x9f, 0xac, 0x68, 0xa2, 0x2c,
+    0x62, 0x96, 0x43, 0xa6, 0x8e, 0xe3, 0x83, 0xb3, 0x9d, 0xf8, 0x91, 0xa3, 0xb2, 0xa1, 0x39, 0x82,
+    0x14, 0xbf, 0x5e, 0x86, 0xb1, 0xb6, 0x48, 0x7a, 0xd2, 0x77, 0xc5, 0xeb, 0x8c, 0x96, 0xd0, 0xb0,
+    0xac, 0x5d, 0xcd, 0x19, 0x15, 0xa6, 0x72, 0x9b, 0x97, 0x52, 0xd7, 0x66, 0xf8, 0xa7, 0xfa, 0x64,
+    0xd1, 0xf6, 0x30, 0xf1, 0x57, 0xd8, 0x86, 0x44, 0xcf, 0xea, 0x3f, 0x7b, 0xc8, 0xcd, 0x54, 0x73,
+    0xee, 0x39, 0x1f, 0x9c, 0x7e, 0xa1, 0x1f, 0x1a, 0xe7, 0xf9, 0x56, 0xeb, 0xd8, 0x5d, 0xa7, 0x94,
+    0x4a, 0xce, 0xae, 0xde, 0xe3, 0x74, 0x97, 0xd7, 0x7d, 0xf2, 0x5e, 0xa5, 0x3d, 0x8a, 0x0e, 0x15,
+    0xb2, 0x7d, 0x66, 0x7e, 0xed, 0xe7, 0xcd, 0xef, 0x61, 0xcb, 0x92, 0x8e, 0x45, 0xf2, 0x0a, 0xd6,
+    0xa3, 0x7c, 0xd5, 0x79, 0x0b, 0x12, 0x57, 0xa9, 0xaf, 0xcd, 0xca, 0xdc, 0xd8, 0x9b, 0x2d, 0xfe,
+    0xa9, 0x2e, 0x38, 0x55, 0xb7, 0x90, 0xeb, 0x42, 0xdc, 0x4e, 0xc5, 0xdb, 0x0d, 0xdf, 0x7f, 0xc4,
+    0x4b, 0xd5, 0xd9, 0x87, 0xea, 0x15, 0x37, 0x07, 0x78, 0x03, 0x58, 0xce, 0x2a, 0xb5, 0x88, 0xef,
+    0xae, 0x77, 0x96, 0x26, 0x55, 0x28, 0x6d, 0x37, 0xbc, 0x79, 0x97, 0x85, 0x6b, 0xf9, 0x41, 0x7f,
+    0x40, 0x1f, 0xc7, 0xb0, 0xc5, 0xc1, 0x6d, 0x01, 0x27, 0x0e, 0x0a, 0x8e, 0x44, 0x43, 0x1f, 0x3a,
+    0x5e, 0xb3, 0x89, 0x14, 0xd1, 0x34, 0x2d, 0x1d, 0xd2, 0xaa, 0x7e, 0x5e, 0xd7, 0x42, 0xbe, 0x72,
+    0x53, 0x15, 0xa2, 0xb9, 0x6a, 0x46, 0x73, 0x75, 0xf3, 0x4d, 0xb7, 0x13, 0xf2, 0x97, 0x0e, 0x2b,
+    0x56, 0x58, 0x71, 0x9d, 0x4b, 0x69, 0xfa, 0xd3, 0x1e, 0xad, 0xda, 0xc3, 0xc2, 0x3f, 0x28, 0x9c,
+    0xa1, 0xd9, 0xb3, 0xdb, 0x91, 0x56, 0x45, 0x33, 0xa0, 0xb7, 0x8b, 0xd2, 0xe1, 0xe7, 0xd0, 0xa7,
+    0x20, 0x8d, 0x31, 0x19, 0xf5, 0xdb, 0x4f, 0xe9, 0x5a, 0xdf, 0x8e, 0x1d, 0xe9, 0x6d, 0x30, 0xa9,
+    0xd3, 0xf9, 0xd6, 0x91, 0x5b, 0xb3, 0xd4, 0x3a, 0x70, 0x2d, 0x83, 0x74, 0x58, 0xd1, 0xa1, 0x46,
+    0xf3, 0x52, 0xb3, 0xf5, 0x1e, 0x16, 0x5e, 0xae, 0xbb, 0xd7, 0xdd, 0x9f, 0x08, 0x09, 0xdd, 0x18,
+    0xf4, 0x50, 0x71, 0xbc, 0x6a, 0xc7, 0x52, 0x70, 0xcf, 0xfd, 0x90, 0x4d, 0xe5, 0x69, 0x99, 0x42,
+    0xf1, 0x08, 0xfd, 0x59, 0xfa, 0x43, 0x9b, 0x51, 0x82, 0xf2, 0x4a, 0x7a, 0x31, 0xe3, 0xcf, 0x46,
+    0x77, 0x53, 0x67, 0x2a, 0xad, 0x67, 0xcc, 0x7d, 0xbe, 0x91, 0x59, 0xdc, 0xc4, 0xa3, 0x1e, 0x9c,
+    0xe0, 0xb8, 0x69, 0xbe, 0x2c, 0xa1, 0xf6, 0xa6, 0x46, 0xd4, 0xc3, 0x3a, 0x51, 0x94, 0xa0, 0xd3,
+    0xaa, 0xb2, 0x2c, 0x1d, 0x94, 0x4b, 0x4f, 0x96, 0x95, 0xe4, 0x68, 0xd6, 0xf0, 0xae, 0x9a, 0xe9,
+    0x07, 0xfb, 0x25, 0xf9, 0x31, 0x7b, 0x03, 0x1e, 0xcd, 0x52, 0x8d, 0xef, 0xd6, 0x77, 0x37, 0x75,
+    0x0f, 0x68, 0x30, 0x86, 0x7b, 0xeb, 0x90, 0xc9, 0x3d, 0xe3, 0x99, 0xa0, 0x12, 0x7d, 0xa7, 0x34,
+    0xa1, 0x59, 0x25, 0x28, 0xa9, 0xb2, 0xc6, 0xf9, 0xf2, 0x87, 0x75, 0x90, 0x35, 0xc9, 0xf1, 0x53,
+    0xc3, 0x5b, 0xb5, 0x7a, 0x9d, 0x89, 0x67, 0x4c, 0xd7, 0x7e, 0xcd, 0xaf, 0x3c, 0x66, 0x91, 0x6c,
+    0x6a, 0x77, 0xb5, 0x71, 0x3d, 0xea, 0xb3, 0x54, 0xca, 0x2b, 0x60, 0x3a, 0x20, 0xe0, 0xe4, 0xf5,
+    0xaa, 0xa8, 0x4b, 0x87, 0x62, 0xaf, 0xac, 0x4d, 0x05, 0x85, 0x03, 0xdd, 0xb7, 0xd1, 0xdb, 0xa7,
+    0x6b, 0x1c, 0x23, 0x29, 0xe8, 0x7e, 0x05, 0xa8, 0x39, 0xdc, 0xcf, 0xfc, 0x74, 0xe7, 0x88, 0xe4,
+    0xa8, 0xbe, 0xfe, 0xa5, 0x6e, 0x81, 0xee, 0xa2, 0x34, 0x11, 0xba, 0x4a, 0x3f, 0x41, 0x77, 0xf2,
+    0x0b, 0xb1, 0x3b, 0xb2, 0x6f, 0xd7, 0x8c, 0x33, 0x2b, 0xb2, 0x14, 0x82, 0x6a, 0x6e, 0xb1, 0x11,
+    0x99, 0xa4, 0xd5, 0xc8, 0xf6, 0x2c, 0x98, 0x67, 0xf9, 0x25, 0xc9, 0x5e, 0xae, 0x6d, 0x39, 0x59,
+    0x21, 0xfb, 0x83, 0x9e, 0xa3, 0xf7, 0xa5, 0x78, 0x49, 0xf7, 0x15, 0x1e, 0xe3, 0x5a, 0xb9, 0x87,
+    0x84, 0x64, 0x4d, 0xd3, 0xad, 0xd3, 0x22, 0x16, 0xf9, 0x5d, 0x7c, 0x5d, 0x09, 0x07, 0x05, 0x3f,
+    0x9b, 0xb9, 0xb8, 0x89, 0xbf, 0x31, 0xa4, 0xf9, 0xfd, 0xe5, 0xd1, 0x62, 0x9c, 0xaf, 0x50, 0xfe,
+    0x83, 0xfa, 0x36, 0xae, 0x56, 0x23, 0x2d, 0x7b, 0xd1, 0xd0, 0xae, 0xef, 0xab, 0xef, 0xde, 0x9b,
+    0xd8, 0xad, 0x55, 0x3e, 0x1f, 0xea, 0x95, 0xca, 0xcf, 0xd8, 0xdd, 0xec, 0xd0, 0x1d, 0x13, 0x90,
+    0x22, 0x77, 0x3d, 0x6c, 0x3f, 0xd5, 0xe4, 0x8d, 0x56, 0xf7, 0x0e, 0xb5, 0xda, 0xfd, 0xdd, 0x05,
+    0xc4, 0x2a, 0x59, 0xad, 0x9a, 0xd5, 0x78, 0x92, 0x8f, 0xef, 0xe4, 0xf2, 0x2e, 0x84, 0x30, 0x2b,
+    0xae, 0x56, 0xcd, 0xd7, 0x77, 0xf6, 0x0a, 0xf4, 0xa5, 0x2b, 0x7f, 0x0c, 0xa3, 0x8c, 0x7e, 0x97,
+    0x35, 0x68, 0x21, 0xd2, 0xdc, 0xf4, 0x3c, 0x91, 0xf5, 0x88, 0x4e, 0x85, 0x9f, 0xa3, 0x90, 0x71,
+    0xb2, 0xec, 0x80, 0xf1, 0x7e, 0x86, 0x75, 0x7f, 0x4b, 0xed, 0x03, 0xbe, 0xc6, 0xc6, 0x55, 0x76,
+    0x75, 0x15, 0x51, 0x9e, 0xe3, 0x89, 0xe9, 0x05, 0x05, 0x2e, 0x27, 0xba, 0xf8, 0xdf, 0x97, 0x24,
+    0xb6, 0x4c, 0xbc, 0x79, 0xd8, 0x18, 0x2d, 0x39, 0x45, 0x43, 0x6e, 0xeb, 0xea, 0x3f, 0x1d, 0xb3,
+    0x7a, 0x9b, 0x73, 0x70, 0xcb, 0x69, 0xcf, 0xed, 0x8b, 0x79, 0xe5, 0x53, 0x5b, 0xc7, 0xbc, 0x6d,
+    0x13, 0xc6, 0xbe, 0x92, 0x1d, 0x4f, 0x9c, 0x7b, 0xc5, 0x53, 0xf5, 0xce, 0x44, 0x8c, 0x10, 0xa1,
+    0xd9, 0xf1, 0x45, 0xd8, 0x65, 0xa6, 0x21, 0xce, 0xaf, 0x2c, 0x97, 0xce, 0x69, 0xc4, 0xb0, 0x6d,
+    0xbd, 0xea, 0xf7, 0xd1, 0x83, 0xc9, 0x27, 0xb2, 0x0a, 0x56, 0xa8, 0x1e, 0xac, 0x04, 0x33, 0x31,
+    0xba, 0xc5, 0x6d, 0x30, 0x46, 0x04, 0xc4, 0xef, 0x23, 0x5c, 0xdc, 0x56, 0x5f, 0x2d, 0x8e, 0xdd,
+    0x2e, 0x19, 0xd5, 0x65, 0x98, 0xc9, 0xdc, 0x8e, 0x97, 0xbb, 0x71, 0x39, 0xfa, 0x5c, 0x3f, 0x5f,
+    0x39, 0xd7, 0xce, 0xe8, 0x7e, 0xf6, 0xc3, 0x5d, 0x0f, 0x69, 0x44, 0xd3, 0xed, 0x2d, 0xe4, 0x16,
+    0x8a, 0xe2, 0x6e, 0x6a, 0x9e, 0xea, 0x58, 0x75, 0x94, 0x63, 0xed, 0x12, 0x32, 0x15, 0x93, 0xd4,
+    0xcf, 0x92, 0x8c, 0x7c, 0xfc, 0x69, 0xe7, 0x65, 0x3c, 0x31, 0xac, 0xfd, 0x04, 0xdd, 0x5a, 0xe6,
+    0x45, 0x36, 0xb7, 0xbc, 0xdb, 0xbf, 0x16, 0x48, 0x36, 0xc3, 0xb6, 0xd4, 0xe2, 0xb3, 0x14, 0x5e,
+    0x1a, 0xb0, 0x73, 0x47, 0x46, 0xd6, 0xce, 0xa7, 0xc6, 0xc4, 0xf4, 0x7c, 0xb5, 0xd2, 0x14, 0xb0,
+    0x16, 0x08, 0xf2, 0xb8, 0x96, 0x25, 0xe4, 0xb4, 0x44, 0x2f, 0x11, 0xb2, 0x19, 0x48, 0x76, 0xe2,
+    0x50, 0xe9, 0xba, 0xfa, 0xd9, 0x90, 0x47, 0x1d, 0x89, 0x3e, 0x5e, 0x94, 0x16, 0x07, 0x16, 0xb4,
+    0xc2, 0xef, 0xa8, 0x4c, 0xa6, 0xf4, 0x79, 0x8e, 0x79, 0x9d, 0x77, 0xa7, 0x33, 0x14, 0x91, 0x9e,
+    0xa5, 0x50, 0x56, 0x67, 0x98, 0x6f, 0xb4, 0x98, 0x94, 0xeb, 0x4f, 0x49, 0x3a, 0x4a, 0x7a, 0x98,
+    0xd9, 0xec, 0xdb, 0x8e, 0x21, 0xe1, 0xcb, 0x78, 0x5e, 0x10, 0x37, 0x55, 0xae, 0x61, 0x1a, 0xab,
+    0xbc, 0xec, 0xca, 0x0b, 0x56, 0x36, 0xe6, 0xaf, 0xc4, 0xb1, 0xc8, 0xf0, 0x82, 0xdf, 0xf4, 0xf2,
+    0xea, 0x23, 0x94, 0x2c, 0x76, 0xb9, 0x17, 0x26, 0xed, 0x8e, 0xa5, 0xda, 0x88, 0x6a, 0xde, 0x3d,
+    0xfc, 0xbd, 0xb0, 0x52, 0x9c, 0xb4, 0xe0, 0x80, 0xe8, 0xbc, 0x39, 0xe3, 0x2d, 0xd5, 0x44, 0xe6,
+    0x6f, 0xe4, 0x0e, 0x43, 0x36, 0x24, 0xc3, 0xe3, 0x6f, 0x3c, 0xa8, 0x55, 0xee, 0x25, 0xf7, 0xdb,
+    0x33, 0xdb, 0x2f, 0x5d, 0x37, 0xdb, 0x96, 0xf7, 0x0b, 0xd6, 0xbb, 0x92, 0xbf, 0x91, 0x1a, 0xa1,
+    0x53, 0x1e, 0x1f, 0x50, 0x4f, 0x6e, 0xd6, 0x6a, 0x9d, 0x2f, 0x9d, 0xa7, 0x2f, 0xb5, 0xef, 0x6c,
+    0xc4, 0xfb, 0xc2, 0x11, 0x53, 0xc3, 0xe7, 0x1b, 0xa1, 0xcb, 0x04, 0x8e, 0xb4, 0x9b, 0xaf, 0x5e,
+    0xb9, 0xdf, 0x88, 0xe4, 0x59, 0xe6, 0x5a, 0x31, 0x38, 0xf4, 0x78, 0x7f, 0x21, 0xb9, 0x59, 0xf1,
+    0xc2, 0x27, 0x0f, 0x03, 0xea, 0xf3, 0x87, 0xc9, 0xdb, 0x2b, 0x3a, 0x55, 0xfa, 0x89, 0xa6, 0xe7,
+    0x7b, 0x29, 0x99, 0x58, 0x1f, 0x5a, 0x86, 0x3b, 0x90, 0x13, 0xfb, 0x42, 0x57, 0x29, 0x24, 0x77,
+    0xa5, 0x77, 0xec, 0x63, 0x73, 0x6a, 0x3d, 0xfb, 0xe8, 0x2f, 0xd9, 0x15, 0xbb, 0xea, 0xa7, 0x34,
+    0x24, 0xc4, 0xc6, 0xbb, 0x59, 0x0f, 0x16, 0xc3, 0x85, 0xc9, 0xbd, 0xfa, 0x03, 0x6c, 0x37, 0x78,
+    0x1b, 0xac, 0x16, 0x68, 0x15, 0x9f, 0x3d, 0xf4, 0xdc, 0xfe, 0xfa, 0x38, 0xaa, 0xb6, 0xb5, 0xcb,
+    0x77, 0x57, 0x63, 0xe3, 0xd0, 0xf1, 0x51, 0xab, 0x97, 0x3f, 0xbb, 0xda, 0xd8, 0x6a, 0x9d, 0xed,
+    0x52, 0xb9, 0xaf, 0x3c, 0x7e, 0xe1, 0xcd, 0xda, 0x79, 0xb6, 0xfd, 0x8c, 0xbf, 0x4d, 0xc6, 0x9a,
+    0xfa, 0x29, 0xd7, 0x3c, 0x4e, 0xdd, 0x4c, 0xde, 0x1e, 0x45, 0x7d, 0xcb, 0x0f, 0x62, 0x32, 0xe4,
+    0x83, 0x3d, 0x75, 0xee, 0x1f, 0xa6, 0xb4, 0x7a, 0xfc, 0x46, 0x75, 0xd5, 0xf4, 0xc4, 0x3a, 0xe9,
+    0x12, 0xa5, 0xb9, 0x63, 0xf7, 0xf4, 0x1d, 0x7f, 0x23, 0x3d, 0x1f, 0xda, 0xf4, 0x4a, 0x43, 0x2b,
+    0x70, 0x27, 0x24, 0x38, 0xfb, 0xb6, 0xcc, 0x6a, 0x8e, 0x75, 0xf6, 0x3d, 0x85, 0x0d, 0xf9, 0x5a,
+    0x1e, 0xbf, 0x9f, 0xb3, 0x7e, 0x01, 0xca, 0x95, 0xf6, 0x76, 0x1c, 0xca, 0x1d, 0x49, 0xd2, 0xa1,
+    0x93, 0x7e, 0xcb, 0x73, 0x81, 0xb6, 0x0e, 0x79, 0x66, 0x4d, 0x9d, 0x75, 0x7e, 0x4c, 0x35, 0x1b,
+    0x1f, 0xa7, 0x1c, 0x8d, 0x47, 0x18, 0xb8, 0xc5, 0x4e, 0xf1, 0x5b, 0xd6, 0xb0, 0x17, 0x3a, 0xff,
+    0x10, 0x1e, 0xf8, 0xeb, 0xba, 0x9a, 0x51, 0xbe, 0x74, 0x5a, 0x3e, 0x24, 0x41, 0xca, 0xcd, 0x6e,
+    0xd2, 0x9e, 0x40, 0x24, 0x93, 0x5a, 0x20, 0x74, 0x37, 0xe6, 0x09, 0x85, 0x37, 0x51, 0xde, 0x3b,
+    0xdf, 0xdf, 0x7b, 0xf2, 0xb6, 0x7f, 0xd3, 0x1b, 0x26, 0x21, 0x32, 0x8a, 0xbf, 0x29, 0x65, 0x5d,
+    0xeb, 0x25, 0x65, 0xd3, 0x8d, 0x49, 0x19, 0xd3, 0x12, 0x0b, 0x31, 0x8f, 0xa2, 0x8f, 0xc7, 0x30,
+    0xba, 0xf5, 0x98, 0xdf, 0xb7, 0xe9, 0x7a, 0xf9, 0xfa, 0x60, 0xbc, 0xa9, 0xfe, 0x66, 0x81, 0x65,
+    0xdb, 0xd3, 0x0b, 0x4f, 0x5e, 0x6f, 0xc4, 0xc6, 0x56, 0xe7, 0x93, 0x79, 0xe6, 0xfc, 0x32, 0x61,
+    0x24, 0x6b, 0x7f, 0x46, 0x6c, 0xbd, 0x7f, 0x45, 0x56, 0xd8, 0x27, 0x62, 0x78, 0x40, 0x28, 0x45,
+    0xe6, 0x49, 0x9c, 0xee, 0x8c, 0xd6, 0x13, 0xa7, 0x6b, 0xb7, 0x58, 0x7b, 0x9c, 0x4f, 0xea, 0xcc,
+    0xf4, 0x79, 0xf4, 0xa9, 0xf1, 0x4e, 0x1c, 0x55, 0x64, 0x8e, 0x7b, 0x42, 0x9d, 0x6d, 0x7c, 0xaa,
+    0xf4, 0x4e, 0x3e, 0xdf, 0x8e, 0x4f, 0xf6, 0x8f, 0x3b, 0x55, 0x0f, 0x68, 0xb9, 0x03, 0xb5, 0x16,
+    0x6e, 0xd2, 0xf2, 0x17, 0x2f, 0xae, 0xd9, 0x18, 0x7c, 0x60, 0x1e, 0x8a, 0x20, 0xb0, 0xcd, 0x79,
+    0x27, 0x79, 0x8b, 0x79, 0xa6, 0x18, 0x54, 0x11, 0xf2, 0x0d, 0x9c, 0x38, 0xda, 0x7c, 0x89, 0x34,
+    0xb1, 0x66, 0x77, 0x4e, 0xb8, 0xe8, 0x5f, 0xb0, 0xb0, 0x50, 0xf4, 0x56, 0x2b, 0x52, 0x7f, 0xdd,
+    0x12, 0xea, 0x6b, 0xe0, 0x23, 0x71, 0xec, 0x1c, 0xcf, 0x81, 0x32, 0x57, 0xdd, 0x29, 0x8a, 0xb1,
+    0xfd, 0x1b, 0xba, 0x76, 0xc3, 0xc9, 0xca, 0xd5, 0xe1, 0xe9, 0xb9, 0x9e, 0x52, 0x45, 0xbf, 0x2e,
+    0x56, 0x86, 0x8a, 0x17, 0x7b, 0xa7, 0x46, 0xde, 0x9a, 0xe7, 0xa8, 0x99, 0x33, 0x25, 0xa5, 0x72,
+    0x2a, 0x7b, 0xff, 0xd1, 0x59, 0xbc, 0x62, 0xc5, 0xf9, 0x43, 0xf5, 0xf3, 0xcc, 0xaf, 0x33, 0xf3,
+    0x33, 0x19, 0xa5, 0x02, 0x24, 0x52, 0xee, 0xa4, 0x8b, 0xe4, 0xcd, 0x4f, 0xf3, 0x7a, 0xde, 0xc5,
+    0x8a, 0xc9, 0x92, 0x50, 0xf0, 0xd2, 0x06, 0x54, 0xfa, 0xe7, 0xb0, 0xcc, 0xfd, 0x6a, 0x3b, 0x42,
+    0xf9, 0xb1, 0x86, 0x4c, 0x60, 0xb7, 0xcf, 0x9c, 0x71, 0x69, 0xec, 0xda, 0xfa, 0x66, 0x9d, 0x70,
+    0xd0, 0xd1, 0x49, 0xda, 0x58, 0xfe, 0x92, 0xb0, 0x9f, 0x1d, 0x56, 0xe7, 0x8d, 0xb7, 0xb3, 0x03,
+    0x03, 0x99, 0xe7, 0x3b, 0x6f, 0xad, 0x95, 0xc6, 0x7d, 0x3d, 0x3a, 0x32, 0x1d, 0xc0, 0x62, 0xe5,
+    0x75, 0x97, 0xa7, 0x78, 0x81, 0xf6, 0x6e, 0xd9, 0xce, 0x7e, 0x85, 0x94, 0xd9, 0x5e, 0x85, 0xf3,
+    0x3b, 0x4c, 0x3f, 0xce, 0xec, 0x0c, 0x69, 0x46, 0x65, 0xab, 0x8c, 0x53, 0xc9, 0x58, 0x5e, 0x99,
+    0x62, 0x73, 0xa0, 0x1b, 0xb3, 0xfa, 0x10, 0x29, 0x36, 0x68, 0x9f, 0xc6, 0x9f, 0x42, 0xaf, 0xda,
+    0x12, 0xe0, 0x34, 0xff, 0xf8, 0xc6, 0x3d, 0x22, 0x9d, 0x32, 0x4f, 0x68, 0x79, 0xe7, 0xef, 0x7d,
+    0xa9, 0x8f, 0x36, 0x1e, 0x90, 0x18, 0x55, 0x7a, 0xfb, 0xef, 0x50, 0x2a, 0x26, 0x8d, 0x55, 0x1a,
+    0x38, 0xf8, 0xb5, 0x3e, 0xe7, 0x6d, 0x78, 0x53, 0xcd, 0xa3, 0x7d, 0x50, 0x8a, 0xdb, 0xe7, 0xb3,
+    0x5c, 0xeb, 0xb7, 0xb5, 0x50, 0x05, 0x49, 0xbf, 0xb9, 0x58, 0x73, 0x51, 0x63, 0xa1, 0x71, 0x41,
+    0x95, 0x06, 0x91, 0xce, 0x29, 0xc3, 0xb9, 0xdf, 0x8d, 0xfa, 0xd7, 0x7c, 0xdf, 0x2f, 0xe4, 0x68,
+    0x76, 0x88, 0xcf, 0xe5, 0xd4, 0x2b, 0xc5, 0x6d, 0x56, 0x13, 0x27, 0x64, 0x9a, 0x34, 0x14, 0x13,
+    0xc3, 0x56, 0xcd, 0x2a, 0xc7, 0x66, 0x64, 0xc6, 0x75, 0x9b, 0x13, 0x76, 0x8c, 0x72, 0x19, 0x5b,
+    0x07, 0x67, 0xfd, 0x2f, 0x49, 0xe6, 0x7e, 0x31, 0xdb, 0xee, 0x08, 0x0b, 0x36, 0x59, 0x11, 0xbc,
+    0xdf, 0xda, 0x96, 0x73, 0xea, 0x6d, 0x80, 0x76, 0x8a, 0xda, 0xd9, 0xe4, 0xe2, 0x96, 0xde, 0x5a,
+    0xff, 0x59, 0x57, 0x62, 0x09, 0x75, 0x0b, 0x7d, 0xe5, 0xeb, 0x2c, 0x4f, 0x4f, 0xce, 0xbf, 0xbb,
+    0xfa, 0x85, 0xe9, 0x49, 0x54, 0x1d, 0x48, 0xee, 0x69, 0xeb, 0x7d, 0x7c, 0x29, 0x21, 0xd4, 0xe7,
+    0x3f, 0x52, 0x3d, 0x42, 0xac, 0x4f, 0x0e, 0x6a, 0x1d, 0x6c, 0xf6, 0x6f, 0xca, 0x2b, 0x7d, 0x97,
+    0x49, 0xcb, 0xe4, 0xcc, 0xa6, 0xc7, 0xee, 0xf5, 0x7c, 0x39, 0x3b, 0xfc, 0x04, 0x95, 0x88, 0xb4,
+    0x13, 0xf5, 0x8a, 0x89, 0xfb, 0xa7, 0xaf, 0x01, 0x6d, 0x0b, 0x3d, 0xd7, 0x1b, 0xbe, 0xb3, 0x15,
+    0xea, 0xe8, 0x92, 0x86, 0xa9, 0xc5, 0xf8, 0x9b, 0x78, 0x70, 0x78, 0xc9, 0xb4, 0xde, 0x66, 0x94,
+    0xfd, 0xe3, 0xcd, 0xf3, 0x82, 0xfa, 0xe2, 0xf1, 0xcf, 0x99, 0xb6, 0x87, 0x5f, 0x70, 0x5a, 0x39,
+    0xf4, 0xbf, 0xb8, 0x34, 0x22, 0xa9, 0x4c, 0xe3, 0x4e, 0x6e, 0x34, 0x50, 0x66, 0x78, 0x84, 0xfe,
+    0x7a, 0xf5, 0x14, 0x7f, 0xfb, 0x21, 0x97, 0xa8, 0x15, 0xb9, 0xb6, 0xf0, 0xf4, 0x2f, 0x7c, 0x0f,
+    0x33, 0x42, 0x06, 0x4c, 0xc8, 0xa6, 0x44, 0x2d, 0xf7, 0x3c, 0xae, 0x15, 0xf6, 0x74, 0x21, 0xbd,
+    0xe3, 0x56, 0xa9, 0xaf, 0xe6, 0x16, 0xf6, 0xc3, 0x80, 0x3a, 0x8b, 0x72, 0x98, 0x7c, 0x4e, 0x36,
+    0xbf, 0x29, 0x9d, 0x5d, 0xc8, 0x7c, 0x5b, 0xcc, 0xf6, 0x19, 0x59, 0xf5, 0xa2, 0x5f, 0x2b, 0x5f,
+    0x4b, 0xca, 0x5e, 0x11, 0x96, 0x48, 0x0f, 0x4f, 0xee, 0x5d, 0x1c, 0x0b, 0x66, 0xc7, 0x38, 0xbb,
+    0x78, 0xbe, 0x15, 0xa8, 0x74, 0xb3, 0x89, 0xf7, 0xdc, 0x51, 0xaf, 0xa9, 0xbe, 0xc5, 0xcb, 0xa4,
+    0x5d, 0xc6, 0xad, 0x5d, 0xde, 0xae, 0x2d, 0x4d, 0xd3, 0x15, 0xd5, 0x7d, 0x92, 0x6c, 0xf4, 0xe9,
+    0xa0, 0xca, 0x21, 0xaa, 0xfb, 0xc9, 0x97, 0x1f, 0x2d, 0x3a, 0xe9, 0x28, 0x7d, 0xe8, 0xfd, 0x24,
+    0xff, 0x89, 0x2c, 0xab, 0x76, 0xe6, 0xf2, 0xa4, 0xc2, 0xe5, 0x64, 0x26, 0x32, 0x53, 0x1a, 0xae,
+    0xe9, 0x4a, 0xf6, 0x55, 0x05, 0xcb, 0xbd, 0x1f, 0xa2, 0xe5, 0x3e, 0x9f, 0xbb, 0x71, 0xf2, 0xc6,
+    0x22, 0x63, 0x03, 0xb7, 0x47, 0x7c, 0x64, 0x83, 0x45, 0xcf, 0xd2, 0x50, 0xe3, 0xd6, 0x62, 0xf9,
+    0xe7, 0x96, 0xb7, 0x75, 0x74, 0x5f, 0x86, 0xc7, 0x18, 0xb4, 0x3e, 0x4b, 0x84, 0x1a, 0x04, 0x55,
+    0x4e, 0xfa, 0x6a, 0x4d, 0xac, 0x4f, 0x7b, 0xcc, 0x1c, 0x62, 0x79, 0x60, 0x2f, 0xe6, 0xa1, 0x17,
+    0xed, 0xe8, 0xcb, 0x9c, 0xab, 0x1d, 0xd5, 0xcf, 0xc2, 0x5f, 0xcd, 0xdf, 0x7f, 0x4d, 0x79, 0x6f,
+    0xa2, 0xa6, 0x5e, 0x64, 0xb8, 0x87, 0xb1, 0x57, 0x65, 0xaa, 0x77, 0x99, 0x48, 0x70, 0x45, 0x39,
+    0xf3, 0x56, 0x6b, 0x58, 0x9f, 0x95, 0xf8, 0xd7, 0x56, 0xcf, 0x87, 0xcf, 0xd4, 0x19, 0xc8, 0x63,
+    0x9c, 0x18, 0x35, 0xb2, 0x24, 0x7e, 0x92, 0x9b, 0x30, 0xc7, 0x28, 0x35, 0xb9, 0xb9, 0x2d, 0x66,
+    0x2e, 0xba, 0xfe, 0xf6, 0x4d, 0x0a, 0x61, 0x35, 0x5e, 0x5e, 0xb0, 0x7b, 0x71, 0x97, 0x61, 0xd9,
+    0xf5, 0x72, 0xb4, 0x90, 0x17, 0x07, 0x8b, 0x27, 0x85, 0xfd, 0xe2, 0x81, 0xa1, 0x2c, 0x1b, 0x87,
+    0x8c, 0x2b, 0xea, 0x1e, 0xf7, 0x34, 0x1d, 0x22, 0x2b, 0x48, 0xcb, 0x29, 0x9f, 0xb6, 0x7f, 0x50,
+    0x4f, 0xca, 0xe4, 0x3b, 0x4e, 0x63, 0xfe, 0xe7, 0x23, 0x7b, 0xa0, 0xd5, 0x09, 0xa5, 0xf2, 0xd3,
+    0x69, 0xf9, 0x32, 0x39, 0xec, 0x1d, 0x91, 0x3c, 0x36, 0x2a, 0x92, 0xf2, 0x46, 0x26, 0x13, 0x34,
+    0x47, 0x14, 0xdf, 0x27, 0xd4, 0xb4, 0xd7, 0x05, 0x12, 0xc7, 0x2b, 0x4c, 0xf4, 0x02, 0x1b, 0xd3,
+    0x2a, 0x8c, 0x76, 0x17, 0x3e, 0xd9, 0xd8, 0x21, 0x17, 0x1f, 0xb0, 0x54, 0x70, 0x2e, 0xaa, 0x7f,
+    0x5d, 0xff, 0x55, 0x75, 0x55, 0x92, 0xa2, 0xed, 0x94, 0x80, 0x60, 0xdd, 0xe9, 0xa3, 0xe7, 0x2b,
+    0xf3, 0x4a, 0x65, 0x4f, 0x12, 0xdc, 0xd2, 0xbe, 0x09, 0xe9, 0xcb, 0x5c, 0x1d, 0x08, 0xd8, 0x17,
+    0xd2, 0x58, 0xcc, 0xfe, 0x64, 0xf4, 0xef, 0x75, 0x77, 0xad, 0x92, 0xb1, 0x91, 0xc1, 0xca, 0x93,
+    0xc9, 0x0d, 0xab, 0xb9, 0x14, 0x5f, 0xac, 0x34, 0x06, 0x95, 0xb7, 0xc6, 0x8f, 0x9a, 0xf7, 0x2f,
+    0x45, 0x30, 0x11, 0x72, 0x07, 0x5d, 0xd4, 0x78, 0x28, 0x26, 0xa2, 0xdd, 0x25, 0x1c, 0x7d, 0x39,
+    0x8b, 0xac, 0x39, 0xc4, 0x66, 0xef, 0x2b, 0x65, 0xca, 0x9f, 0x34, 0x18, 0xd6, 0xf5, 0xae, 0x8e,
+    0x54, 0xbd, 0x70, 0x71, 0xdc, 0x86, 0xf3, 0x42, 0xef, 0xd9, 0xab, 0x21, 0x61, 0x7a, 0xcf, 0x19,
+    0xe2, 0x54, 0x7f, 0xb5, 0x64, 0x2e, 0xa8, 0x9b, 0xa5, 0xbc, 0x6f, 0x91, 0x17, 0x88, 0xae, 0x0b,
+    0x31, 0x19, 0xd4, 0x5d, 0x33, 0x89, 0x15, 0x4c, 0xcf, 0x5a, 0xca, 0x1a, 0x16, 0x34, 0xb2, 0x39,
+    0xb3, 0xae, 0x6f, 0xe1, 0x47, 0x3a, 0xf1, 0x92, 0x7e, 0xd9, 0xf1, 0xa1, 0x51, 0xa0, 0x6e, 0x29,
+    0xa5, 0x84, 0x58, 0xdc, 0x6d, 0xe3, 0xfe, 0x65, 0xf5, 0x67, 0x26, 0xb6, 0xa3, 0x4f, 0x6e, 0xeb,
+    0xcf, 0x88, 0x46, 0xea, 0x59, 0x58, 0x4f, 0xd9, 0x46, 0x11, 0x17, 0xb2, 0x8b, 0x8f, 0xc9, 0x75,
+    0x68, 0xd2, 0x1d, 0xf4, 0xea, 0xbe, 0xb2, 0xa9, 0x7a, 0x2b, 0x28, 0x74, 0x7d, 0xb3, 0xa8, 0xfb,
+    0x2a, 0x03, 0xe5, 0x2d, 0xf3, 0xba, 0x82, 0xd1, 0x69, 0xed, 0x06, 0xae, 0x8b, 0x8f, 0xa3, 0x2c,
+    0xd5, 0x9b, 0x97, 0x95, 0xad, 0xc9, 0x02, 0xd9, 0xbf, 0x2f, 0xd2, 0x1c, 0x10, 0x95, 0xa8, 0xaa,
+    0xbc, 0xf1, 0x86, 0x56, 0x6d, 0x67, 0xef, 0xe0, 0xa5, 0xdd, 0x45, 0x3f, 0xf9, 0xfd, 0x1c, 0xda,
+    0x3d, 0x5a, 0x74, 0x56, 0x2f, 0x11, 0xa7, 0x19, 0x73, 0x98, 0xd8, 0x49, 0x2f, 0x3c, 0x15, 0xb2,
+    0xe4, 0xca, 0x1f, 0xca, 0xb7, 0x0c, 0x16, 0x59, 0x68, 0x9e, 0x12, 0x9c, 0xe4, 0xe5, 0xf1, 0xb4,
+    0x5d, 0x20, 0xb4, 0x12, 0x7f, 0x2a, 0x32, 0x2d, 0xb6, 0x1f, 0xf2, 0xec, 0x90, 0xfe, 0x34, 0xfb,
+    0xb4, 0xf3, 0x1b, 0xad, 0x5e, 0x6d, 0x22, 0xe7, 0xb9, 0x43, 0x03, 0xba, 0x54, 0x4b, 0xd9, 0xee,
+    0x16, 0xd4, 0xcf, 0x06, 0xe3, 0xe5, 0x28, 0xbd, 0x38, 0x8d, 0xee, 0x9b, 0x9c, 0xe9, 0x3d, 0x30,
+    0x25, 0xfc, 0x25, 0x4a, 0x59, 0x21, 0x21, 0xe9, 0x54, 0xe2, 0x77, 0x32, 0xb3, 0xd4, 0x27, 0xbb,
+    0x1e, 0xeb, 0x77, 0x30, 0x06, 0xd1, 0xc7, 0x1a, 0xd1, 0xdc, 0x4f, 0x08, 0x7c, 0x11, 0x3f, 0xcc,
+    0x96, 0xf7, 0xb3, 0xd1, 0x31, 0x83, 0x2f, 0xf8, 0x0f, 0x3f, 0xa7, 0xbe, 0x89, 0x6e, 0xa5, 0xce,
+    0xde, 0x8a, 0x62, 0xb5, 0xf5, 0xfb, 0xfa, 0xde, 0x11, 0xaf, 0xe4, 0x6b, 0x2f, 0x65, 0xdb, 0x0c,
+    0x75, 0x87, 0x6d, 0xb9, 0xfb, 0xfc, 0x48, 0x6e, 0x94, 0x3a, 0x72, 0x57, 0xb4, 0x38, 0x76, 0x47,
+    0xbe, 0xcf, 0x2f, 0x80, 0xcd, 0x2f, 0x4f, 0x49, 0xaf, 0x76, 0xb7, 0xff, 0xa6, 0xc8, 0x00, 0xe9,
+    0x5b, 0xeb, 0xda, 0x3f, 0xed, 0x17, 0x47, 0x8b, 0xe9, 0x4a, 0x87, 0x78, 0xe5, 0xa8, 0x4a, 0x64,
+    0xcf, 0xca, 0x0f, 0x1e, 0x5f, 0x69, 0x62, 0x96, 0xda, 0x19, 0xa4, 0xb7, 0x61, 0xa7, 0xe2, 0x2a,
+    0x9e, 0x0b, 0x6b, 0x75, 0xe3, 0x97, 0xac, 0xb1, 0x16, 0x1c, 0x33, 0x71, 0x78, 0xae, 0x27, 0xf7,
+    0x9d, 0xa8, 0x91, 0x6d, 0xa6, 0x57, 0xc4, 0x77, 0x38, 0x55, 0x5c, 0xf2, 0xb4, 0x92, 0xc0, 0x12,
+    0xd5, 0xae, 0x33, 0xd7, 0x22, 0xfe, 0x7e, 0x1f, 0xb6, 0x16, 0x78, 0xc0, 0x13, 0x65, 0x7d, 0xab,
+    0xc7, 0xf9, 0xec, 0x69, 0xae, 0x36, 0x4f, 0xeb, 0x6b, 0xba, 0xb6, 0x09, 0xc3, 0x9e, 0xa4, 0x94,
+    0x34, 0x12, 0x67, 0x4a, 0x48, 0x95, 0x85, 0x0f, 0x76, 0xbd, 0x4f, 0x73, 0xdc, 0x5d, 0x1d, 0x10,
+    0xee, 0x52, 0x77, 0x4a, 0x32, 0x4f, 0x93, 0x3f, 0x7f, 0x69, 0x64, 0xab, 0x7b, 0x3a, 0x75, 0x58,
+    0xd2, 0xf2, 0x2f, 0x9d, 0x4b, 0x62, 0xe1, 0x90, 0x98, 0xf7, 0xbf, 0xef, 0xf7, 0xe0, 0x8f, 0xdb,
+    0x3b, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0xff, 0x92, 0xff, 0xfb,
+    0x9d, 0x6a, 0x54, 0x8f, 0x5d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc0, 0x7f,
+    0x8f, 0x1b, 0xfb, 0xbf, 0x67, 0xc2, 0xd0, 0xce, 0x0e, 0xb6, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xa9, 0x7f, 0x01, 0x5d, 0x4c,
+    0xd2, 0xdd,
+};
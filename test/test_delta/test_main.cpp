@@ -0,0 +1,171 @@
+/**
+    @title     MoonLight
+    @file      test_main.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+// DeltaUpdate with a patch made by scripts/delta.py (patch.h, see make_patch.py) on the base image in the stubbed
+// running partition: the rebuilt image must pass the SHA-256 check of the writer, fed at once and in small chunks.
+// The patch has negative seeks and inflates to more than the 32 KB window, so the window wraps. A patch for another
+// base, a corrupt stream and a truncated patch must fail. Times are of the build machine.
+
+#include <unity.h>
+#include <DeltaUpdate.cpp>
+#include <chrono>
+#include <vector>
+#include "patch.h"
+
+unsigned long hostMillis = 0;
+
+#define BENCH_RUNS 20
+
+static DeltaUpdate *update;
+
+// the base image, as images() in make_patch.py
+static std::vector<uint8_t> base()
+{
+    std::vector<uint8_t> image(DELTA_BASE_SIZE);
+    uint32_t x = 2463534242u;
+    for (uint8_t &b : image) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        b = x;
+    }
+    return image;
+}
+
+// feeds the patch in chunks of 1..chunk bytes, false if a write failed
+static bool feed(const std::vector<uint8_t> &patch, size_t chunk)
+{
+    if (!update->begin())
+        return false;
+    size_t n = 1;
+    for (size_t pos = 0; pos < patch.size(); pos += n) {
+        n = MIN(chunk ? 1 + pos % chunk : patch.size(), patch.size() - pos);
+        if (!update->write(patch.data() + pos, n))
+            return false;
+    }
+    return true;
+}
+
+void setUp()
+{
+    hostPartition() = base();
+    runningShaValid = false; //the base may have changed
+    update = new DeltaUpdate();
+}
+
+void tearDown()
+{
+    delete update;
+}
+
+void test_patch_covers()
+{
+    // the records of the patch: a wrapping window and negative seeks
+    std::vector<uint8_t> body(DELTA_NEW_SIZE + 1024);
+    uLongf len = body.size();
+    TEST_ASSERT_EQUAL(Z_OK, uncompress(body.data(), &len, deltaPatch + sizeof(delta_header_t), sizeof(deltaPatch) - sizeof(delta_header_t)));
+    TEST_ASSERT_TRUE(len > TINFL_LZ_DICT_SIZE);
+
+    int negative = 0;
+    for (size_t pos = 0; pos < len;) {
+        int32_t control[3];
+        memcpy(control, body.data() + pos, sizeof(control));
+        pos += sizeof(control) + control[0] + control[1];
+        if (control[2] < 0)
+            negative++;
+    }
+    TEST_ASSERT_TRUE(negative >= 2);
+}
+
+void test_apply_at_once()
+{
+    std::vector<uint8_t> patch(deltaPatch, deltaPatch + sizeof(deltaPatch));
+    TEST_ASSERT_TRUE(feed(patch, 0));
+    TEST_ASSERT_TRUE(update->end());
+    TEST_ASSERT_EQUAL(DELTA_NEW_SIZE, update->written());
+    TEST_ASSERT_EQUAL(DELTA_NEW_SIZE, update->writer().image().size());
+}
+
+void test_apply_in_chunks()
+{
+    // chunks of 1..13 bytes: the header, control records and inflate calls are split everywhere
+    std::vector<uint8_t> patch(deltaPatch, deltaPatch + sizeof(deltaPatch));
+    TEST_ASSERT_TRUE(feed(patch, 13));
+    TEST_ASSERT_TRUE(update->end());
+
+    // the same image as at once
+    DeltaUpdate once;
+    TEST_ASSERT_TRUE(once.begin());
+    TEST_ASSERT_TRUE(once.write(deltaPatch, sizeof(deltaPatch)));
+    TEST_ASSERT_TRUE(once.end());
+    TEST_ASSERT_TRUE(once.writer().image() == update->writer().image());
+}
+
+void test_other_base()
+{
+    hostPartition()[1000]++;
+    std::vector<uint8_t> patch(deltaPatch, deltaPatch + sizeof(deltaPatch));
+    TEST_ASSERT_FALSE(feed(patch, 0));
+    TEST_ASSERT_TRUE(update->baseMismatch());
+    update->abort();
+}
+
+void test_corrupt()
+{
+    // a byte of the compressed records flipped: the stream or the image is wrong, never applied
+    std::vector<uint8_t> patch(deltaPatch, deltaPatch + sizeof(deltaPatch));
+    patch[sizeof(delta_header_t) + patch.size() / 3] ^= 0x55;
+    bool ok = feed(patch, 0) && update->end();
+    TEST_ASSERT_FALSE(ok);
+    TEST_ASSERT_NOT_NULL(update->error());
+    TEST_ASSERT_FALSE(update->baseMismatch());
+    update->abort();
+}
+
+void test_truncated()
+{
+    std::vector<uint8_t> patch(deltaPatch, deltaPatch + sizeof(deltaPatch) / 2);
+    TEST_ASSERT_TRUE(feed(patch, 0));
+    TEST_ASSERT_FALSE(update->end());
+    update->abort();
+}
+
+// us to rebuild the image, without the flash writes of the device
+void test_bench()
+{
+    uint8_t sha[32];
+    DeltaUpdate::runningSha256(sha); //hashed once, as on the device
+    auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < BENCH_RUNS; run++) {
+        DeltaUpdate bench;
+        TEST_ASSERT_TRUE(bench.begin());
+        for (size_t pos = 0; pos < sizeof(deltaPatch); pos += 1436) //a TCP segment
+            TEST_ASSERT_TRUE(bench.write(deltaPatch + pos, MIN((size_t)1436, sizeof(deltaPatch) - pos)));
+        TEST_ASSERT_TRUE(bench.end());
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / BENCH_RUNS;
+
+    char message[128];
+    snprintf(message, sizeof(message), "delta of %d bytes to an image of %d bytes: %.0f us", (int)sizeof(deltaPatch), DELTA_NEW_SIZE, us);
+    TEST_MESSAGE(message);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_patch_covers);
+    RUN_TEST(test_apply_at_once);
+    RUN_TEST(test_apply_in_chunks);
+    RUN_TEST(test_other_base);
+    RUN_TEST(test_corrupt);
+    RUN_TEST(test_truncated);
+    RUN_TEST(test_bench);
+    return UNITY_END();
+}
@@ -0,0 +1,242 @@
+/**
+    @title     MoonLight
+    @file      test_main.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+// EffectGraph with the renderers of EffectNodes: scheduling, caching of nodes whose inputs did not change, the
+// StarLight and Plane effects, bypassed nodes, frames() only counting rendered frames, and the frame time of a graph of 16K leds.
+
+#include <unity.h>
+#include <LayerCompositor.cpp>
+#include <EffectGraph.cpp>
+#include <EffectNodes.cpp>
+#include <MappingTable.cpp>
+#include <chrono>
+#include <vector>
+
+unsigned long hostMillis = 0;
+
+#define BENCH_LEDS 16384
+#define BENCH_FRAMES 200
+
+static EffectGraph *graph;
+
+static NodeSettings node(uint8_t id, uint8_t type, uint16_t index = 0, uint8_t input0 = 0, uint8_t input1 = 0)
+{
+    NodeSettings settings;
+    settings.id = id;
+    settings.type = type;
+    settings.index = index;
+    settings.inputs[0] = input0;
+    settings.inputs[1] = input1;
+    return settings;
+}
+
+static bool cached(uint8_t scheduled)
+{
+    JsonDocument doc;
+    JsonObject root = doc.to<JsonObject>();
+    graph->timing(root);
+    JsonArray nodes = root["nodes"];
+    bool cached = nodes[scheduled]["cached"];
+    return cached;
+}
+
+void setUp()
+{
+    hostMillis = 1000;
+    graph = new EffectGraph();
+    addNodeRenderers(*graph);
+}
+
+void tearDown()
+{
+    delete graph;
+}
+
+void test_schedule()
+{
+    std::vector<CRGB> leds(10);
+    // listed output first, node 4 is not connected
+    graph->configure({node(3, NODE_OUTPUT, 0, 2), node(2, NODE_MODIFIER, NODE_MODIFIER_REVERSE, 1), node(1, NODE_EFFECT, NODE_EFFECT_GRADIENT),
+                      node(4, NODE_EFFECT, NODE_EFFECT_RAINBOW)},
+                     leds.size());
+    TEST_ASSERT_TRUE(graph->active());
+    TEST_ASSERT_TRUE(graph->render(leds.data(), leds.size()));
+    TEST_ASSERT_TRUE(leds[0] == CRGB(0, 0, 255)); //gradient, reversed
+    TEST_ASSERT_TRUE(leds[9] == CRGB(255, 0, 0));
+
+    JsonDocument doc;
+    JsonObject root = doc.to<JsonObject>();
+    graph->timing(root);
+    JsonArray nodes = root["nodes"];
+    TEST_ASSERT_EQUAL(3, nodes.size());
+}
+
+void test_cycle()
+{
+    std::vector<CRGB> leds(10);
+    graph->configure({node(1, NODE_MODIFIER, NODE_MODIFIER_REVERSE, 2), node(2, NODE_MODIFIER, NODE_MODIFIER_BLUR, 1), node(3, NODE_OUTPUT, 0, 1)},
+                     leds.size());
+    TEST_ASSERT_FALSE(graph->active());
+    TEST_ASSERT_FALSE(graph->render(leds.data(), leds.size()));
+}
+
+void test_cached()
+{
+    std::vector<CRGB> leds(10);
+    graph->configure({node(1, NODE_EFFECT, NODE_EFFECT_GRADIENT), node(2, NODE_MODIFIER, NODE_MODIFIER_REVERSE, 1), node(3, NODE_OUTPUT, 0, 2)},
+                     leds.size());
+    graph->render(leds.data(), leds.size());
+    TEST_ASSERT_FALSE(cached(1));
+
+    // the second frame reruns the reverse: its buffer went back to the pool as it changed in the first
+    for (int frame = 0; frame < 2; frame++) {
+        hostMillis += 20;
+        memset(leds.data(), 0, leds.size() * sizeof(CRGB));
+        graph->render(leds.data(), leds.size());
+    }
+    TEST_ASSERT_TRUE(cached(1)); //the gradient did not change, the reverse is not rerun
+    TEST_ASSERT_TRUE(leds[0] == CRGB(0, 0, 255));
+
+    // a moving effect reruns the nodes depending on it
+    graph->configure({node(1, NODE_EFFECT, NODE_EFFECT_RAINBOW), node(2, NODE_MODIFIER, NODE_MODIFIER_REVERSE, 1), node(3, NODE_OUTPUT, 0, 2)},
+                     leds.size());
+    graph->render(leds.data(), leds.size());
+    hostMillis += 20;
+    graph->render(leds.data(), leds.size());
+    TEST_ASSERT_FALSE(cached(1));
+}
+
+void test_starlight()
+{
+    std::vector<CRGB> leds(10);
+    for (size_t i = 0; i < leds.size(); i++)
+        leds[i] = CRGB(i, 0, 0);
+    // the frame of loopStar, mirrored
+    graph->configure({node(1, NODE_EFFECT, NODE_EFFECT_STARLIGHT), node(2, NODE_MODIFIER, NODE_MODIFIER_MIRROR, 1), node(3, NODE_OUTPUT, 0, 2)},
+                     leds.size());
+    graph->render(leds.data(), leds.size());
+    TEST_ASSERT_TRUE(leds[0] == CRGB(0, 0, 0));
+    TEST_ASSERT_TRUE(leds[4] == CRGB(4, 0, 0));
+    TEST_ASSERT_TRUE(leds[5] == CRGB(4, 0, 0));
+    TEST_ASSERT_TRUE(leds[9] == CRGB(0, 0, 0));
+}
+
+void test_plane()
+{
+    // a 4x4 panel: a row moves, at 1s it is row 1
+    std::vector<CRGB> leds(16);
+    mappingTable.begin(4, 4, 1);
+    for (uint16_t i = 0; i < 16; i++)
+        mappingTable.add(i, i);
+    mappingTable.end();
+    graph->configure({node(1, NODE_EFFECT, NODE_EFFECT_PLANE), node(2, NODE_OUTPUT, 0, 1)}, leds.size());
+    graph->render(leds.data(), leds.size());
+    TEST_ASSERT_TRUE(leds[3] == CRGB(0, 0, 0));
+    TEST_ASSERT_TRUE(leds[4] == wheel(hostMillis / 20));
+    TEST_ASSERT_TRUE(leds[7] == wheel(hostMillis / 20));
+    TEST_ASSERT_TRUE(leds[8] == CRGB(0, 0, 0));
+    mappingTable.clear();
+}
+
+void test_projection_and_blend()
+{
+    std::vector<CRGB> leds(10);
+    // the gradient shown twice, blended at opacity 0 on the gradient: the tile is not visible
+    graph->configure({node(1, NODE_EFFECT, NODE_EFFECT_GRADIENT), node(2, NODE_PROJECTION, NODE_PROJECTION_TILE, 1), node(3, NODE_OUTPUT, 0, 2)},
+                     leds.size());
+    graph->render(leds.data(), leds.size());
+    TEST_ASSERT_TRUE(leds[0] == leds[5]);
+    TEST_ASSERT_TRUE(leds[0] == CRGB(255, 0, 0));
+
+    NodeSettings blend = node(4, NODE_BLEND, 0, 1, 2);
+    blend.opacity = 0;
+    graph->configure({node(1, NODE_EFFECT, NODE_EFFECT_GRADIENT), node(2, NODE_PROJECTION, NODE_PROJECTION_TILE, 1), blend, node(3, NODE_OUTPUT, 0, 4)},
+                     leds.size());
+    graph->render(leds.data(), leds.size());
+    TEST_ASSERT_TRUE(leds[9] == CRGB(0, 0, 255));
+}
+
+void test_bypass()
+{
+    std::vector<CRGB> leds(10);
+    NodeSettings reverse = node(2, NODE_MODIFIER, NODE_MODIFIER_REVERSE, 1);
+    reverse.on = false;
+    graph->configure({node(1, NODE_EFFECT, NODE_EFFECT_GRADIENT), reverse, node(3, NODE_OUTPUT, 0, 2)}, leds.size());
+    graph->render(leds.data(), leds.size());
+    TEST_ASSERT_TRUE(leds[0] == CRGB(255, 0, 0)); //the gradient, not reversed
+
+    // without renderers effects render black and the other nodes pass their input
+    EffectGraph bare;
+    for (CRGB &led : leds)
+        led = CRGB(1, 2, 3);
+    bare.configure({node(1, NODE_EFFECT, NODE_EFFECT_GRADIENT), node(2, NODE_MODIFIER, NODE_MODIFIER_REVERSE, 1), node(3, NODE_OUTPUT, 0, 2)},
+                   leds.size());
+    TEST_ASSERT_TRUE(bare.render(leds.data(), leds.size()));
+    TEST_ASSERT_TRUE(leds[0] == CRGB(0, 0, 0));
+}
+
+void test_frames()
+{
+    std::vector<CRGB> leds(10);
+    graph->configure({node(1, NODE_EFFECT, NODE_EFFECT_RAINBOW)}, leds.size()); //no output node
+    TEST_ASSERT_FALSE(graph->render(leds.data(), leds.size()));
+    TEST_ASSERT_EQUAL(0, graph->frames());
+
+    graph->configure({node(1, NODE_EFFECT, NODE_EFFECT_RAINBOW), node(2, NODE_OUTPUT, 0, 1)}, leds.size());
+    graph->render(leds.data(), leds.size());
+    graph->render(leds.data(), leds.size());
+    TEST_ASSERT_EQUAL(2, graph->frames());
+}
+
+// us per frame of render() with an effect, a modifier and a projection rerun every frame, and with the static gradient
+static double bench(uint16_t effect)
+{
+    std::vector<CRGB> leds(BENCH_LEDS);
+    graph->configure({node(1, NODE_EFFECT, effect), node(2, NODE_MODIFIER, NODE_MODIFIER_BLUR, 1), node(3, NODE_PROJECTION, NODE_PROJECTION_TILE, 2),
+                      node(4, NODE_OUTPUT, 0, 3)},
+                     leds.size());
+    graph->render(leds.data(), leds.size()); //buffers allocated
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        hostMillis += 20;
+        graph->render(leds.data(), leds.size());
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / BENCH_FRAMES;
+
+    char message[128];
+    snprintf(message, sizeof(message), "render %d leds effect %d, blur, tile: %.1f us/frame (budget %d us)", BENCH_LEDS, effect, us,
+             COMPOSITOR_BUDGET_US);
+    TEST_MESSAGE(message);
+    return us;
+}
+
+void test_bench_rainbow() { TEST_ASSERT_LESS_THAN(COMPOSITOR_BUDGET_US, bench(NODE_EFFECT_RAINBOW)); }
+void test_bench_gradient()
+{
+    TEST_ASSERT_LESS_THAN(COMPOSITOR_BUDGET_US, bench(NODE_EFFECT_GRADIENT));
+    TEST_ASSERT_TRUE(cached(1) && cached(2)); //only the gradient and the output ran
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_schedule);
+    RUN_TEST(test_cycle);
+    RUN_TEST(test_cached);
+    RUN_TEST(test_starlight);
+    RUN_TEST(test_plane);
+    RUN_TEST(test_projection_and_blend);
+    RUN_TEST(test_bypass);
+    RUN_TEST(test_frames);
+    RUN_TEST(test_bench_rainbow);
+    RUN_TEST(test_bench_gradient);
+    return UNITY_END();
+}
@@ -0,0 +1,143 @@
+/**
+    @title     MoonLight
+    @file      test_main.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+// Decoding of inbound event socket frames (EventEnvelope): the envelope of JSON and MsgPack frames, malformed
+// frames, and the decode throughput of a slider update (30-60 of these per second per client).
+
+#include <unity.h>
+#include <EventEnvelope.cpp>
+#include <chrono>
+#include <string>
+#include <vector>
+
+unsigned long hostMillis = 0;
+
+#define BENCH_FRAMES 1000000
+
+static event_envelope_t envelope;
+
+static bool decodeJson(const char *frame)
+{
+    return decodeJsonEnvelope((const uint8_t *)frame, strlen(frame), envelope);
+}
+
+static std::string eventName()
+{
+    return std::string(envelope.event, envelope.eventLen);
+}
+
+static std::string dataText()
+{
+    return std::string((const char *)envelope.data, envelope.dataLen);
+}
+
+// {"event":"lights","data":{"bri":200,"on":true,"list":[1,-1,300,1.5]}}
+static const std::vector<uint8_t> msgPackLights = {
+    0x82, 0xa5, 'e', 'v', 'e', 'n', 't', 0xa6, 'l', 'i', 'g', 'h', 't', 's', 0xa4, 'd', 'a', 't', 'a',
+    0x83, 0xa3, 'b', 'r', 'i', 0xcc, 200, 0xa2, 'o', 'n', 0xc3, 0xa4, 'l', 'i', 's', 't',
+    0x94, 0x01, 0xff, 0xcd, 0x01, 0x2c, 0xcb, 0x3f, 0xf8, 0, 0, 0, 0, 0, 0};
+
+void setUp() {}
+void tearDown() {}
+
+void test_json_subscribe()
+{
+    TEST_ASSERT_TRUE(decodeJson("{\"event\":\"subscribe\",\"data\":\"analytics\"}"));
+    TEST_ASSERT_EQUAL_STRING("subscribe", eventName().c_str());
+    const char *string;
+    size_t len;
+    TEST_ASSERT_TRUE(envelopeJsonString(envelope, string, len));
+    TEST_ASSERT_EQUAL_STRING("analytics", std::string(string, len).c_str());
+}
+
+void test_json_nested_data()
+{
+    // data first, whitespace, a string with an escaped quote and a brace
+    TEST_ASSERT_TRUE(decodeJson(" { \"data\" : {\"a\":[1,2,{\"b\":\"x}\\\"y\"}],\"c\":true} , \"event\" : \"lights\" } "));
+    TEST_ASSERT_EQUAL_STRING("lights", eventName().c_str());
+    TEST_ASSERT_EQUAL_STRING("{\"a\":[1,2,{\"b\":\"x}\\\"y\"}],\"c\":true}", dataText().c_str());
+}
+
+void test_json_malformed_rejected()
+{
+    TEST_ASSERT_FALSE(decodeJson("{\"event\":\"li\\\"ghts\",\"data\":1}")); //escaped event name
+    TEST_ASSERT_FALSE(decodeJson("{\"event\":\"lights\",\"data\":{\"a\":1}")); //truncated
+    TEST_ASSERT_FALSE(decodeJson("[\"lights\"]"));
+    TEST_ASSERT_FALSE(decodeJson("{\"data\":1}")); //no event
+}
+
+void test_msgpack_nested_data()
+{
+    TEST_ASSERT_TRUE(decodeMsgPackEnvelope(msgPackLights.data(), msgPackLights.size(), envelope));
+    TEST_ASSERT_EQUAL_STRING("lights", eventName().c_str());
+    TEST_ASSERT_EQUAL(msgPackLights.size() - 19, envelope.dataLen); //the map after "data"
+    TEST_ASSERT_EQUAL(0x83, envelope.data[0]);
+}
+
+void test_msgpack_subscribe()
+{
+    const std::vector<uint8_t> frame = {0x82, 0xa5, 'e', 'v', 'e', 'n', 't', 0xa9, 's', 'u', 'b', 's', 'c', 'r', 'i', 'b', 'e',
+                                        0xa4, 'd', 'a', 't', 'a', 0xa9, 'a', 'n', 'a', 'l', 'y', 't', 'i', 'c', 's'};
+    TEST_ASSERT_TRUE(decodeMsgPackEnvelope(frame.data(), frame.size(), envelope));
+    TEST_ASSERT_EQUAL_STRING("subscribe", eventName().c_str());
+    const char *string;
+    size_t len;
+    TEST_ASSERT_TRUE(envelopeMsgPackString(envelope, string, len));
+    TEST_ASSERT_EQUAL_STRING("analytics", std::string(string, len).c_str());
+}
+
+void test_msgpack_truncated_rejected()
+{
+    for (size_t len = 0; len < msgPackLights.size(); len++)
+        TEST_ASSERT_FALSE(decodeMsgPackEnvelope(msgPackLights.data(), len, envelope));
+}
+
+// decode time per frame and throughput, times are of the build machine
+static void bench(const char *name, const uint8_t *frame, size_t len, bool msgPack)
+{
+    size_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_FRAMES; i++)
+    {
+        bool decoded = msgPack ? decodeMsgPackEnvelope(frame, len, envelope) : decodeJsonEnvelope(frame, len, envelope);
+        sum += decoded ? envelope.dataLen : 0;
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    TEST_ASSERT_EQUAL(BENCH_FRAMES * envelope.dataLen, sum);
+
+    char message[128];
+    snprintf(message, sizeof(message), "%s %zu bytes: %.0f ns/frame, %.0f MB/s", name, len, us * 1000 / BENCH_FRAMES, len * (double)BENCH_FRAMES / us);
+    TEST_MESSAGE(message);
+}
+
+void test_bench_json()
+{
+    const char *slider = "{\"event\":\"lightsControl\",\"data\":{\"lightsOn\":true,\"brightness\":173,\"red\":255,\"green\":120,\"blue\":40,\"preset\":3}}";
+    bench("json slider", (const uint8_t *)slider, strlen(slider), false);
+}
+
+void test_bench_msgpack()
+{
+    bench("msgpack lights", msgPackLights.data(), msgPackLights.size(), true);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_json_subscribe);
+    RUN_TEST(test_json_nested_data);
+    RUN_TEST(test_json_malformed_rejected);
+    RUN_TEST(test_msgpack_nested_data);
+    RUN_TEST(test_msgpack_subscribe);
+    RUN_TEST(test_msgpack_truncated_rejected);
+    RUN_TEST(test_bench_json);
+    RUN_TEST(test_bench_msgpack);
+    return UNITY_END();
+}
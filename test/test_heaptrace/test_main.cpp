@@ -0,0 +1,169 @@
+/**
+    @title     MoonLight
+    @file      test_main.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+// The task table of HeapTrace (HeapTraceTasks): entries of deleted tasks are reused, a reused handle does not inherit
+// the tag of the task it belonged to, and the cost of the lookup done on every malloc and free.
+
+#include <unity.h>
+#include <HeapTraceTasks.h>
+#include <chrono>
+
+unsigned long hostMillis = 0;
+
+#define BENCH_CALLS 10000000
+
+static HeapTraceTasks *tasks;
+static char tcbs[HEAP_TRACE_MAX_TASKS + 8][64]; //the task handles
+
+static TaskHandle_t handle(int i)
+{
+    return (TaskHandle_t)tcbs[i];
+}
+
+// finds the task and tags a new entry the way HeapTrace does, returns the entry
+static heap_task_t *lookup(TaskHandle_t task, const char *name, uint8_t tag, bool *isNew = nullptr)
+{
+    bool added;
+    heap_task_t *entry = tasks->find(task, name, added);
+    if (added)
+        entry->taskTag = tag;
+    if (isNew)
+        *isNew = added;
+    return entry;
+}
+
+void setUp()
+{
+    tasks = new HeapTraceTasks();
+}
+
+void tearDown()
+{
+    delete tasks;
+}
+
+void test_same_task_same_entry()
+{
+    bool isNew;
+    heap_task_t *loop = lookup(handle(0), "loopTask", 1, &isNew);
+    TEST_ASSERT_TRUE(isNew);
+    loop->scopeTag = 5;
+    heap_task_t *httpd = lookup(handle(1), "httpd", 2, &isNew);
+    TEST_ASSERT_TRUE(isNew);
+    TEST_ASSERT_EQUAL_PTR(loop, lookup(handle(0), "loopTask", 9, &isNew));
+    TEST_ASSERT_FALSE(isNew);
+    TEST_ASSERT_EQUAL(1, loop->taskTag);
+    TEST_ASSERT_EQUAL(5, loop->scopeTag);
+    TEST_ASSERT_EQUAL(2, httpd->taskTag);
+    TEST_ASSERT_EQUAL(2, tasks->count());
+}
+
+// a task deleted within a HEAP_TAG scope, a new task gets its memory
+void test_reused_handle_gets_own_tag()
+{
+    heap_task_t *ota = lookup(handle(0), "ota", 3);
+    ota->scopeTag = 7;
+    bool isNew;
+    heap_task_t *worker = lookup(handle(0), "mqtt_task", 4, &isNew);
+    TEST_ASSERT_TRUE(isNew);
+    TEST_ASSERT_EQUAL_PTR(ota, worker); //the entry is reused, not added
+    TEST_ASSERT_EQUAL(1, tasks->count());
+    TEST_ASSERT_EQUAL(4, worker->taskTag);
+    TEST_ASSERT_EQUAL(0, worker->scopeTag);
+    TEST_ASSERT_EQUAL_STRING("mqtt_task", worker->name);
+}
+
+// names of configMAX_TASK_NAME_LEN - 1 characters and more are cut as FreeRTOS does
+void test_long_name()
+{
+    lookup(handle(0), "a_very_long_task_name", 1);
+    bool isNew;
+    lookup(handle(0), "a_very_long_task_name", 2, &isNew);
+    TEST_ASSERT_FALSE(isNew);
+    lookup(handle(0), "a_very_long_tas", 2, &isNew);
+    TEST_ASSERT_FALSE(isNew);
+}
+
+// more tasks than entries over time: the entries of tasks which stopped allocating are reused, busy tasks keep theirs
+void test_full_table_reuses_least_recent()
+{
+    char name[16];
+    for (int i = 0; i < HEAP_TRACE_MAX_TASKS; i++)
+    {
+        snprintf(name, sizeof(name), "task%d", i);
+        lookup(handle(i), name, i);
+    }
+    for (int i = 0; i < HEAP_TRACE_MAX_TASKS; i++)
+        if (i != 3 && i != 10)
+        {
+            snprintf(name, sizeof(name), "task%d", i);
+            lookup(handle(i), name, i); //task3 and task10 are deleted
+        }
+    TEST_ASSERT_EQUAL(HEAP_TRACE_MAX_TASKS, tasks->count());
+
+    bool isNew;
+    heap_task_t *first = lookup(handle(HEAP_TRACE_MAX_TASKS), "new1", 40, &isNew);
+    TEST_ASSERT_TRUE(isNew);
+    TEST_ASSERT_EQUAL_STRING("new1", first->name);
+    heap_task_t *second = lookup(handle(HEAP_TRACE_MAX_TASKS + 1), "new2", 41);
+    TEST_ASSERT_NOT_EQUAL(first, second);
+    TEST_ASSERT_EQUAL(HEAP_TRACE_MAX_TASKS, tasks->count());
+
+    // all others still have their own entry and tag
+    for (int i = 0; i < HEAP_TRACE_MAX_TASKS; i++)
+        if (i != 3 && i != 10)
+        {
+            snprintf(name, sizeof(name), "task%d", i);
+            lookup(handle(i), name, 99, &isNew);
+            TEST_ASSERT_FALSE(isNew);
+        }
+    TEST_ASSERT_EQUAL(40, lookup(handle(HEAP_TRACE_MAX_TASKS), "new1", 99)->taskTag);
+}
+
+// ns per lookup of the task at position (of count tasks), times are of the build machine
+static void bench(int count, int position, const char *what)
+{
+    char names[HEAP_TRACE_MAX_TASKS][16];
+    for (int i = 0; i < count; i++)
+    {
+        snprintf(names[i], sizeof(names[i]), "task%d", i);
+        lookup(handle(i), names[i], i);
+    }
+    uint32_t sum = 0;
+    TaskHandle_t task = handle(position);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_CALLS; i++)
+    {
+        bool added;
+        sum += tasks->find(task, names[position], added)->taskTag;
+        __asm__ __volatile__("" : : : "memory"); //not hoisted out of the loop
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    TEST_ASSERT_EQUAL((uint32_t)BENCH_CALLS * position, sum);
+
+    char message[128];
+    snprintf(message, sizeof(message), "lookup %s (%d of %d tasks): %.1f ns/call", what, position + 1, count, ns / BENCH_CALLS);
+    TEST_MESSAGE(message);
+}
+
+void test_bench_first() { bench(HEAP_TRACE_MAX_TASKS, 0, "first"); }
+void test_bench_last() { bench(HEAP_TRACE_MAX_TASKS, HEAP_TRACE_MAX_TASKS - 1, "last"); }
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_same_task_same_entry);
+    RUN_TEST(test_reused_handle_gets_own_tag);
+    RUN_TEST(test_long_name);
+    RUN_TEST(test_full_table_reuses_least_recent);
+    RUN_TEST(test_bench_first);
+    RUN_TEST(test_bench_last);
+    return UNITY_END();
+}
@@ -0,0 +1,161 @@
+/**
+    @title     MoonLight
+    @file      test_main.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+// Several instances in one process, broadcasts are delivered to all others over a loopback "network"
+
+#include <unity.h>
+#include <InstanceProtocol.cpp>
+
+unsigned long hostMillis = 0;
+
+#define NR_OF_NODES 3
+
+static InstanceProtocol *nodes[NR_OF_NODES];
+static uint8_t buffer[MAX(sizeof(InstanceBeaconPacket), sizeof(InstanceStatePacket))];
+static int received[NR_OF_NODES]; //state callbacks per node
+static InstanceState lastState[NR_OF_NODES];
+static uint8_t lastFields[NR_OF_NODES];
+
+// delivers the packet in buffer to all nodes but the sender, returns the number of nodes which accepted it
+static int broadcast(int sender, size_t len)
+{
+    int accepted = 0;
+    for (int i = 0; i < NR_OF_NODES; i++)
+        if (i != sender && nodes[i]->handlePacket(buffer, len, 0x0A000001 + sender, hostMillis))
+            accepted++;
+    return accepted;
+}
+
+static void beacons()
+{
+    for (int i = 0; i < NR_OF_NODES; i++)
+        broadcast(i, nodes[i]->buildBeacon(buffer, "node", hostMillis / 1000));
+}
+
+static void startNode(int i, uint16_t boot)
+{
+    delete nodes[i];
+    nodes[i] = new InstanceProtocol();
+    nodes[i]->setId(0x11000000 + i, boot);
+    nodes[i]->onState([i](const Instance &sender, const InstanceState &state, uint8_t fields) {
+        received[i]++;
+        lastState[i] = state;
+        lastFields[i] = fields;
+    });
+}
+
+void setUp()
+{
+    hostMillis = 1000;
+    for (int i = 0; i < NR_OF_NODES; i++)
+    {
+        startNode(i, 100 + i);
+        received[i] = 0;
+    }
+    beacons();
+}
+
+void tearDown() {}
+
+void test_discovery()
+{
+    for (int i = 0; i < NR_OF_NODES; i++)
+        TEST_ASSERT_EQUAL(NR_OF_NODES - 1, nodes[i]->nrOfInstances());
+}
+
+void test_own_packets_ignored()
+{
+    size_t len = nodes[0]->buildBeacon(buffer, "node", 1);
+    TEST_ASSERT_FALSE(nodes[0]->handlePacket(buffer, len, 0, hostMillis));
+}
+
+void test_state_coalesced()
+{
+    TEST_ASSERT_EQUAL(0, nodes[0]->buildState(buffer)); //nothing changed
+
+    nodes[0]->setState(INSTANCE_FIELD_BRIGHTNESS, 10);
+    nodes[0]->setState(INSTANCE_FIELD_BRIGHTNESS, 20);
+    nodes[0]->setState(INSTANCE_FIELD_EFFECT, 7);
+    TEST_ASSERT_EQUAL(NR_OF_NODES - 1, broadcast(0, nodes[0]->buildState(buffer)));
+
+    for (int i = 1; i < NR_OF_NODES; i++)
+    {
+        TEST_ASSERT_EQUAL(1, received[i]);
+        TEST_ASSERT_EQUAL(INSTANCE_FIELD_BRIGHTNESS | INSTANCE_FIELD_EFFECT, lastFields[i]);
+        TEST_ASSERT_EQUAL(20, lastState[i].brightness); //last value wins
+        TEST_ASSERT_EQUAL(7, lastState[i].effect);
+    }
+    TEST_ASSERT_EQUAL(0, nodes[0]->buildState(buffer));
+
+    nodes[0]->setState(INSTANCE_FIELD_BRIGHTNESS, 20); //unchanged: not sent
+    TEST_ASSERT_EQUAL(0, nodes[0]->buildState(buffer));
+}
+
+void test_duplicates_dropped()
+{
+    nodes[1]->setState(INSTANCE_FIELD_ON, 1);
+    size_t len = nodes[1]->buildState(buffer);
+    TEST_ASSERT_EQUAL(NR_OF_NODES - 1, broadcast(1, len));
+    TEST_ASSERT_EQUAL(0, broadcast(1, len)); //same seq again
+    TEST_ASSERT_EQUAL(1, received[0]);
+}
+
+void test_restarted_peer_accepted()
+{
+    // many packets, then node 2 restarts with a new boot and counts from seq 1 again
+    for (int k = 0; k < 100; k++)
+        beacons();
+    startNode(2, 999);
+    nodes[2]->setState(INSTANCE_FIELD_PRESET, 3);
+    TEST_ASSERT_EQUAL(NR_OF_NODES - 1, broadcast(2, nodes[2]->buildState(buffer)));
+    TEST_ASSERT_EQUAL(3, lastState[0].preset);
+
+    // and its duplicates are dropped again
+    TEST_ASSERT_EQUAL(0, broadcast(2, sizeof(InstanceStatePacket)));
+}
+
+void test_state_of_unknown_peer_ignored()
+{
+    startNode(2, 5);
+    nodes[2]->setId(0x22000000, 5); //not announced by a beacon
+    nodes[2]->setState(INSTANCE_FIELD_ON, 1);
+    TEST_ASSERT_EQUAL(0, broadcast(2, nodes[2]->buildState(buffer)));
+}
+
+void test_expire()
+{
+    hostMillis += INSTANCE_TIMEOUT / 2;
+    broadcast(1, nodes[1]->buildBeacon(buffer, "node", 1)); //only node 1 is alive
+    hostMillis += INSTANCE_TIMEOUT / 2 + 1;
+    nodes[0]->expire(hostMillis);
+    TEST_ASSERT_EQUAL(1, nodes[0]->nrOfInstances());
+    TEST_ASSERT_EQUAL(0x11000001, nodes[0]->instances()[0].id + nodes[0]->instances()[1].id);
+}
+
+void test_truncated_packets_rejected()
+{
+    size_t len = nodes[1]->buildBeacon(buffer, "node", 1);
+    TEST_ASSERT_FALSE(broadcast(1, sizeof(InstanceHeader) - 1));
+    TEST_ASSERT_FALSE(broadcast(1, len - 1));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_discovery);
+    RUN_TEST(test_own_packets_ignored);
+    RUN_TEST(test_state_coalesced);
+    RUN_TEST(test_duplicates_dropped);
+    RUN_TEST(test_restarted_peer_accepted);
+    RUN_TEST(test_state_of_unknown_peer_ignored);
+    RUN_TEST(test_expire);
+    RUN_TEST(test_truncated_packets_rejected);
+    return UNITY_END();
+}
@@ -0,0 +1,205 @@
+/**
+    @title     MoonLight
+    @file      test_main.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+// MappingTable: spans of row major and serpentine fixtures, leds sharing a virtual led, ranges, the hot range cache,
+// and memory and per frame cost against a dense table (an entry per virtual led) for a sphere of leds in a 128^3 grid.
+// Times are of the build machine.
+
+#include <unity.h>
+#include <MappingTable.cpp>
+#include <FastLED.h>
+#include <chrono>
+#include <math.h>
+#include <vector>
+
+unsigned long hostMillis = 0;
+
+#define BENCH_SIZE 128
+#define BENCH_FRAMES 20
+
+static MappingTable *table;
+
+typedef std::vector<std::pair<uint32_t, uint16_t>> Visits; //virtual, physical
+
+static Visits range(uint32_t from, uint32_t to)
+{
+    Visits visits;
+    table->forRange(from, to, [&](uint32_t v, uint16_t p) { visits.push_back({v, p}); });
+    return visits;
+}
+
+// leds on a sphere around the center of a size^3 grid, added in x, y, z order as a fixture definition would
+static uint16_t sphere(uint16_t size, std::vector<uint16_t> &dense)
+{
+    dense.assign((size_t)size * size * size, UINT16_MAX);
+    table->begin(size, size, size);
+    uint16_t nrOfLeds = 0;
+    float radius = size / 4.0f, center = (size - 1) / 2.0f;
+    for (uint16_t z = 0; z < size; z++)
+        for (uint16_t y = 0; y < size; y++)
+            for (uint16_t x = 0; x < size; x++) {
+                float d = sqrtf((x - center) * (x - center) + (y - center) * (y - center) + (z - center) * (z - center));
+                if (fabsf(d - radius) < 0.5f) {
+                    uint32_t v = x + size * (y + (uint32_t)size * z);
+                    table->add(v, nrOfLeds);
+                    dense[v] = nrOfLeds++;
+                }
+            }
+    table->end();
+    return nrOfLeds;
+}
+
+void setUp()
+{
+    hostPsram() = false;
+    table = new MappingTable();
+}
+
+void tearDown()
+{
+    delete table;
+}
+
+void test_row_major()
+{
+    table->begin(10, 1, 1);
+    for (uint16_t i = 0; i < 10; i++)
+        table->add(i, i);
+    table->end();
+    TEST_ASSERT_EQUAL(1, table->nrOfSpans());
+
+    Visits visits = range(2, 5);
+    TEST_ASSERT_EQUAL(3, visits.size());
+    TEST_ASSERT_EQUAL(2, visits[0].first);
+    TEST_ASSERT_EQUAL(2, visits[0].second);
+    TEST_ASSERT_EQUAL(4, visits[2].second);
+    TEST_ASSERT_EQUAL(0, range(10, 20).size());
+}
+
+void test_serpentine()
+{
+    // 4x4, odd rows run right to left: added in physical order, so out of virtual order
+    table->begin(4, 4, 1);
+    for (uint16_t p = 0; p < 16; p++) {
+        uint16_t y = p / 4, x = y % 2 ? 3 - p % 4 : p % 4;
+        table->add(x + 4 * y, p);
+    }
+    table->end();
+    TEST_ASSERT_EQUAL(2 + 2 * 4, table->nrOfSpans()); //even rows one span, odd rows a span per led
+
+    Visits visits = range(4, 8); //row 1
+    TEST_ASSERT_EQUAL(4, visits.size());
+    TEST_ASSERT_EQUAL(4, visits[0].first);
+    TEST_ASSERT_EQUAL(7, visits[0].second);
+    TEST_ASSERT_EQUAL(4, visits[3].second);
+}
+
+void test_shared_virtual()
+{
+    // two physical leds on the same virtual led, and one span covering a range which starts inside it
+    table->begin(100, 1, 1);
+    for (uint16_t i = 0; i < 50; i++)
+        table->add(i, i);
+    table->add(40, 50);
+    table->end();
+
+    Visits visits = range(40, 41);
+    TEST_ASSERT_EQUAL(2, visits.size());
+    TEST_ASSERT_EQUAL(40, visits[0].second);
+    TEST_ASSERT_EQUAL(50, visits[1].second);
+    TEST_ASSERT_EQUAL(5, range(45, 100).size()); //45..49 and nothing after 49
+}
+
+void test_wide()
+{
+    std::vector<uint16_t> dense;
+    uint16_t nrOfLeds = sphere(BENCH_SIZE, dense);
+    TEST_ASSERT_EQUAL(8, sizeof(MappingSpan<uint32_t>));
+    TEST_ASSERT_EQUAL(nrOfLeds, range(0, (uint32_t)BENCH_SIZE * BENCH_SIZE * BENCH_SIZE).size());
+
+    // every plane the same as through the dense table
+    uint32_t plane = BENCH_SIZE * BENCH_SIZE;
+    for (uint32_t z = 0; z < BENCH_SIZE; z += 7) {
+        std::vector<uint16_t> expected;
+        for (uint32_t v = z * plane; v < (z + 1) * plane; v++)
+            if (dense[v] != UINT16_MAX)
+                expected.push_back(dense[v]);
+        Visits visits = range(z * plane, (z + 1) * plane);
+        TEST_ASSERT_EQUAL(expected.size(), visits.size());
+        for (size_t i = 0; i < visits.size(); i++)
+            TEST_ASSERT_EQUAL(expected[i], visits[i].second);
+    }
+}
+
+void test_hot_cache()
+{
+    hostPsram() = true; //spans in "PSRAM", walks through the hot range
+    std::vector<uint16_t> dense;
+    uint16_t nrOfLeds = sphere(64, dense);
+    TEST_ASSERT_TRUE(table->nrOfSpans() > MAPPING_HOT_SPANS);
+
+    uint32_t plane = 64 * 64;
+    uint32_t count = 0;
+    for (uint32_t z = 0; z < 64; z++)
+        for (int again = 0; again < 2; again++) { //the same plane next frame: a hit
+            Visits visits = range(z * plane, (z + 1) * plane);
+            if (!again)
+                count += visits.size();
+        }
+    TEST_ASSERT_EQUAL(nrOfLeds, count);
+
+    JsonDocument doc;
+    JsonObject root = doc.to<JsonObject>();
+    table->analytics(root);
+    uint32_t hitPct = root["mapping_hot_hit_pct"];
+    TEST_ASSERT_TRUE(hitPct >= 50);
+}
+
+// memory, and us per frame of visiting the leds of every plane (as the Plane effect does for one plane per frame)
+void test_bench()
+{
+    std::vector<uint16_t> dense;
+    uint16_t nrOfLeds = sphere(BENCH_SIZE, dense);
+    uint32_t plane = BENCH_SIZE * BENCH_SIZE;
+    std::vector<CRGB> leds(nrOfLeds);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++)
+        for (uint32_t z = 0; z < BENCH_SIZE; z++)
+            table->forRange(z * plane, (z + 1) * plane, [&](uint32_t, uint16_t p) { leds[p] = CRGB(frame, z, 0); });
+    double spansUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / BENCH_FRAMES;
+
+    start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++)
+        for (uint32_t z = 0; z < BENCH_SIZE; z++)
+            for (uint32_t v = z * plane; v < (z + 1) * plane; v++)
+                if (dense[v] != UINT16_MAX)
+                    leds[dense[v]] = CRGB(frame, z, 0);
+    double denseUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / BENCH_FRAMES;
+
+    char message[160];
+    snprintf(message, sizeof(message), "%d leds in %d^3: %d spans %d bytes, %.1f us/frame; dense %d bytes, %.1f us/frame", nrOfLeds, BENCH_SIZE,
+             (int)table->nrOfSpans(), (int)table->bytes(), spansUs, (int)table->denseBytes(), denseUs);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(table->bytes() * 20 < table->denseBytes());
+    TEST_ASSERT_TRUE(spansUs < denseUs);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_row_major);
+    RUN_TEST(test_serpentine);
+    RUN_TEST(test_shared_virtual);
+    RUN_TEST(test_wide);
+    RUN_TEST(test_hot_cache);
+    RUN_TEST(test_bench);
+    return UNITY_END();
+}
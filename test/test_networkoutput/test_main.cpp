@@ -0,0 +1,201 @@
+/**
+    @title     MoonLight
+    @file      test_main.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+// The packets of one network output destination (NetworkOutput): DDP and Art-Net framing, unchanged packets skipped
+// and resent as keep alive, the rate limits, and the time per frame of hashing and building the packets of 16K leds.
+// Times are of the build machine, the device reports its show() time in GET /rest/networkOutputStats.
+
+#include <unity.h>
+#include <NetworkOutput.cpp>
+#include <chrono>
+#include <vector>
+
+unsigned long hostMillis = 0;
+
+#define BENCH_LEDS 16384
+#define BENCH_FRAMES 200
+
+static NetworkOutput *output;
+static uint8_t packet[DDP_HEADER_SIZE + DDP_MAX_DATA];
+static std::vector<std::vector<uint8_t>> sent;
+
+static OutputSend capture = [](const OutputDestination &destination, const uint8_t *data, size_t len) {
+    sent.push_back(std::vector<uint8_t>(data, data + len));
+};
+
+static void show(std::vector<CRGB> &leds, uint8_t brightness = UINT8_MAX, uint32_t elapsed = 20000)
+{
+    sent.clear();
+    output->show(leds.data(), leds.size(), brightness, elapsed, packet, capture);
+}
+
+void setUp()
+{
+    hostMillis = 1000;
+    output = new NetworkOutput();
+}
+
+void tearDown()
+{
+    delete output;
+}
+
+void test_ddp_packets()
+{
+    std::vector<CRGB> leds(1000); //480 + 480 + 40
+    for (size_t i = 0; i < leds.size(); i++)
+        leds[i] = CRGB(i, i >> 8, 7);
+    show(leds);
+    TEST_ASSERT_EQUAL(3, sent.size());
+    TEST_ASSERT_EQUAL(DDP_HEADER_SIZE + DDP_MAX_DATA, sent[0].size());
+    TEST_ASSERT_EQUAL(0x40, sent[0][0]); //no push
+    TEST_ASSERT_EQUAL(0x41, sent[2][0]); //push with the last packet
+    TEST_ASSERT_EQUAL(1, sent[0][1]); //sequence
+    uint32_t offset = (sent[1][4] << 24) | (sent[1][5] << 16) | (sent[1][6] << 8) | sent[1][7];
+    TEST_ASSERT_EQUAL(480 * 3, offset);
+    TEST_ASSERT_EQUAL(DDP_HEADER_SIZE + 40 * 3, sent[2].size());
+    TEST_ASSERT_EQUAL(40 * 3, (sent[2][8] << 8) | sent[2][9]);
+    TEST_ASSERT_EQUAL(480 & 0xFF, sent[1][DDP_HEADER_SIZE]); //led 480
+    TEST_ASSERT_EQUAL(3, output->packets);
+}
+
+void test_skip_unchanged_and_keepalive()
+{
+    std::vector<CRGB> leds(1000, CRGB(1, 2, 3));
+    show(leds);
+    TEST_ASSERT_EQUAL(3, sent.size());
+
+    hostMillis += 20;
+    show(leds);
+    TEST_ASSERT_EQUAL(0, sent.size());
+    TEST_ASSERT_EQUAL(3, output->skipped);
+
+    leds[500] = CRGB(9, 9, 9); //second packet only, it pushes
+    show(leds);
+    TEST_ASSERT_EQUAL(1, sent.size());
+    TEST_ASSERT_EQUAL(0x41, sent[0][0]);
+    TEST_ASSERT_EQUAL(480 * 3, sent[0][7] | (sent[0][6] << 8));
+
+    show(leds, 128); //brightness changes the bytes sent
+    TEST_ASSERT_EQUAL(3, sent.size());
+    TEST_ASSERT_EQUAL(4, sent[1][DDP_HEADER_SIZE + 20 * 3 + 2]); //led 500: scale8(9, 128)
+
+    hostMillis += OUTPUT_KEEPALIVE;
+    show(leds, 128);
+    TEST_ASSERT_EQUAL(3, sent.size());
+}
+
+void test_artnet_universes()
+{
+    output->settings.protocol = OUTPUT_ARTNET;
+    output->settings.universe = 3;
+    output->settings.start = 10;
+    output->settings.count = 171; //170 + 1
+    std::vector<CRGB> leds(200, CRGB(4, 5, 6));
+    show(leds);
+    TEST_ASSERT_EQUAL(3, sent.size()); //2 universes and ArtSync
+    TEST_ASSERT_EQUAL_STRING("Art-Net", (const char *)sent[0].data());
+    TEST_ASSERT_EQUAL(0x50, sent[0][9]);
+    TEST_ASSERT_EQUAL(3, sent[0][14]);
+    TEST_ASSERT_EQUAL(4, sent[1][14]);
+    TEST_ASSERT_EQUAL(ARTNET_MAX_DATA, (sent[0][16] << 8) | sent[0][17]);
+    TEST_ASSERT_EQUAL(4, (sent[1][16] << 8) | sent[1][17]); //3 bytes, padded to even
+    TEST_ASSERT_EQUAL(ARTNET_HEADER_SIZE + 4, sent[1].size());
+    TEST_ASSERT_EQUAL(0x52, sent[2][9]); //OpSync
+    TEST_ASSERT_EQUAL(14, sent[2].size());
+
+    hostMillis += 20;
+    show(leds);
+    TEST_ASSERT_EQUAL(0, sent.size()); //no ArtSync without universes
+}
+
+// start and count beyond the fixture send nothing or the leds until the end
+void test_clipped_to_fixture()
+{
+    std::vector<CRGB> leds(100, CRGB(1, 1, 1));
+    output->settings.start = 100;
+    show(leds);
+    TEST_ASSERT_EQUAL(0, sent.size());
+    output->settings.start = 90;
+    show(leds);
+    TEST_ASSERT_EQUAL(1, sent.size());
+    TEST_ASSERT_EQUAL(DDP_HEADER_SIZE + 10 * 3, sent[0].size());
+}
+
+// 8 packets a frame at 100 packets/s and 20ms frames: 2 tokens a frame after the first burst
+void test_packet_rate_limit()
+{
+    output->settings.maxPacketsPerSecond = 100;
+    std::vector<CRGB> leds(480 * 8);
+    uint32_t frames = 0;
+    for (int frame = 0; frame < 50; frame++) {
+        for (size_t i = 0; i < leds.size(); i++)
+            leds[i] = CRGB(frame, i, 0);
+        hostMillis += 20;
+        show(leds, UINT8_MAX, 20000);
+        frames += sent.size();
+    }
+    TEST_ASSERT_INT_WITHIN(12, 100 + 10, frames); //1s of packets and the burst of 100ms
+    TEST_ASSERT_TRUE(output->throttled > 0);
+    TEST_ASSERT_EQUAL(output->packets, frames);
+}
+
+// throttled packets are sent in a next frame, even if their leds do not change anymore
+void test_throttled_sent_later()
+{
+    output->settings.maxPacketsPerSecond = 10; //burst: at least one frame (3 packets + 1)
+    std::vector<CRGB> leds(1000, CRGB(1, 1, 1));
+    show(leds, UINT8_MAX, 0);
+    TEST_ASSERT_EQUAL(0, sent.size()); //no tokens yet
+    TEST_ASSERT_EQUAL(3, output->throttled);
+    hostMillis += 20;
+    show(leds, UINT8_MAX, 400000);
+    TEST_ASSERT_EQUAL(3, sent.size());
+}
+
+// time per frame of show() for a destination of all leds: hashing only (unchanged), or hashing and building all
+// packets. Returns the number of packets sent
+static uint32_t bench(bool change)
+{
+    std::vector<CRGB> leds(BENCH_LEDS);
+    uint32_t packets = 0;
+    OutputSend count = [&packets](const OutputDestination &, const uint8_t *, size_t) { packets++; };
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        if (change || !frame)
+            for (size_t i = 0; i < leds.size(); i++)
+                leds[i] = CRGB(i + frame, frame, i >> 8);
+        hostMillis += 20;
+        output->show(leds.data(), leds.size(), 200, 20000, packet, count);
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / BENCH_FRAMES;
+
+    char message[128];
+    snprintf(message, sizeof(message), "show %d leds %s: %.1f us/frame, %u packets", BENCH_LEDS, change ? "all changed" : "unchanged", us, packets);
+    TEST_MESSAGE(message);
+    return packets;
+}
+
+void test_bench_unchanged() { TEST_ASSERT_TRUE(bench(false) < BENCH_FRAMES * 35 / 10); } //first frame and keep alives only
+void test_bench_changed() { TEST_ASSERT_EQUAL(BENCH_FRAMES * 35, bench(true)); } //35 packets a frame
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ddp_packets);
+    RUN_TEST(test_skip_unchanged_and_keepalive);
+    RUN_TEST(test_artnet_universes);
+    RUN_TEST(test_clipped_to_fixture);
+    RUN_TEST(test_packet_rate_limit);
+    RUN_TEST(test_throttled_sent_later);
+    RUN_TEST(test_bench_unchanged);
+    RUN_TEST(test_bench_changed);
+    return UNITY_END();
+}
@@ -0,0 +1,117 @@
+/**
+    @title     MoonLight
+    @file      test_main.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+// Round trip and throughput of the recording codec at 16K leds (STARLIGHT_MAXLEDS of the n16r8v boards):
+// encode and decode time per frame and the payload bytes per frame the reader task has to stream from flash.
+// Times are of the build machine, the device reports its decode time in GET /rest/recorder (decode_us).
+
+#include <unity.h>
+#include <FrameCodec.cpp>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+unsigned long hostMillis = 0;
+
+#define BENCH_LEDS 16384
+#define BENCH_FRAMES 200
+#define BENCH_FPS 40
+
+typedef void (*Pattern)(CRGB *leds, uint16_t nrOfLeds, uint32_t frame);
+
+// every led changes every frame: the worst case for deltas
+static void rainbow(CRGB *leds, uint16_t nrOfLeds, uint32_t frame)
+{
+    for (uint16_t i = 0; i < nrOfLeds; i++)
+        leds[i] = CRGB(i + frame * 3, i * 2 + frame, 255 - i - frame * 2);
+}
+
+// a few moving dots on black, most leds unchanged between frames
+static void dots(CRGB *leds, uint16_t nrOfLeds, uint32_t frame)
+{
+    std::fill(leds, leds + nrOfLeds, CRGB(0, 0, 0));
+    for (uint16_t d = 0; d < 64; d++)
+        leds[(d * 257 + frame * (d + 1)) % nrOfLeds] = CRGB(255, d * 4, 0);
+}
+
+// a solid color fading: long runs
+static void fade(CRGB *leds, uint16_t nrOfLeds, uint32_t frame)
+{
+    for (uint16_t i = 0; i < nrOfLeds; i++)
+        leds[i] = CRGB(frame, 0, 255 - frame);
+}
+
+static double micros(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void bench(const char *name, Pattern pattern)
+{
+    std::vector<CRGB> leds(BENCH_LEDS), previous(BENCH_LEDS), decoded(BENCH_LEDS);
+    std::vector<uint8_t> payload(frameMaxPayload(BENCH_LEDS));
+    double encodeMicros = 0, decodeMicros = 0, worstDecode = 0;
+    size_t bytes = 0, worstBytes = 0;
+
+    for (uint32_t frame = 0; frame < BENCH_FRAMES; frame++)
+    {
+        pattern(leds.data(), BENCH_LEDS, frame);
+        bool key = frame % FRAME_KEY_INTERVAL == 0;
+
+        auto start = std::chrono::steady_clock::now();
+        size_t len = frameEncode(leds.data(), key ? nullptr : previous.data(), BENCH_LEDS, payload.data());
+        encodeMicros += micros(start);
+        TEST_ASSERT_LESS_OR_EQUAL(frameMaxPayload(BENCH_LEDS), len);
+
+        start = std::chrono::steady_clock::now();
+        bool ok = frameDecode(payload.data(), len, key ? FRAME_KEY : FRAME_DELTA, decoded.data(), BENCH_LEDS);
+        double decode = micros(start);
+        TEST_ASSERT_TRUE(ok);
+        TEST_ASSERT_EQUAL_MEMORY(leds.data(), decoded.data(), BENCH_LEDS * sizeof(CRGB));
+
+        decodeMicros += decode;
+        worstDecode = MAX(worstDecode, decode);
+        bytes += len;
+        worstBytes = MAX(worstBytes, len);
+        previous = leds;
+    }
+
+    char message[200];
+    snprintf(message, sizeof(message), "%s %d leds: encode %.0f us, decode %.0f us (worst %.0f), %zu bytes/frame (worst %zu): %.0f KB/s at %d fps",
+             name, BENCH_LEDS, encodeMicros / BENCH_FRAMES, decodeMicros / BENCH_FRAMES, worstDecode, bytes / BENCH_FRAMES, worstBytes,
+             (double)bytes / BENCH_FRAMES * BENCH_FPS / 1024, BENCH_FPS);
+    TEST_MESSAGE(message);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_rainbow() { bench("rainbow", rainbow); }
+void test_dots() { bench("dots", dots); }
+void test_fade() { bench("fade", fade); }
+
+void test_corrupt_rejected()
+{
+    CRGB leds[4];
+    uint8_t tooLong[] = {127, 1, 2, 3}; //128 literals, 1 present
+    TEST_ASSERT_FALSE(frameDecode(tooLong, sizeof(tooLong), FRAME_KEY, leds, 4));
+    uint8_t tooShort[] = {128, 1, 2, 3}; //run of 2 of 4 leds
+    TEST_ASSERT_FALSE(frameDecode(tooShort, sizeof(tooShort), FRAME_KEY, leds, 4));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_rainbow);
+    RUN_TEST(test_dots);
+    RUN_TEST(test_fade);
+    RUN_TEST(test_corrupt_rejected);
+    return UNITY_END();
+}
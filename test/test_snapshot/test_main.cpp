@@ -0,0 +1,163 @@
+/**
+    @title     MoonLight
+    @file      test_main.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+// StateSnapshot under contention: a writer thread updates a state the size of FixtureState holding a lock, as
+// StatefulService::update does, while the test reads it with that lock and from the snapshot. Checks that snapshot
+// copies are never torn and measures the reader latency of both. Times are of the build machine.
+
+#include <unity.h>
+#include <StateSnapshot.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+unsigned long hostMillis = 0;
+
+#define BENCH_MILLIS 300
+
+typedef std::chrono::steady_clock benchClock;
+
+struct BenchState
+{
+    bool lightsOn;
+    uint8_t brightness;
+    uint16_t fixture;
+    bool driverOn;
+    bool monitorOn;
+    uint16_t slice[6]; //all the same value: a torn copy has different ones
+};
+
+static std::recursive_mutex accessMutex; //as StatefulService::_accessMutex
+static BenchState state;
+static StateSnapshot<BenchState> snapshot;
+static std::atomic<bool> stopWriter;
+
+static void writer(int holdMicros)
+{
+    uint16_t value = 0;
+    while (!stopWriter)
+    {
+        std::lock_guard<std::recursive_mutex> lock(accessMutex);
+        value++;
+        for (uint16_t &coordinate : state.slice)
+            coordinate = value;
+        state.brightness = value;
+        snapshot.publish(state);
+        auto start = benchClock::now();
+        while (benchClock::now() - start < std::chrono::microseconds(holdMicros))
+            ; //a slow handler
+    }
+}
+
+static bool torn(const BenchState &copy)
+{
+    for (uint16_t coordinate : copy.slice)
+        if (coordinate != copy.slice[0])
+            return true;
+    return false;
+}
+
+struct Latency
+{
+    double p50, p99, max;
+    size_t reads;
+    bool torn;
+};
+
+// reads for BENCH_MILLIS, pause: micros between reads (0: as fast as possible)
+template <typename Read>
+static Latency measure(Read read, int pause)
+{
+    std::vector<double> nanos;
+    BenchState copy;
+    bool anyTorn = false;
+    auto end = benchClock::now() + std::chrono::milliseconds(BENCH_MILLIS);
+    while (benchClock::now() < end)
+    {
+        auto start = benchClock::now();
+        read(copy);
+        nanos.push_back(std::chrono::duration<double, std::nano>(benchClock::now() - start).count());
+        anyTorn |= torn(copy);
+        if (pause)
+            std::this_thread::sleep_for(std::chrono::microseconds(pause));
+    }
+    std::sort(nanos.begin(), nanos.end());
+    return {nanos[nanos.size() / 2], nanos[nanos.size() * 99 / 100], nanos.back(), nanos.size(), anyTorn};
+}
+
+static void lockedRead(BenchState &copy)
+{
+    std::lock_guard<std::recursive_mutex> lock(accessMutex);
+    copy = state;
+}
+
+static void snapshotRead(BenchState &copy)
+{
+    snapshot.read(copy);
+}
+
+static void report(const char *name, int holdMicros, const Latency &latency)
+{
+    char message[160];
+    snprintf(message, sizeof(message), "%s read, writer holds the lock %d us: p50 %.0f ns, p99 %.0f ns, max %.0f ns (%zu reads)",
+             name, holdMicros, latency.p50, latency.p99, latency.max, latency.reads);
+    TEST_MESSAGE(message);
+}
+
+void setUp()
+{
+    stopWriter = false;
+}
+
+void tearDown() {}
+
+// writer and reader as fast as possible: the most retries, no copy may be torn
+void test_no_torn_reads()
+{
+    std::thread thread(writer, 0);
+    Latency latency = measure(snapshotRead, 0);
+    stopWriter = true;
+    thread.join();
+
+    TEST_ASSERT_FALSE(latency.torn);
+    TEST_ASSERT_GREATER_THAN(0, snapshot.version());
+    char message[96];
+    snprintf(message, sizeof(message), "%zu reads, %u retries", latency.reads, snapshot.retries());
+    TEST_MESSAGE(message);
+}
+
+static void bench(int holdMicros)
+{
+    std::thread thread(writer, holdMicros);
+    Latency locked = measure(lockedRead, 50);
+    Latency snapshotted = measure(snapshotRead, 50);
+    stopWriter = true;
+    thread.join();
+
+    report("locked", holdMicros, locked);
+    report("snapshot", holdMicros, snapshotted);
+    TEST_ASSERT_FALSE(locked.torn || snapshotted.torn);
+    if (holdMicros)
+        TEST_ASSERT_LESS_THAN(locked.p50, snapshotted.p99); //the snapshot reader does not wait for the writer
+}
+
+void test_bench_fast_writer() { bench(0); }
+void test_bench_slow_writer() { bench(2000); }
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_no_torn_reads);
+    RUN_TEST(test_bench_fast_writer);
+    RUN_TEST(test_bench_slow_writer);
+    return UNITY_END();
+}
@@ -0,0 +1,311 @@
+/**
+    @title     MoonLight
+    @file      test_main.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+// StateFields against the hand-written read / update FixtureState had before it was declared with StateFields:
+// the generated codecs give the same json, and the serialization cost of json read, json update, MsgPack and
+// binary encoding of both. Times are of the build machine.
+
+#include <unity.h>
+#include <ArduinoJson.h>
+#include <StateFields.cpp>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+unsigned long hostMillis = 0;
+
+#define BENCH_RUNS 200000
+
+struct BenchSlice
+{
+    uint16_t x = 0, y = 0, z = 0;
+    uint16_t width = 0, height = 0, depth = 0;
+};
+
+// FixtureState
+struct BenchState
+{
+    bool lightsOn = false;
+    uint8_t brightness = UINT8_MAX;
+    uint16_t fixture = UINT8_MAX;
+    bool driverOn = false;
+    bool monitorOn = false;
+    BenchSlice slice;
+};
+
+static constexpr state_field_t benchFieldList[] = {
+    STATE_FIELD(BenchState, lightsOn),
+    STATE_FIELD(BenchState, brightness),
+    STATE_FIELD(BenchState, fixture),
+    STATE_FIELD(BenchState, driverOn),
+    STATE_FIELD(BenchState, monitorOn),
+    STATE_FIELD(BenchState, slice.x),
+    STATE_FIELD(BenchState, slice.y),
+    STATE_FIELD(BenchState, slice.z),
+    STATE_FIELD(BenchState, slice.width),
+    STATE_FIELD(BenchState, slice.height),
+    STATE_FIELD(BenchState, slice.depth),
+};
+static constexpr StateFields benchFields(benchFieldList);
+static_assert(benchFields.bit("brightness") == 1u << 1, "bit of a field");
+static_assert(benchFields.groupBits("slice") == 0x7E0, "bits of a nested object");
+
+// the hand-written FixtureState::read and update, without the StarLight side effects
+static void handRead(BenchState &state, JsonObject &root)
+{
+    root["lightsOn"] = state.lightsOn;
+    root["brightness"] = state.brightness;
+    root["fixture"] = state.fixture;
+    root["driverOn"] = state.driverOn;
+    root["monitorOn"] = state.monitorOn;
+    JsonObject slice = root["slice"].to<JsonObject>();
+    slice["x"] = state.slice.x;
+    slice["y"] = state.slice.y;
+    slice["z"] = state.slice.z;
+    slice["width"] = state.slice.width;
+    slice["height"] = state.slice.height;
+    slice["depth"] = state.slice.depth;
+}
+
+static bool handUpdate(JsonObject &root, BenchState &state)
+{
+    bool changed = false;
+    if (state.lightsOn != root["lightsOn"]) {
+        state.lightsOn = root["lightsOn"]; changed = true;
+    }
+    if (state.brightness != root["brightness"]) {
+        state.brightness = root["brightness"]; changed = true;
+    }
+    if (state.fixture != root["fixture"]) {
+        state.fixture = root["fixture"]; changed = true;
+    }
+    if (state.driverOn != root["driverOn"]) {
+        state.driverOn = root["driverOn"]; changed = true;
+    }
+    if (state.monitorOn != root["monitorOn"]) {
+        state.monitorOn = root["monitorOn"]; changed = true;
+    }
+    JsonObject slice = root["slice"];
+    if (!slice.isNull()) {
+        BenchSlice newSlice;
+        newSlice.x = slice["x"]; newSlice.y = slice["y"]; newSlice.z = slice["z"];
+        newSlice.width = slice["width"]; newSlice.height = slice["height"]; newSlice.depth = slice["depth"];
+        if (memcmp(&newSlice, &state.slice, sizeof(BenchSlice)) != 0) {
+            state.slice = newSlice; changed = true;
+        }
+    }
+    return changed;
+}
+
+// the whole state, as the UI sends it
+static const char *updateJson = "{\"lightsOn\":true,\"brightness\":128,\"fixture\":3,\"driverOn\":true,\"monitorOn\":false,"
+                                "\"slice\":{\"x\":0,\"y\":16,\"z\":0,\"width\":32,\"height\":32,\"depth\":1}}";
+
+static BenchState changedState()
+{
+    BenchState state;
+    state.lightsOn = true;
+    state.brightness = 128;
+    state.fixture = 3;
+    state.driverOn = true;
+    state.slice.y = 16;
+    state.slice.width = 32;
+    state.slice.height = 32;
+    state.slice.depth = 1;
+    return state;
+}
+
+template <typename Run>
+static double nanosPerRun(Run run)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_RUNS; i++)
+        run(i);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / BENCH_RUNS;
+}
+
+static void report(const char *what, double hand, double fields, size_t handBytes, size_t fieldsBytes)
+{
+    char message[160];
+    snprintf(message, sizeof(message), "%s: hand-written %.0f ns (%zu bytes), StateFields %.0f ns (%zu bytes)", what, hand, handBytes, fields, fieldsBytes);
+    TEST_MESSAGE(message);
+}
+
+static volatile size_t sink;
+
+void setUp() {}
+void tearDown() {}
+
+void test_read_same_json()
+{
+    BenchState state = changedState();
+    JsonDocument handDoc, fieldsDoc;
+    JsonObject handRoot = handDoc.to<JsonObject>();
+    JsonObject fieldsRoot = fieldsDoc.to<JsonObject>();
+    handRead(state, handRoot);
+    benchFields.read(&state, fieldsRoot);
+
+    char hand[256], fields[256];
+    serializeJson(handDoc, hand, sizeof(hand));
+    serializeJson(fieldsDoc, fields, sizeof(fields));
+    TEST_ASSERT_EQUAL_STRING(hand, fields);
+}
+
+void test_update_changed_bits()
+{
+    JsonDocument doc;
+    deserializeJson(doc, updateJson);
+    JsonObject root = doc.as<JsonObject>();
+    BenchState state, initial, expected = changedState();
+    uint32_t changed = benchFields.update(root, &state);
+    TEST_ASSERT_EQUAL_UINT32(benchFields.diff(&state, &initial), changed);
+    TEST_ASSERT_EQUAL(0, benchFields.diff(&state, &expected));
+    TEST_ASSERT_EQUAL(0, benchFields.update(root, &state)); //the same again: nothing changed
+}
+
+// the hand-written update reset missing keys to 0, StateFields leaves their fields as they are
+void test_update_missing_keys_unchanged()
+{
+    JsonDocument doc;
+    deserializeJson(doc, "{\"brightness\":10}");
+    JsonObject root = doc.as<JsonObject>();
+
+    BenchState fieldsState = changedState();
+    TEST_ASSERT_EQUAL_UINT32(benchFields.bit("brightness"), benchFields.update(root, &fieldsState));
+    TEST_ASSERT_EQUAL(10, fieldsState.brightness);
+    TEST_ASSERT_EQUAL(3, fieldsState.fixture);
+    TEST_ASSERT_EQUAL(32, fieldsState.slice.width);
+
+    BenchState handState = changedState();
+    handUpdate(root, handState);
+    TEST_ASSERT_EQUAL(0, handState.fixture);
+}
+
+void test_binary_round_trip()
+{
+    BenchState state = changedState(), copy;
+    uint8_t buffer[64];
+    uint32_t mask = benchFields.diff(&state, &copy);
+    size_t len = benchFields.writeBinary(&state, buffer, sizeof(buffer), mask);
+    TEST_ASSERT_EQUAL(benchFields.binarySize(mask), len);
+    TEST_ASSERT_EQUAL_UINT32(mask, benchFields.readBinary(buffer, len, &copy));
+    TEST_ASSERT_EQUAL(0, benchFields.diff(&state, &copy));
+    BenchState truncated;
+    TEST_ASSERT_EQUAL(0, benchFields.readBinary(buffer, len - 1, &truncated));
+}
+
+void test_msgpack_same_as_arduinojson()
+{
+    BenchState state = changedState();
+    JsonDocument doc;
+    JsonObject root = doc.to<JsonObject>();
+    handRead(state, root);
+    uint8_t expected[128], buffer[128];
+    size_t expectedLen = serializeMsgPack(doc, expected, sizeof(expected));
+    size_t len = benchFields.writeMsgPack(&state, buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL(expectedLen, len);
+    TEST_ASSERT_EQUAL_MEMORY(expected, buffer, len);
+    TEST_ASSERT_EQUAL(0, benchFields.writeMsgPack(&state, buffer, len - 1)); //too small
+}
+
+// state to json text: the read of every http get, websocket and event of the service
+void test_bench_read()
+{
+    BenchState state = changedState();
+    char buffer[256];
+    size_t handLen = 0, fieldsLen = 0;
+    double hand = nanosPerRun([&](int i) {
+        JsonDocument doc;
+        JsonObject root = doc.to<JsonObject>();
+        handRead(state, root);
+        handLen = serializeJson(doc, buffer, sizeof(buffer));
+    });
+    double fields = nanosPerRun([&](int i) {
+        JsonDocument doc;
+        JsonObject root = doc.to<JsonObject>();
+        benchFields.read(&state, root);
+        fieldsLen = serializeJson(doc, buffer, sizeof(buffer));
+    });
+    report("read + serializeJson", hand, fields, handLen, fieldsLen);
+}
+
+// parsed once, the update alone: the field lookups and assignments
+void test_bench_update()
+{
+    JsonDocument doc;
+    deserializeJson(doc, updateJson);
+    JsonObject root = doc.as<JsonObject>();
+    BenchState states[2] = {BenchState(), changedState()};
+    double hand = nanosPerRun([&](int i) {
+        BenchState state = states[i & 1]; //every other run changes all fields
+        sink = handUpdate(root, state);
+    });
+    double fields = nanosPerRun([&](int i) {
+        BenchState state = states[i & 1];
+        sink = benchFields.update(root, &state);
+    });
+    report("update", hand, fields, strlen(updateJson), strlen(updateJson));
+
+    double parse = nanosPerRun([&](int i) {
+        JsonDocument parsed;
+        deserializeJson(parsed, updateJson);
+        sink = parsed.size();
+    });
+    char message[96];
+    snprintf(message, sizeof(message), "deserializeJson of the update: %.0f ns", parse);
+    TEST_MESSAGE(message);
+}
+
+// MsgPack: ArduinoJson of a read document against StateFields directly from the state
+void test_bench_msgpack()
+{
+    BenchState state = changedState();
+    uint8_t buffer[128];
+    size_t handLen = 0, fieldsLen = 0;
+    double hand = nanosPerRun([&](int i) {
+        JsonDocument doc;
+        JsonObject root = doc.to<JsonObject>();
+        handRead(state, root);
+        handLen = serializeMsgPack(doc, buffer, sizeof(buffer));
+    });
+    double fields = nanosPerRun([&](int i) {
+        fieldsLen = benchFields.writeMsgPack(&state, buffer, sizeof(buffer));
+    });
+    report("read + serializeMsgPack / writeMsgPack", hand, fields, handLen, fieldsLen);
+}
+
+// binary encoding of all fields and of one changed field, and diff (no hand-written counterpart)
+void test_bench_binary()
+{
+    BenchState state = changedState(), other;
+    uint8_t buffer[64];
+    size_t allLen = 0, oneLen = 0;
+    double all = nanosPerRun([&](int i) { allLen = benchFields.writeBinary(&state, buffer, sizeof(buffer)); });
+    double one = nanosPerRun([&](int i) { oneLen = benchFields.writeBinary(&state, buffer, sizeof(buffer), benchFields.bit("brightness")); });
+    double diff = nanosPerRun([&](int i) { sink = benchFields.diff(&state, &other); });
+    char message[160];
+    snprintf(message, sizeof(message), "writeBinary all %.0f ns (%zu bytes), brightness only %.0f ns (%zu bytes), diff %.0f ns", all, allLen, one, oneLen, diff);
+    TEST_MESSAGE(message);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_read_same_json);
+    RUN_TEST(test_update_changed_bits);
+    RUN_TEST(test_update_missing_keys_unchanged);
+    RUN_TEST(test_binary_round_trip);
+    RUN_TEST(test_msgpack_same_as_arduinojson);
+    RUN_TEST(test_bench_read);
+    RUN_TEST(test_bench_update);
+    RUN_TEST(test_bench_msgpack);
+    RUN_TEST(test_bench_binary);
+    return UNITY_END();
+}
@@ -0,0 +1,140 @@
+/**
+    @title     MoonLight
+    @file      test_main.cpp
+    @repo      https://github.com/MoonModules/MoonLight, submit changes to this file as PRs
+    @Authors   https://github.com/MoonModules/MoonLight/commits/main
+    @Copyright © 2025 Github MoonLight Commit Authors
+    @license   GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007
+    @license   For non GPL-v3 usage, commercial licenses must be purchased. Contact moonmodules@icloud.com
+**/
+
+// N followers synchronize to a leader over a simulated WiFi link: each follower has its own clock offset and skew,
+// packets get an asymmetric random delay and now and then a queueing delay. Checks that all followers agree with the
+// leader clock within a millisecond.
+
+#include <unity.h>
+#include <TimeSyncClock.cpp>
+#include <random>
+
+unsigned long hostMillis = 0;
+
+#define NR_OF_NODES 8
+#define SIMULATED_SECONDS 300
+
+static std::mt19937 rng(1);
+static std::uniform_real_distribution<double> uniform(0, 1);
+static std::exponential_distribution<double> jitter(1 / 150.0); //us, mean 150
+
+// one way WiFi delay in us: base, jitter and 5% of the packets queued up to 20ms
+static double linkDelay()
+{
+    return 800 + jitter(rng) + (uniform(rng) < 0.05 ? 20000 * uniform(rng) : 0);
+}
+
+struct Node
+{
+    TimeSyncClock clock;
+    double offset; //us
+    double skew;   //fraction, positive: runs fast
+    int64_t local(double leader) { return (int64_t)(leader * (1 + skew) + offset); }
+};
+
+static Node nodes[NR_OF_NODES];
+static double worstError; //us, after the warm up
+static double meanError;
+
+void setUp()
+{
+    for (Node &node : nodes)
+    {
+        node.clock = TimeSyncClock();
+        node.clock.setLeader(false);
+        node.offset = (uniform(rng) - 0.5) * 2e9;    //+-1000s
+        node.skew = (uniform(rng) - 0.5) * 80e-6; //+-40ppm
+    }
+}
+
+void tearDown() {}
+
+// one SYNC, DELAY_REQ, DELAY_RESP exchange per node every TIME_SYNC_INTERVAL, t in us of the leader clock
+static void simulate(int seconds, int warmup)
+{
+    worstError = 0;
+    meanError = 0;
+    int measured = 0;
+    for (int k = 0; k < seconds * 1000 / TIME_SYNC_INTERVAL; k++)
+    {
+        double t = k * TIME_SYNC_INTERVAL * 1000.0;
+        hostMillis = t / 1000;
+        for (Node &node : nodes)
+        {
+            double t2 = t + linkDelay();
+            node.clock.handleSync(k & 0xFF, (int64_t)t, node.local(t2));
+            uint8_t seq;
+            double t3 = t2 + 300; //answered from the AsyncUDP task
+            TEST_ASSERT_TRUE(node.clock.delayRequestPending(seq, node.local(t3)));
+            node.clock.handleDelayResp(seq, (int64_t)(t3 + linkDelay()));
+
+            if (k >= warmup)
+            {
+                // between two syncs: the effect clock of the node against the leader
+                double probe = t + TIME_SYNC_INTERVAL * 1000.0 * uniform(rng);
+                double error = fabs((double)node.clock.globalMicros(node.local(probe)) - probe);
+                worstError = MAX(worstError, error);
+                meanError += error;
+                measured++;
+            }
+        }
+    }
+    if (measured)
+        meanError /= measured;
+}
+
+void test_alignment_sub_millisecond()
+{
+    simulate(SIMULATED_SECONDS, TIME_SYNC_WINDOW * 2);
+
+    char message[100];
+    snprintf(message, sizeof(message), "%d nodes, %ds: worst %.0f us, mean %.0f us", NR_OF_NODES, SIMULATED_SECONDS, worstError, meanError);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_LESS_THAN(1000, worstError);
+
+    // skewPpm is the slope of a 4s window: tens of ppm noise, which over the 250ms between syncs is a few us
+    for (Node &node : nodes)
+    {
+        TimeSyncStats stats = node.clock.stats();
+        TEST_ASSERT_FLOAT_WITHIN(100, node.skew * 1e6, stats.skewPpm);
+        TEST_ASSERT_GREATER_THAN(0, stats.rejected); //queued packets were left out
+        TEST_ASSERT_TRUE(node.clock.synced());
+    }
+}
+
+void test_late_response_ignored()
+{
+    TimeSyncClock &clock = nodes[0].clock;
+    clock.handleSync(1, 1000, 2000);
+    uint8_t seq;
+    TEST_ASSERT_TRUE(clock.delayRequestPending(seq, 2100));
+    TEST_ASSERT_FALSE(clock.delayRequestPending(seq, 2200)); //one request per sync
+    clock.handleSync(2, 2000, 3000); //next sync before the response
+    clock.handleDelayResp(1, 1300);
+    TEST_ASSERT_EQUAL(0, clock.stats().samples);
+}
+
+void test_reset_falls_back_to_local()
+{
+    simulate(10, SIMULATED_SECONDS);
+    Node &node = nodes[0];
+    TEST_ASSERT_TRUE(node.clock.globalMicros(1000) != 1000);
+    node.clock.reset(); //new leader
+    TEST_ASSERT_EQUAL(1000, node.clock.globalMicros(1000));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_alignment_sub_millisecond);
+    RUN_TEST(test_late_response_ignored);
+    RUN_TEST(test_reset_falls_back_to_local);
+    return UNITY_END();
+}